@@ -0,0 +1,644 @@
+// bench/rubiks_bench.cpp - Reproducible solver benchmark
+//
+// Runs a fixed corpus of seeded scrambles, grouped by scramble length,
+// through each solver at each thread count, several times over, and reports
+// measured wall times only: mean and p50/p95/p99, node throughput, nodes per
+// IDA* iteration, and strong scaling and throughput efficiency against the
+// sequential solver. --json and --csv write the same numbers for diffing
+// between builds.
+//
+// --kernel-ops N instead times the facelet move kernels (scalar, AVX2,
+// AVX-512) on N moves, isSolved and heuristic calls each, and exits.
+//
+// MPI and hybrid solves are collective: start with `mpirun -np N` and every
+// rank runs the same corpus; only rank 0 reports.
+#include "rubiks_cube.hpp"
+#include "facelet_kernel.hpp"
+#include "heuristic.hpp"
+#include "move_sequence.hpp"
+#include "pattern_database.hpp"
+#include "sequential_solver.hpp"
+#include "bidirectional_solver.hpp"
+#include "two_phase_solver.hpp"
+#include "transposition_table.hpp"
+#include "thread_placement.hpp"
+#ifdef HAVE_OPENMP
+#include "openmp_solver.hpp"
+#endif
+#ifdef HAVE_MPI
+#include "mpi_solver.hpp"
+#include "hybrid_solver.hpp"
+#include "mpi_protocol.hpp"
+#include <mpi.h>
+#endif
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct Options {
+    std::vector<int> depths = {4, 6, 8, 10};
+    int perDepth = 4;
+    int repetitions = 3;
+    int warmup = 1;
+    std::vector<int> threads;
+    std::vector<std::string> solvers;
+    uint64_t seed = 20240601;
+    int maxDepth = 20;
+    double timeLimit = 30.0;
+    std::string heuristic = "manhattan";
+    Metric metric = Metric::QUARTER_TURN;
+    size_t tableMegabytes = 0;
+    std::string pdbPath;
+    std::string jsonPath;
+    std::string csvPath;
+    uint64_t kernelOps = 0;  // > 0: time the facelet kernels only
+};
+
+struct Scramble {
+    int depth;
+    std::vector<std::string> moves;
+};
+
+struct Run {
+    double wallTime;
+    uint64_t nodes;
+    bool solved;
+    bool timeout;
+    std::map<int, uint64_t> iterationNodes;  // threshold -> nodes in that iteration
+};
+
+// One solver at one thread count on one depth group
+struct Group {
+    std::string solver;
+    int threads;
+    int ranks;
+    int workers;
+    int depth;
+    std::vector<Run> runs;
+
+    double meanTime = 0.0;
+    double p50 = 0.0, p95 = 0.0, p99 = 0.0, minTime = 0.0, maxTime = 0.0;
+    uint64_t nodes = 0;
+    double nodesPerSecond = 0.0;
+    int solved = 0;
+    int timeouts = 0;
+    double speedup = NAN;         // sequential mean / this mean
+    double strongEfficiency = NAN; // speedup / workers
+    double throughputEfficiency = NAN; // node rate / (workers * sequential node rate)
+    std::map<int, double> meanIterationNodes;
+};
+
+std::vector<int> parseIntList(const std::string& text) {
+    std::vector<int> values;
+    std::stringstream ss(text);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        if (!item.empty()) values.push_back(std::stoi(item));
+    }
+    return values;
+}
+
+std::vector<std::string> parseList(const std::string& text) {
+    std::vector<std::string> values;
+    std::stringstream ss(text);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        if (!item.empty()) values.push_back(item);
+    }
+    return values;
+}
+
+void printUsage() {
+    std::cout << "Usage: rubiks_bench [options]\n"
+              << "  --depths 4,6,8,10    scramble lengths, one group each\n"
+              << "  --per-depth N        scrambles per depth (default 4)\n"
+              << "  --reps N             repetitions of every solve (default 3)\n"
+              << "  --warmup N           unmeasured solves per configuration (default 1)\n"
+              << "  --threads 1,2,4      thread counts for openmp and hybrid\n"
+              << "  --solvers a,b        sequential, openmp, mpi, hybrid, twophase,\n"
+              << "                       bidirectional\n"
+              << "  --seed N             corpus seed (default 20240601)\n"
+              << "  --max-depth N        search depth limit (default 20)\n"
+              << "  --time-limit S       per-solve budget in seconds (default 30)\n"
+              << "  --heuristic NAME     manhattan (default) or pdb\n"
+              << "  --pdb FILE           pattern database for --heuristic pdb\n"
+              << "  --metric qtm|htm     move metric of the IDA* solvers (default qtm)\n"
+              << "  --tt-mb N            transposition table of N MiB per solver (default off)\n"
+              << "  --json FILE          write results as JSON\n"
+              << "  --csv FILE           write results as CSV\n"
+              << "  --kernel-ops N       only time the facelet kernels, N calls each\n";
+}
+
+bool parseOptions(int argc, char* argv[], Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h") {
+            printUsage();
+            return false;
+        }
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for " << arg << std::endl;
+            return false;
+        }
+        std::string value = argv[++i];
+        if (arg == "--depths") options.depths = parseIntList(value);
+        else if (arg == "--per-depth") options.perDepth = std::stoi(value);
+        else if (arg == "--reps") options.repetitions = std::stoi(value);
+        else if (arg == "--warmup") options.warmup = std::stoi(value);
+        else if (arg == "--threads") options.threads = parseIntList(value);
+        else if (arg == "--solvers") options.solvers = parseList(value);
+        else if (arg == "--seed") options.seed = std::stoull(value);
+        else if (arg == "--max-depth") options.maxDepth = std::stoi(value);
+        else if (arg == "--time-limit") options.timeLimit = std::stod(value);
+        else if (arg == "--heuristic") options.heuristic = value;
+        else if (arg == "--pdb") options.pdbPath = value;
+        else if (arg == "--metric") {
+            if (!parseMetric(value, options.metric)) {
+                std::cerr << "Unknown metric " << value << std::endl;
+                return false;
+            }
+        }
+        else if (arg == "--tt-mb") options.tableMegabytes = std::stoull(value);
+        else if (arg == "--json") options.jsonPath = value;
+        else if (arg == "--csv") options.csvPath = value;
+        else if (arg == "--kernel-ops") options.kernelOps = std::stoull(value);
+        else {
+            std::cerr << "Unknown option " << arg << std::endl;
+            printUsage();
+            return false;
+        }
+    }
+    return true;
+}
+
+// Nanoseconds per call of each facelet kernel the CPU supports. The moves
+// come from a fixed seeded stream and every result feeds the next call, so
+// nothing is optimised away.
+void runKernelBench(uint64_t ops) {
+    std::vector<Move> moves(4096);
+    std::mt19937_64 rng(1);
+    for (Move& move : moves) move = static_cast<Move>(rng() % NUM_MOVES);
+
+    using Clock = std::chrono::steady_clock;
+    auto perCall = [&](Clock::time_point start) {
+        return std::chrono::duration<double, std::nano>(Clock::now() - start).count() / ops;
+    };
+
+    FaceletKernel::Kind best = FaceletKernel::active();
+    std::cout << std::left << std::setw(10) << "Kernel" << std::right << std::setw(12) << "move ns"
+              << std::setw(14) << "isSolved ns" << std::setw(15) << "heuristic ns" << std::endl;
+    double scalarMove = 0.0;
+    for (auto kind : {FaceletKernel::Kind::SCALAR, FaceletKernel::Kind::AVX2, FaceletKernel::Kind::AVX512}) {
+        if (!FaceletKernel::select(kind)) {
+            std::cout << std::left << std::setw(10) << FaceletKernel::name(kind) << "not supported" << std::endl;
+            continue;
+        }
+        RubiksCube cube;
+        auto start = Clock::now();
+        for (uint64_t i = 0; i < ops; ++i) cube.applyMove(moves[i & 4095]);
+        double move = perCall(start);
+
+        uint64_t sink = 0;
+        start = Clock::now();
+        for (uint64_t i = 0; i < ops; ++i) {
+            sink += cube.isSolved();
+            cube.applyMove(moves[(i + sink) & 4095]);
+        }
+        double solved = perCall(start) - move;
+        start = Clock::now();
+        for (uint64_t i = 0; i < ops; ++i) {
+            sink += cube.getManhattanDistance();
+            cube.applyMove(moves[(i + sink) & 4095]);
+        }
+        double heuristic = perCall(start) - move;
+        if (kind == FaceletKernel::Kind::SCALAR) scalarMove = move;
+
+        std::cout << std::left << std::setw(10) << FaceletKernel::name(kind) << std::right << std::fixed
+                  << std::setprecision(2) << std::setw(12) << move << std::setw(14) << solved
+                  << std::setw(15) << heuristic;
+        if (scalarMove > 0.0 && kind != FaceletKernel::Kind::SCALAR) {
+            std::cout << "   (moves " << std::setprecision(1) << scalarMove / move << "x scalar)";
+        }
+        std::cout << " [" << (sink & 1) << "]" << std::endl;
+    }
+    FaceletKernel::select(best);
+}
+
+// Random quarter turns, never two in a row on the same axis. These are
+// canonical quarter-turn sequences, so the IDA* solvers solve a scramble of
+// length d in at most d moves; the rule is kept so results stay comparable
+// across versions. Depends only on the seed and the depth.
+std::vector<Scramble> buildCorpus(const Options& options) {
+    static const char* FACES[6] = {"U", "D", "F", "B", "L", "R"};
+    static const char* TURNS[2] = {"", "'"};
+
+    std::vector<Scramble> corpus;
+    for (int depth : options.depths) {
+        std::mt19937_64 rng(options.seed ^ (static_cast<uint64_t>(depth) * 0x9E3779B97F4A7C15ULL));
+        std::uniform_int_distribution<int> faceDist(0, 5);
+        std::uniform_int_distribution<int> turnDist(0, 1);
+        for (int n = 0; n < options.perDepth; ++n) {
+            Scramble scramble{depth, {}};
+            int last = -1;
+            while (static_cast<int>(scramble.moves.size()) < depth) {
+                int face = faceDist(rng);
+                if (last >= 0 && face / 2 == last / 2) continue;
+                scramble.moves.push_back(std::string(FACES[face]) + TURNS[turnDist(rng)]);
+                last = face;
+            }
+            corpus.push_back(scramble);
+        }
+    }
+    return corpus;
+}
+
+std::unique_ptr<Solver> makeSolver(const std::string& name, int threads) {
+    if (name == "sequential") return std::make_unique<SequentialSolver>();
+    if (name == "twophase") return std::make_unique<TwoPhaseSolver>();
+    if (name == "bidirectional") return std::make_unique<BidirectionalSolver>();
+#ifdef HAVE_OPENMP
+    if (name == "openmp") return std::make_unique<OpenMPSolver>(threads);
+#endif
+#ifdef HAVE_MPI
+    if (name == "mpi") return std::make_unique<MPISolver>();
+    if (name == "hybrid") return std::make_unique<HybridSolver>(threads);
+#endif
+    (void)threads;
+    return nullptr;
+}
+
+bool isCollective(const std::string& name) {
+    return name == "mpi" || name == "hybrid";
+}
+
+bool isThreaded(const std::string& name) {
+    return name == "openmp" || name == "hybrid";
+}
+
+Run runOnce(Solver& solver, const Scramble& scramble, int maxDepth, bool record) {
+    RubiksCube cube;
+    cube.applyMoves(scramble.moves);
+
+    // Progress reports carry the node count at the start of each iteration
+    std::vector<SolveProgress> reports;
+    if (record) {
+        solver.setProgressCallback([&](const SolveProgress& p) { reports.push_back(p); });
+    } else {
+        solver.setProgressCallback(nullptr);
+    }
+
+    // Every run starts from an empty table, so repetitions measure the same work
+    if (solver.getTranspositionTable()) solver.getTranspositionTable()->clear();
+
+    auto start = std::chrono::steady_clock::now();
+    auto solution = solver.solve(cube, maxDepth);
+    double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    Run run;
+    run.wallTime = wall;
+    run.nodes = solver.getNodesExplored();
+    run.timeout = solution.empty() && solver.wasStopped();
+    cube.applyMoves(solution);
+    run.solved = cube.isSolved() && !run.timeout;
+    for (size_t i = 0; i < reports.size(); ++i) {
+        uint64_t end = i + 1 < reports.size() ? reports[i + 1].nodes : run.nodes;
+        run.iterationNodes[reports[i].threshold] = end >= reports[i].nodes ? end - reports[i].nodes : 0;
+    }
+    return run;
+}
+
+// Nearest-rank percentile of sorted values
+double percentile(const std::vector<double>& sorted, double p) {
+    if (sorted.empty()) return 0.0;
+    size_t rank = static_cast<size_t>(std::ceil(p / 100.0 * sorted.size()));
+    return sorted[std::min(sorted.size(), std::max<size_t>(rank, 1)) - 1];
+}
+
+void summarize(Group& group) {
+    std::vector<double> times;
+    double total = 0.0;
+    std::map<int, double> iterationSums;
+    for (const auto& run : group.runs) {
+        times.push_back(run.wallTime);
+        total += run.wallTime;
+        group.nodes += run.nodes;
+        if (run.solved) group.solved++;
+        if (run.timeout) group.timeouts++;
+        for (const auto& entry : run.iterationNodes) iterationSums[entry.first] += entry.second;
+    }
+    std::sort(times.begin(), times.end());
+    if (times.empty()) return;
+
+    group.meanTime = total / times.size();
+    group.p50 = percentile(times, 50);
+    group.p95 = percentile(times, 95);
+    group.p99 = percentile(times, 99);
+    group.minTime = times.front();
+    group.maxTime = times.back();
+    group.nodesPerSecond = total > 0.0 ? group.nodes / total : 0.0;
+    for (const auto& entry : iterationSums) {
+        group.meanIterationNodes[entry.first] = entry.second / group.runs.size();
+    }
+}
+
+// Baseline: the sequential solver on the same depth group. Strong scaling
+// compares time on the same corpus; throughput efficiency compares node
+// rates, i.e. whether p workers get through p times as much search per
+// second. The corpus does not grow with the workers, so this is not weak
+// scaling.
+// Two-phase is a different algorithm and gets no scaling figures.
+void computeScaling(std::vector<Group>& groups) {
+    std::map<int, const Group*> baseline;
+    for (const auto& group : groups) {
+        if (group.solver == "sequential") baseline[group.depth] = &group;
+    }
+    for (auto& group : groups) {
+        auto it = baseline.find(group.depth);
+        if (it == baseline.end() || group.solver == "twophase") continue;
+        const Group& base = *it->second;
+        if (group.meanTime > 0.0) {
+            group.speedup = base.meanTime / group.meanTime;
+            group.strongEfficiency = group.speedup / group.workers;
+        }
+        if (base.nodesPerSecond > 0.0) {
+            group.throughputEfficiency = group.nodesPerSecond / (group.workers * base.nodesPerSecond);
+        }
+    }
+}
+
+std::string jsonNumber(double value) {
+    if (std::isnan(value)) return "null";
+    std::stringstream ss;
+    ss << std::setprecision(9) << value;
+    return ss.str();
+}
+
+std::string csvNumber(double value) {
+    return std::isnan(value) ? "" : jsonNumber(value);
+}
+
+void writeJSON(const std::string& path, const Options& options, const std::vector<Scramble>& corpus,
+               const std::vector<Group>& groups, int ranks) {
+    std::ofstream out(path);
+    out << "{\n  \"build\": {\"compiler\": \"" << __VERSION__ << "\""
+#ifdef HAVE_OPENMP
+        << ", \"openmp\": true"
+#else
+        << ", \"openmp\": false"
+#endif
+#ifdef HAVE_MPI
+        << ", \"mpi\": true"
+#else
+        << ", \"mpi\": false"
+#endif
+        << ", \"hardwareThreads\": " << std::thread::hardware_concurrency()
+        << ", \"rankCpus\": " << ThreadPlacement::get().cpus().size()
+        << ", \"ranks\": " << ranks << "},\n";
+    out << "  \"config\": {\"seed\": " << options.seed << ", \"perDepth\": " << options.perDepth
+        << ", \"repetitions\": " << options.repetitions << ", \"warmup\": " << options.warmup
+        << ", \"maxDepth\": " << options.maxDepth << ", \"timeLimit\": " << options.timeLimit
+        << ", \"heuristic\": \"" << options.heuristic << "\""
+        << ", \"metric\": \"" << metricName(options.metric) << "\""
+        << ", \"ttMegabytes\": " << options.tableMegabytes << "},\n";
+
+    out << "  \"corpus\": [";
+    for (size_t i = 0; i < corpus.size(); ++i) {
+        out << (i ? ", " : "") << "{\"depth\": " << corpus[i].depth << ", \"moves\": \"";
+        for (size_t j = 0; j < corpus[i].moves.size(); ++j) {
+            out << (j ? " " : "") << corpus[i].moves[j];
+        }
+        out << "\"}";
+    }
+    out << "],\n";
+
+    out << "  \"results\": [\n";
+    for (size_t i = 0; i < groups.size(); ++i) {
+        const Group& g = groups[i];
+        out << "    {\"solver\": \"" << g.solver << "\", \"threads\": " << g.threads
+            << ", \"ranks\": " << g.ranks << ", \"workers\": " << g.workers
+            << ", \"depth\": " << g.depth << ", \"runs\": " << g.runs.size()
+            << ", \"solved\": " << g.solved << ", \"timeouts\": " << g.timeouts
+            << ", \"meanTime\": " << jsonNumber(g.meanTime)
+            << ", \"p50\": " << jsonNumber(g.p50) << ", \"p95\": " << jsonNumber(g.p95)
+            << ", \"p99\": " << jsonNumber(g.p99) << ", \"minTime\": " << jsonNumber(g.minTime)
+            << ", \"maxTime\": " << jsonNumber(g.maxTime) << ", \"nodes\": " << g.nodes
+            << ", \"nodesPerSecond\": " << jsonNumber(g.nodesPerSecond)
+            << ", \"speedup\": " << jsonNumber(g.speedup)
+            << ", \"strongEfficiency\": " << jsonNumber(g.strongEfficiency)
+            << ", \"throughputEfficiency\": " << jsonNumber(g.throughputEfficiency)
+            << ", \"iterationNodes\": [";
+        bool first = true;
+        for (const auto& entry : g.meanIterationNodes) {
+            out << (first ? "" : ", ") << "{\"threshold\": " << entry.first
+                << ", \"nodes\": " << jsonNumber(entry.second) << "}";
+            first = false;
+        }
+        out << "]}" << (i + 1 < groups.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+}
+
+void writeCSV(const std::string& path, const std::vector<Group>& groups) {
+    std::ofstream out(path);
+    out << "solver,threads,ranks,workers,depth,runs,solved,timeouts,mean_s,p50_s,p95_s,p99_s,"
+           "min_s,max_s,nodes,nodes_per_s,speedup,strong_eff,throughput_eff,iteration_nodes\n";
+    for (const auto& g : groups) {
+        out << g.solver << "," << g.threads << "," << g.ranks << "," << g.workers << ","
+            << g.depth << "," << g.runs.size() << "," << g.solved << "," << g.timeouts << ","
+            << csvNumber(g.meanTime) << "," << csvNumber(g.p50) << "," << csvNumber(g.p95) << ","
+            << csvNumber(g.p99) << "," << csvNumber(g.minTime) << "," << csvNumber(g.maxTime) << ","
+            << g.nodes << "," << csvNumber(g.nodesPerSecond) << "," << csvNumber(g.speedup) << ","
+            << csvNumber(g.strongEfficiency) << "," << csvNumber(g.throughputEfficiency) << ",";
+        bool first = true;
+        for (const auto& entry : g.meanIterationNodes) {
+            out << (first ? "" : ";") << entry.first << ":" << std::llround(entry.second);
+            first = false;
+        }
+        out << "\n";
+    }
+}
+
+void printTable(const std::vector<Group>& groups) {
+    std::cout << "\n" << std::left << std::setw(15) << "Solver" << std::setw(8) << "Workers"
+              << std::setw(7) << "Depth" << std::setw(8) << "Solved" << std::setw(11) << "Mean(s)"
+              << std::setw(11) << "p50(s)" << std::setw(11) << "p95(s)" << std::setw(11) << "p99(s)"
+              << std::setw(13) << "Nodes/s" << std::setw(9) << "Speedup" << std::setw(8) << "Strong"
+              << "Thrpt" << std::endl;
+    std::cout << std::string(121, '-') << std::endl;
+    auto fixed = [](double value, int precision) {
+        if (std::isnan(value)) return std::string("-");
+        std::stringstream ss;
+        ss << std::fixed << std::setprecision(precision) << value;
+        return ss.str();
+    };
+    for (const auto& g : groups) {
+        std::stringstream solved;
+        solved << g.solved << "/" << g.runs.size();
+        std::cout << std::left << std::setw(15) << g.solver << std::setw(8) << g.workers
+                  << std::setw(7) << g.depth << std::setw(8) << solved.str()
+                  << std::setw(11) << fixed(g.meanTime, 5) << std::setw(11) << fixed(g.p50, 5)
+                  << std::setw(11) << fixed(g.p95, 5) << std::setw(11) << fixed(g.p99, 5)
+                  << std::setw(13) << fixed(g.nodesPerSecond, 0) << std::setw(9) << fixed(g.speedup, 2)
+                  << std::setw(8) << fixed(g.strongEfficiency, 2) << fixed(g.throughputEfficiency, 2)
+                  << std::endl;
+    }
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int rank = 0;
+    int ranks = 1;
+#ifdef HAVE_MPI
+    MPISolver::Initialize(&argc, &argv);
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &ranks);
+#endif
+    // Ranks on one node split its cores, as the server's do
+    int localRank = 0;
+    int localRanks = 1;
+#ifdef HAVE_MPI
+    nodeLocalRank(localRank, localRanks);
+#endif
+    ThreadPlacement::get().configure(localRank, localRanks, ThreadBinding::CLOSE);
+
+    Options options;
+    bool ok;
+    try {
+        ok = parseOptions(argc, argv, options);
+    } catch (const std::exception& e) {
+        if (rank == 0) std::cerr << "Invalid option value: " << e.what() << std::endl;
+        ok = false;
+    }
+    if (!ok) {
+#ifdef HAVE_MPI
+        MPISolver::Finalize();
+#endif
+        return 1;
+    }
+
+    if (options.kernelOps > 0) {
+        if (rank == 0) runKernelBench(options.kernelOps);
+#ifdef HAVE_MPI
+        MPISolver::Finalize();
+#endif
+        return 0;
+    }
+
+    if (options.solvers.empty()) {
+        options.solvers = {"sequential", "twophase"};
+#ifdef HAVE_OPENMP
+        options.solvers.push_back("openmp");
+#endif
+#ifdef HAVE_MPI
+        options.solvers.push_back("mpi");
+        options.solvers.push_back("hybrid");
+#endif
+    }
+    if (options.threads.empty()) {
+        int cpus = ThreadPlacement::get().threads();
+        for (int t = 1; t < cpus; t *= 2) options.threads.push_back(t);
+        options.threads.push_back(cpus);
+    }
+    if (!options.pdbPath.empty()) {
+        try {
+            setDefaultPatternDatabase(PatternDatabase::load(options.pdbPath));
+        } catch (const std::exception& e) {
+            if (rank == 0) std::cerr << "Failed to load pattern database: " << e.what() << std::endl;
+        }
+    }
+    auto heuristic = createHeuristic(options.heuristic);
+
+    std::vector<Scramble> corpus = buildCorpus(options);
+    if (rank == 0) {
+        std::cout << "==================================" << std::endl;
+        std::cout << "Rubik's Cube Solver Benchmark" << std::endl;
+        std::cout << "==================================" << std::endl;
+        std::cout << "Corpus: " << corpus.size() << " scrambles (seed " << options.seed << "), "
+                  << options.repetitions << " repetitions" << std::endl;
+        std::cout << "Heuristic: " << heuristic->getName() << ", metric: " << metricName(options.metric)
+                  << ", ranks: " << ranks << std::endl;
+        if (options.tableMegabytes > 0) {
+            std::cout << "Transposition table: " << options.tableMegabytes << " MiB per solver" << std::endl;
+        }
+    }
+
+    std::vector<Group> groups;
+    for (const auto& name : options.solvers) {
+        std::vector<int> threadCounts = isThreaded(name) ? options.threads : std::vector<int>{1};
+        for (int threads : threadCounts) {
+            auto solver = makeSolver(name, threads);
+            if (!solver) {
+                if (rank == 0) std::cerr << "Solver not available in this build: " << name << std::endl;
+                break;
+            }
+            // Only the collective solvers involve the other ranks
+            bool collective = isCollective(name);
+            if (!collective && rank != 0) continue;
+
+            solver->setHeuristic(heuristic);
+            solver->setMetric(options.metric);
+            if (options.tableMegabytes > 0) {
+                solver->setTranspositionTable(
+                    std::make_shared<TranspositionTable>(options.tableMegabytes << 20));
+            }
+            solver->setTimeLimit(options.timeLimit);
+            int groupRanks = collective ? ranks : 1;
+            if (rank == 0) {
+                std::cout << "\nRunning " << solver->getName() << " (" << threads << " threads, "
+                          << groupRanks << " ranks)..." << std::endl;
+            }
+
+            for (int w = 0; w < options.warmup && !corpus.empty(); ++w) {
+                runOnce(*solver, corpus.front(), options.maxDepth, false);
+            }
+
+            std::map<int, size_t> groupIndex;
+            for (const auto& scramble : corpus) {
+                if (!groupIndex.count(scramble.depth)) {
+                    groupIndex[scramble.depth] = groups.size();
+                    groups.push_back(Group{name, threads, groupRanks, threads * groupRanks,
+                                           scramble.depth, {}});
+                }
+                for (int r = 0; r < options.repetitions; ++r) {
+                    groups[groupIndex[scramble.depth]].runs.push_back(
+                        runOnce(*solver, scramble, options.maxDepth, rank == 0));
+                }
+            }
+        }
+    }
+
+    if (rank == 0) {
+        for (auto& group : groups) summarize(group);
+        computeScaling(groups);
+        printTable(groups);
+        if (!options.jsonPath.empty()) {
+            writeJSON(options.jsonPath, options, corpus, groups, ranks);
+            std::cout << "\nWrote " << options.jsonPath << std::endl;
+        }
+        if (!options.csvPath.empty()) {
+            writeCSV(options.csvPath, groups);
+            std::cout << "Wrote " << options.csvPath << std::endl;
+        }
+    }
+
+#ifdef HAVE_MPI
+    MPISolver::Finalize();
+#endif
+    return 0;
+}
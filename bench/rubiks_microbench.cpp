@@ -0,0 +1,528 @@
+// bench/rubiks_microbench.cpp - Timings of the cube primitives and search kernels
+//
+// Each primitive (facelet and cubie moves, isSolved, the Manhattan estimate,
+// hash, string and JSON conversion, the search heuristic) runs in a loop
+// sized to --min-time, --reps times over; the fastest repetition gives its
+// ns/op and throughput. Every search solver then solves a fixed, seeded set
+// of scrambles of --search-depth quarter turns, reported per node searched.
+// Heap allocations are counted by replacing the global operator new, and
+// reported per op.
+//
+// --csv writes the results, and --baseline compares a run against such a
+// file: any benchmark slower than its baseline by more than --threshold
+// percent, or allocating more, fails the run (exit status 1).
+#include "rubiks_cube.hpp"
+#include "cubie_cube.hpp"
+#include "facelet_kernel.hpp"
+#include "heuristic.hpp"
+#include "json.hpp"
+#include "pattern_database.hpp"
+#include "scrambler.hpp"
+#include "sequential_solver.hpp"
+#include "bidirectional_solver.hpp"
+#include "two_phase_solver.hpp"
+#include "frontier_table.hpp"
+#include "thread_placement.hpp"
+#ifdef HAVE_OPENMP
+#include "openmp_solver.hpp"
+#endif
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <new>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+std::atomic<uint64_t> allocations{0};
+
+void* allocate(std::size_t size, std::size_t alignment) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    size = std::max<std::size_t>(size, 1);
+    void* block = alignment > alignof(std::max_align_t)
+        ? std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment)
+        : std::malloc(size);
+    if (!block) throw std::bad_alloc();
+    return block;
+}
+
+} // namespace
+
+// Every allocation of the process is counted: the array and nothrow forms
+// call these
+void* operator new(std::size_t size) { return allocate(size, 0); }
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    return allocate(size, static_cast<std::size_t>(alignment));
+}
+void operator delete(void* block) noexcept { std::free(block); }
+void operator delete(void* block, std::size_t) noexcept { std::free(block); }
+void operator delete(void* block, std::align_val_t) noexcept { std::free(block); }
+void operator delete(void* block, std::size_t, std::align_val_t) noexcept { std::free(block); }
+
+namespace {
+
+struct Options {
+    int repetitions = 5;
+    double minTime = 0.05;  // seconds per repetition
+    int searchDepth = 8;
+    int searchPositions = 4;
+    uint64_t seed = 20240601;
+    std::vector<std::string> solvers;
+    std::string heuristic = "manhattan";
+    std::string pdbPath;
+    std::string filter;
+    std::string csvPath;
+    std::string jsonPath;
+    std::string baselinePath;
+    double threshold = 10.0;  // percent
+};
+
+struct Result {
+    std::string name;
+    std::string unit;      // "op", or "node" for the searches
+    uint64_t ops = 0;      // per repetition
+    double nsPerOp = 0.0;  // fastest repetition
+    double allocsPerOp = 0.0;
+
+    double opsPerSecond() const { return nsPerOp > 0.0 ? 1e9 / nsPerOp : 0.0; }
+};
+
+std::vector<std::string> parseList(const std::string& text) {
+    std::vector<std::string> values;
+    std::stringstream ss(text);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        if (!item.empty()) values.push_back(item);
+    }
+    return values;
+}
+
+void printUsage() {
+    std::cout << "Usage: rubiks_microbench [options]\n"
+              << "  --reps N             repetitions, the fastest counts (default 5)\n"
+              << "  --min-time S         seconds per repetition of a primitive (default 0.05)\n"
+              << "  --filter TEXT        only benchmarks whose name contains TEXT\n"
+              << "  --search-depth N     scramble length of the search benchmarks (default 8)\n"
+              << "  --search-positions N scrambles per search repetition (default 4)\n"
+              << "  --solvers a,b        sequential, openmp, bidirectional, twophase\n"
+              << "  --seed N             scramble seed (default 20240601)\n"
+              << "  --heuristic NAME     manhattan (default) or pdb\n"
+              << "  --pdb FILE           pattern database for --heuristic pdb\n"
+              << "  --csv FILE           write results as CSV (the baseline format)\n"
+              << "  --json FILE          write results as JSON\n"
+              << "  --baseline FILE      compare against a CSV from an earlier run\n"
+              << "  --threshold PCT      slowdown that fails --baseline (default 10)\n";
+}
+
+bool parseOptions(int argc, char* argv[], Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h") {
+            printUsage();
+            return false;
+        }
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for " << arg << std::endl;
+            return false;
+        }
+        std::string value = argv[++i];
+        if (arg == "--reps") options.repetitions = std::max(1, std::stoi(value));
+        else if (arg == "--min-time") options.minTime = std::stod(value);
+        else if (arg == "--filter") options.filter = value;
+        else if (arg == "--search-depth") options.searchDepth = std::stoi(value);
+        else if (arg == "--search-positions") options.searchPositions = std::max(1, std::stoi(value));
+        else if (arg == "--solvers") options.solvers = parseList(value);
+        else if (arg == "--seed") options.seed = std::stoull(value);
+        else if (arg == "--heuristic") options.heuristic = value;
+        else if (arg == "--pdb") options.pdbPath = value;
+        else if (arg == "--csv") options.csvPath = value;
+        else if (arg == "--json") options.jsonPath = value;
+        else if (arg == "--baseline") options.baselinePath = value;
+        else if (arg == "--threshold") options.threshold = std::stod(value);
+        else {
+            std::cerr << "Unknown option " << arg << std::endl;
+            printUsage();
+            return false;
+        }
+    }
+    return true;
+}
+
+// Makes the compiler produce value (and everything it was computed from)
+// without costing a store per call
+template <typename T>
+inline void keep(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r"(&value) : "memory");
+#else
+    static const void* volatile escape;
+    escape = &value;
+#endif
+}
+
+using Clock = std::chrono::steady_clock;
+
+double secondsOf(const std::function<void(uint64_t)>& body, uint64_t ops) {
+    auto start = Clock::now();
+    body(ops);
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// body(n) runs the primitive n times. The count doubles until a run takes
+// --min-time, then every repetition runs that many.
+Result measure(const std::string& name, const Options& options, const std::function<void(uint64_t)>& body) {
+    uint64_t ops = 256;
+    while (secondsOf(body, ops) < options.minTime && ops < (uint64_t{1} << 34)) ops *= 2;
+
+    Result result{name, "op", ops, 0.0, 0.0};
+    double best = INFINITY;
+    uint64_t allocated = allocations.load(std::memory_order_relaxed);
+    for (int r = 0; r < options.repetitions; ++r) best = std::min(best, secondsOf(body, ops));
+    allocated = allocations.load(std::memory_order_relaxed) - allocated;
+    result.nsPerOp = best * 1e9 / ops;
+    result.allocsPerOp = static_cast<double>(allocated) / (static_cast<double>(ops) * options.repetitions);
+    return result;
+}
+
+bool selected(const Options& options, const std::string& name) {
+    return options.filter.empty() || name.find(options.filter) != std::string::npos;
+}
+
+// Inputs are fixed by the seed: uniform random states, for the primitives
+// whose cost could depend on the position, and a move stream
+void runPrimitives(const Options& options, std::vector<Result>& results) {
+    constexpr size_t INPUTS = 64;
+    Scrambler scrambler(options.seed);
+    std::vector<RubiksCube> cubes;
+    std::vector<CubieCube> cubies;
+    std::vector<std::string> strings;
+    for (size_t i = 0; i < INPUTS; ++i) {
+        cubies.push_back(scrambler.randomState());
+        cubes.push_back(cubies.back().toFacelets());
+        strings.push_back(cubes.back().toString());
+    }
+    std::vector<Move> moves(4096);
+    for (Move& move : moves) move = static_cast<Move>(scrambler.uniform(NUM_MOVES));
+    auto heuristic = createHeuristic(options.heuristic);
+
+    std::vector<std::pair<std::string, std::function<void(uint64_t)>>> benchmarks;
+    benchmarks.emplace_back("cube.applyMove", [&](uint64_t n) {
+        RubiksCube cube;
+        for (uint64_t i = 0; i < n; ++i) cube.applyMove(moves[i & 4095]);
+        keep(cube);
+    });
+    benchmarks.emplace_back("cube.isSolved", [&](uint64_t n) {
+        for (uint64_t i = 0; i < n; ++i) {
+            bool solved = cubes[i % INPUTS].isSolved();
+            keep(solved);
+        }
+    });
+    benchmarks.emplace_back("cube.getManhattanDistance", [&](uint64_t n) {
+        for (uint64_t i = 0; i < n; ++i) {
+            int distance = cubes[i % INPUTS].getManhattanDistance();
+            keep(distance);
+        }
+    });
+    benchmarks.emplace_back("cube.hash", [&](uint64_t n) {
+        for (uint64_t i = 0; i < n; ++i) {
+            size_t hash = cubes[i % INPUTS].hash();
+            keep(hash);
+        }
+    });
+    benchmarks.emplace_back("cube.toString", [&](uint64_t n) {
+        for (uint64_t i = 0; i < n; ++i) {
+            std::string text = cubes[i % INPUTS].toString();
+            keep(text);
+        }
+    });
+    benchmarks.emplace_back("cube.fromString", [&](uint64_t n) {
+        RubiksCube cube;
+        for (uint64_t i = 0; i < n; ++i) {
+            cube.fromString(strings[i % INPUTS]);
+            keep(cube);
+        }
+    });
+    benchmarks.emplace_back("cube.toJSON", [&](uint64_t n) {
+        for (uint64_t i = 0; i < n; ++i) {
+            std::string json = cubes[i % INPUTS].toJSON();
+            keep(json);
+        }
+    });
+    // The server's path: one buffer, reused
+    benchmarks.emplace_back("cube.writeJSON", [&](uint64_t n) {
+        std::string buffer;
+        for (uint64_t i = 0; i < n; ++i) {
+            buffer.clear();
+            JSONWriter json(buffer);
+            json.beginObject();
+            cubes[i % INPUTS].writeJSON(json);
+            json.endObject();
+            keep(buffer);
+        }
+    });
+    benchmarks.emplace_back("cubie.applyMove", [&](uint64_t n) {
+        CubieCube cube;
+        for (uint64_t i = 0; i < n; ++i) cube.applyMove(moves[i & 4095]);
+        keep(cube);
+    });
+    benchmarks.emplace_back("cubie.fingerprint", [&](uint64_t n) {
+        for (uint64_t i = 0; i < n; ++i) {
+            uint64_t key = cubies[i % INPUTS].fingerprint();
+            keep(key);
+        }
+    });
+    benchmarks.emplace_back("cubie.fromFacelets", [&](uint64_t n) {
+        for (uint64_t i = 0; i < n; ++i) {
+            CubieCube cube = CubieCube::fromFacelets(cubes[i % INPUTS]);
+            keep(cube);
+        }
+    });
+    benchmarks.emplace_back("heuristic." + options.heuristic, [&](uint64_t n) {
+        for (uint64_t i = 0; i < n; ++i) {
+            int estimate = heuristic->estimate(cubies[i % INPUTS]);
+            keep(estimate);
+        }
+    });
+
+    for (const auto& benchmark : benchmarks) {
+        if (!selected(options, benchmark.first)) continue;
+        results.push_back(measure(benchmark.first, options, benchmark.second));
+    }
+}
+
+std::unique_ptr<Solver> makeSolver(const std::string& name) {
+    if (name == "sequential") return std::make_unique<SequentialSolver>();
+    if (name == "twophase") return std::make_unique<TwoPhaseSolver>();
+    if (name == "bidirectional") return std::make_unique<BidirectionalSolver>();
+#ifdef HAVE_OPENMP
+    if (name == "openmp") return std::make_unique<OpenMPSolver>(ThreadPlacement::get().threads());
+#endif
+    return nullptr;
+}
+
+// The same scrambles every repetition, so the node counts repeat and only
+// the time per node can drift. One unmeasured pass first builds whatever
+// the solver sets up once (the frontier table, two-phase's move tables).
+bool runSearches(const Options& options, std::vector<Result>& results) {
+    Scrambler scrambler(Scrambler::streamSeed(options.seed, 1));
+    std::vector<RubiksCube> scrambles(options.searchPositions);
+    for (RubiksCube& cube : scrambles) {
+        for (Move move : scrambler.randomMoves(options.searchDepth, true)) cube.applyMove(move);
+    }
+    auto heuristic = createHeuristic(options.heuristic);
+
+    for (const std::string& name : options.solvers) {
+        if (!selected(options, "search." + name)) continue;
+        auto solver = makeSolver(name);
+        if (!solver) {
+            std::cerr << "Solver not available in this build: " << name << std::endl;
+            return false;
+        }
+        solver->setHeuristic(heuristic);
+        for (RubiksCube cube : scrambles) solver->solve(cube, std::max(options.searchDepth, 22));
+
+        Result result{"search." + name, "node", 0, INFINITY, 0.0};
+        uint64_t allocated = allocations.load(std::memory_order_relaxed);
+        uint64_t totalNodes = 0;
+        for (int r = 0; r < options.repetitions; ++r) {
+            uint64_t nodes = 0;
+            auto start = Clock::now();
+            for (RubiksCube cube : scrambles) {
+                solver->solve(cube, std::max(options.searchDepth, 22));
+                nodes += solver->getNodesExplored();
+            }
+            double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+            result.ops = nodes;
+            totalNodes += nodes;
+            if (nodes > 0) result.nsPerOp = std::min(result.nsPerOp, seconds * 1e9 / nodes);
+        }
+        allocated = allocations.load(std::memory_order_relaxed) - allocated;
+        if (std::isinf(result.nsPerOp)) result.nsPerOp = 0.0;
+        result.allocsPerOp = totalNodes > 0 ? static_cast<double>(allocated) / totalNodes : 0.0;
+        results.push_back(result);
+    }
+    return true;
+}
+
+std::string jsonNumber(double value) {
+    if (std::isnan(value) || std::isinf(value)) return "null";
+    std::stringstream ss;
+    ss << std::setprecision(9) << value;
+    return ss.str();
+}
+
+void writeCSV(const std::string& path, const std::vector<Result>& results) {
+    std::ofstream out(path);
+    out << "benchmark,unit,ops,ns_per_op,ops_per_s,allocs_per_op\n";
+    for (const auto& r : results) {
+        out << r.name << "," << r.unit << "," << r.ops << "," << jsonNumber(r.nsPerOp) << ","
+            << jsonNumber(r.opsPerSecond()) << "," << jsonNumber(r.allocsPerOp) << "\n";
+    }
+}
+
+void writeJSON(const std::string& path, const Options& options, const std::vector<Result>& results) {
+    std::ofstream out(path);
+    out << "{\n  \"build\": {\"compiler\": \"" << __VERSION__ << "\""
+        << ", \"kernel\": \"" << FaceletKernel::name(FaceletKernel::active()) << "\""
+        << ", \"hardwareThreads\": " << std::thread::hardware_concurrency() << "},\n";
+    out << "  \"config\": {\"seed\": " << options.seed << ", \"repetitions\": " << options.repetitions
+        << ", \"minTime\": " << options.minTime << ", \"searchDepth\": " << options.searchDepth
+        << ", \"searchPositions\": " << options.searchPositions
+        << ", \"heuristic\": \"" << options.heuristic << "\"},\n";
+    out << "  \"results\": [\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const Result& r = results[i];
+        out << "    {\"benchmark\": \"" << r.name << "\", \"unit\": \"" << r.unit << "\""
+            << ", \"ops\": " << r.ops << ", \"nsPerOp\": " << jsonNumber(r.nsPerOp)
+            << ", \"opsPerSecond\": " << jsonNumber(r.opsPerSecond())
+            << ", \"allocsPerOp\": " << jsonNumber(r.allocsPerOp) << "}"
+            << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+}
+
+// benchmark -> (ns/op, allocs/op) from a --csv file
+bool readBaseline(const std::string& path, std::map<std::string, std::pair<double, double>>& baseline) {
+    std::ifstream in(path);
+    if (!in) return false;
+    std::string line;
+    std::getline(in, line);  // header
+    while (std::getline(in, line)) {
+        std::vector<std::string> fields;
+        std::stringstream ss(line);
+        std::string field;
+        while (std::getline(ss, field, ',')) fields.push_back(field);
+        if (fields.size() < 6) continue;
+        try {
+            baseline[fields[0]] = {std::stod(fields[3]), std::stod(fields[5])};
+        } catch (const std::exception&) {
+            continue;
+        }
+    }
+    return true;
+}
+
+void printTable(const std::vector<Result>& results) {
+    std::cout << "\n" << std::left << std::setw(28) << "Benchmark" << std::right << std::setw(12) << "ns/op"
+              << std::setw(16) << "ops/s" << std::setw(12) << "allocs/op" << "  unit" << std::endl;
+    std::cout << std::string(74, '-') << std::endl;
+    for (const auto& r : results) {
+        std::cout << std::left << std::setw(28) << r.name << std::right << std::fixed
+                  << std::setprecision(2) << std::setw(12) << r.nsPerOp << std::setprecision(0)
+                  << std::setw(16) << r.opsPerSecond() << std::setprecision(3) << std::setw(12)
+                  << r.allocsPerOp << "  " << r.unit << std::endl;
+    }
+}
+
+// Slower by more than the threshold, or more allocations (beyond rounding
+// of the search averages), is a regression. Benchmarks missing from either
+// side are listed but never fail.
+bool compareBaseline(const Options& options, const std::vector<Result>& results) {
+    std::map<std::string, std::pair<double, double>> baseline;
+    if (!readBaseline(options.baselinePath, baseline)) {
+        std::cerr << "Cannot read baseline " << options.baselinePath << std::endl;
+        return false;
+    }
+    std::cout << "\nAgainst " << options.baselinePath << " (threshold " << options.threshold << "%)" << std::endl;
+    std::cout << std::left << std::setw(28) << "Benchmark" << std::right << std::setw(12) << "base ns"
+              << std::setw(12) << "ns/op" << std::setw(10) << "change" << std::setw(12) << "allocs" << std::endl;
+    std::cout << std::string(74, '-') << std::endl;
+    bool passed = true;
+    for (const auto& r : results) {
+        auto it = baseline.find(r.name);
+        std::cout << std::left << std::setw(28) << r.name << std::right << std::fixed;
+        if (it == baseline.end()) {
+            std::cout << std::setw(12) << "-" << std::setprecision(2) << std::setw(12) << r.nsPerOp
+                      << "  (not in baseline)" << std::endl;
+            continue;
+        }
+        double baseNs = it->second.first;
+        double baseAllocs = it->second.second;
+        double change = baseNs > 0.0 ? (r.nsPerOp / baseNs - 1.0) * 100.0 : 0.0;
+        bool slower = change > options.threshold;
+        bool allocates = r.allocsPerOp > baseAllocs * (1.0 + options.threshold / 100.0) + 0.01;
+        std::stringstream allocs;
+        allocs << std::fixed << std::setprecision(2) << baseAllocs << "->" << r.allocsPerOp;
+        std::cout << std::setprecision(2) << std::setw(12) << baseNs << std::setw(12) << r.nsPerOp
+                  << std::showpos << std::setprecision(1) << std::setw(9) << change << "%" << std::noshowpos
+                  << std::setw(12) << allocs.str();
+        if (slower || allocates) {
+            std::cout << "  REGRESSION";
+            passed = false;
+        }
+        std::cout << std::endl;
+        baseline.erase(it);
+    }
+    for (const auto& entry : baseline) {
+        std::cout << std::left << std::setw(28) << entry.first << "  (not run)" << std::endl;
+    }
+    std::cout << (passed ? "\nNo regressions" : "\nRegressions found") << std::endl;
+    return passed;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    ThreadPlacement::get().configure(0, 1, ThreadBinding::CLOSE);
+
+    Options options;
+    bool ok;
+    try {
+        ok = parseOptions(argc, argv, options);
+    } catch (const std::exception& e) {
+        std::cerr << "Invalid option value: " << e.what() << std::endl;
+        ok = false;
+    }
+    if (!ok) return 1;
+
+    if (options.solvers.empty()) {
+        options.solvers = {"sequential", "bidirectional", "twophase"};
+#ifdef HAVE_OPENMP
+        options.solvers.push_back("openmp");
+#endif
+    }
+    if (!options.pdbPath.empty()) {
+        try {
+            setDefaultPatternDatabase(PatternDatabase::load(options.pdbPath));
+        } catch (const std::exception& e) {
+            std::cerr << "Failed to load pattern database: " << e.what() << std::endl;
+            return 1;
+        }
+    }
+
+    std::cout << "==================================" << std::endl;
+    std::cout << "Rubik's Cube Microbenchmarks" << std::endl;
+    std::cout << "==================================" << std::endl;
+    std::cout << "Facelet kernel: " << FaceletKernel::name(FaceletKernel::active())
+              << ", best of " << options.repetitions << " repetitions" << std::endl;
+    std::cout << "Searches: " << options.searchPositions << " scrambles of " << options.searchDepth
+              << " moves (seed " << options.seed << "), heuristic " << options.heuristic << std::endl;
+
+    std::vector<Result> results;
+    runPrimitives(options, results);
+    if (!runSearches(options, results)) return 1;
+    printTable(results);
+
+    if (!options.jsonPath.empty()) {
+        writeJSON(options.jsonPath, options, results);
+        std::cout << "\nWrote " << options.jsonPath << std::endl;
+    }
+    if (!options.csvPath.empty()) {
+        writeCSV(options.csvPath, results);
+        std::cout << "Wrote " << options.csvPath << std::endl;
+    }
+    if (!options.baselinePath.empty() && !compareBaseline(options, results)) return 1;
+    return 0;
+}
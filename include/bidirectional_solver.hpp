@@ -0,0 +1,42 @@
+// include/bidirectional_solver.hpp
+#pragma once
+#include "solver.hpp"
+#include "frontier_table.hpp"
+#include "cubie_cube.hpp"
+#include "move.hpp"
+#include <memory>
+
+// Meet-in-the-middle IDA*. A FrontierTable holds every position within D
+// moves of solved with its exact distance; the forward search from the
+// scramble uses that distance inside the frontier and at least D + 1
+// outside it (or the heuristic, if larger). Forward paths therefore stop
+// about D moves short of the threshold, and once one reaches the frontier
+// the table's distances lead straight down to solved. A scramble within
+// the frontier is answered from the table without a search. Solutions are
+// optimal in the metric, like the other IDA* solvers'.
+class BidirectionalSolver : public Solver {
+public:
+    BidirectionalSolver() = default;
+    std::vector<std::string> solve(RubiksCube& cube, int maxDepth = 20) override;
+    std::string getName() const override { return "Bidirectional (IDA*)"; }
+    std::unique_ptr<Solver> clone() const override {
+        auto copy = std::make_unique<BidirectionalSolver>();
+        copySettingsTo(*copy);
+        copy->frontier_ = frontier_;
+        return copy;
+    }
+    bool canClone() const override { return true; }
+
+    // Table of the metric to meet; by default getFrontierTable() at the
+    // first solve. A table of the other metric is ignored.
+    void setFrontierTable(std::shared_ptr<const FrontierTable> table) { frontier_ = std::move(table); }
+
+private:
+    std::shared_ptr<const FrontierTable> frontier_;
+    std::vector<Move> solution_;
+    std::vector<Move> currentPath_;
+    SearchCounters counters_;
+
+    template <typename BaseHeuristic>
+    int search(const BaseHeuristic& base, const CubieCube& start, int threshold);
+};
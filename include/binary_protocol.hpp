@@ -0,0 +1,89 @@
+// include/binary_protocol.hpp
+#pragma once
+#include "cubie_cube.hpp"
+#include "move.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Frames of the binary solve port (rubiks_solver --binary-port), for
+// machine clients that would otherwise pay for HTTP and JSON on every
+// short solve.
+//
+// Both directions carry frames: a 4-byte payload length, then the payload.
+// All integers are little-endian. A client may send any number of requests
+// without waiting; the answers come back in request order, each with the
+// request's tag.
+//
+// Request payload (32 bytes):
+//    0  u8   version (1)
+//    1  u8   solver (BinarySolver)
+//    2  u8   metric: 0 quarter turn, 1 half turn
+//    3  u8   maximum depth, 0 = the solver's default
+//    4  u32  tag, echoed in the response
+//    8  u32  deadline in microseconds after the server read the frame,
+//            0 = the default (10 s)
+//   12  20   the cube in CubieCube's layout (as GET /cube?format=binary)
+//
+// Response payload (20 bytes, then one byte per move):
+//    0  u8   version (1)
+//    1  u8   status (BinaryStatus)
+//    2  u8   flags: bit 0 = answered from the solution cache
+//    3  u8   number of moves
+//    4  u32  tag
+//    8  u64  nodes searched
+//   16  u32  solve time in microseconds
+//   20  ...  the solution, one Move id (0..17, see move.hpp) per move
+constexpr uint8_t BINARY_PROTOCOL_VERSION = 1;
+constexpr size_t BINARY_REQUEST_BYTES = 32;
+constexpr size_t BINARY_RESPONSE_BYTES = 20;  // without the moves
+
+enum class BinarySolver : uint8_t { TWO_PHASE = 0, SEQUENTIAL = 1, BIDIRECTIONAL = 2, OPENMP = 3 };
+
+enum class BinaryStatus : uint8_t {
+    SOLVED = 0,       // the moves solve the cube (none for a solved cube)
+    UNSOLVED = 1,     // no solution within the maximum depth
+    TIMEOUT = 2,      // the deadline passed, or the server is shutting down
+    INVALID_CUBE = 3, // not a cube that turns can reach
+    UNSUPPORTED = 4,  // unknown version, solver or metric
+    BUSY = 5          // the solve queue is full; try again
+};
+
+struct BinarySolveRequest {
+    uint8_t version = BINARY_PROTOCOL_VERSION;
+    uint8_t solver = static_cast<uint8_t>(BinarySolver::TWO_PHASE);
+    uint8_t metric = 0;
+    uint8_t maxDepth = 0;
+    uint32_t tag = 0;
+    uint32_t deadlineMicros = 0;
+    CubieCube cube;
+};
+
+struct BinarySolveResponse {
+    BinaryStatus status = BinaryStatus::SOLVED;
+    bool cached = false;
+    uint32_t tag = 0;
+    uint64_t nodes = 0;
+    uint32_t micros = 0;
+    std::vector<Move> solution;
+};
+
+enum class FrameStatus { COMPLETE, INCOMPLETE, BAD_FRAME };
+
+// The solver type the server pools ("twophase", ...), or nullptr for an
+// unknown id
+const char* binarySolverType(uint8_t solver);
+
+// The first request frame in data. On COMPLETE, consumed is the frame's
+// size. A payload that is not a request is BAD_FRAME; the stream cannot be
+// resynchronised after one. Field values are not checked here.
+FrameStatus decodeSolveRequest(const char* data, size_t size, BinarySolveRequest& request,
+                               size_t& consumed);
+// Append the response frame to out
+void encodeSolveResponse(std::string& out, const BinarySolveResponse& response);
+
+// The client side of the same frames
+void encodeSolveRequest(std::string& out, const BinarySolveRequest& request);
+FrameStatus decodeSolveResponse(const char* data, size_t size, BinarySolveResponse& response,
+                                size_t& consumed);
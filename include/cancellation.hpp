@@ -0,0 +1,43 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+
+// Shared stop signal for a running search. Whoever owns the request (the
+// HTTP handler, a competing solver, ...) keeps a copy and calls cancel();
+// the solver polls isCancelled() while it searches. An optional absolute
+// deadline applies on top of the solver's own time limit.
+//
+// A token made from a parent is also cancelled (and bounded) by it, so a
+// group of solvers can be stopped together without touching the parent.
+class CancellationToken {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    CancellationToken() = default;
+    explicit CancellationToken(std::shared_ptr<const CancellationToken> parent)
+        : parent_(std::move(parent)) {}
+
+    void cancel() { cancelled_.store(true, std::memory_order_relaxed); }
+    bool isCancelled() const {
+        return cancelled_.load(std::memory_order_relaxed) || (parent_ && parent_->isCancelled());
+    }
+
+    void setDeadline(Clock::time_point deadline) { deadline_ = deadline; }
+    void setTimeLimit(double seconds) {
+        deadline_ = Clock::now() + std::chrono::duration_cast<Clock::duration>(
+                                       std::chrono::duration<double>(seconds));
+    }
+    Clock::time_point getDeadline() const {
+        return parent_ ? std::min(deadline_, parent_->getDeadline()) : deadline_;
+    }
+
+    // Cancelled, or the deadline has passed
+    bool expired() const { return isCancelled() || Clock::now() >= getDeadline(); }
+
+private:
+    std::shared_ptr<const CancellationToken> parent_;
+    std::atomic<bool> cancelled_{false};
+    Clock::time_point deadline_ = Clock::time_point::max();
+};
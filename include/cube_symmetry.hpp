@@ -0,0 +1,33 @@
+// include/cube_symmetry.hpp
+#pragma once
+#include "cubie_cube.hpp"
+#include "move.hpp"
+#include "rubiks_cube.hpp"
+#include <vector>
+
+// The 48 symmetries of the cube: 24 rotations, each with or without a mirror.
+//
+// apply(s, cube) is the conjugate S * cube * S^-1. The stickers move with the
+// whole-cube rotation (or reflection), then the colours are renamed so the
+// centres read as before. It is again a legal position, and exactly as hard:
+// if moves m1..mk solve the cube, mapMove(s, m1)..mapMove(s, mk) solve
+// apply(s, cube). A mirror image turns clockwise moves into counter-clockwise
+// ones.
+//
+// canonical() picks the representative all 48 symmetric positions share, so
+// caches and tables keyed on it treat them as one entry.
+class CubeSymmetry {
+public:
+    static constexpr int COUNT = 48;
+    static constexpr int IDENTITY = 0;
+
+    static RubiksCube apply(int sym, const RubiksCube& cube);
+    static Move mapMove(int sym, Move move);
+    static std::vector<Move> mapMoves(int sym, const std::vector<Move>& moves);
+    static int inverse(int sym);
+    static bool isMirror(int sym);
+
+    // The symmetric position whose facelet string is smallest. sym, if
+    // given, receives a symmetry with apply(*sym, cube) equal to it.
+    static RubiksCube canonical(const RubiksCube& cube, int* sym = nullptr);
+};
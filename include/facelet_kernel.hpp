@@ -0,0 +1,47 @@
+// include/facelet_kernel.hpp
+#pragma once
+#include "move.hpp"
+#include <atomic>
+#include <cstdint>
+
+// Moves and checks on the facelet form as whole-block byte shuffles. The
+// 54 stickers (face * 9 + position, faces in RubiksCube::Face order) sit in
+// a 64-byte aligned block whose last 10 bytes are padding. Every move is
+// one precomputed permutation of the block: a single vpermb with
+// AVX-512 VBMI, eight pshufb with AVX2, or a byte loop. The first call
+// picks the best kernel the CPU supports.
+class FaceletKernel {
+public:
+    static constexpr int STICKERS = 54;
+    static constexpr int BLOCK_BYTES = 64;
+
+    enum class Kind { SCALAR, AVX2, AVX512 };
+
+    // block must be BLOCK_BYTES long and 64-byte aligned; the padding is
+    // left as it is
+    static void applyMove(char* block, Move move) { table().applyMove(block, moveIndex(move)); }
+
+    // Bit i is set when sticker i differs from the center of its face
+    static uint64_t mismatches(const char* block) { return table().mismatches(block); }
+
+    static Kind active() { return table().kind; }
+    static bool supported(Kind kind);
+    // Switch kernels (tests and benchmarks); false if the CPU lacks it
+    static bool select(Kind kind);
+    static const char* name(Kind kind);
+
+private:
+    struct Table {
+        Kind kind;
+        void (*applyMove)(char* block, int move);
+        uint64_t (*mismatches)(const char* block);
+    };
+    static const Table KERNELS[3];  // in Kind order
+    static std::atomic<const Table*> active_;  // null until the first call
+
+    static const Table& table() {
+        const Table* active = active_.load(std::memory_order_relaxed);
+        return active ? *active : resolve();
+    }
+    static const Table& resolve();
+};
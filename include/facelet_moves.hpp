@@ -0,0 +1,79 @@
+// include/facelet_moves.hpp
+#pragma once
+#include "move.hpp"
+#include <cstdint>
+
+// The 18 moves of the facelet form as sticker permutations, built at
+// compile time. Stickers are numbered face * 9 + position, faces in
+// RubiksCube::Face order; the permutations span a 64-byte block whose
+// last 10 bytes (padding) map to themselves. Sticker i after move m is
+// sticker FACELET_MOVES.perm[m][i] before it. Both the facelet kernels and
+// the cubie move tables are derived from these, so the two models always
+// agree on what a move does.
+namespace facelet_moves {
+
+constexpr int STICKERS = 54;
+constexpr int BLOCK_BYTES = 64;
+
+struct Permutations {
+    alignas(64) uint8_t perm[NUM_MOVES][BLOCK_BYTES];
+};
+
+// One sticker strip of three, as face and positions
+struct Strip {
+    int face;
+    int a, b, c;
+};
+
+// A clockwise quarter turn: the face rotates, and each strip moves to the
+// next one in the list (the last to the first)
+struct Turn {
+    int face;
+    Strip strips[4];
+};
+
+enum : int { U = 0, D = 1, F = 2, B = 3, L = 4, R = 5 };
+
+constexpr Turn TURNS[6] = {
+    {U, {{F, 0, 1, 2}, {L, 0, 1, 2}, {B, 0, 1, 2}, {R, 0, 1, 2}}},
+    {D, {{F, 6, 7, 8}, {R, 6, 7, 8}, {B, 6, 7, 8}, {L, 6, 7, 8}}},
+    {F, {{U, 6, 7, 8}, {R, 0, 3, 6}, {D, 2, 1, 0}, {L, 8, 5, 2}}},
+    {B, {{U, 2, 1, 0}, {L, 0, 3, 6}, {D, 6, 7, 8}, {R, 8, 5, 2}}},
+    {L, {{U, 0, 3, 6}, {F, 0, 3, 6}, {D, 0, 3, 6}, {B, 8, 5, 2}}},
+    {R, {{U, 8, 5, 2}, {B, 0, 3, 6}, {D, 8, 5, 2}, {F, 8, 5, 2}}},
+};
+
+constexpr int sticker(int face, int position) { return face * 9 + position; }
+
+constexpr Permutations build() {
+    Permutations t{};
+    for (int m = 0; m < NUM_MOVES; ++m) {
+        for (int i = 0; i < BLOCK_BYTES; ++i) t.perm[m][i] = static_cast<uint8_t>(i);
+    }
+
+    constexpr int FACE_CW[9] = {6, 3, 0, 7, 4, 1, 8, 5, 2};
+    for (int face = 0; face < 6; ++face) {
+        const Turn& turn = TURNS[face];
+        uint8_t* quarter = t.perm[face * 3];
+        for (int i = 0; i < 9; ++i) {
+            quarter[sticker(turn.face, i)] = static_cast<uint8_t>(sticker(turn.face, FACE_CW[i]));
+        }
+        for (int s = 0; s < 4; ++s) {
+            const Strip& to = turn.strips[s];
+            const Strip& from = turn.strips[(s + 3) % 4];
+            quarter[sticker(to.face, to.a)] = static_cast<uint8_t>(sticker(from.face, from.a));
+            quarter[sticker(to.face, to.b)] = static_cast<uint8_t>(sticker(from.face, from.b));
+            quarter[sticker(to.face, to.c)] = static_cast<uint8_t>(sticker(from.face, from.c));
+        }
+        // X2 = X X and X' = X X X; applying p then q takes p[q[i]]
+        uint8_t* prime = t.perm[face * 3 + 1];
+        uint8_t* half = t.perm[face * 3 + 2];
+        for (int i = 0; i < BLOCK_BYTES; ++i) half[i] = quarter[quarter[i]];
+        for (int i = 0; i < BLOCK_BYTES; ++i) prime[i] = half[quarter[i]];
+    }
+    return t;
+}
+
+} // namespace facelet_moves
+
+inline constexpr facelet_moves::Permutations FACELET_MOVES = facelet_moves::build();
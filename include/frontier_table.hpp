@@ -0,0 +1,101 @@
+// include/frontier_table.hpp
+#pragma once
+#include "cubie_cube.hpp"
+#include "move.hpp"
+#include "move_sequence.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Every position within a few moves of solved, with its exact distance, for
+// the bidirectional solver to meet.
+//
+// The table is filled backward from the solved cube one depth at a time,
+// stopping at the deepest depth whose positions fit the memory cap. It is
+// an open-addressing hash table of CubieCube fingerprints (linear probing,
+// at most half full) with one byte per slot beside it: the distance and
+// the last move of a shortest sequence reaching the position from solved,
+// so the inverse of that move leads one step back toward solved. A
+// position is only taken for another on a single 64-bit fingerprint
+// collision. A saved table is memory-mapped read-only, like the pattern
+// database, so every process on a node shares its pages.
+class FrontierTable {
+public:
+    static constexpr uint32_t FORMAT_VERSION = 1;
+    static constexpr int MAX_DEPTH = 7;                      // distances fit in 3 bits
+    static constexpr size_t DEFAULT_BYTES = size_t{64} << 20;
+    static constexpr size_t SLOT_BYTES = 9;                  // key and info
+
+    FrontierTable() = default;
+    ~FrontierTable();
+    FrontierTable(const FrontierTable&) = delete;
+    FrontierTable& operator=(const FrontierTable&) = delete;
+
+    // The positions within the deepest depth (at most maxDepth) whose slots
+    // fit in maxBytes. Depths are measured in the metric's moves.
+    static std::shared_ptr<FrontierTable> build(Metric metric, size_t maxBytes = DEFAULT_BYTES,
+                                                int maxDepth = MAX_DEPTH, std::ostream* log = nullptr);
+
+    void save(const std::string& path) const;
+    static std::shared_ptr<const FrontierTable> load(const std::string& path);
+
+    Metric getMetric() const { return metric_; }
+    int getDepth() const { return depth_; }
+    uint64_t size() const { return count_; }
+    uint64_t getByteCount() const { return capacity_ * SLOT_BYTES; }
+
+    // Exact distance to solved, or -1 for positions beyond the depth
+    int distance(const CubieCube& cube) const {
+        uint64_t slot = find(keyOf(cube));
+        return slot == NOT_FOUND ? -1 : info_[slot] >> MOVE_BITS;
+    }
+
+    // Appends the moves from cube to solved; false (path unchanged) when cube
+    // is beyond the depth
+    bool pathToSolved(const CubieCube& cube, std::vector<Move>& path) const;
+
+private:
+    static constexpr int MOVE_BITS = 5;
+    static constexpr uint8_t MOVE_MASK = (1 << MOVE_BITS) - 1;  // all ones: no move (solved)
+    static constexpr uint64_t NOT_FOUND = ~uint64_t{0};
+
+    Metric metric_ = Metric::QUARTER_TURN;
+    int depth_ = 0;
+    uint64_t capacity_ = 0;   // slots, a power of two
+    uint64_t count_ = 0;
+    const uint64_t* keys_ = nullptr;
+    const uint8_t* info_ = nullptr;
+
+    std::vector<uint64_t> ownedKeys_;
+    std::vector<uint8_t> ownedInfo_;
+    void* mapping_ = nullptr;
+    size_t mappingSize_ = 0;
+
+    // Zero marks an empty slot
+    static uint64_t keyOf(const CubieCube& cube) {
+        uint64_t key = cube.fingerprint();
+        return key ? key : 1;
+    }
+
+    uint64_t find(uint64_t key) const {
+        for (uint64_t slot = key & (capacity_ - 1);; slot = (slot + 1) & (capacity_ - 1)) {
+            if (keys_[slot] == key) return slot;
+            if (keys_[slot] == 0) return NOT_FOUND;
+        }
+    }
+
+    bool insert(const CubieCube& cube, int distance, Move move);
+    void fill(const CubieCube& cube, int depth, int remaining, Move last,
+              MoveSequenceAutomaton::State state, const MoveSequenceAutomaton& automaton,
+              uint64_t& added);
+};
+
+// The table each metric's bidirectional searches meet. Without one set
+// here, the first call builds it under the cap from setFrontierTableBytes()
+// (callers asking meanwhile wait for it); it is then kept for the process.
+void setDefaultFrontierTable(std::shared_ptr<const FrontierTable> table);
+void setFrontierTableBytes(size_t bytes);
+std::shared_ptr<const FrontierTable> getFrontierTable(Metric metric);
@@ -0,0 +1,43 @@
+#pragma once
+#include "cubie_cube.hpp"
+#include "pattern_database.hpp"
+#include <memory>
+#include <string>
+#include <vector>
+
+// Lower-bound estimate of the number of moves to solve a cube
+class Heuristic {
+public:
+    virtual ~Heuristic() = default;
+    virtual int estimate(const CubieCube& cube) const = 0;
+    virtual std::string getName() const = 0;
+};
+
+// Misplaced stickers / 8 (the original heuristic, always available). Final,
+// like PatternDatabaseHeuristic, so IDAStar can call it without a vtable.
+class ManhattanHeuristic final : public Heuristic {
+public:
+    int estimate(const CubieCube& cube) const override { return cube.getManhattanDistance(); }
+    std::string getName() const override { return "manhattan"; }
+};
+
+// Maximum over the tables of a pattern database
+class PatternDatabaseHeuristic final : public Heuristic {
+public:
+    explicit PatternDatabaseHeuristic(std::shared_ptr<const PatternDatabase> db)
+        : db_(std::move(db)) {}
+    int estimate(const CubieCube& cube) const override { return db_->estimate(cube); }
+    std::string getName() const override { return "pdb"; }
+    
+private:
+    std::shared_ptr<const PatternDatabase> db_;
+};
+
+// Process-wide pattern database, mapped once at startup
+void setDefaultPatternDatabase(std::shared_ptr<const PatternDatabase> db);
+std::shared_ptr<const PatternDatabase> getDefaultPatternDatabase();
+
+// Create a heuristic by name ("manhattan" or "pdb"). "pdb" falls back to
+// manhattan when no pattern database has been loaded.
+std::shared_ptr<const Heuristic> createHeuristic(const std::string& type);
+std::vector<std::string> getAvailableHeuristics();
@@ -2,54 +2,251 @@
 #pragma once
 #include "rubiks_cube.hpp"
 #include "solver.hpp"
+#include "solver_pool.hpp"
+#include "session_store.hpp"
+#include "solution_cache.hpp"
+#include "thread_pool.hpp"
+#include "json.hpp"
+#include "binary_protocol.hpp"
+#include <atomic>
+#include <chrono>
+#include <functional>
 #include <string>
 #include <memory>
 #include <map>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
 
+class MPIScheduler;
+class FrontierTable;
+
+// One parsed request. Header names are stored lower-case.
+struct HTTPRequest {
+    std::string method;
+    std::string path;   // without the query
+    std::string query;  // after '?', as sent
+    std::string version;
+    std::map<std::string, std::string> headers;
+    std::string body;
+
+    std::string header(const std::string& name) const;
+    // HTTP/1.1 keeps the connection open unless asked not to; 1.0 only on request
+    bool keepAlive() const;
+    // The value of name=value in the query, "" without one (no %-decoding)
+    std::string queryParam(const std::string& name) const;
+};
+
+// A response before framing. The server writes the status line, the
+// standard headers, these extra ones and the body in one go into the
+// connection's output buffer.
+struct HTTPResponse {
+    int status = 200;
+    std::string body;
+    const char* contentType = "application/json";
+    std::string headers;  // extra header lines, each ending in \r\n
+
+    void addHeader(const std::string& line) { headers += line + "\r\n"; }
+    // Status line, headers (with Connection when keepAlive is given) and body
+    void serialize(std::string& out, int keepAlive = -1) const;
+};
+
+// How cube endpoints return the cube: "verbose" (the default), per-sticker
+// arrays under "faces"; "compact", the 54-character string under "state";
+// "binary", the 20-byte CubieCube layout as application/octet-stream, with
+// any other fields moved to headers. Chosen by ?format= or a "format" member.
+enum class CubeFormat { VERBOSE, COMPACT, BINARY };
+bool parseCubeFormat(const std::string& name, CubeFormat& format);
+
+// Event-driven server: one epoll loop accepts connections and waits for
+// input, an IO pool parses requests and answers the cheap endpoints, and a
+// separate bounded pool runs solves. A busy solve pool therefore never holds
+// up /status; when its queue is full new solves get 503 right away.
+// Connections are persistent (HTTP/1.1 keep-alive) and requests are framed
+// by Content-Length, so pipelined requests are answered in order.
+//
+// An optional second port speaks the binary solve protocol (see
+// binary_protocol.hpp) on the same event loop and pools, so its solves
+// share the solver instances, the solution cache and the metrics with
+// the HTTP ones.
 class HTTPServer {
 public:
+    static constexpr size_t IO_THREADS = 4;
+    static constexpr size_t SOLVE_THREADS = 2;
+    static constexpr size_t SOLVE_QUEUE_LIMIT = 8;
+    static constexpr size_t MAX_REQUEST_BYTES = 1 << 20;
+    // Finished jobs stay readable this long, and at most this many are kept
+    static constexpr std::chrono::seconds JOB_RETENTION{10 * 60};
+    static constexpr size_t MAX_JOBS = 256;
+    // Binary frames answered per solve-pool task, in one write
+    static constexpr size_t MAX_PIPELINED_FRAMES = 64;
+
+    enum class ParseStatus { COMPLETE, INCOMPLETE, BAD_REQUEST, TOO_LARGE, UNSUPPORTED };
+
     HTTPServer(int port = 8080);
     ~HTTPServer();
     
+    // Blocks until stop(); stop() is safe to call from a signal handler
     void start();
     void stop();
+
+    // Parse the first request in buffer; on COMPLETE, consumed is its length
+    static ParseStatus parseRequest(const std::string& buffer, HTTPRequest& request,
+                                    size_t& consumed);
     
     // Solver selection
     void setSolver(const std::string& solverType);
     std::string getCurrentSolver() const;
     std::vector<std::string> getAvailableSolvers() const;
     
+    // Persist the solution cache in this file across restarts
+    void setCacheFile(const std::string& path);
+    
+    // Also serve the binary solve protocol on this port (0, the default:
+    // not at all); call before start()
+    void setBinaryPort(int port) { binaryPort_ = port; }
+    
+    // Answer positions within this many moves of solved from the frontier
+    // table, before any cache or search (0, the default: never); call
+    // before start()
+    void setNearSolvedDepth(int depth);
+    
+    // The worker groups that run "mpi" and "hybrid" solves; without them
+    // those solvers are unavailable
+    void setMPIScheduler(std::shared_ptr<MPIScheduler> scheduler) { mpiScheduler_ = std::move(scheduler); }
+    
 private:
     int port_;
+    int binaryPort_ = 0;
     int serverSocket_;
-    bool running_;
-    std::unique_ptr<Solver> solver_;
+    int binarySocket_ = -1;
+    int nearSolvedDepth_ = 0;
+    std::shared_ptr<const FrontierTable> nearTables_[2];  // by Metric
+    int epollFd_;
+    int wakeFd_;
+    std::atomic<bool> running_;
+
+    // Keyed by id rather than fd, so a stale event for a closed fd can't
+    // reach a new connection that reused the number
+    struct Connection {
+        uint64_t id;
+        int fd;
+        bool binary = false;  // accepted on the binary port
+        std::string buffer;  // received but not yet parsed
+        // The response being written; cleared, never shrunk, so a warm
+        // connection frames its responses without allocating
+        std::string output;
+    };
+    std::unordered_map<uint64_t, std::shared_ptr<Connection>> connections_;
+    uint64_t nextConnectionId_ = 1;
+    std::mutex connectionsMutex_;
+    std::unique_ptr<ThreadPool> ioPool_;
+    std::unique_ptr<ThreadPool> solvePool_;
+    // Cancelled on shutdown so queued and running solves finish quickly
+    std::shared_ptr<CancellationToken> shutdownToken_;
+    std::shared_ptr<SolutionCache> solutionCache_;
+    std::string cachePath_;
+    // Totals of every solve run, for GET /metrics
+    SolveMetrics solveMetrics_;
+    std::shared_ptr<MPIScheduler> mpiScheduler_;
+
+    // A solve started by POST /jobs. Its events are kept as ready-to-send
+    // SSE frames so a client that (re)connects late replays what it missed;
+    // subscribers are event-stream connections, which are never re-armed.
+    struct AsyncJob {
+        std::string id;
+        std::shared_ptr<CancellationToken> token;
+        std::mutex mutex;  // guards everything below
+        std::vector<std::string> events;
+        std::vector<std::shared_ptr<Connection>> subscribers;
+        std::string result;  // final response body once finished
+        bool finished = false;
+        std::chrono::steady_clock::time_point finishedAt;
+    };
+    std::unordered_map<std::string, std::shared_ptr<AsyncJob>> jobs_;
+    std::mutex jobsMutex_;
+
+    // Guards currentSolverType_, currentSolverName_ and currentCube_
+    mutable std::mutex stateMutex_;
+    SessionStore sessions_;
+    // Every solve borrows its solvers here instead of constructing them
+    SolverPool solverPool_;
     std::string currentSolverType_;
-    RubiksCube currentCube_;
+    std::string currentSolverName_;
+    RubiksCube currentCube_;  // default session for requests without X-Session-Id
     
+    // Connection handling
+    int openListener(int port);
+    void acceptConnections(int listener, bool binary);
+    void serviceConnection(const std::shared_ptr<Connection>& conn);
+    void serviceFrames(const std::shared_ptr<Connection>& conn, bool peerClosed);
+    bool writeResponse(const std::shared_ptr<Connection>& conn, const std::string& response);
+    bool writeWithoutBlocking(const std::shared_ptr<Connection>& conn, const std::string& data);
+    bool sendResponse(const std::shared_ptr<Connection>& conn, const HTTPResponse& response, bool keepAlive);
+    void rearmConnection(const std::shared_ptr<Connection>& conn);
+    void closeConnection(const std::shared_ptr<Connection>& conn);
+    void closeAllConnections();
+    static bool isSolveRequest(const HTTPRequest& request);
+    static bool isEventStreamRequest(const HTTPRequest& request);
+
     // Request handlers
-    std::string handleRequest(const std::string& request);
-    std::string handleGET(const std::string& path);
-    std::string handlePOST(const std::string& path, const std::string& body);
-    std::string handleOPTIONS();
+    HTTPResponse handleRequest(const HTTPRequest& request);
+    HTTPResponse handleGET(const HTTPRequest& request);
+    HTTPResponse handlePOST(const HTTPRequest& request);
+    HTTPResponse handleDELETE(const HTTPRequest& request);
+    HTTPResponse handleOPTIONS();
     
     // API endpoints
-    std::string getStatus();
-    std::string getCubeState();
-    std::string resetCube();
-    std::string scrambleCube(const std::string& body);
-    std::string applyMove(const std::string& body);
-    std::string solveCube(const std::string& body);
-    std::string setCubeState(const std::string& body);
-    std::string selectSolver(const std::string& body);
-    std::string listSolvers();
+    HTTPResponse getStatus();
+    HTTPResponse getMetrics();
+    HTTPResponse getCubeState(const std::string& sessionId, CubeFormat format);
+    HTTPResponse resetCube(const std::string& sessionId, CubeFormat format);
+    HTTPResponse scrambleCube(const JSONBody& body, const std::string& sessionId, CubeFormat format);
+    HTTPResponse applyMove(const JSONBody& body, const std::string& sessionId, CubeFormat format);
+    HTTPResponse solveCube(const JSONBody& body, const std::string& sessionId);
+    HTTPResponse solveStateless(const JSONBody& body);
+    bool streamBatch(const std::shared_ptr<Connection>& conn, const HTTPRequest& request,
+                     bool keepAlive);
+    HTTPResponse setCubeState(const JSONBody& body, const std::string& sessionId, CubeFormat format);
+    int solveState(const RubiksCube& cube, const JSONBody& body, std::string& json,
+                   AsyncJob* job = nullptr);
+    BinarySolveResponse solveFrame(const BinarySolveRequest& request,
+                                   CancellationToken::Clock::time_point receivedAt);
+    // Optimal solutions differ between the metrics, so they are cached
+    // apart; two-phase answers the same way in both
+    static std::string solutionCacheKey(const std::string& solver, Metric metric);
+    // An optimal path to solved when the cube is within the near-solved depth
+    bool lookupNearSolved(const CubieCube& cube, Metric metric, std::vector<Move>& path) const;
+    
+    // Asynchronous jobs
+    HTTPResponse createJob(const JSONBody& body, const std::string& sessionId);
+    HTTPResponse getJob(const std::string& jobId);
+    HTTPResponse cancelJob(const std::string& jobId);
+    void streamJobEvents(const std::shared_ptr<Connection>& conn, const HTTPRequest& request);
+    void emitJobEvent(AsyncJob& job, const std::string& event, const std::string& data);
+    void finishJob(AsyncJob& job, int status, const std::string& json);
+    std::shared_ptr<AsyncJob> findJob(const std::string& jobId);
+    void purgeJobs();
+    
+    // Session state
+    bool withCube(const std::string& sessionId, const std::function<void(RubiksCube&)>& fn);
+    HTTPResponse sessionNotFound();
+    void saveSolutionCache();
+    HTTPResponse selectSolver(const JSONBody& body);
+    HTTPResponse listSolvers();
     
     // HTTP helpers
-    std::string createResponse(int status, const std::string& body, 
-                               const std::string& contentType = "application/json");
-    std::map<std::string, std::string> parseJSON(const std::string& json);
-    std::string extractJSONValue(const std::string& json, const std::string& key);
+    static HTTPResponse createResponse(int status, std::string body,
+                                       const char* contentType = "application/json");
+    // The cube in format, after the members extra writes (a binary
+    // response sends none of them; put what matters in headers as well)
+    static HTTPResponse cubeResponse(const RubiksCube& cube, CubeFormat format,
+                                     const std::function<void(JSONWriter&)>& extra = nullptr);
     
-    // Solver factory
+    // Solver factory. Pooled instances are keyed by type and thread count
+    // (openmp only; 0 = all cores).
     std::unique_ptr<Solver> createSolver(const std::string& type);
+    std::unique_ptr<Solver> createSolverInstance(const std::string& type, int threads = 0);
+    SolverPool::Lease borrowSolver(const std::string& type, int threads = 0);
+    std::string getDefaultHeuristicType() const;
 };
@@ -1,18 +1,29 @@
 #pragma once
 #include "solver.hpp"
 #include "rubiks_cube.hpp"
+#include "cubie_cube.hpp"
+#include "move.hpp"
+#include "mpi_protocol.hpp"
+#include "thread_placement.hpp"
 #include <mpi.h>
 #include <omp.h>
+#include <atomic>
 #include <chrono>
 
 class HybridSolver : public Solver {
 public:
-    HybridSolver(int numThreads = 2);
+    // numThreads 0 uses ThreadPlacement's count for this rank
+    HybridSolver(int numThreads = 0);
     ~HybridSolver();
     
     std::vector<std::string> solve(RubiksCube& cube, int maxDepth = 20) override;
     std::string getName() const override { return "Hybrid (MPI+OpenMP IDA*)"; }
     
+    // As for MPISolver. The OpenMP threads make no MPI calls, so a cancel
+    // is only seen between iterations.
+    void setCommunicator(MPI_Comm comm);
+    void setJobControl(JobControl control) { control_ = control; }
+    
     static void Initialize(int* argc, char*** argv);
     static void Finalize();
     static bool IsInitialized() { return initialized_; }
@@ -22,18 +33,29 @@ public:
     int getNumThreads() const { return numThreads_; }
     
 private:
+    MPI_Comm comm_ = MPI_COMM_WORLD;
     int rank_;
     int size_;
     int numThreads_;
+    JobControl control_;
     static bool initialized_;
     
-    std::vector<std::string> solution_;
+    std::vector<Move> solution_;
     int maxDepth_;
-    bool solutionFound_;
+    std::atomic<bool> solutionFound_{false};  // read unlocked by every thread
+    PerThread<SearchCounters> threadCounters_;  // one per OpenMP thread
+    
+    // IDAStar policy: every thread unwinds once one of this rank's found a
+    // solution
+    struct ThreadPolicy {
+        HybridSolver& solver;
+        bool stop(uint64_t nodes) {
+            return solver.shouldStop(nodes) || solver.solutionFound_.load(std::memory_order_relaxed);
+        }
+        bool complete() const {
+            return !solver.solutionFound_.load(std::memory_order_relaxed) && !solver.wasStopped();
+        }
+    };
     
-    int heuristic(const RubiksCube& cube) const;
-    int idaSearchHybrid(RubiksCube& cube, int g, int threshold,
-                       const std::string& lastMove, std::vector<std::string>& path,
-                       double timeLimit, std::chrono::high_resolution_clock::time_point startTime);
-    bool isRedundantMove(const std::string& lastMove, const std::string& nextMove) const;
+    uint64_t localNodes() const;  // this rank's nodes so far
 };
\ No newline at end of file
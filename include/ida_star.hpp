@@ -0,0 +1,133 @@
+// include/ida_star.hpp
+#pragma once
+#include "cubie_cube.hpp"
+#include "heuristic.hpp"
+#include "move.hpp"
+#include "move_sequence.hpp"
+#include "solve_stats.hpp"
+#include "transposition_table.hpp"
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+// Move sets of the two metrics, for IDAStar's MoveSet parameter
+struct QuarterTurnMoves {
+    static constexpr Metric METRIC = Metric::QUARTER_TURN;
+    static constexpr int COUNT = 12;
+};
+
+struct HalfTurnMoves {
+    static constexpr Metric METRIC = Metric::HALF_TURN;
+    static constexpr int COUNT = NUM_MOVES;
+};
+
+// The depth-first part of one IDA* iteration, shared by every IDA* solver.
+// Each specialization gets its own copy of the inner loop, with the
+// heuristic (a final class), the goal test and the move count inlined:
+//
+//   CubeModel    - applyMove(Move), isSolved(); TranspositionTable::key()
+//                  must accept it when a table is set
+//   HeuristicType - estimate(const CubeModel&); the virtual Heuristic base
+//                  works too, at the cost of an indirect call
+//   MoveSet      - QuarterTurnMoves or HalfTurnMoves
+//   Parallelism  - how the solver shares the search, a small object
+//                  (usually a reference to the solver) held by value:
+//                    bool stop(uint64_t nodes)  checked at every node,
+//                                               after it is counted;
+//                    bool complete() const      false once the iteration
+//                                               was cut short, so its
+//                                               bounds are not proven
+//
+// search() returns FOUND with the solution's moves appended to path, or
+// the smallest f above the threshold (NONE if nothing was left or the
+// search stopped).
+template <typename CubeModel, typename HeuristicType, typename MoveSet, typename Parallelism>
+class IDAStar {
+public:
+    static constexpr int FOUND = -1;
+    static constexpr int NONE = std::numeric_limits<int>::max();
+
+    IDAStar(const HeuristicType& heuristic, TranspositionTable* table, Parallelism parallelism,
+            SearchCounters& counters)
+        : heuristic_(heuristic), table_(table), parallelism_(parallelism), counters_(counters),
+          automaton_(MoveSequenceAutomaton::get(MoveSet::METRIC)) {}
+
+    int search(const CubeModel& cube, int g, int threshold, MoveSequenceAutomaton::State state,
+               std::vector<Move>& path) {
+        counters_.visit(g);
+
+        // Deadline, cancellation, or another worker's solution
+        if (parallelism_.stop(counters_.nodes)) return NONE;
+
+        int f = g + heuristic_.estimate(cube);
+        counters_.heuristicEvaluations++;
+        if (f > threshold) {
+            counters_.boundCutoffs++;
+            return f;
+        }
+
+        // With slack left the subtree is worth a lookup; a bound from an
+        // earlier visit may prune it
+        bool useTable = table_ && threshold - f >= TranspositionTable::MIN_SLACK;
+        uint64_t key = 0;
+        if (useTable) {
+            key = TranspositionTable::key(cube, state, MoveSet::METRIC);
+            counters_.tableProbes++;
+            int bound = g + table_->probe(key);
+            if (bound > threshold) {
+                counters_.tableCutoffs++;
+                return bound;
+            }
+        }
+
+        if (cube.isSolved()) return FOUND;
+
+        int min = NONE;
+        MoveMask allowed = automaton_.allowed(state);
+        counters_.sequencePruned += MoveSet::COUNT - allowed.count();
+        for (Move move : allowed) {
+            CubeModel next = cube;
+            next.applyMove(move);
+            path.push_back(move);
+
+            int temp = search(next, g + 1, threshold, automaton_.next(state, move), path);
+            if (temp == FOUND) return FOUND;
+            if (temp < min) min = temp;
+
+            path.pop_back();
+        }
+
+        // Only a search that ran to the end proves the bound
+        if (useTable && parallelism_.complete()) table_->store(key, g, min - g);
+
+        return min;
+    }
+
+private:
+    const HeuristicType& heuristic_;
+    TranspositionTable* table_;
+    Parallelism parallelism_;
+    SearchCounters& counters_;
+    const MoveSequenceAutomaton& automaton_;
+};
+
+// Runs IDAStar<CubieCube, ...>::search specialized for a solver's
+// run-time heuristic and metric. The built-in heuristics get their own
+// instantiations; any other Heuristic runs through the virtual call.
+template <typename Parallelism>
+int searchIDAStar(const Heuristic& heuristic, Metric metric, TranspositionTable* table,
+                  Parallelism parallelism, SearchCounters& counters, const CubieCube& cube,
+                  int g, int threshold, MoveSequenceAutomaton::State state, std::vector<Move>& path) {
+    auto withMoves = [&](const auto& estimate) {
+        using HeuristicType = std::decay_t<decltype(estimate)>;
+        if (metric == Metric::HALF_TURN) {
+            return IDAStar<CubieCube, HeuristicType, HalfTurnMoves, Parallelism>(
+                estimate, table, parallelism, counters).search(cube, g, threshold, state, path);
+        }
+        return IDAStar<CubieCube, HeuristicType, QuarterTurnMoves, Parallelism>(
+            estimate, table, parallelism, counters).search(cube, g, threshold, state, path);
+    };
+    if (auto* manhattan = dynamic_cast<const ManhattanHeuristic*>(&heuristic)) return withMoves(*manhattan);
+    if (auto* pdb = dynamic_cast<const PatternDatabaseHeuristic*>(&heuristic)) return withMoves(*pdb);
+    return withMoves(heuristic);
+}
@@ -0,0 +1,160 @@
+// include/json.hpp
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+// Streaming JSON output appended to a caller's buffer. Commas are placed
+// by the writer, so a document is a flat sequence of calls:
+//
+//   JSONWriter json(buffer);
+//   json.beginObject().member("moves", 3).key("solution").beginArray();
+//   for (const std::string& move : solution) json.value(move);
+//   json.endArray().endObject();
+//
+// Nothing is allocated beyond the buffer itself, which keeps its capacity
+// when the caller clears and reuses it. Nesting is limited to 64 levels.
+class JSONWriter {
+public:
+    explicit JSONWriter(std::string& out) : out_(out) {}
+
+    JSONWriter& beginObject() { return open('{'); }
+    JSONWriter& endObject() { return close('}'); }
+    JSONWriter& beginArray() { return open('['); }
+    JSONWriter& endArray() { return close(']'); }
+
+    // The next value belongs to this member of the enclosing object
+    JSONWriter& key(std::string_view name) {
+        separate();
+        appendString(name);
+        out_ += ':';
+        afterKey_ = true;
+        return *this;
+    }
+
+    // Strings are escaped
+    JSONWriter& value(std::string_view text) {
+        separate();
+        appendString(text);
+        return *this;
+    }
+    JSONWriter& value(const char* text) { return value(std::string_view(text)); }
+    JSONWriter& value(const std::string& text) { return value(std::string_view(text)); }
+    JSONWriter& value(bool flag) {
+        separate();
+        out_ += flag ? "true" : "false";
+        return *this;
+    }
+    template <typename T, typename std::enable_if<std::is_integral<T>::value, int>::type = 0>
+    JSONWriter& value(T number) {
+        separate();
+        appendInteger(static_cast<typename std::conditional<std::is_signed<T>::value, int64_t, uint64_t>::type>(number));
+        return *this;
+    }
+    // Fixed-point with this many decimals
+    JSONWriter& value(double number, int decimals = 6);
+    JSONWriter& null() {
+        separate();
+        out_ += "null";
+        return *this;
+    }
+    // Already-encoded JSON, written as is
+    JSONWriter& raw(std::string_view json) {
+        separate();
+        out_.append(json.data(), json.size());
+        return *this;
+    }
+
+    template <typename T>
+    JSONWriter& member(std::string_view name, const T& v) { return key(name).value(v); }
+    JSONWriter& member(std::string_view name, double v, int decimals) { return key(name).value(v, decimals); }
+
+    std::string& buffer() { return out_; }
+
+    // text as a quoted, escaped JSON string
+    static void appendString(std::string& out, std::string_view text);
+
+private:
+    static constexpr int MAX_DEPTH = 64;
+
+    JSONWriter& open(char bracket) {
+        separate();
+        out_ += bracket;
+        if (depth_ < MAX_DEPTH) empty_ |= uint64_t{1} << depth_;
+        ++depth_;
+        return *this;
+    }
+    JSONWriter& close(char bracket) {
+        --depth_;
+        out_ += bracket;
+        return *this;
+    }
+    // A comma before every element but the first of its container
+    void separate() {
+        if (afterKey_) {
+            afterKey_ = false;
+            return;
+        }
+        if (depth_ == 0 || depth_ > MAX_DEPTH) return;
+        uint64_t bit = uint64_t{1} << (depth_ - 1);
+        if (empty_ & bit) {
+            empty_ &= ~bit;
+        } else {
+            out_ += ',';
+        }
+    }
+    void appendString(std::string_view text) { appendString(out_, text); }
+    void appendInteger(int64_t number);
+    void appendInteger(uint64_t number);
+
+    std::string& out_;
+    uint64_t empty_ = 0;  // bit d: the container at depth d has no element yet
+    int depth_ = 0;
+    bool afterKey_ = false;
+};
+
+// The top-level members of a JSON object, found in one pass over a request
+// body. The whole text is checked (nesting, strings and escapes, numbers,
+// literals), but only the top level is indexed: members hold views into
+// the text, which must outlive the JSONBody. An empty or all-whitespace
+// body is an empty object. Repeated keys: the first one counts.
+class JSONBody {
+public:
+    // Bodies with more top-level members than this are rejected
+    static constexpr size_t MAX_MEMBERS = 32;
+
+    explicit JSONBody(std::string_view text);
+
+    // False unless the text is an object (or empty)
+    bool valid() const { return valid_; }
+    std::string_view text() const { return text_; }
+    bool has(std::string_view key) const { return find(key) != nullptr; }
+
+    // A string member unescaped, a number or literal as written, anything
+    // else as its raw text; empty when missing
+    std::string value(std::string_view key) const;
+    // The member exactly as written (strings keep their quotes)
+    std::string_view raw(std::string_view key) const;
+    // The strings of an array member; other elements are skipped
+    std::vector<std::string> strings(std::string_view key) const;
+
+    // The contents of a JSON string literal (quotes included) unescaped
+    static std::string unescape(std::string_view literal);
+
+private:
+    struct Member {
+        std::string_view key;    // as written, without quotes
+        std::string_view value;  // as written
+    };
+
+    const Member* find(std::string_view key) const;
+
+    std::string_view text_;
+    std::array<Member, MAX_MEMBERS> members_;
+    size_t count_ = 0;
+    bool valid_ = false;
+};
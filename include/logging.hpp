@@ -0,0 +1,48 @@
+// include/logging.hpp
+#pragma once
+#include <atomic>
+#include <sstream>
+#include <string>
+
+// Leveled console logging. ERROR and WARNING go to stderr, INFO and DEBUG to
+// stdout. The level starts from RUBIKS_LOG_LEVEL (error, warning, info or
+// debug; info by default); production servers run with warning.
+enum class LogLevel : int { ERROR = 0, WARNING = 1, INFO = 2, DEBUG = 3 };
+
+namespace logging_detail {
+extern std::atomic<int> currentLevel;
+}
+
+inline bool logEnabled(LogLevel level) {
+    return static_cast<int>(level) <= logging_detail::currentLevel.load(std::memory_order_relaxed);
+}
+void setLogLevel(LogLevel level);
+LogLevel getLogLevel();
+
+// False if name is not one of the four level names
+bool parseLogLevel(const std::string& name, LogLevel& level);
+
+// One message, written as a single line when it goes out of scope so lines
+// from different threads never interleave
+class LogLine {
+public:
+    explicit LogLine(LogLevel level) : level_(level) {}
+    ~LogLine();
+    LogLine(const LogLine&) = delete;
+    LogLine& operator=(const LogLine&) = delete;
+
+    template <typename T>
+    LogLine& operator<<(const T& value) {
+        out_ << value;
+        return *this;
+    }
+
+private:
+    LogLevel level_;
+    std::ostringstream out_;
+};
+
+// RUBIKS_LOG(INFO) << "..." << value;  Nothing after the macro is evaluated
+// when the level is off, so disabled logging costs one relaxed load.
+#define RUBIKS_LOG(level) \
+    if (!logEnabled(LogLevel::level)) {} else LogLine(LogLevel::level)
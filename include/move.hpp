@@ -0,0 +1,82 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Integer move identifiers, in the same order as RubiksCube::getAllMoves().
+// The face is moveFace(m) (RubiksCube::Face order) and the turn is
+// moveIndex(m) % 3: 0 = clockwise, 1 = prime, 2 = half turn.
+enum class Move : uint8_t {
+    U = 0, UPrime, U2,
+    D, DPrime, D2,
+    F, FPrime, F2,
+    B, BPrime, B2,
+    L, LPrime, L2,
+    R, RPrime, R2
+};
+
+constexpr int NUM_MOVES = 18;
+
+// Placeholder for "no previous move" in search code
+constexpr Move NO_MOVE = static_cast<Move>(0xFF);
+
+// Quarter turns only (the search move set)
+constexpr std::array<Move, 12> BASIC_MOVES = {
+    Move::U, Move::UPrime, Move::D, Move::DPrime, Move::F, Move::FPrime,
+    Move::B, Move::BPrime, Move::L, Move::LPrime, Move::R, Move::RPrime
+};
+
+// Quarter and half turns
+constexpr std::array<Move, NUM_MOVES> ALL_MOVES = {
+    Move::U, Move::UPrime, Move::U2, Move::D, Move::DPrime, Move::D2,
+    Move::F, Move::FPrime, Move::F2, Move::B, Move::BPrime, Move::B2,
+    Move::L, Move::LPrime, Move::L2, Move::R, Move::RPrime, Move::R2
+};
+
+constexpr int moveIndex(Move m) { return static_cast<int>(m); }
+constexpr int moveFace(Move m) { return static_cast<int>(m) / 3; }
+
+// Opposite faces (U/D, F/B, L/R) share an axis
+constexpr int moveAxis(Move m) { return moveFace(m) / 2; }
+
+// X <-> X', X2 is its own inverse
+constexpr Move inverse(Move m) {
+    return static_cast<int>(m) % 3 == 2 ? m
+         : static_cast<int>(m) % 3 == 0 ? static_cast<Move>(static_cast<int>(m) + 1)
+                                        : static_cast<Move>(static_cast<int>(m) - 1);
+}
+
+// Notation conversion, used only at API boundaries
+inline const char* moveToString(Move m) {
+    static const char* const NAMES[NUM_MOVES] = {
+        "U", "U'", "U2", "D", "D'", "D2", "F", "F'", "F2",
+        "B", "B'", "B2", "L", "L'", "L2", "R", "R'", "R2"
+    };
+    return NAMES[moveIndex(m)];
+}
+
+inline Move moveFromString(const std::string& move) {
+    int face;
+    switch (move.empty() ? '\0' : move[0]) {
+        case 'U': face = 0; break;
+        case 'D': face = 1; break;
+        case 'F': face = 2; break;
+        case 'B': face = 3; break;
+        case 'L': face = 4; break;
+        case 'R': face = 5; break;
+        default: throw std::invalid_argument("Invalid move: " + move);
+    }
+    if (move.size() == 1) return static_cast<Move>(face * 3);
+    if (move.size() == 2 && move[1] == '\'') return static_cast<Move>(face * 3 + 1);
+    if (move.size() == 2 && move[1] == '2') return static_cast<Move>(face * 3 + 2);
+    throw std::invalid_argument("Invalid move: " + move);
+}
+
+inline std::vector<std::string> movesToStrings(const std::vector<Move>& moves) {
+    std::vector<std::string> result;
+    result.reserve(moves.size());
+    for (Move m : moves) result.emplace_back(moveToString(m));
+    return result;
+}
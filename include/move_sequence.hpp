@@ -0,0 +1,97 @@
+// include/move_sequence.hpp
+#pragma once
+#include "move.hpp"
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Which turns count as one move: the 12 quarter turns, or those plus the 6
+// half turns
+enum class Metric : uint8_t { QUARTER_TURN, HALF_TURN };
+
+// "qtm" and "htm", as used by the API and the command-line tools
+inline const char* metricName(Metric metric) {
+    return metric == Metric::HALF_TURN ? "htm" : "qtm";
+}
+
+// False if name is neither "qtm" nor "htm"
+inline bool parseMetric(const std::string& name, Metric& metric) {
+    if (name == "qtm") metric = Metric::QUARTER_TURN;
+    else if (name == "htm") metric = Metric::HALF_TURN;
+    else return false;
+    return true;
+}
+
+// Set of moves as a bitmask over move ids, iterable in id order
+class MoveMask {
+public:
+    class iterator {
+    public:
+        explicit iterator(uint32_t bits) : bits_(bits) {}
+        Move operator*() const { return static_cast<Move>(__builtin_ctz(bits_)); }
+        iterator& operator++() { bits_ &= bits_ - 1; return *this; }
+        bool operator!=(const iterator& other) const { return bits_ != other.bits_; }
+    private:
+        uint32_t bits_;
+    };
+
+    constexpr explicit MoveMask(uint32_t bits = 0) : bits_(bits) {}
+    bool contains(Move m) const { return (bits_ >> moveIndex(m)) & 1; }
+    uint32_t bits() const { return bits_; }
+    int count() const { return __builtin_popcount(bits_); }
+    iterator begin() const { return iterator(bits_); }
+    iterator end() const { return iterator(0); }
+
+private:
+    uint32_t bits_;
+};
+
+// Finite-state automaton over move sequences that accepts only one
+// ordering of each group of equivalent sequences, so a search that follows
+// it never visits the same position twice by trivially different paths:
+//
+//   - Turns of opposite faces commute; they are taken lower face first
+//     (U D, never D U), and after the higher face the lower one is closed
+//     until another axis is turned (no U D U).
+//   - In the half-turn metric a face is never turned twice in a row.
+//   - In the quarter-turn metric a face may be turned twice, clockwise
+//     (U U, which is U2); U U' cancels, U' U' equals U U and U U U is U'.
+//
+// The state is the face last turned and, in the quarter-turn metric, how
+// it was turned. Both the successor table and the allowed-move masks are
+// precomputed, so a search step is one load for the mask and one for the
+// next state.
+class MoveSequenceAutomaton {
+public:
+    using State = uint8_t;
+    static constexpr State START = 0;
+    static constexpr State REJECT = 0xFF;
+    // START plus, per face: one clockwise turn, one counter-clockwise turn,
+    // two clockwise turns (the half-turn metric uses the first of the three)
+    static constexpr int NUM_STATES = 1 + 6 * 3;
+
+    explicit MoveSequenceAutomaton(Metric metric);
+
+    // Shared instances; the tables never change after construction
+    static const MoveSequenceAutomaton& get(Metric metric);
+
+    Metric getMetric() const { return metric_; }
+
+    // The metric's moves, in move id order
+    const std::vector<Move>& getMoves() const { return moves_; }
+
+    MoveMask allowed(State state) const { return MoveMask(allowed_[state]); }
+    State next(State state, Move move) const { return next_[state][moveIndex(move)]; }
+
+    // State after a whole sequence, or REJECT if it is not canonical
+    State run(const std::vector<Move>& moves, State state = START) const;
+
+private:
+    Metric metric_;
+    std::vector<Move> moves_;
+    std::array<uint32_t, NUM_STATES> allowed_;
+    std::array<std::array<State, NUM_MOVES>, NUM_STATES> next_;
+
+    State transition(State state, Move move) const;
+};
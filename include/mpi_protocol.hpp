@@ -0,0 +1,228 @@
+#pragma once
+#include "cubie_cube.hpp"
+#include "move.hpp"
+#include "solve_stats.hpp"
+#include <mpi.h>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// Messages between rank 0 (the HTTP front end) and the worker ranks.
+//
+// The workers are split into groups, each on its own communicator (see
+// MPIScheduler). Rank 0 sends a job, one fixed-size record, to a group's
+// leader (group rank 0) with TAG_JOB; the leader broadcasts it to the rest
+// of its group, and the group solves it together. Members wait for the
+// broadcast, and leaders for rank 0's message, with a sleep backoff, so an
+// idle worker uses almost no CPU. The leader sends the outcome back with
+// TAG_RESULT; rank 0 may cancel a running job with TAG_CANCEL.
+
+// RESPLIT: every group re-forms with the group size carried in jobId
+enum class JobCommand : uint8_t { SOLVE = 1, SHUTDOWN = 2, RESPLIT = 3 };
+enum class SolverKind : uint8_t { MPI = 1, HYBRID = 2 };
+
+struct SolveJob {
+    // Bit-fields can't have default member initializers before C++20
+    SolveJob() : usePatternDatabase(0), halfTurnMetric(0) {}
+
+    uint32_t jobId = 0;
+    JobCommand command = JobCommand::SOLVE;
+    SolverKind solver = SolverKind::MPI;
+    uint8_t usePatternDatabase : 1;
+    uint8_t halfTurnMetric : 1;
+    uint8_t maxDepth = 20;
+    float timeLimit = 0.0f;  // seconds from receipt; relative, clocks differ across nodes
+    CubieCube cube;
+};
+
+static_assert(sizeof(SolveJob) == 32, "SolveJob is sent as 32 raw bytes");
+static_assert(std::is_trivially_copyable<SolveJob>::value,
+              "SolveJob must be trivially copyable");
+
+// Point-to-point tags on MPI_COMM_WORLD between rank 0 and group leaders
+constexpr int TAG_JOB = 201;     // SolveJob, rank 0 -> leader
+constexpr int TAG_CANCEL = 202;  // uint32_t jobId, rank 0 -> leader
+constexpr int TAG_RESULT = 203;  // PackedJobResult, leader -> rank 0
+
+// Sleep between tests of a pending message: 50 us doubling up to 2 ms,
+// which bounds dispatch latency while idle ranks stay quiet
+class Backoff {
+public:
+    void wait() {
+        std::this_thread::sleep_for(delay_);
+        if (delay_ < std::chrono::microseconds(2000)) delay_ *= 2;
+    }
+
+private:
+    std::chrono::microseconds delay_{50};
+};
+
+// Rank 0 of comm: send a job to the other ranks of comm
+inline void broadcastJob(SolveJob& job, MPI_Comm comm = MPI_COMM_WORLD) {
+    MPI_Request request;
+    MPI_Ibcast(&job, sizeof(SolveJob), MPI_BYTE, 0, comm, &request);
+    MPI_Wait(&request, MPI_STATUS_IGNORE);
+}
+
+// The other ranks of comm: wait for the next job. Blocking and
+// non-blocking collectives do not match each other, so rank 0 of comm
+// must use broadcastJob.
+inline SolveJob receiveJob(MPI_Comm comm = MPI_COMM_WORLD) {
+    SolveJob job;
+    MPI_Request request;
+    MPI_Ibcast(&job, sizeof(SolveJob), MPI_BYTE, 0, comm, &request);
+
+    Backoff backoff;
+    int done = 0;
+    MPI_Test(&request, &done, MPI_STATUS_IGNORE);
+    while (!done) {
+        backoff.wait();
+        MPI_Test(&request, &done, MPI_STATUS_IGNORE);
+    }
+    return job;
+}
+
+// Where a group leader hears that rank 0 cancelled its job. Cancels for
+// jobs that already finished are dropped.
+struct JobControl {
+    MPI_Comm comm = MPI_COMM_NULL;
+    int root = 0;
+    uint32_t jobId = 0;
+
+    bool cancelled() const {
+        if (comm == MPI_COMM_NULL) return false;
+        bool hit = false;
+        while (true) {
+            int pending = 0;
+            MPI_Iprobe(root, TAG_CANCEL, comm, &pending, MPI_STATUS_IGNORE);
+            if (!pending) return hit;
+            uint32_t id = 0;
+            MPI_Recv(&id, 1, MPI_UINT32_T, root, TAG_CANCEL, comm, MPI_STATUS_IGNORE);
+            hit = hit || id == jobId;
+        }
+    }
+};
+
+// A solution travels as one fixed 64-byte message: length, then one byte
+// per move
+struct PackedSolution {
+    static constexpr int MAX_MOVES = 63;
+    uint8_t length = 0;
+    uint8_t moves[MAX_MOVES] = {};
+};
+
+static_assert(sizeof(PackedSolution) == 64, "PackedSolution is one 64-byte message");
+
+// Collective: every rank ends up with root's solution
+inline void broadcastSolution(std::vector<Move>& solution, int root, MPI_Comm comm = MPI_COMM_WORLD) {
+    int rank;
+    MPI_Comm_rank(comm, &rank);
+
+    PackedSolution packed;
+    if (rank == root) {
+        if (solution.size() > static_cast<size_t>(PackedSolution::MAX_MOVES)) {
+            throw std::length_error("Solution too long to broadcast");
+        }
+        packed.length = static_cast<uint8_t>(solution.size());
+        std::memcpy(packed.moves, solution.data(), solution.size());
+    }
+
+    MPI_Bcast(&packed, sizeof(PackedSolution), MPI_BYTE, root, comm);
+
+    if (rank != root) {
+        solution.assign(reinterpret_cast<const Move*>(packed.moves),
+                        reinterpret_cast<const Move*>(packed.moves) + packed.length);
+    }
+}
+
+// Batch mode: one solved position on its way back to rank 0. A length of
+// UNSOLVED marks a position that was not solved.
+struct PackedBatchResult {
+    static constexpr uint8_t UNSOLVED = 0xFF;
+    PackedSolution solution;
+    uint64_t nodes = 0;
+    double time = 0.0;
+};
+
+static_assert(sizeof(PackedBatchResult) == 80, "PackedBatchResult is sent as 80 raw bytes");
+
+// SearchCounters as a flat array of uint64_t, for reductions and messages
+struct PackedCounters {
+    static constexpr int FIELDS = 6;
+    static constexpr int SIZE = FIELDS + SearchCounters::MAX_DEPTH;
+    uint64_t values[SIZE] = {};
+
+    PackedCounters() = default;
+    explicit PackedCounters(const SearchCounters& counters) {
+        const uint64_t fields[FIELDS] = {
+            counters.nodes, counters.heuristicEvaluations, counters.boundCutoffs,
+            counters.sequencePruned, counters.tableProbes, counters.tableCutoffs};
+        std::memcpy(values, fields, sizeof(fields));
+        std::memcpy(values + FIELDS, counters.nodesPerDepth.data(), sizeof(counters.nodesPerDepth));
+    }
+
+    SearchCounters unpack() const {
+        SearchCounters counters;
+        counters.nodes = values[0];
+        counters.heuristicEvaluations = values[1];
+        counters.boundCutoffs = values[2];
+        counters.sequencePruned = values[3];
+        counters.tableProbes = values[4];
+        counters.tableCutoffs = values[5];
+        std::memcpy(counters.nodesPerDepth.data(), values + FIELDS, sizeof(counters.nodesPerDepth));
+        return counters;
+    }
+};
+
+// A group's answer to one job, from its leader to rank 0
+struct PackedJobResult {
+    uint32_t jobId = 0;
+    uint8_t found = 0;
+    uint8_t stopped = 0;      // deadline or cancel
+    uint8_t reserved[2] = {};
+    double time = 0.0;        // seconds on the group
+    PackedSolution solution;
+    PackedCounters counters;  // summed over the group
+};
+
+static_assert(std::is_trivially_copyable<PackedJobResult>::value,
+              "PackedJobResult must be trivially copyable");
+
+// Collective: sum the counters of every rank, and gather each rank's
+// per-worker node counts into workerNodes, rank-major. Every rank gets the
+// same result.
+inline SearchCounters reduceCounters(const SearchCounters& local,
+                                     const std::vector<uint64_t>& localWorkers,
+                                     std::vector<uint64_t>& workerNodes,
+                                     MPI_Comm comm = MPI_COMM_WORLD) {
+    PackedCounters packed(local);
+    MPI_Allreduce(MPI_IN_PLACE, packed.values, PackedCounters::SIZE, MPI_UINT64_T, MPI_SUM, comm);
+    SearchCounters total = packed.unpack();
+
+    int size;
+    MPI_Comm_size(comm, &size);
+    int count = static_cast<int>(localWorkers.size());
+    std::vector<int> counts(size), offsets(size, 0);
+    MPI_Allgather(&count, 1, MPI_INT, counts.data(), 1, MPI_INT, comm);
+    for (int i = 1; i < size; ++i) offsets[i] = offsets[i - 1] + counts[i - 1];
+    workerNodes.assign(offsets[size - 1] + counts[size - 1], 0);
+    MPI_Allgatherv(localWorkers.data(), count, MPI_UINT64_T, workerNodes.data(),
+                   counts.data(), offsets.data(), MPI_UINT64_T, comm);
+    return total;
+}
+
+// Collective over MPI_COMM_WORLD: this rank's index among the ranks that
+// share its node, and how many they are
+inline void nodeLocalRank(int& localRank, int& localRanks) {
+    int rank;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm node;
+    MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, rank, MPI_INFO_NULL, &node);
+    MPI_Comm_rank(node, &localRank);
+    MPI_Comm_size(node, &localRanks);
+    MPI_Comm_free(&node);
+}
@@ -0,0 +1,165 @@
+// include/mpi_scheduler.hpp
+#pragma once
+#include "solver.hpp"
+#include "mpi_protocol.hpp"
+#include <mpi.h>
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// How the worker ranks (world ranks 1..workers) are split into groups:
+// consecutive runs of groupSize ranks, any remainder joining the last group
+struct MPIGroupLayout {
+    int workers = 1;
+    int groupSize = 1;
+
+    int groupCount() const { return std::max(1, workers / groupSize); }
+    int groupOf(int worker) const { return std::min(worker / groupSize, groupCount() - 1); }
+    int leaderOf(int group) const { return 1 + group * groupSize; }  // world rank
+    int sizeOf(int group) const {
+        return group == groupCount() - 1 ? workers - group * groupSize : groupSize;
+    }
+
+    // The group size for demand jobs at once: a group per job, each as
+    // large as that allows, but no smaller than minSize. One job (or none)
+    // gets every worker.
+    static int chooseGroupSize(int workers, size_t demand, int minSize) {
+        int size = demand <= 1 ? workers : static_cast<int>(workers / demand);
+        return std::max(std::min(std::max(size, minSize), workers), 1);
+    }
+};
+
+// Rank 0's side of the worker groups. Each group has its own communicator
+// from MPI_Comm_split and solves one job at a time, so independent MPI
+// solves run side by side on different groups instead of queueing for
+// the whole world. Jobs wait in a FIFO queue for an idle group.
+//
+// The layout follows the load: whenever every group is idle and jobs are
+// waiting, the groups are re-formed (one collective split over the world)
+// at the size chooseGroupSize() picks for the queue depth: one group of
+// every worker for a lone request, the lowest latency, and smaller groups
+// as the queue grows, the most throughput.
+//
+// One dispatch thread makes all of rank 0's MPI calls; solve threads only
+// touch the queue, so MPI_THREAD_SERIALIZED is enough.
+class MPIScheduler {
+public:
+    using Clock = CancellationToken::Clock;
+
+    // What the group sent back
+    struct Outcome {
+        bool found = false;
+        bool stopped = false;  // deadline or cancel, possibly before it ran
+        std::vector<Move> solution;
+        SearchCounters counters;
+        double time = 0.0;     // on the group, excluding the wait in the queue
+    };
+
+    struct GroupStatus {
+        int leader = 0;        // world rank
+        int size = 0;
+        uint32_t jobId = 0;    // 0 when idle
+        SolverKind solver = SolverKind::MPI;
+        double seconds = 0.0;  // on the current job
+        uint64_t completed = 0;
+    };
+
+    struct Status {
+        int workers = 0;
+        int groupSize = 0;
+        int minGroupSize = 0;
+        size_t queued = 0;
+        uint64_t completed = 0;
+        uint64_t resizes = 0;
+        std::vector<GroupStatus> groups;
+    };
+
+    class Job;
+    using JobHandle = std::shared_ptr<Job>;
+
+    // Rank 0 only, and collective with runMPIWorker() on every other rank:
+    // forms the first layout (one group of every worker) and starts the
+    // dispatch thread. Groups never get smaller than minGroupSize.
+    explicit MPIScheduler(int minGroupSize = 1);
+    ~MPIScheduler();
+    MPIScheduler(const MPIScheduler&) = delete;
+    MPIScheduler& operator=(const MPIScheduler&) = delete;
+
+    // Queue job (its jobId and timeLimit are filled in); it is dropped as
+    // stopped if deadline passes before a group takes it
+    JobHandle submit(SolveJob job, Clock::time_point deadline);
+
+    // Blocks until the job is done. stop is polled every few milliseconds;
+    // once it returns true the job is cancelled, wherever it is.
+    Outcome wait(const JobHandle& job, const std::function<bool()>& stop);
+
+    int getWorkers() const { return layout_.workers; }
+    size_t idleGroups() const;
+    Status getStatus() const;
+
+    // Cancels every job, waits for the running ones and releases the
+    // workers from runMPIWorker(). Called by the destructor.
+    void shutdown();
+
+private:
+    struct Group {
+        int leader;
+        int size;
+        JobHandle job;
+        Clock::time_point started;
+        uint64_t completed = 0;
+    };
+
+    void run();
+    void formGroups(int groupSize);
+    void finish(const JobHandle& job, Outcome outcome);
+    bool collectResults();
+
+    const int minGroupSize_;
+    MPIGroupLayout layout_;
+    mutable std::mutex mutex_;
+    std::condition_variable wakeup_;    // the dispatch thread: new work
+    std::condition_variable finished_;  // waiters: a job is done
+    std::deque<JobHandle> queue_;
+    std::vector<Group> groups_;
+    uint32_t nextJobId_ = 0;
+    uint64_t completed_ = 0;
+    uint64_t resizes_ = 0;
+    bool stopping_ = false;
+    std::thread dispatcher_;
+};
+
+// A Solver that hands its solve to a worker group. HTTPServer lends these
+// out as "mpi" and "hybrid"; the searching happens in an MPISolver or
+// HybridSolver on the group's ranks.
+class MPIJobSolver : public Solver {
+public:
+    MPIJobSolver(std::shared_ptr<MPIScheduler> scheduler, SolverKind kind)
+        : scheduler_(std::move(scheduler)), kind_(kind) {}
+
+    std::vector<std::string> solve(RubiksCube& cube, int maxDepth = 20) override;
+    std::string getName() const override {
+        return kind_ == SolverKind::HYBRID ? "Hybrid (MPI+OpenMP IDA*)" : "MPI (IDA*)";
+    }
+    std::unique_ptr<Solver> clone() const override {
+        auto copy = std::make_unique<MPIJobSolver>(scheduler_, kind_);
+        copySettingsTo(*copy);
+        return copy;
+    }
+    bool canClone() const override { return true; }
+
+private:
+    std::shared_ptr<MPIScheduler> scheduler_;
+    SolverKind kind_;
+};
+
+// Every rank but 0: serve jobs in whatever group this rank is in until
+// rank 0's MPIScheduler shuts down
+void runMPIWorker();
@@ -1,6 +1,9 @@
 #pragma once
 #include "solver.hpp"
 #include "rubiks_cube.hpp"
+#include "cubie_cube.hpp"
+#include "move.hpp"
+#include "mpi_protocol.hpp"
 #include <mpi.h>
 #include <chrono>
 
@@ -12,6 +15,24 @@ public:
     std::vector<std::string> solve(RubiksCube& cube, int maxDepth = 20) override;
     std::string getName() const override { return "MPI (IDA*)"; }
     
+    // STATIC deals the 12 root moves round-robin. DYNAMIC (default) lets
+    // rank 0 hand out the nodes at splitDepth one at a time, so any number
+    // of ranks stays busy. Every rank must use the same settings.
+    enum class Distribution { STATIC, DYNAMIC };
+    static constexpr int DEFAULT_SPLIT_DEPTH = 3;
+    
+    void setDistribution(Distribution distribution) { distribution_ = distribution; }
+    Distribution getDistribution() const { return distribution_; }
+    void setSplitDepth(int depth) { splitDepth_ = depth < 1 ? 1 : depth; }
+    
+    // Search on comm instead of MPI_COMM_WORLD; every rank of comm must
+    // call solve() with the same settings
+    void setCommunicator(MPI_Comm comm);
+    // Rank 0 of the communicator stops the search, and with it the other
+    // ranks, once control reports a cancel. The cancel goes to the solver's
+    // token, so give it a token of its own.
+    void setJobControl(JobControl control) { control_ = control; }
+    
     static void Initialize(int* argc, char*** argv);
     static void Finalize();
     static bool IsInitialized() { return initialized_; }
@@ -20,16 +41,57 @@ public:
     int getSize() const { return size_; }
     
 private:
+    MPI_Comm comm_ = MPI_COMM_WORLD;
     int rank_;
     int size_;
+    JobControl control_;
     static bool initialized_;
     
-    std::vector<std::string> solution_;
+    std::vector<Move> solution_;
     int maxDepth_;
+    SearchCounters counters_;
+    
+    // Tags for the dynamic work pool
+    static constexpr int TAG_WORK_REQUEST = 101;
+    static constexpr int TAG_WORK_ASSIGN = 102;
+    static constexpr int TAG_FOUND = 103;
+    
+    struct FrontierNode {
+        CubieCube cube;
+        std::vector<Move> path;
+        MoveSequenceAutomaton::State sequence;
+    };
+    
+    Distribution distribution_ = Distribution::DYNAMIC;
+    int splitDepth_ = DEFAULT_SPLIT_DEPTH;
+    std::vector<FrontierNode> frontier_;
+    
+    // Per-iteration state of the dynamic mode
+    int nextTask_ = 0;
+    int finishedWorkers_ = 0;
+    int stopFlag_ = 0;
+    bool stopPosted_ = false;
+    bool remoteStop_ = false;
+    bool polling_ = false;
+    MPI_Request stopRequest_ = MPI_REQUEST_NULL;
+    
+    // IDAStar policy: serves (rank 0) or polls the work pool every 1024
+    // nodes, and unwinds once any rank has found a solution
+    struct RankPolicy {
+        MPISolver& solver;
+        bool stop(uint64_t nodes) {
+            if (solver.polling_ && (nodes & 0x3FF) == 0) solver.pollMessages();
+            return solver.remoteStop_ || solver.shouldStop(nodes);
+        }
+        bool complete() const { return !solver.remoteStop_ && !solver.wasStopped(); }
+    };
+    RankPolicy policy_{*this};
     
-    int heuristic(const RubiksCube& cube) const;
-    int idaSearch(RubiksCube& cube, int g, int threshold, const std::string& lastMove,
-                  std::vector<std::string>& path, double timeLimit,
-                  std::chrono::high_resolution_clock::time_point startTime);
-    bool isRedundantMove(const std::string& lastMove, const std::string& nextMove) const;
+    int searchStatic(const CubieCube& start, int threshold, std::vector<Move>& localSolution);
+    int searchDynamic(int threshold, std::vector<Move>& localSolution);
+    void buildFrontier(const CubieCube& start);
+    void postStop(int flag);
+    void serveRequests(bool block);
+    void pollMessages();
+    void checkCancel();
 };
@@ -1,26 +1,64 @@
 #pragma once
 #include "solver.hpp"
 #include "rubiks_cube.hpp"
+#include "cubie_cube.hpp"
+#include "move.hpp"
+#include "thread_placement.hpp"
 #include <omp.h>
+#include <atomic>
 #include <chrono>
 
+// Task-parallel IDA*. Each threshold iteration expands the tree to
+// splitDepth as nested OpenMP tasks; every node at the split depth becomes
+// one task that runs a sequential IDA* on its subtree. Idle threads steal
+// tasks from the runtime's queues, so unbalanced subtrees no longer leave
+// cores idle. splitDepth 1 is the old root-move split.
 class OpenMPSolver : public Solver {
 public:
-    OpenMPSolver(int numThreads = 4);
+    static constexpr int DEFAULT_SPLIT_DEPTH = 3;
+
+    // numThreads 0 uses ThreadPlacement's count for this rank (OMP_NUM_THREADS
+    // if set, else one per CPU of the rank's share)
+    OpenMPSolver(int numThreads = 0, int splitDepth = DEFAULT_SPLIT_DEPTH);
     std::vector<std::string> solve(RubiksCube& cube, int maxDepth = 20) override;
     std::string getName() const override { return "OpenMP (IDA*)"; }
-    
+    std::unique_ptr<Solver> clone() const override {
+        auto copy = std::make_unique<OpenMPSolver>(numThreads_, splitDepth_);
+        copySettingsTo(*copy);
+        return copy;
+    }
+    bool canClone() const override { return true; }
+
     int getNumThreads() const { return numThreads_; }
-    
+    int getSplitDepth() const { return splitDepth_; }
+    void setSplitDepth(int depth) { splitDepth_ = depth; }
+
 private:
+    // Written by one thread only, and allocated by it, on its own node;
+    // padded so neighbours don't share a line
+    struct alignas(64) ThreadState {
+        int minNext;
+        SearchCounters counters;
+    };
+
     int numThreads_;
-    std::vector<std::string> solution_;
-    int maxDepth_;
-    bool solutionFound_;
-    
-    int heuristic(const RubiksCube& cube) const;
-    int idaSearchParallel(RubiksCube& cube, int g, int threshold,
-                         const std::string& lastMove, std::vector<std::string>& path,
-                         double timeLimit, std::chrono::high_resolution_clock::time_point startTime);
-    bool isRedundantMove(const std::string& lastMove, const std::string& nextMove) const;
+    int splitDepth_;
+    std::vector<Move> solution_;
+    std::atomic<bool> solutionFound_{false};
+    PerThread<ThreadState> threadState_;
+
+    // IDAStar policy: every task unwinds once one of them found a solution
+    struct TaskPolicy {
+        OpenMPSolver& solver;
+        bool stop(uint64_t nodes) {
+            return solver.solutionFound_.load(std::memory_order_relaxed) || solver.shouldStop(nodes);
+        }
+        bool complete() const {
+            return !solver.wasStopped() && !solver.solutionFound_.load(std::memory_order_relaxed);
+        }
+    };
+
+    void searchTask(const CubieCube& cube, int g, int threshold,
+                    MoveSequenceAutomaton::State sequence, std::vector<Move>& path);
+    void recordSolution(const std::vector<Move>& path);
 };
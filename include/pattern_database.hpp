@@ -0,0 +1,86 @@
+#pragma once
+#include "cubie_cube.hpp"
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <string>
+#include <vector>
+
+// One pattern table: exact half-turn-metric distance to solved for the
+// positions and orientations of a subset of corner or edge cubies.
+// Distances are stored as 4-bit entries, two per byte.
+class PatternTable {
+public:
+    enum class Kind : uint8_t { CORNERS = 0, EDGES = 1 };
+
+    PatternTable(Kind kind, const std::vector<int>& pieces);
+
+    Kind getKind() const { return kind_; }
+    const std::vector<int>& getPieces() const { return pieces_; }
+    uint64_t getEntryCount() const { return entries_; }
+    uint64_t getByteCount() const { return (entries_ + 1) / 2; }
+
+    // Index of the tracked pieces of a cube in this table
+    uint64_t index(const CubieCube& cube) const;
+    int lookup(const CubieCube& cube) const { return get(index(cube)); }
+
+    // Fill the table by breadth-first search from the solved cube
+    void generate(std::ostream* log = nullptr);
+
+    // Use externally owned (e.g. memory-mapped) table contents
+    void attach(const uint8_t* data) { data_ = data; owned_.clear(); }
+    const uint8_t* data() const { return owned_.empty() ? data_ : owned_.data(); }
+
+private:
+    Kind kind_;
+    std::vector<int> pieces_;
+    int slots_;            // 8 corners or 12 edges
+    int orientations_;     // 3 twists or 2 flips
+    bool lastOriImplied_;  // all pieces tracked: last orientation is fixed
+    uint64_t permutations_;
+    uint64_t orientationCount_;
+    uint64_t entries_;
+    int tracked_[12];      // cubie -> index in pieces_, or -1
+
+    const uint8_t* data_ = nullptr;
+    std::vector<uint8_t> owned_;
+
+    int get(uint64_t idx) const { return (data()[idx >> 1] >> ((idx & 1) * 4)) & 0x0F; }
+    void set(uint64_t idx, int value);
+
+    uint64_t rank(const int* pos, const int* ori) const;
+    void unrank(uint64_t idx, int* pos, int* ori) const;
+};
+
+// A set of pattern tables combined by taking the maximum, stored in a
+// versioned binary file that is memory-mapped read-only so every process
+// on a node shares the same physical pages.
+class PatternDatabase {
+public:
+    static constexpr uint32_t FORMAT_VERSION = 1;
+
+    PatternDatabase() = default;
+    ~PatternDatabase();
+    PatternDatabase(const PatternDatabase&) = delete;
+    PatternDatabase& operator=(const PatternDatabase&) = delete;
+
+    // Corner table plus two 6-edge tables (about 86 MB on disk)
+    static std::unique_ptr<PatternDatabase> createDefault();
+
+    void addTable(PatternTable::Kind kind, const std::vector<int>& pieces);
+    void generate(std::ostream* log = nullptr);
+
+    void save(const std::string& path) const;
+    static std::shared_ptr<const PatternDatabase> load(const std::string& path);
+
+    // Admissible lower bound on the distance to solved
+    int estimate(const CubieCube& cube) const;
+
+    const std::vector<PatternTable>& getTables() const { return tables_; }
+    uint64_t getByteCount() const;
+
+private:
+    std::vector<PatternTable> tables_;
+    void* mapping_ = nullptr;
+    size_t mappingSize_ = 0;
+};
@@ -1,10 +1,15 @@
 #pragma once
+#include "move.hpp"
+#include "facelet_kernel.hpp"
 #include <array>
+#include <cstdint>
 #include <string>
 #include <vector>
 #include <random>
 #include <sstream>
 
+class JSONWriter;
+
 // Represents a 3x3x3 Rubik's Cube
 class RubiksCube {
 public:
@@ -23,7 +28,10 @@ public:
     
     // Core operations
     void reset();
+    // Random, redundancy-free face turns (see Scrambler); the seeded form
+    // is reproducible
     void scramble(int moves = 20);
+    void scramble(int moves, uint64_t seed);
     bool isSolved() const;
     
     // Move operations (clockwise 90 degrees)
@@ -50,7 +58,8 @@ public:
     void moveF2();
     void moveB2();
     
-    // Apply move from string notation
+    // Apply move by id or from string notation
+    void applyMove(Move move);
     void applyMove(const std::string& move);
     void applyMoves(const std::vector<std::string>& moves);
     
@@ -60,6 +69,9 @@ public:
     // Serialization
     std::string toString() const;
     std::string toJSON() const;
+    // The members of toJSON() into an open object: "faces" and "isSolved",
+    // or with compact the 54-character "state" in place of "faces"
+    void writeJSON(JSONWriter& json, bool compact = false) const;
     void fromString(const std::string& state);
     
     // Get all possible moves
@@ -77,25 +89,13 @@ public:
     size_t hash() const;
     
     // Get face color
-    char getFaceCenter(Face face) const { return faces_[face][4]; }
-    char getSticker(Face face, int position) const { return faces_[face][position]; }
+    char getFaceCenter(Face face) const { return stickers_[face * 9 + 4]; }
+    char getSticker(Face face, int position) const { return stickers_[face * 9 + position]; }
     
 private:
-    // 6 faces, each with 9 stickers
-    std::array<std::array<char, 9>, 6> faces_;
-    
-    // Helper functions
-    void rotateFaceClockwise(Face face);
-    void rotateFaceCounterClockwise(Face face);
-    void rotateFace180(Face face);
-    
-    // Edge rotations
-    void rotateEdgesClockwise(
-        Face f1, int e1a, int e1b, int e1c,
-        Face f2, int e2a, int e2b, int e2c,
-        Face f3, int e3a, int e3b, int e3c,
-        Face f4, int e4a, int e4b, int e4c
-    );
+    // 6 faces of 9 stickers, face * 9 + position, in one aligned block
+    // that FaceletKernel permutes whole; the padding stays zero
+    alignas(64) std::array<char, FaceletKernel::BLOCK_BYTES> stickers_;
 };
 
 // Hash function for use in unordered containers
@@ -0,0 +1,40 @@
+// include/scrambler.hpp
+#pragma once
+#include "cubie_cube.hpp"
+#include "move.hpp"
+#include <cstdint>
+#include <random>
+#include <vector>
+
+// Seeded source of scrambles. The same seed gives the same scrambles on
+// every platform: the engine is std::mt19937_64 and the bounded draws are
+// done here rather than by the implementation-defined std distributions.
+//
+// randomMoves() never turns the same face twice in a row and turns
+// opposite faces in one order only (U D, never D U), so no adjacent moves
+// cancel or merge. randomState() samples uniformly over all reachable
+// states, which a random walk of any practical length does not.
+class Scrambler {
+public:
+    explicit Scrambler(uint64_t seed = randomSeed());
+
+    void seed(uint64_t seed);
+    uint64_t getSeed() const { return seed_; }
+
+    std::vector<Move> randomMoves(int length, bool quarterTurnsOnly = false);
+    CubieCube randomState();
+
+    // Uniform in [0, n)
+    uint64_t uniform(uint64_t n);
+
+    // Nondeterministic seed, for callers that don't pick one
+    static uint64_t randomSeed();
+
+    // Seed of the stream-th independent stream derived from seed. Work split
+    // into streams comes out the same whatever the number of threads.
+    static uint64_t streamSeed(uint64_t seed, uint64_t stream);
+
+private:
+    uint64_t seed_;
+    std::mt19937_64 rng_;
+};
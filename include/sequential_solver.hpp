@@ -2,6 +2,8 @@
 #pragma once
 #include "solver.hpp"
 #include "rubiks_cube.hpp"
+#include "cubie_cube.hpp"
+#include "move.hpp"
 #include <chrono>
 
 class SequentialSolver : public Solver {
@@ -9,14 +11,15 @@ public:
     SequentialSolver() = default;
     std::vector<std::string> solve(RubiksCube& cube, int maxDepth = 20) override;
     std::string getName() const override { return "Sequential (IDA*)"; }
+    std::unique_ptr<Solver> clone() const override {
+        auto copy = std::make_unique<SequentialSolver>();
+        copySettingsTo(*copy);
+        return copy;
+    }
+    bool canClone() const override { return true; }
     
 private:
-    std::vector<std::string> solution_;
-    std::vector<std::string> currentPath_;
-    int maxDepth_;
-    
-    int heuristic(const RubiksCube& cube) const;
-    int idaSearch(RubiksCube& cube, int g, int threshold, const std::string& lastMove,
-                  double timeLimit, std::chrono::high_resolution_clock::time_point startTime);
-    bool isRedundantMove(const std::string& lastMove, const std::string& nextMove) const;
+    std::vector<Move> solution_;
+    std::vector<Move> currentPath_;
+    SearchCounters counters_;
 };
\ No newline at end of file
@@ -0,0 +1,69 @@
+// include/session_store.hpp
+#pragma once
+#include "rubiks_cube.hpp"
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Cube state per client session, keyed by an unguessable random id.
+//
+// Sessions are spread over independently locked shards, so clients working
+// on different sessions rarely contend. Each shard keeps its sessions in
+// least-recently-used order and holds at most maxSessions / numShards of
+// them: creating one more evicts the shard's least recently used session,
+// and sessions idle for longer than the TTL are dropped as they are found.
+// Memory is therefore bounded by maxSessions regardless of client
+// behaviour; a client whose session was evicted gets "not found" and starts
+// a new one.
+class SessionStore {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr size_t DEFAULT_SHARDS = 16;
+    static constexpr size_t DEFAULT_MAX_SESSIONS = 16384;
+    static constexpr std::chrono::seconds DEFAULT_TTL{30 * 60};
+
+    explicit SessionStore(size_t maxSessions = DEFAULT_MAX_SESSIONS,
+                          std::chrono::seconds ttl = DEFAULT_TTL,
+                          size_t numShards = DEFAULT_SHARDS);
+
+    // New session holding a solved cube; returns its id
+    std::string create();
+
+    // Run fn on the session's cube under its shard lock and mark it used.
+    // False (fn not called) if the id is unknown or the session expired.
+    bool withSession(const std::string& id, const std::function<void(RubiksCube&)>& fn);
+
+    bool erase(const std::string& id);
+    size_t size() const;
+    size_t capacity() const { return shards_.size() * perShard_; }
+
+    // 128 bits from the OS CSPRNG as 32 hex digits; also used for job ids
+    static std::string generateId();
+
+private:
+    struct Session {
+        std::string id;
+        RubiksCube cube;
+        Clock::time_point lastUsed;
+    };
+
+    struct Shard {
+        mutable std::mutex mutex;
+        std::list<Session> lru;  // most recently used first
+        std::unordered_map<std::string, std::list<Session>::iterator> index;
+    };
+
+    std::vector<std::unique_ptr<Shard>> shards_;
+    size_t perShard_;
+    Clock::duration ttl_;
+
+    Shard& shardFor(const std::string& id);
+    void evictExpired(Shard& shard, Clock::time_point now);
+};
@@ -0,0 +1,103 @@
+// include/solution_cache.hpp
+#pragma once
+#include "solver.hpp"
+#include "cubie_cube.hpp"
+#include "move.hpp"
+#include "rubiks_cube.hpp"
+#include <atomic>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Solutions of previously solved positions, shared by all clients.
+//
+// Entries are keyed on the symmetry-canonical position (see CubeSymmetry)
+// in its 20-byte cubie form, so the 48 rotated and mirrored variants of a
+// position share an entry. The solution is mapped through the symmetry on
+// the way in and out. Each solver gets its own entries: an optimal search
+// must not be answered with a two-phase solution.
+//
+// The cache is split into independently locked shards, each in LRU order,
+// holding at most `capacity` entries in total. save() and load() keep the
+// contents across restarts (host byte order, like the pattern database).
+class SolutionCache {
+public:
+    static constexpr size_t DEFAULT_CAPACITY = 1 << 16;
+    static constexpr size_t DEFAULT_SHARDS = 16;
+    static constexpr uint32_t FORMAT_VERSION = 1;
+
+    explicit SolutionCache(size_t capacity = DEFAULT_CAPACITY, size_t numShards = DEFAULT_SHARDS);
+
+    // A cached solution for cube no longer than maxDepth. Counts a hit or miss.
+    bool lookup(const std::string& solver, const RubiksCube& cube, int maxDepth,
+                std::vector<std::string>& solution);
+
+    // Remember a solution; an existing shorter one is kept
+    void store(const std::string& solver, const RubiksCube& cube,
+               const std::vector<std::string>& solution);
+
+    // Throw std::runtime_error on I/O errors or a bad file; load() returns
+    // the number of entries read
+    void save(const std::string& path) const;
+    size_t load(const std::string& path);
+
+    void clear();
+    size_t size() const;
+    size_t capacity() const { return shards_.size() * perShard_; }
+    uint64_t getHits() const { return hits_.load(std::memory_order_relaxed); }
+    uint64_t getMisses() const { return misses_.load(std::memory_order_relaxed); }
+
+private:
+    struct Key {
+        uint32_t solver;
+        CubieCube cube;
+        bool operator==(const Key& other) const { return solver == other.solver && cube == other.cube; }
+    };
+    struct KeyHash {
+        size_t operator()(const Key& key) const {
+            return key.cube.hash() ^ (static_cast<size_t>(key.solver) * 0x9E3779B97F4A7C15ULL);
+        }
+    };
+    struct Entry {
+        Key key;
+        std::vector<Move> solution;
+    };
+    struct Shard {
+        mutable std::mutex mutex;
+        std::list<Entry> lru;  // most recently used first
+        std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> index;
+    };
+
+    std::vector<std::unique_ptr<Shard>> shards_;
+    size_t perShard_;
+    std::atomic<uint64_t> hits_{0};
+    std::atomic<uint64_t> misses_{0};
+
+    Shard& shardFor(const Key& key);
+    void insert(const Key& key, std::vector<Move> solution);
+    static uint32_t solverId(const std::string& solver);
+};
+
+// Answers from the cache when it can, otherwise runs the wrapped solver and
+// caches what it finds. Configure the wrapped solver (heuristic, time limit)
+// through inner().
+class CachedSolver : public Solver {
+public:
+    CachedSolver(std::unique_ptr<Solver> inner, std::shared_ptr<SolutionCache> cache);
+
+    std::vector<std::string> solve(RubiksCube& cube, int maxDepth = 20) override;
+    std::string getName() const override { return inner_->getName(); }
+    uint64_t getNodesExplored() const override { return lastHit_ ? 0 : inner_->getNodesExplored(); }
+
+    Solver& inner() { return *inner_; }
+    bool lastWasHit() const { return lastHit_; }
+
+private:
+    std::unique_ptr<Solver> inner_;
+    std::shared_ptr<SolutionCache> cache_;
+    bool lastHit_ = false;
+};
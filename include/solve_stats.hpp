@@ -0,0 +1,98 @@
+// include/solve_stats.hpp
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+class JSONWriter;
+
+// Counters one search thread bumps at every node. Each thread (or rank) has
+// its own, padded to a cache line, and they are merged once the solve ends,
+// so the search never writes to shared memory.
+struct alignas(64) SearchCounters {
+    static constexpr int MAX_DEPTH = 64;
+
+    uint64_t nodes = 0;
+    uint64_t heuristicEvaluations = 0;
+    uint64_t boundCutoffs = 0;      // nodes whose f exceeded the threshold
+    uint64_t sequencePruned = 0;    // moves the move-sequence automaton ruled out
+    uint64_t tableProbes = 0;       // transposition table lookups
+    uint64_t tableCutoffs = 0;      // lookups whose bound pruned the node
+    std::array<uint64_t, MAX_DEPTH> nodesPerDepth{};
+
+    void visit(int g) {
+        ++nodes;
+        ++nodesPerDepth[std::min(g, MAX_DEPTH - 1)];
+    }
+
+    void add(const SearchCounters& other);
+};
+
+// One IDA* iteration (for two-phase, one phase-1 depth)
+struct IterationStats {
+    int threshold;
+    uint64_t nodes;
+    double seconds;
+};
+
+// Everything measured during one solve()
+struct SolveStats {
+    std::string solver;
+    bool solved = false;
+    bool stopped = false;           // deadline or cancel
+    bool cached = false;            // answered from the solution cache
+    int solutionLength = 0;
+    double time = 0.0;
+    uint64_t nodes = 0;
+    uint64_t heuristicEvaluations = 0;
+    uint64_t boundCutoffs = 0;
+    uint64_t sequencePruned = 0;
+    uint64_t tableProbes = 0;
+    uint64_t tableCutoffs = 0;
+    std::vector<uint64_t> nodesPerDepth;  // index = g; trailing zeros dropped
+    std::vector<IterationStats> iterations;
+    // Nodes searched by each worker: threads for OpenMP, ranks for MPI,
+    // rank-major then thread for hybrid
+    std::vector<uint64_t> workerNodes;
+
+    double nodesPerSecond() const { return time > 0.0 ? nodes / time : 0.0; }
+
+    // Copy the merged counters in (nodesPerDepth is trimmed)
+    void setCounters(const SearchCounters& counters);
+
+    std::string toJSON() const;
+    // The members of toJSON() into an open object
+    void writeJSON(JSONWriter& json) const;
+};
+
+// Running totals over many solves, per solver, for the /metrics endpoint.
+// Thread-safe; record() takes a short lock.
+class SolveMetrics {
+public:
+    void record(const SolveStats& stats);
+
+    // Prometheus text exposition format
+    std::string toPrometheus() const;
+
+private:
+    struct Totals {
+        uint64_t solves = 0;
+        uint64_t solved = 0;
+        uint64_t stopped = 0;
+        uint64_t cached = 0;
+        double seconds = 0.0;
+        uint64_t nodes = 0;
+        uint64_t heuristicEvaluations = 0;
+        uint64_t boundCutoffs = 0;
+        uint64_t sequencePruned = 0;
+        uint64_t tableProbes = 0;
+        uint64_t tableCutoffs = 0;
+    };
+
+    mutable std::mutex mutex_;
+    std::map<std::string, Totals> totals_;
+};
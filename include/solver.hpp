@@ -1,24 +1,253 @@
 #pragma once
 #include "rubiks_cube.hpp"
+#include "heuristic.hpp"
+#include "cancellation.hpp"
+#include "move_sequence.hpp"
+#include "transposition_table.hpp"
+#include "solve_stats.hpp"
+#include "ida_star.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
 #include <vector>
 #include <string>
 
+// Snapshot of a running search, reported at every IDA* iteration (and by
+// the two-phase solver at every phase-1 depth)
+struct SolveProgress {
+    int threshold;
+    uint64_t nodes;
+    double elapsed;  // seconds since solve() started
+};
+
+// Outcome of one position of solveBatch()
+struct BatchResult {
+    size_t index;                        // position in the input
+    bool success;                        // solved (an already solved cube counts)
+    std::vector<std::string> solution;
+    uint64_t nodes;
+    double time;
+    std::string error;                   // why the position was rejected, if it was
+    SolveStats stats;                    // empty unless a search ran
+};
+
+// What a solve searches with, apart from the cube: shared, read-only
+// objects and plain values, so one instance can configure any number of
+// solvers at once. A solver holds its settings next to its per-solve
+// search state (paths, counters, per-thread buffers), which is why one
+// solver instance runs one solve at a time; SolverPool lends instances out.
+struct SolverSettings {
+    std::shared_ptr<const Heuristic> heuristic = std::make_shared<ManhattanHeuristic>();
+    Metric metric = Metric::QUARTER_TURN;
+    std::shared_ptr<TranspositionTable> table;  // may be null
+    double timeLimit = 0.0;                     // seconds per solve, 0 = unlimited
+};
+
 // Abstract solver interface
 class Solver {
 public:
+    using ProgressCallback = std::function<void(const SolveProgress&)>;
+    using BatchCallback = std::function<void(const BatchResult&)>;
+
     virtual ~Solver() = default;
-    
+
     // Solve the cube and return the sequence of moves
     virtual std::vector<std::string> solve(RubiksCube& cube, int maxDepth = 20) = 0;
-    
+
     // Get solver name
     virtual std::string getName() const = 0;
-    
+
+    // A solver with the same settings (heuristic, time limit, token, but no
+    // progress callback) that can search at the same time as this one.
+    // Collective solvers (MPI, hybrid) return nullptr.
+    virtual std::unique_ptr<Solver> clone() const { return nullptr; }
+    // Whether clone() returns a solver, without making one
+    virtual bool canClone() const { return false; }
+
+    // Solve every cube, one clone per thread (numThreads 0 = one per CPU of
+    // this rank, see ThreadPlacement), and call onResult once per cube in
+    // input order, never concurrently. Results are handed on as soon as
+    // every earlier cube is done; onResult must not throw. Without clone()
+    // the cubes are solved one after another on this solver.
+    void solveBatch(const std::vector<RubiksCube>& cubes, const BatchCallback& onResult,
+                    int maxDepth = 20, int numThreads = 0);
+
     // Get statistics from last solve
-    virtual int getNodesExplored() const { return nodesExplored_; }
+    virtual uint64_t getNodesExplored() const { return nodesExplored_; }
     virtual double getSolveTime() const { return solveTime_; }
-    
+    // Everything the last solve measured. MPI and hybrid merge the counters
+    // of every rank, so each rank holds the totals.
+    const SolveStats& getStats() const { return stats_; }
+
+    // Heuristic used by the search (defaults to the manhattan estimate)
+    void setHeuristic(std::shared_ptr<const Heuristic> heuristic) { heuristic_ = std::move(heuristic); }
+    const Heuristic& getHeuristic() const { return *heuristic_; }
+
+    // Moves the search may use, and so what a solution's length counts:
+    // quarter turns only (the default) or quarter and half turns. Solvers
+    // tied to one metric ignore this.
+    virtual void setMetric(Metric metric) {
+        metric_ = metric;
+        automaton_ = &MoveSequenceAutomaton::get(metric);
+    }
+    Metric getMetric() const { return metric_; }
+
+    // Optional store of bounds learned by the IDA* searches (nullptr, the
+    // default, searches without one). Clones share it, and it stays valid
+    // across solves. Solvers without an IDA* search ignore it.
+    void setTranspositionTable(std::shared_ptr<TranspositionTable> table) { table_ = std::move(table); }
+    const std::shared_ptr<TranspositionTable>& getTranspositionTable() const { return table_; }
+
+    // Time budget per solve() call in seconds (0 = unlimited)
+    void setTimeLimit(double seconds) { timeLimit_ = seconds; }
+    double getTimeLimit() const { return timeLimit_; }
+
+    // All of the above at once; the metric goes through setMetric(), so
+    // solvers tied to one metric keep theirs
+    void configure(const SolverSettings& settings) {
+        heuristic_ = settings.heuristic;
+        setMetric(settings.metric);
+        table_ = settings.table;
+        timeLimit_ = settings.timeLimit;
+    }
+    SolverSettings getSettings() const { return SolverSettings{heuristic_, metric_, table_, timeLimit_}; }
+
+    // External cancellation; the token's deadline also bounds the search
+    void setCancellationToken(std::shared_ptr<CancellationToken> token) { token_ = std::move(token); }
+    const std::shared_ptr<CancellationToken>& getCancellationToken() const { return token_; }
+
+    // True if the last solve() stopped early (deadline or cancel)
+    bool wasStopped() const { return stopped_.load(std::memory_order_relaxed); }
+
+    // Called on the solving thread; keep it short
+    void setProgressCallback(ProgressCallback callback) { onProgress_ = std::move(callback); }
+
 protected:
-    int nodesExplored_ = 0;
+    uint64_t nodesExplored_ = 0;
     double solveTime_ = 0.0;
-};
\ No newline at end of file
+    SolveStats stats_;
+    std::shared_ptr<const Heuristic> heuristic_ = std::make_shared<ManhattanHeuristic>();
+    // Canonical move sequences of the metric, which the search follows
+    Metric metric_ = Metric::QUARTER_TURN;
+    const MoveSequenceAutomaton* automaton_ = &MoveSequenceAutomaton::get(Metric::QUARTER_TURN);
+    std::shared_ptr<TranspositionTable> table_;
+
+    // IDAStar policy for a search with only the deadline and the token to
+    // watch
+    struct DeadlinePolicy {
+        Solver& solver;
+        bool stop(uint64_t nodes) { return solver.shouldStop(nodes); }
+        bool complete() const { return !solver.wasStopped(); }
+    };
+
+    // One IDA* iteration below cube (at depth g) with this solver's
+    // heuristic, metric and table; see IDAStar for the result
+    template <typename Parallelism>
+    int idaStar(Parallelism parallelism, SearchCounters& counters, const CubieCube& cube, int g,
+                int threshold, MoveSequenceAutomaton::State state, std::vector<Move>& path) {
+        return searchIDAStar(*heuristic_, metric_, table_.get(), parallelism, counters, cube, g,
+                             threshold, state, path);
+    }
+
+    // Call at the start of solve() to fix this search's deadline
+    void beginSearch() {
+        searchStart_ = CancellationToken::Clock::now();
+        deadline_ = token_->getDeadline();
+        if (timeLimit_ > 0.0) {
+            auto limit = CancellationToken::Clock::now() +
+                std::chrono::duration_cast<CancellationToken::Clock::duration>(
+                    std::chrono::duration<double>(timeLimit_));
+            deadline_ = std::min(deadline_, limit);
+        }
+        stopped_.store(false, std::memory_order_relaxed);
+        if (table_) table_->newSearch();
+        stats_ = SolveStats{};
+        stats_.solver = getName();
+        iterationOpen_ = false;
+    }
+
+    // Call at the end of solve() with the merged counters; sets
+    // nodesExplored_ and ends the last iteration. solveTime_ must be set.
+    void finishStats(const SearchCounters& counters, bool solved, size_t solutionLength,
+                     std::vector<uint64_t> workerNodes = {}) {
+        endIteration(counters.nodes);
+        stats_.setCounters(counters);
+        stats_.workerNodes = std::move(workerNodes);
+        stats_.solutionLength = static_cast<int>(solutionLength);
+        stats_.solved = solved;
+        stats_.stopped = wasStopped();
+        stats_.time = solveTime_;
+        nodesExplored_ = counters.nodes;
+    }
+
+    // Cheap enough to call at every node: two relaxed loads, plus a clock
+    // read once every 4096 nodes
+    bool shouldStop(uint64_t nodes) {
+        if (stopped_.load(std::memory_order_relaxed)) return true;
+        if (token_->isCancelled() ||
+            ((nodes & 0xFFF) == 0 && CancellationToken::Clock::now() >= deadline_)) {
+            stopped_.store(true, std::memory_order_relaxed);
+            return true;
+        }
+        return false;
+    }
+
+    // Unsampled check, for iteration boundaries
+    bool deadlineExpired() {
+        if (token_->isCancelled() || CancellationToken::Clock::now() >= deadline_) {
+            stopped_.store(true, std::memory_order_relaxed);
+        }
+        return stopped_.load(std::memory_order_relaxed);
+    }
+
+    // For searches that run elsewhere: the deadline beginSearch() fixed,
+    // and a stop that happened there
+    CancellationToken::Clock::time_point searchDeadline() const { return deadline_; }
+    void markStopped() { stopped_.store(true, std::memory_order_relaxed); }
+
+    // For clone(): copy the settings shared by every solver
+    void copySettingsTo(Solver& other) const {
+        other.heuristic_ = heuristic_;
+        other.metric_ = metric_;
+        other.automaton_ = automaton_;
+        other.table_ = table_;
+        other.timeLimit_ = timeLimit_;
+        other.token_ = token_;
+    }
+
+    // Call at the start of every iteration: opens its entry in the stats
+    // and tells the progress callback
+    void reportProgress(int threshold, uint64_t nodes) {
+        double elapsed = std::chrono::duration<double>(CancellationToken::Clock::now() - searchStart_).count();
+        endIteration(nodes);
+        stats_.iterations.push_back(IterationStats{threshold, nodes, elapsed});
+        iterationOpen_ = true;
+        if (onProgress_) onProgress_(SolveProgress{threshold, nodes, elapsed});
+    }
+
+    // Turns the open iteration's start values into its own totals. The
+    // collective solvers call it with rank 0's count before merging ranks,
+    // so their iterations count rank 0's nodes.
+    void endIteration(uint64_t nodes) {
+        if (!iterationOpen_) return;
+        IterationStats& last = stats_.iterations.back();
+        double elapsed = std::chrono::duration<double>(CancellationToken::Clock::now() - searchStart_).count();
+        last.nodes = nodes - last.nodes;
+        last.seconds = elapsed - last.seconds;
+        iterationOpen_ = false;
+    }
+
+private:
+    double timeLimit_ = 0.0;
+    // The last entry of stats_.iterations still holds its start values
+    bool iterationOpen_ = false;
+    std::shared_ptr<CancellationToken> token_ = std::make_shared<CancellationToken>();
+    CancellationToken::Clock::time_point deadline_ = CancellationToken::Clock::time_point::max();
+    CancellationToken::Clock::time_point searchStart_;
+    ProgressCallback onProgress_;
+    std::atomic<bool> stopped_{false};
+
+};
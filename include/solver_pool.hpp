@@ -0,0 +1,78 @@
+// include/solver_pool.hpp
+#pragma once
+#include "solver.hpp"
+#include "cancellation.hpp"
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Idle solver instances, kept for reuse by concurrent requests. A request
+// borrows one instance of a kind (e.g. "sequential" or "openmp/4"),
+// configures it with its SolverSettings, solves, and the lease hands it
+// back. A returned instance keeps the buffers its last solve grew (paths,
+// per-thread counters, frontiers), so once the pool is warm a request
+// neither constructs a solver nor allocates search state.
+class SolverPool {
+public:
+    using Factory = std::function<std::unique_ptr<Solver>()>;
+
+    // Returned instances past this many idle ones of their kind are freed
+    static constexpr size_t MAX_IDLE_PER_KIND = 8;
+
+    // Exclusive use of one instance until destroyed or moved from
+    class Lease {
+    public:
+        Lease() = default;
+        Lease(Lease&& other) noexcept { *this = std::move(other); }
+        Lease& operator=(Lease&& other) noexcept;
+        ~Lease() { release(); }
+
+        Solver& operator*() const { return *solver_; }
+        Solver* operator->() const { return solver_.get(); }
+        Solver* get() const { return solver_.get(); }
+        explicit operator bool() const { return solver_ != nullptr; }
+
+    private:
+        friend class SolverPool;
+        Lease(SolverPool* pool, std::string kind, std::unique_ptr<Solver> solver)
+            : pool_(pool), kind_(std::move(kind)), solver_(std::move(solver)) {}
+        void release();
+
+        SolverPool* pool_ = nullptr;
+        std::string kind_;
+        std::unique_ptr<Solver> solver_;
+    };
+
+    SolverPool() = default;
+    SolverPool(const SolverPool&) = delete;
+    SolverPool& operator=(const SolverPool&) = delete;
+
+    // An idle instance of kind, or a new one from create. Every instance of
+    // a kind must come from an equivalent factory.
+    Lease acquire(const std::string& kind, const Factory& create);
+
+    // Construct instances ahead of the first request, up to count idle
+    // (at most MAX_IDLE_PER_KIND)
+    void reserve(const std::string& kind, const Factory& create, size_t count);
+
+    // Lend out an instance built elsewhere
+    void add(const std::string& kind, std::unique_ptr<Solver> solver);
+
+    size_t idle() const;
+    uint64_t getCreated() const;
+    uint64_t getReused() const;
+
+private:
+    // Returned instances drop the borrower's token and callback
+    void release(const std::string& kind, std::unique_ptr<Solver> solver);
+
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, std::vector<std::unique_ptr<Solver>>> idle_;
+    std::shared_ptr<CancellationToken> idleToken_ = std::make_shared<CancellationToken>();
+    uint64_t created_ = 0;
+    uint64_t reused_ = 0;
+};
@@ -0,0 +1,118 @@
+// include/thread_placement.hpp
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+// How the search threads of a rank are pinned to its CPUs. With close,
+// consecutive threads take neighbouring cores, filling one NUMA node
+// before the next; with spread they alternate between the nodes. Either
+// way every physical core gets a thread before any core gets a second.
+enum class ThreadBinding { NONE, CLOSE, SPREAD };
+
+// "none", "close" or "spread"; throws std::invalid_argument otherwise
+ThreadBinding parseThreadBinding(const std::string& name);
+const char* threadBindingName(ThreadBinding binding);
+
+// The CPUs this process searches on and how its threads sit on them.
+//
+// The topology (NUMA node, core and hardware thread of every CPU) comes
+// from sysfs; without it every CPU is its own core on node 0. Ranks on one
+// node split its cores between them in contiguous runs, so each rank's
+// share stays on as few NUMA nodes as possible, unless the launcher
+// (mpirun --bind-to, taskset, a batch system) already narrowed the
+// process's affinity, in which case its choice stands.
+//
+// Parallel solvers size their teams by threads() and call bindThread()
+// from every team thread, then allocate that thread's search state from
+// the thread itself (see PerThread), so the first touch puts it on the
+// thread's own node.
+class ThreadPlacement {
+public:
+    struct Cpu {
+        int id;
+        int node;
+        int core;     // unique across packages
+        int sibling;  // index among the core's hardware threads
+    };
+
+    // The process's placement; one rank alone on the node, bound close,
+    // until configure() says otherwise
+    static ThreadPlacement& get();
+
+    // Call once from main, before any search thread exists: this process
+    // is localRank of localRanks on its node. With several ranks, the
+    // process's affinity is narrowed to its share.
+    void configure(int localRank, int localRanks, ThreadBinding binding);
+
+    // Search threads for this rank: the first OMP_NUM_THREADS value if set,
+    // else one per CPU of its share
+    int threads() const;
+    // This rank's CPUs, in binding order
+    const std::vector<Cpu>& cpus() const { return cpus_; }
+    std::vector<int> nodes() const;
+    ThreadBinding binding() const { return binding_; }
+    // The launcher chose the CPUs, or OMP_PROC_BIND / OMP_PLACES the pinning
+    bool launcherBound() const { return launcherBound_; }
+    bool runtimeBinds() const { return runtimeBinds_; }
+
+    // One line for the startup log
+    std::string describe() const;
+
+    // Pin the calling thread, number index of a team of teamSize, to its
+    // CPU. Only teams that use the whole share (teamSize == threads()) are
+    // pinned: smaller ones, several of which may run at once, are left to
+    // the scheduler. Thread 0 is the thread that started the team, which
+    // belongs to the caller and keeps its affinity. No-op with binding
+    // none or when the OpenMP runtime does the binding.
+    void bindThread(int index, int teamSize) const;
+
+    // Spread the pages of [memory, memory + bytes) round-robin over this
+    // rank's NUMA nodes, for memory every thread reads alike. Only pages
+    // not touched yet move; no-op on one node or where mbind is refused.
+    void interleave(void* memory, size_t bytes) const;
+
+private:
+    ThreadPlacement();
+
+    std::vector<Cpu> cpus_;
+    int localRank_ = 0;
+    int localRanks_ = 1;
+    int onlineCpus_ = 1;
+    ThreadBinding binding_ = ThreadBinding::CLOSE;
+    bool launcherBound_ = false;
+    bool runtimeBinds_ = false;
+};
+
+// One T per thread of a team, each made by the thread that uses it (after
+// bindThread()), so it lives on that thread's NUMA node rather than on the
+// node of whoever started the solve. Slots outlive a solve, placement and
+// all; reset their contents between parallel regions instead.
+template <typename T>
+class PerThread {
+public:
+    // Outside a parallel region
+    void resize(size_t count) { slots_.resize(count); }
+    size_t size() const { return slots_.size(); }
+
+    // Thread index's slot, made on first use; only thread index may call it
+    T& local(size_t index) {
+        std::unique_ptr<T>& slot = slots_[index];
+        if (!slot) slot = std::make_unique<T>();
+        return *slot;
+    }
+
+    // Every slot made so far, in thread order; outside a parallel region
+    template <typename F>
+    void forEach(F visit) {
+        for (auto& slot : slots_) if (slot) visit(*slot);
+    }
+    template <typename F>
+    void forEach(F visit) const {
+        for (const auto& slot : slots_) if (slot) visit(static_cast<const T&>(*slot));
+    }
+
+private:
+    std::vector<std::unique_ptr<T>> slots_;
+};
@@ -0,0 +1,44 @@
+// include/thread_pool.hpp
+#pragma once
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of worker threads draining a FIFO of tasks. With a queue limit
+// the pool refuses work instead of letting the backlog grow without bound,
+// so callers can shed load (e.g. answer 503) while existing tasks finish.
+class ThreadPool {
+public:
+    // maxQueued 0 means unbounded; it counts tasks waiting, not running
+    explicit ThreadPool(size_t numThreads, size_t maxQueued = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // False if the queue is full or the pool is shutting down
+    bool trySubmit(std::function<void()> task);
+
+    // Finish the queued tasks, then join the workers. Idempotent.
+    void shutdown();
+
+    size_t numThreads() const { return workers_.size(); }
+    size_t queued() const;
+    size_t active() const;
+
+private:
+    std::vector<std::thread> workers_;
+    std::deque<std::function<void()>> tasks_;
+    size_t maxQueued_;
+    size_t active_ = 0;
+    bool stopping_ = false;
+
+    mutable std::mutex mutex_;
+    std::condition_variable available_;
+
+    void workerLoop();
+};
@@ -0,0 +1,97 @@
+// include/transposition_table.hpp
+#pragma once
+#include "cubie_cube.hpp"
+#include "move_sequence.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+// Lower bounds on the distance to solved learned by IDA*, shared by every
+// thread searching with the table.
+//
+// When the subtree below a node is searched to a threshold and fails, the
+// smallest f that exceeded the threshold, less the node's g, is a lower
+// bound on the node's remaining distance that is usually larger than the
+// heuristic. Re-entering the position, by a transposition in the same
+// iteration or in any later one, then prunes it at once. The bound only
+// holds for the moves the search may still make there, so the key covers
+// the automaton state and the metric as well as the position. It does not
+// depend on the cube being solved, so the table can stay filled across
+// solves and be shared by clones.
+//
+// The table is a fixed array of 64-byte buckets of four entries. An entry
+// is two words, the key XORed with the data and the data, each stored with
+// a relaxed atomic: a reader that sees halves of two different writes gets
+// a key that matches neither and treats it as a miss, so no locks are
+// needed. A hit on a different position takes a single 64-bit
+// fingerprint collision.
+//
+// Replacement: a matching entry keeps the larger bound and the smaller g.
+// Otherwise the victim is an empty entry, else one from an older search,
+// else the one with the largest g, whose subtree is the cheapest to redo.
+class TranspositionTable {
+public:
+    static constexpr size_t BUCKET_BYTES = 64;
+    static constexpr size_t DEFAULT_MEGABYTES = 64;
+    // Nodes whose f is within this of the threshold have subtrees cheaper
+    // to search than to look up, so the searches skip the table there
+    static constexpr int MIN_SLACK = 1;
+
+    // At most `bytes` of memory, rounded down to a power-of-two number of
+    // buckets. Throws std::invalid_argument below one bucket.
+    explicit TranspositionTable(size_t bytes = DEFAULT_MEGABYTES << 20);
+
+    static uint64_t key(const CubieCube& cube, MoveSequenceAutomaton::State state, Metric metric) {
+        return cube.fingerprint((static_cast<uint64_t>(metric) << 8) | state);
+    }
+
+    // The stored lower bound for key, or 0 without one
+    int probe(uint64_t key) const {
+        const Bucket& bucket = bucketFor(key);
+        for (const Entry& entry : bucket.entries) {
+            uint64_t data = entry.data.load(std::memory_order_relaxed);
+            if ((entry.check.load(std::memory_order_relaxed) ^ data) == key && data != 0) {
+                return boundOf(data);
+            }
+        }
+        return 0;
+    }
+
+    // Record that the subtree below key, reached at depth g, needs at least
+    // `bound` more moves
+    void store(uint64_t key, int g, int bound);
+
+    // Ages the entries already stored; call once per solve
+    void newSearch() {
+        uint16_t next = static_cast<uint16_t>(generation_.load(std::memory_order_relaxed) + 1);
+        generation_.store(next == 0 ? 1 : next, std::memory_order_relaxed);
+    }
+
+    void clear();
+    size_t getBytes() const { return numBuckets_ * BUCKET_BYTES; }
+    size_t getCapacity() const { return numBuckets_ * 4; }
+    // Occupied entries; walks the whole table
+    size_t size() const;
+
+private:
+    struct Entry {
+        std::atomic<uint64_t> check;  // key ^ data
+        std::atomic<uint64_t> data;   // bound | g << 8 | generation << 16, 0 if empty
+    };
+    struct alignas(BUCKET_BYTES) Bucket {
+        Entry entries[4];
+    };
+    static_assert(sizeof(Bucket) == BUCKET_BYTES, "Bucket must fill one cache line");
+
+    std::unique_ptr<Bucket[]> buckets_;
+    size_t numBuckets_;
+    std::atomic<uint16_t> generation_{1};
+
+    const Bucket& bucketFor(uint64_t key) const { return buckets_[key & (numBuckets_ - 1)]; }
+    Bucket& bucketFor(uint64_t key) { return buckets_[key & (numBuckets_ - 1)]; }
+
+    static int boundOf(uint64_t data) { return static_cast<int>(data & 0xFF); }
+    static int depthOf(uint64_t data) { return static_cast<int>((data >> 8) & 0xFF); }
+    static uint16_t generationOf(uint64_t data) { return static_cast<uint16_t>(data >> 16); }
+};
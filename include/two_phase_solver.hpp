@@ -0,0 +1,66 @@
+// include/two_phase_solver.hpp
+#pragma once
+#include "solver.hpp"
+#include "rubiks_cube.hpp"
+#include "cubie_cube.hpp"
+#include "move.hpp"
+#include <chrono>
+#include <functional>
+
+// Kociemba's two-phase algorithm. Phase 1 brings the cube into the subgroup
+// <U, D, F2, B2, L2, R2> (corners twisted and edges flipped correctly, slice
+// edges in the middle layer); phase 2 solves it using only those moves.
+// Both phases search small coordinate spaces with precomputed move and
+// pruning tables, so a solution of 22 moves or less usually takes a few
+// milliseconds. The result is not optimal.
+//
+// By default the search stops at the first solution no longer than
+// maxDepth. In anytime mode it keeps looking for shorter solutions until the
+// time limit (5 s by default) or cancellation, reporting each improvement
+// through the solution callback.
+class TwoPhaseSolver : public Solver {
+public:
+    using SolutionCallback = std::function<void(const std::vector<std::string>&)>;
+
+    // Both phases search in the half-turn metric, whatever setMetric() says
+    TwoPhaseSolver() {
+        setTimeLimit(5.0);
+        metric_ = Metric::HALF_TURN;
+        automaton_ = &MoveSequenceAutomaton::get(Metric::HALF_TURN);
+    }
+    void setMetric(Metric) override {}
+    std::vector<std::string> solve(RubiksCube& cube, int maxDepth = 20) override;
+    std::string getName() const override { return "Two-Phase (Kociemba)"; }
+    // The solution callback is not copied
+    std::unique_ptr<Solver> clone() const override {
+        auto copy = std::make_unique<TwoPhaseSolver>();
+        copySettingsTo(*copy);
+        copy->anytime_ = anytime_;
+        return copy;
+    }
+    bool canClone() const override { return true; }
+
+    void setAnytime(bool anytime) { anytime_ = anytime; }
+    void setSolutionCallback(SolutionCallback callback) { onSolution_ = std::move(callback); }
+
+    // Build the coordinate tables now instead of on the first solve
+    static void initTables();
+
+private:
+    bool anytime_ = false;
+    SolutionCallback onSolution_;
+
+    CubieCube start_;
+    std::vector<Move> solution_;
+    std::vector<Move> currentPath_;
+    int bestLength_;
+    int targetLength_;
+    bool stop_;
+    SearchCounters counters_;  // nodesPerDepth is indexed by path length over both phases
+
+    bool phase1(int twist, int flip, int slice, int togo, MoveSequenceAutomaton::State sequence);
+    bool startPhase2(MoveSequenceAutomaton::State sequence);
+    bool phase2(int cornerPerm, int edgePerm, int slicePerm, int togo,
+                MoveSequenceAutomaton::State sequence);
+    bool timeUp();
+};
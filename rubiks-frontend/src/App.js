@@ -1,4 +1,5 @@
 import React, { useState, useEffect } from 'react';
+import { apiFetch } from './api';
 import { Shuffle, Play, RotateCw, BookOpen, TrendingUp, Clock, ArrowUp, ArrowDown, ArrowLeft, ArrowRight, RotateCcw, RotateCw as RotateCwIcon } from 'lucide-react';
 
 const App = () => {
@@ -41,12 +42,12 @@ const App = () => {
 
   useEffect(() => {
     checkBackend();
-    loadCube();
+    handleReset(); // starts this tab's session
   }, []);
 
   const checkBackend = async () => {
     try {
-      const response = await fetch('http://localhost:8080/status');
+      const response = await apiFetch('/status');
       setServerStatus(response.ok ? 'connected' : 'error');
     } catch (err) {
       setServerStatus('disconnected');
@@ -55,7 +56,7 @@ const App = () => {
 
   const loadCube = async () => {
     try {
-      const response = await fetch('http://localhost:8080/cube');
+      const response = await apiFetch('/cube');
       const data = await response.json();
       setCubeState(data);
     } catch (err) {
@@ -67,7 +68,7 @@ const App = () => {
     setIsScrambling(true);
     setResults([]);
     try {
-      const response = await fetch('http://localhost:8080/cube/scramble', {
+      const response = await apiFetch('/cube/scramble', {
         method: 'POST',
         headers: { 'Content-Type': 'application/json' },
         body: JSON.stringify({ moves: scrambleMoves })
@@ -83,7 +84,7 @@ const App = () => {
 
   const handleManualMove = async (move) => {
     try {
-      const response = await fetch('http://localhost:8080/cube/move', {
+      const response = await apiFetch('/cube/move', {
         method: 'POST',
         headers: { 'Content-Type': 'application/json' },
         body: JSON.stringify({ move })
@@ -100,10 +101,10 @@ const App = () => {
     setResults([]);
     
     try {
-      const response = await fetch('http://localhost:8080/cube/solve', {
+      const response = await apiFetch('/cube/solve', {
         method: 'POST',
         headers: { 'Content-Type': 'application/json' },
-        body: JSON.stringify({ maxDepth: 15 })
+        body: JSON.stringify({ maxDepth: 15, mode: 'benchmark' })
       });
       
       const data = await response.json();
@@ -124,7 +125,7 @@ const App = () => {
   const handleReset = async () => {
     setResults([]);
     try {
-      const response = await fetch('http://localhost:8080/cube/reset', { method: 'POST' });
+      const response = await apiFetch('/cube/reset', { method: 'POST' });
       const data = await response.json();
       setCubeState(data);
     } catch (err) {
@@ -135,7 +136,7 @@ const App = () => {
   const handleApplySolution = async (moves) => {
     try {
       for (const move of moves) {
-        await fetch('http://localhost:8080/cube/move', {
+        await apiFetch('/cube/move', {
           method: 'POST',
           headers: { 'Content-Type': 'application/json' },
           body: JSON.stringify({ move })
@@ -1,13 +1,30 @@
 const API_URL = 'http://localhost:8080';
 
+// Each tab works on its own cube; the server hands out the id on /cube/reset
+let sessionId = null;
+
+export const apiFetch = async (path, options = {}) => {
+  const headers = { ...(options.headers || {}) };
+  if (sessionId) headers['X-Session-Id'] = sessionId;
+  const res = await fetch(`${API_URL}${path}`, { ...options, headers });
+  const id = res.headers.get('X-Session-Id');
+  if (id) sessionId = id;
+  return res;
+};
+
 export const cubeAPI = {
+  reset: async () => {
+    const res = await apiFetch('/cube/reset', { method: 'POST' });
+    return res.json();
+  },
+
   getCube: async () => {
-    const res = await fetch(`${API_URL}/cube`);
+    const res = await apiFetch(`/cube`);
     return res.json();
   },
   
   scramble: async (moves = 20) => {
-    const res = await fetch(`${API_URL}/cube/scramble`, {
+    const res = await apiFetch(`/cube/scramble`, {
       method: 'POST',
       headers: { 'Content-Type': 'application/json' },
       body: JSON.stringify({ moves })
@@ -16,7 +33,7 @@ export const cubeAPI = {
   },
   
   solve: async () => {
-    const res = await fetch(`${API_URL}/cube/solve`, {
+    const res = await apiFetch(`/cube/solve`, {
       method: 'POST',
       headers: { 'Content-Type': 'application/json' },
       body: JSON.stringify({ maxDepth: 20 })
@@ -25,11 +42,47 @@ export const cubeAPI = {
   },
   
   applyMove: async (move) => {
-    const res = await fetch(`${API_URL}/cube/move`, {
+    const res = await apiFetch(`/cube/move`, {
       method: 'POST',
       headers: { 'Content-Type': 'application/json' },
       body: JSON.stringify({ move })
     });
     return res.json();
+  },
+
+  // Solve in the background; returns { jobId, events }
+  startSolveJob: async (options = { maxDepth: 20 }) => {
+    const res = await apiFetch(`/jobs`, {
+      method: 'POST',
+      headers: { 'Content-Type': 'application/json' },
+      body: JSON.stringify(options)
+    });
+    return res.json();
+  },
+
+  // Calls onProgress / onResult as the job runs and onDone with the full
+  // response. Returns a function that stops watching.
+  watchSolveJob: (jobId, { onProgress, onResult, onDone, onError } = {}) => {
+    const source = new EventSource(`${API_URL}/jobs/${jobId}/events`);
+    const listen = (event, handler) => source.addEventListener(event, (e) => {
+      if (handler) handler(JSON.parse(e.data));
+    });
+    listen('progress', onProgress);
+    listen('result', onResult);
+    source.addEventListener('done', (e) => {
+      source.close();
+      if (onDone) onDone(JSON.parse(e.data));
+    });
+    // Both a failed solve and a dropped stream end up here
+    source.addEventListener('error', (e) => {
+      source.close();
+      if (onError) onError(e.data ? JSON.parse(e.data) : null);
+    });
+    return () => source.close();
+  },
+
+  cancelSolveJob: async (jobId) => {
+    const res = await apiFetch(`/jobs/${jobId}`, { method: 'DELETE' });
+    return res.json();
   }
 };
\ No newline at end of file
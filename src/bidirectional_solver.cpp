@@ -0,0 +1,119 @@
+// src/bidirectional_solver.cpp - IDA* toward a precomputed frontier around solved
+#include "bidirectional_solver.hpp"
+#include "logging.hpp"
+#include <algorithm>
+#include <chrono>
+#include <limits>
+
+namespace {
+
+// The exact distance inside the frontier, at least one more than its depth
+// outside. A base estimate above the depth already rules the frontier out,
+// so the table is only probed for positions that may be in it.
+template <typename BaseHeuristic>
+class FrontierEstimate {
+public:
+    FrontierEstimate(const BaseHeuristic& base, const FrontierTable& frontier)
+        : base_(base), frontier_(frontier), depth_(frontier.getDepth()) {}
+
+    int estimate(const CubieCube& cube) const {
+        int h = base_.estimate(cube);
+        if (h > depth_) return h;
+        int distance = frontier_.distance(cube);
+        return distance >= 0 ? distance : std::max(h, depth_ + 1);
+    }
+
+private:
+    const BaseHeuristic& base_;
+    const FrontierTable& frontier_;
+    int depth_;
+};
+
+} // namespace
+
+template <typename BaseHeuristic>
+int BidirectionalSolver::search(const BaseHeuristic& base, const CubieCube& start, int threshold) {
+    using Estimate = FrontierEstimate<BaseHeuristic>;
+    Estimate estimate(base, *frontier_);
+    DeadlinePolicy policy{*this};
+    if (metric_ == Metric::HALF_TURN) {
+        return IDAStar<CubieCube, Estimate, HalfTurnMoves, DeadlinePolicy>(
+            estimate, table_.get(), policy, counters_).search(start, 0, threshold,
+                                                                MoveSequenceAutomaton::START, currentPath_);
+    }
+    return IDAStar<CubieCube, Estimate, QuarterTurnMoves, DeadlinePolicy>(
+        estimate, table_.get(), policy, counters_).search(start, 0, threshold,
+                                                            MoveSequenceAutomaton::START, currentPath_);
+}
+
+std::vector<std::string> BidirectionalSolver::solve(RubiksCube& cube, int maxDepth) {
+    auto startTime = std::chrono::high_resolution_clock::now();
+
+    solution_.clear();
+    currentPath_.clear();
+    currentPath_.reserve(maxDepth + 1);
+    counters_ = SearchCounters{};
+    beginSearch();
+
+    if (cube.isSolved()) {
+        solveTime_ = 0.0;
+        finishStats(counters_, true, 0);
+        return {};
+    }
+
+    // Built on the first solve of the metric and kept for the process
+    if (!frontier_ || frontier_->getMetric() != metric_) frontier_ = getFrontierTable(metric_);
+    RUBIKS_LOG(DEBUG) << "=== Bidirectional IDA* Search === max depth " << maxDepth
+                      << ", frontier depth " << frontier_->getDepth() << " ("
+                      << frontier_->size() << " positions), heuristic " << heuristic_->getName();
+
+    CubieCube start(cube);
+    bool found = false;
+
+    // Scrambles inside the frontier need no search
+    if (frontier_->pathToSolved(start, solution_)) {
+        found = solution_.size() <= static_cast<size_t>(maxDepth);
+        if (!found) solution_.clear();
+    } else {
+        int threshold = std::max(heuristic_->estimate(start), frontier_->getDepth() + 1);
+        const Heuristic& heuristic = *heuristic_;
+        auto* manhattan = dynamic_cast<const ManhattanHeuristic*>(&heuristic);
+        auto* pdb = dynamic_cast<const PatternDatabaseHeuristic*>(&heuristic);
+
+        while (threshold <= maxDepth) {
+            RUBIKS_LOG(DEBUG) << "Searching with threshold " << threshold << "...";
+            reportProgress(threshold, counters_.nodes);
+
+            currentPath_.clear();
+            int temp = manhattan ? search(*manhattan, start, threshold)
+                     : pdb ? search(*pdb, start, threshold)
+                           : search(heuristic, start, threshold);
+
+            if (temp == -1) {
+                solution_ = currentPath_;
+                found = true;
+                break;
+            }
+            if (deadlineExpired()) {
+                RUBIKS_LOG(DEBUG) << "Time limit reached";
+                break;
+            }
+            if (temp == std::numeric_limits<int>::max()) break;
+            threshold = temp;
+        }
+    }
+
+    auto endTime = std::chrono::high_resolution_clock::now();
+    solveTime_ = std::chrono::duration<double>(endTime - startTime).count();
+
+    finishStats(counters_, found, solution_.size());
+
+    if (found) {
+        RUBIKS_LOG(DEBUG) << "✓ Solution found: " << solution_.size() << " moves, "
+                          << counters_.nodes << " nodes, " << solveTime_ << "s";
+        return movesToStrings(solution_);
+    }
+    RUBIKS_LOG(DEBUG) << "✗ No solution found (timeout or invalid scramble): "
+                      << counters_.nodes << " nodes, " << solveTime_ << "s";
+    return {};
+}
@@ -0,0 +1,105 @@
+// src/binary_protocol.cpp - Frames of the binary solve port
+#include "binary_protocol.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+void putU32(std::string& out, uint32_t value) {
+    for (int i = 0; i < 4; ++i) out += static_cast<char>((value >> (8 * i)) & 0xFF);
+}
+
+void putU64(std::string& out, uint64_t value) {
+    for (int i = 0; i < 8; ++i) out += static_cast<char>((value >> (8 * i)) & 0xFF);
+}
+
+uint32_t getU32(const char* data) {
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(data);
+    return static_cast<uint32_t>(bytes[0]) | static_cast<uint32_t>(bytes[1]) << 8 |
+           static_cast<uint32_t>(bytes[2]) << 16 | static_cast<uint32_t>(bytes[3]) << 24;
+}
+
+uint64_t getU64(const char* data) {
+    return static_cast<uint64_t>(getU32(data)) | static_cast<uint64_t>(getU32(data + 4)) << 32;
+}
+
+} // namespace
+
+const char* binarySolverType(uint8_t solver) {
+    switch (static_cast<BinarySolver>(solver)) {
+        case BinarySolver::TWO_PHASE: return "twophase";
+        case BinarySolver::SEQUENTIAL: return "sequential";
+        case BinarySolver::BIDIRECTIONAL: return "bidirectional";
+        case BinarySolver::OPENMP: return "openmp";
+    }
+    return nullptr;
+}
+
+FrameStatus decodeSolveRequest(const char* data, size_t size, BinarySolveRequest& request,
+                               size_t& consumed) {
+    if (size < 4) return FrameStatus::INCOMPLETE;
+    if (getU32(data) != BINARY_REQUEST_BYTES) return FrameStatus::BAD_FRAME;
+    if (size < 4 + BINARY_REQUEST_BYTES) return FrameStatus::INCOMPLETE;
+
+    const char* payload = data + 4;
+    request.version = static_cast<uint8_t>(payload[0]);
+    request.solver = static_cast<uint8_t>(payload[1]);
+    request.metric = static_cast<uint8_t>(payload[2]);
+    request.maxDepth = static_cast<uint8_t>(payload[3]);
+    request.tag = getU32(payload + 4);
+    request.deadlineMicros = getU32(payload + 8);
+    std::memcpy(&request.cube, payload + 12, sizeof(CubieCube));
+    consumed = 4 + BINARY_REQUEST_BYTES;
+    return FrameStatus::COMPLETE;
+}
+
+void encodeSolveResponse(std::string& out, const BinarySolveResponse& response) {
+    size_t moves = std::min<size_t>(response.solution.size(), 255);
+    putU32(out, static_cast<uint32_t>(BINARY_RESPONSE_BYTES + moves));
+    out += static_cast<char>(BINARY_PROTOCOL_VERSION);
+    out += static_cast<char>(response.status);
+    out += static_cast<char>(response.cached ? 1 : 0);
+    out += static_cast<char>(moves);
+    putU32(out, response.tag);
+    putU64(out, response.nodes);
+    putU32(out, response.micros);
+    for (size_t i = 0; i < moves; ++i) out += static_cast<char>(moveIndex(response.solution[i]));
+}
+
+void encodeSolveRequest(std::string& out, const BinarySolveRequest& request) {
+    putU32(out, BINARY_REQUEST_BYTES);
+    out += static_cast<char>(request.version);
+    out += static_cast<char>(request.solver);
+    out += static_cast<char>(request.metric);
+    out += static_cast<char>(request.maxDepth);
+    putU32(out, request.tag);
+    putU32(out, request.deadlineMicros);
+    out.append(reinterpret_cast<const char*>(&request.cube), sizeof(CubieCube));
+}
+
+FrameStatus decodeSolveResponse(const char* data, size_t size, BinarySolveResponse& response,
+                                size_t& consumed) {
+    if (size < 4) return FrameStatus::INCOMPLETE;
+    uint32_t length = getU32(data);
+    if (length < BINARY_RESPONSE_BYTES || length > BINARY_RESPONSE_BYTES + 255) return FrameStatus::BAD_FRAME;
+    if (size < 4 + length) return FrameStatus::INCOMPLETE;
+
+    const char* payload = data + 4;
+    size_t moves = static_cast<unsigned char>(payload[3]);
+    if (static_cast<uint8_t>(payload[0]) != BINARY_PROTOCOL_VERSION || length != BINARY_RESPONSE_BYTES + moves) {
+        return FrameStatus::BAD_FRAME;
+    }
+    response.status = static_cast<BinaryStatus>(payload[1]);
+    response.cached = (payload[2] & 1) != 0;
+    response.tag = getU32(payload + 4);
+    response.nodes = getU64(payload + 8);
+    response.micros = getU32(payload + 16);
+    response.solution.clear();
+    for (size_t i = 0; i < moves; ++i) {
+        uint8_t id = static_cast<uint8_t>(payload[BINARY_RESPONSE_BYTES + i]);
+        if (id >= NUM_MOVES) return FrameStatus::BAD_FRAME;
+        response.solution.push_back(static_cast<Move>(id));
+    }
+    consumed = 4 + length;
+    return FrameStatus::COMPLETE;
+}
@@ -0,0 +1,190 @@
+#include "cube_symmetry.hpp"
+#include <array>
+#include <map>
+#include <string>
+
+namespace {
+
+// Axes: x points to R, y to U, z to F. Faces in RubiksCube::Face order.
+const int FACE_NORMALS[6][3] = {
+    {0, 1, 0}, {0, -1, 0}, {0, 0, 1}, {0, 0, -1}, {-1, 0, 0}, {1, 0, 0}
+};
+
+using Vec = std::array<int, 3>;
+
+// Position of sticker i (row-major, 0..8) on a face in the 54-char layout,
+// scaled by two and pushed out along the normal so every sticker gets a
+// distinct integer point
+Vec stickerPoint(int face, int sticker) {
+    int a = sticker % 3 - 1;  // column
+    int b = sticker / 3 - 1;  // row
+    Vec p;
+    switch (face) {
+        case 0: p = {a, 1, b}; break;    // U: back row first
+        case 1: p = {a, -1, -b}; break;  // D: front row first
+        case 2: p = {a, -b, 1}; break;   // F
+        case 3: p = {-a, -b, -1}; break; // B: seen from behind
+        case 4: p = {-1, -b, a}; break;  // L: back column first
+        default: p = {1, -b, -a}; break; // R: front column first
+    }
+    return {2 * p[0] + FACE_NORMALS[face][0],
+            2 * p[1] + FACE_NORMALS[face][1],
+            2 * p[2] + FACE_NORMALS[face][2]};
+}
+
+struct SymmetryTables {
+    int matrix[CubeSymmetry::COUNT][3][3];
+    bool mirror[CubeSymmetry::COUNT];
+    int inverse[CubeSymmetry::COUNT];
+    int face[CubeSymmetry::COUNT][6];             // face f goes to face[s][f]
+    uint8_t facelet[CubeSymmetry::COUNT][54];     // sticker i goes to facelet[s][i]
+    Move move[CubeSymmetry::COUNT][NUM_MOVES];
+};
+
+Vec transform(const int m[3][3], const Vec& v) {
+    Vec r;
+    for (int i = 0; i < 3; ++i) {
+        r[i] = m[i][0] * v[0] + m[i][1] * v[1] + m[i][2] * v[2];
+    }
+    return r;
+}
+
+int findFace(const Vec& normal) {
+    for (int f = 0; f < 6; ++f) {
+        if (normal[0] == FACE_NORMALS[f][0] && normal[1] == FACE_NORMALS[f][1] &&
+            normal[2] == FACE_NORMALS[f][2]) {
+            return f;
+        }
+    }
+    return -1;
+}
+
+// Every signed permutation matrix is a symmetry: 6 permutations x 8 sign
+// patterns. The identity comes first.
+SymmetryTables buildTables() {
+    SymmetryTables t{};
+
+    std::map<Vec, int> pointIndex;
+    for (int f = 0; f < 6; ++f) {
+        for (int i = 0; i < 9; ++i) {
+            pointIndex[stickerPoint(f, i)] = f * 9 + i;
+        }
+    }
+
+    const int PERMS[6][3] = {{0, 1, 2}, {0, 2, 1}, {1, 0, 2}, {1, 2, 0}, {2, 0, 1}, {2, 1, 0}};
+    const int PERM_PARITY[6] = {1, -1, -1, 1, 1, -1};
+    int s = 0;
+    for (int p = 0; p < 6; ++p) {
+        for (int signs = 0; signs < 8; ++signs, ++s) {
+            int det = PERM_PARITY[p];
+            for (int row = 0; row < 3; ++row) {
+                int sign = (signs >> row) & 1 ? -1 : 1;
+                det *= sign;
+                for (int col = 0; col < 3; ++col) {
+                    t.matrix[s][row][col] = PERMS[p][row] == col ? sign : 0;
+                }
+            }
+            t.mirror[s] = det < 0;
+
+            for (int f = 0; f < 6; ++f) {
+                Vec n = {FACE_NORMALS[f][0], FACE_NORMALS[f][1], FACE_NORMALS[f][2]};
+                t.face[s][f] = findFace(transform(t.matrix[s], n));
+            }
+            for (int i = 0; i < 54; ++i) {
+                t.facelet[s][i] = static_cast<uint8_t>(
+                    pointIndex.at(transform(t.matrix[s], stickerPoint(i / 9, i % 9))));
+            }
+            // A turn keeps its sense under a rotation and reverses it in a mirror
+            for (int m = 0; m < NUM_MOVES; ++m) {
+                int turn = m % 3;
+                if (t.mirror[s] && turn < 2) turn = 1 - turn;
+                t.move[s][m] = static_cast<Move>(t.face[s][m / 3] * 3 + turn);
+            }
+        }
+    }
+
+    // Orthogonal matrices: the inverse is the transpose
+    for (int a = 0; a < CubeSymmetry::COUNT; ++a) {
+        for (int b = 0; b < CubeSymmetry::COUNT; ++b) {
+            bool transposed = true;
+            for (int i = 0; i < 3 && transposed; ++i) {
+                for (int j = 0; j < 3; ++j) {
+                    if (t.matrix[a][i][j] != t.matrix[b][j][i]) {
+                        transposed = false;
+                        break;
+                    }
+                }
+            }
+            if (transposed) {
+                t.inverse[a] = b;
+                break;
+            }
+        }
+    }
+    return t;
+}
+
+const SymmetryTables& tables() {
+    static const SymmetryTables t = buildTables();
+    return t;
+}
+
+std::string applyToString(const SymmetryTables& t, int sym, const std::string& state) {
+    // Rename colours through the centres: whatever sits on the centre of face
+    // f is renamed to the colour of the centre of the face f goes to
+    char rename[256];
+    for (int c = 0; c < 256; ++c) rename[c] = static_cast<char>(c);
+    for (int f = 0; f < 6; ++f) {
+        rename[static_cast<unsigned char>(state[f * 9 + 4])] = state[t.face[sym][f] * 9 + 4];
+    }
+
+    std::string result(54, '?');
+    for (int i = 0; i < 54; ++i) {
+        result[t.facelet[sym][i]] = rename[static_cast<unsigned char>(state[i])];
+    }
+    return result;
+}
+
+} // namespace
+
+RubiksCube CubeSymmetry::apply(int sym, const RubiksCube& cube) {
+    return RubiksCube(applyToString(tables(), sym, cube.toString()));
+}
+
+Move CubeSymmetry::mapMove(int sym, Move move) {
+    return tables().move[sym][moveIndex(move)];
+}
+
+std::vector<Move> CubeSymmetry::mapMoves(int sym, const std::vector<Move>& moves) {
+    const SymmetryTables& t = tables();
+    std::vector<Move> result;
+    result.reserve(moves.size());
+    for (Move m : moves) result.push_back(t.move[sym][moveIndex(m)]);
+    return result;
+}
+
+int CubeSymmetry::inverse(int sym) {
+    return tables().inverse[sym];
+}
+
+bool CubeSymmetry::isMirror(int sym) {
+    return tables().mirror[sym];
+}
+
+RubiksCube CubeSymmetry::canonical(const RubiksCube& cube, int* sym) {
+    const SymmetryTables& t = tables();
+    const std::string state = cube.toString();
+
+    std::string best = state;
+    int bestSym = IDENTITY;
+    for (int s = 1; s < COUNT; ++s) {
+        std::string candidate = applyToString(t, s, state);
+        if (candidate < best) {
+            best = std::move(candidate);
+            bestSym = s;
+        }
+    }
+
+    if (sym) *sym = bestSym;
+    return RubiksCube(best);
+}
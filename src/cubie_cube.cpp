@@ -0,0 +1,358 @@
+#include "cubie_cube.hpp"
+#include "facelet_moves.hpp"
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+
+// Facelet index (face * 9 + sticker) of each corner slot, starting with the
+// U/D sticker and going clockwise around the corner.
+constexpr int CORNER_FACELETS[8][3] = {
+    {0 * 9 + 8, 5 * 9 + 0, 2 * 9 + 2},  // URF: U8 R0 F2
+    {0 * 9 + 6, 2 * 9 + 0, 4 * 9 + 2},  // UFL: U6 F0 L2
+    {0 * 9 + 0, 4 * 9 + 0, 3 * 9 + 2},  // ULB: U0 L0 B2
+    {0 * 9 + 2, 3 * 9 + 0, 5 * 9 + 2},  // UBR: U2 B0 R2
+    {1 * 9 + 2, 2 * 9 + 8, 5 * 9 + 6},  // DFR: D2 F8 R6
+    {1 * 9 + 0, 4 * 9 + 8, 2 * 9 + 6},  // DLF: D0 L8 F6
+    {1 * 9 + 6, 3 * 9 + 8, 4 * 9 + 6},  // DBL: D6 B8 L6
+    {1 * 9 + 8, 5 * 9 + 8, 3 * 9 + 6},  // DRB: D8 R8 B6
+};
+
+// Facelet index of each edge slot, U/D (or F/B for slice edges) sticker first.
+constexpr int EDGE_FACELETS[12][2] = {
+    {0 * 9 + 5, 5 * 9 + 1},  // UR
+    {0 * 9 + 7, 2 * 9 + 1},  // UF
+    {0 * 9 + 3, 4 * 9 + 1},  // UL
+    {0 * 9 + 1, 3 * 9 + 1},  // UB
+    {1 * 9 + 5, 5 * 9 + 7},  // DR
+    {1 * 9 + 1, 2 * 9 + 7},  // DF
+    {1 * 9 + 3, 4 * 9 + 7},  // DL
+    {1 * 9 + 7, 3 * 9 + 7},  // DB
+    {2 * 9 + 5, 5 * 9 + 3},  // FR
+    {2 * 9 + 3, 4 * 9 + 5},  // FL
+    {3 * 9 + 5, 4 * 9 + 3},  // BL
+    {3 * 9 + 3, 5 * 9 + 5},  // BR
+};
+
+const char SOLVED_COLORS[6] = {'W', 'Y', 'G', 'B', 'O', 'R'};
+
+constexpr int faceOfFacelet(int facelet) { return facelet / 9; }
+
+constexpr uint8_t cornerByte(int cubie, int twist) {
+    return static_cast<uint8_t>(cubie | (twist << 3));
+}
+
+constexpr uint8_t edgeByte(int cubie, int flip) {
+    return static_cast<uint8_t>(cubie | (flip << 4));
+}
+
+using cubie_detail::MoveTables;
+
+constexpr MoveTables buildMoveTables() {
+    MoveTables t{};
+
+    // Derive every move from the facelet permutations, reading the turned
+    // solved cube the way fromFacelets() does, so both representations
+    // always agree on what a move does.
+    for (int m = 0; m < NUM_MOVES; ++m) {
+        int faces[facelet_moves::STICKERS] = {};
+        for (int i = 0; i < facelet_moves::STICKERS; ++i) {
+            faces[i] = faceOfFacelet(FACELET_MOVES.perm[m][i]);
+        }
+
+        for (int i = 0; i < 8; ++i) {
+            int twist = 0;
+            while (faces[CORNER_FACELETS[i][twist]] != RubiksCube::UP &&
+                   faces[CORNER_FACELETS[i][twist]] != RubiksCube::DOWN) {
+                twist++;
+            }
+            int src = 0;
+            while (faces[CORNER_FACELETS[i][(twist + 1) % 3]] != faceOfFacelet(CORNER_FACELETS[src][1]) ||
+                   faces[CORNER_FACELETS[i][(twist + 2) % 3]] != faceOfFacelet(CORNER_FACELETS[src][2])) {
+                src++;
+            }
+            t.cornerSrc[m][i] = static_cast<uint8_t>(src);
+            for (int cubie = 0; cubie < 8; ++cubie) {
+                for (int o = 0; o < 3; ++o) {
+                    t.cornerMap[m][i][cornerByte(cubie, o)] = cornerByte(cubie, (o + twist) % 3);
+                }
+            }
+        }
+        for (int i = 0; i < 12; ++i) {
+            int a = faces[EDGE_FACELETS[i][0]];
+            int b = faces[EDGE_FACELETS[i][1]];
+            int src = 0, flip = 0;
+            for (int j = 0; j < 12; ++j) {
+                int ja = faceOfFacelet(EDGE_FACELETS[j][0]);
+                int jb = faceOfFacelet(EDGE_FACELETS[j][1]);
+                if (a == ja && b == jb) { src = j; flip = 0; break; }
+                if (a == jb && b == ja) { src = j; flip = 1; break; }
+            }
+            t.edgeSrc[m][i] = static_cast<uint8_t>(src);
+            for (int cubie = 0; cubie < 12; ++cubie) {
+                for (int o = 0; o < 2; ++o) {
+                    t.edgeMap[m][i][edgeByte(cubie, o)] = edgeByte(cubie, o ^ flip);
+                }
+            }
+        }
+    }
+
+    for (int i = 0; i < 8; ++i) {
+        for (int cubie = 0; cubie < 8; ++cubie) {
+            for (int o = 0; o < 3; ++o) {
+                int misplaced = 0;
+                for (int n = 0; n < 3; ++n) {
+                    int shown = faceOfFacelet(CORNER_FACELETS[cubie][n]);
+                    int at = faceOfFacelet(CORNER_FACELETS[i][(n + o) % 3]);
+                    if (shown != at) misplaced++;
+                }
+                t.cornerMisplaced[i][cornerByte(cubie, o)] = static_cast<uint8_t>(misplaced);
+            }
+        }
+    }
+    for (int i = 0; i < 12; ++i) {
+        for (int cubie = 0; cubie < 12; ++cubie) {
+            for (int o = 0; o < 2; ++o) {
+                int misplaced = 0;
+                for (int n = 0; n < 2; ++n) {
+                    int shown = faceOfFacelet(EDGE_FACELETS[cubie][n]);
+                    int at = faceOfFacelet(EDGE_FACELETS[i][(n + o) % 2]);
+                    if (shown != at) misplaced++;
+                }
+                t.edgeMisplaced[i][edgeByte(cubie, o)] = static_cast<uint8_t>(misplaced);
+            }
+        }
+    }
+
+    return t;
+}
+
+// splitmix64 finalizer
+uint64_t mix64(uint64_t z) {
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+} // namespace
+
+// Constant-initialized, so moves work during static initialization too
+constexpr MoveTables cubie_detail::MOVE_TABLES = buildMoveTables();
+
+CubieCube::CubieCube() {
+    reset();
+}
+
+CubieCube::CubieCube(const RubiksCube& cube) {
+    *this = fromFacelets(cube);
+}
+
+CubieCube::CubieCube(const std::string& state) {
+    fromString(state);
+}
+
+void CubieCube::reset() {
+    for (int i = 0; i < NUM_CORNERS; ++i) corners_[i] = cornerByte(i, 0);
+    for (int i = 0; i < NUM_EDGES; ++i) edges_[i] = edgeByte(i, 0);
+}
+
+void CubieCube::applyMove(Move m) {
+    const MoveTables& t = cubie_detail::MOVE_TABLES;
+    const int move = moveIndex(m);
+    std::array<uint8_t, NUM_CORNERS> c;
+    std::array<uint8_t, NUM_EDGES> e;
+    for (int i = 0; i < NUM_CORNERS; ++i) {
+        c[i] = t.cornerMap[move][i][corners_[t.cornerSrc[move][i]]];
+    }
+    for (int i = 0; i < NUM_EDGES; ++i) {
+        e[i] = t.edgeMap[move][i][edges_[t.edgeSrc[move][i]]];
+    }
+    corners_ = c;
+    edges_ = e;
+}
+
+void CubieCube::applyMove(const std::string& move) {
+    applyMove(moveFromString(move));
+}
+
+CubieCube CubieCube::fromFacelets(const RubiksCube& cube) {
+    std::string state = cube.toString();
+
+    // Map sticker colors to faces through the (fixed) centers
+    int colorToFace[256];
+    for (int& f : colorToFace) f = -1;
+    for (int f = 0; f < 6; ++f) {
+        unsigned char center = static_cast<unsigned char>(state[f * 9 + 4]);
+        if (colorToFace[center] != -1) {
+            throw std::invalid_argument("Duplicate center color");
+        }
+        colorToFace[center] = f;
+    }
+
+    int faces[54];
+    for (int i = 0; i < 54; ++i) {
+        faces[i] = colorToFace[static_cast<unsigned char>(state[i])];
+        if (faces[i] < 0) {
+            throw std::invalid_argument("Unknown sticker color");
+        }
+    }
+
+    CubieCube result;
+    int cornerSeen = 0, edgeSeen = 0;
+    int twistSum = 0, flipSum = 0;
+
+    for (int i = 0; i < NUM_CORNERS; ++i) {
+        int ori = 0;
+        while (ori < 3) {
+            int face = faces[CORNER_FACELETS[i][ori]];
+            if (face == RubiksCube::UP || face == RubiksCube::DOWN) break;
+            ori++;
+        }
+        if (ori == 3) throw std::invalid_argument("Invalid corner");
+
+        int col1 = faces[CORNER_FACELETS[i][(ori + 1) % 3]];
+        int col2 = faces[CORNER_FACELETS[i][(ori + 2) % 3]];
+        int cubie = -1;
+        for (int j = 0; j < NUM_CORNERS; ++j) {
+            if (col1 == faceOfFacelet(CORNER_FACELETS[j][1]) &&
+                col2 == faceOfFacelet(CORNER_FACELETS[j][2])) {
+                cubie = j;
+                break;
+            }
+        }
+        if (cubie < 0 || (cornerSeen & (1 << cubie))) {
+            throw std::invalid_argument("Invalid corner");
+        }
+        cornerSeen |= 1 << cubie;
+        twistSum += ori;
+        result.corners_[i] = cornerByte(cubie, ori);
+    }
+
+    for (int i = 0; i < NUM_EDGES; ++i) {
+        int a = faces[EDGE_FACELETS[i][0]];
+        int b = faces[EDGE_FACELETS[i][1]];
+        int cubie = -1, flip = 0;
+        for (int j = 0; j < NUM_EDGES; ++j) {
+            int ja = faceOfFacelet(EDGE_FACELETS[j][0]);
+            int jb = faceOfFacelet(EDGE_FACELETS[j][1]);
+            if (a == ja && b == jb) { cubie = j; flip = 0; break; }
+            if (a == jb && b == ja) { cubie = j; flip = 1; break; }
+        }
+        if (cubie < 0 || (edgeSeen & (1 << cubie))) {
+            throw std::invalid_argument("Invalid edge");
+        }
+        edgeSeen |= 1 << cubie;
+        flipSum += flip;
+        result.edges_[i] = edgeByte(cubie, flip);
+    }
+
+    if (twistSum % 3 != 0) throw std::invalid_argument("Twisted corner");
+    if (flipSum % 2 != 0) throw std::invalid_argument("Flipped edge");
+
+    // Corner and edge permutations must have the same parity
+    int parity = 0;
+    for (int i = 0; i < NUM_CORNERS; ++i)
+        for (int j = i + 1; j < NUM_CORNERS; ++j)
+            if (result.getCornerPermutation(i) > result.getCornerPermutation(j)) parity ^= 1;
+    for (int i = 0; i < NUM_EDGES; ++i)
+        for (int j = i + 1; j < NUM_EDGES; ++j)
+            if (result.getEdgePermutation(i) > result.getEdgePermutation(j)) parity ^= 1;
+    if (parity) throw std::invalid_argument("Parity error");
+
+    return result;
+}
+
+bool CubieCube::isValid() const {
+    unsigned seenCorners = 0, seenEdges = 0;
+    int twistSum = 0, flipSum = 0;
+    for (int i = 0; i < NUM_CORNERS; ++i) {
+        if (corners_[i] >= 24) return false;  // twist 3
+        seenCorners |= 1u << getCornerPermutation(i);
+        twistSum += getCornerOrientation(i);
+    }
+    for (int i = 0; i < NUM_EDGES; ++i) {
+        if (edges_[i] >= 32 || getEdgePermutation(i) >= NUM_EDGES) return false;
+        seenEdges |= 1u << getEdgePermutation(i);
+        flipSum += getEdgeOrientation(i);
+    }
+    if (seenCorners != (1u << NUM_CORNERS) - 1 || seenEdges != (1u << NUM_EDGES) - 1) return false;
+    if (twistSum % 3 != 0 || flipSum % 2 != 0) return false;
+
+    int parity = 0;
+    for (int i = 0; i < NUM_CORNERS; ++i)
+        for (int j = i + 1; j < NUM_CORNERS; ++j)
+            if (getCornerPermutation(i) > getCornerPermutation(j)) parity ^= 1;
+    for (int i = 0; i < NUM_EDGES; ++i)
+        for (int j = i + 1; j < NUM_EDGES; ++j)
+            if (getEdgePermutation(i) > getEdgePermutation(j)) parity ^= 1;
+    return parity == 0;
+}
+
+RubiksCube CubieCube::toFacelets() const {
+    return RubiksCube(toString());
+}
+
+std::string CubieCube::toString() const {
+    std::string state(54, ' ');
+    for (int f = 0; f < 6; ++f) {
+        state[f * 9 + 4] = SOLVED_COLORS[f];
+    }
+    for (int i = 0; i < NUM_CORNERS; ++i) {
+        int cubie = getCornerPermutation(i);
+        int ori = getCornerOrientation(i);
+        for (int n = 0; n < 3; ++n) {
+            state[CORNER_FACELETS[i][(n + ori) % 3]] =
+                SOLVED_COLORS[faceOfFacelet(CORNER_FACELETS[cubie][n])];
+        }
+    }
+    for (int i = 0; i < NUM_EDGES; ++i) {
+        int cubie = getEdgePermutation(i);
+        int flip = getEdgeOrientation(i);
+        for (int n = 0; n < 2; ++n) {
+            state[EDGE_FACELETS[i][(n + flip) % 2]] =
+                SOLVED_COLORS[faceOfFacelet(EDGE_FACELETS[cubie][n])];
+        }
+    }
+    return state;
+}
+
+void CubieCube::fromString(const std::string& state) {
+    *this = fromFacelets(RubiksCube(state));
+}
+
+bool CubieCube::operator==(const CubieCube& other) const {
+    return corners_ == other.corners_ && edges_ == other.edges_;
+}
+
+bool CubieCube::operator!=(const CubieCube& other) const {
+    return !(*this == other);
+}
+
+size_t CubieCube::hash() const {
+    uint64_t a, b;
+    uint32_t c;
+    std::memcpy(&a, corners_.data(), 8);
+    std::memcpy(&b, edges_.data(), 8);
+    std::memcpy(&c, edges_.data() + 8, 4);
+
+    // splitmix64-style finalizer over the three words
+    uint64_t h = a ^ (b * 0x9E3779B97F4A7C15ULL) ^ (static_cast<uint64_t>(c) << 17);
+    h ^= h >> 30; h *= 0xBF58476D1CE4E5B9ULL;
+    h ^= h >> 27; h *= 0x94D049BB133111EBULL;
+    h ^= h >> 31;
+    return static_cast<size_t>(h);
+}
+
+uint64_t CubieCube::fingerprint(uint64_t salt) const {
+    uint64_t a, b;
+    uint32_t c;
+    std::memcpy(&a, corners_.data(), 8);
+    std::memcpy(&b, edges_.data(), 8);
+    std::memcpy(&c, edges_.data() + 8, 4);
+
+    // Each step is a bijection of the running value, so no two words can
+    // cancel each other out
+    uint64_t h = mix64(a + 0x9E3779B97F4A7C15ULL);
+    h = mix64(h ^ b);
+    return mix64(h ^ (static_cast<uint64_t>(c) | (salt << 32)));
+}
@@ -0,0 +1,189 @@
+// src/facelet_kernel.cpp - Facelet moves as precomputed byte permutations
+#include "facelet_kernel.hpp"
+#include "facelet_moves.hpp"
+#include <atomic>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define FACELET_KERNEL_X86 1
+#endif
+
+namespace {
+
+// The center permutation (every sticker takes its face's center) comes
+// after the 18 moves, so isSolved shares the move code
+constexpr int CENTERS = NUM_MOVES;
+constexpr int PERMUTATIONS = NUM_MOVES + 1;
+
+struct Tables {
+    // Sticker i of the result is sticker perm[m][i] of the input; the
+    // padding maps to itself
+    alignas(64) uint8_t perm[PERMUTATIONS][FaceletKernel::BLOCK_BYTES];
+    // AVX2: for each 32-byte output half and each 16-byte input chunk, the
+    // pshufb mask picking that chunk's bytes (0x80 elsewhere)
+    alignas(32) uint8_t shuffle[PERMUTATIONS][2][4][32];
+};
+
+constexpr Tables buildTables() {
+    Tables t{};
+    for (int m = 0; m < NUM_MOVES; ++m) {
+        for (int i = 0; i < FaceletKernel::BLOCK_BYTES; ++i) t.perm[m][i] = FACELET_MOVES.perm[m][i];
+    }
+    for (int i = FaceletKernel::STICKERS; i < FaceletKernel::BLOCK_BYTES; ++i) {
+        t.perm[CENTERS][i] = static_cast<uint8_t>(i);
+    }
+    for (int i = 0; i < FaceletKernel::STICKERS; ++i) {
+        t.perm[CENTERS][i] = static_cast<uint8_t>(facelet_moves::sticker(i / 9, 4));
+    }
+
+    for (int m = 0; m < PERMUTATIONS; ++m) {
+        for (int half = 0; half < 2; ++half) {
+            for (int chunk = 0; chunk < 4; ++chunk) {
+                for (int j = 0; j < 32; ++j) {
+                    int source = t.perm[m][half * 32 + j];
+                    t.shuffle[m][half][chunk][j] =
+                        static_cast<uint8_t>(source / 16 == chunk ? source % 16 : 0x80);
+                }
+            }
+        }
+    }
+    return t;
+}
+
+// Built at compile time, so solvers constructed during static
+// initialization never see an empty table
+constexpr Tables TABLES = buildTables();
+
+constexpr uint64_t STICKER_BITS = (uint64_t{1} << FaceletKernel::STICKERS) - 1;
+
+void applyMoveScalar(char* block, int move) {
+    char in[FaceletKernel::BLOCK_BYTES];
+    std::memcpy(in, block, sizeof(in));
+    const uint8_t* perm = TABLES.perm[move];
+    for (int i = 0; i < FaceletKernel::STICKERS; ++i) block[i] = in[perm[i]];
+}
+
+uint64_t mismatchesScalar(const char* block) {
+    const uint8_t* centers = TABLES.perm[CENTERS];
+    uint64_t bits = 0;
+    for (int i = 0; i < FaceletKernel::STICKERS; ++i) {
+        bits |= static_cast<uint64_t>(block[i] != block[centers[i]]) << i;
+    }
+    return bits;
+}
+
+#ifdef FACELET_KERNEL_X86
+
+// pshufb only shuffles within 16-byte lanes: each input chunk is broadcast
+// to both lanes and the per-chunk masks pick out what every output byte
+// needs from it
+__attribute__((target("avx2")))
+inline void permuteAVX2(const char* block, int m, __m256i& low, __m256i& high) {
+    const __m128i* in = reinterpret_cast<const __m128i*>(block);
+    __m256i chunks[4];
+    for (int c = 0; c < 4; ++c) chunks[c] = _mm256_broadcastsi128_si256(_mm_load_si128(in + c));
+    __m256i halves[2];
+    for (int h = 0; h < 2; ++h) {
+        const __m256i* masks = reinterpret_cast<const __m256i*>(TABLES.shuffle[m][h]);
+        halves[h] = _mm256_or_si256(
+            _mm256_or_si256(_mm256_shuffle_epi8(chunks[0], _mm256_load_si256(masks + 0)),
+                            _mm256_shuffle_epi8(chunks[1], _mm256_load_si256(masks + 1))),
+            _mm256_or_si256(_mm256_shuffle_epi8(chunks[2], _mm256_load_si256(masks + 2)),
+                            _mm256_shuffle_epi8(chunks[3], _mm256_load_si256(masks + 3))));
+    }
+    low = halves[0];
+    high = halves[1];
+}
+
+__attribute__((target("avx2")))
+void applyMoveAVX2(char* block, int move) {
+    __m256i low, high;
+    permuteAVX2(block, move, low, high);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(block), low);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(block) + 1, high);
+}
+
+__attribute__((target("avx2")))
+uint64_t mismatchesAVX2(const char* block) {
+    __m256i low, high;
+    permuteAVX2(block, CENTERS, low, high);
+    const __m256i* in = reinterpret_cast<const __m256i*>(block);
+    uint64_t equal =
+        static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_load_si256(in), low))) |
+        static_cast<uint64_t>(static_cast<uint32_t>(
+            _mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_load_si256(in + 1), high)))) << 32;
+    return ~equal & STICKER_BITS;
+}
+
+// The unmasked _mm512_permutexvar_epi8 trips GCC 12's -Wuninitialized on
+// the header's undefined source (a false positive); an all-ones zero mask
+// is the same vpermb without it
+constexpr __mmask64 ALL_BYTES = ~__mmask64{0};
+
+__attribute__((target("avx512f,avx512bw,avx512vbmi")))
+void applyMoveAVX512(char* block, int move) {
+    __m512i stickers = _mm512_load_si512(block);
+    __m512i perm = _mm512_load_si512(TABLES.perm[move]);
+    _mm512_store_si512(block, _mm512_maskz_permutexvar_epi8(ALL_BYTES, perm, stickers));
+}
+
+__attribute__((target("avx512f,avx512bw,avx512vbmi")))
+uint64_t mismatchesAVX512(const char* block) {
+    __m512i stickers = _mm512_load_si512(block);
+    __m512i centers = _mm512_maskz_permutexvar_epi8(ALL_BYTES, _mm512_load_si512(TABLES.perm[CENTERS]), stickers);
+    return _mm512_cmpneq_epi8_mask(stickers, centers) & STICKER_BITS;
+}
+
+#endif
+
+} // namespace
+
+const FaceletKernel::Table FaceletKernel::KERNELS[3] = {
+    {Kind::SCALAR, applyMoveScalar, mismatchesScalar},
+#ifdef FACELET_KERNEL_X86
+    {Kind::AVX2, applyMoveAVX2, mismatchesAVX2},
+    {Kind::AVX512, applyMoveAVX512, mismatchesAVX512},
+#else
+    {Kind::AVX2, applyMoveScalar, mismatchesScalar},
+    {Kind::AVX512, applyMoveScalar, mismatchesScalar},
+#endif
+};
+
+std::atomic<const FaceletKernel::Table*> FaceletKernel::active_{nullptr};
+
+bool FaceletKernel::supported(Kind kind) {
+    switch (kind) {
+        case Kind::SCALAR: return true;
+#ifdef FACELET_KERNEL_X86
+        case Kind::AVX2: return __builtin_cpu_supports("avx2");
+        case Kind::AVX512:
+            return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw") &&
+                   __builtin_cpu_supports("avx512vbmi");
+#endif
+        default: return false;
+    }
+}
+
+bool FaceletKernel::select(Kind kind) {
+    if (!supported(kind)) return false;
+    active_.store(&KERNELS[static_cast<int>(kind)], std::memory_order_relaxed);
+    return true;
+}
+
+const char* FaceletKernel::name(Kind kind) {
+    switch (kind) {
+        case Kind::SCALAR: return "scalar";
+        case Kind::AVX2: return "avx2";
+        case Kind::AVX512: return "avx512";
+    }
+    return "unknown";
+}
+
+// Threads racing here all pick the same kernel
+const FaceletKernel::Table& FaceletKernel::resolve() {
+    Kind best = supported(Kind::AVX512) ? Kind::AVX512
+              : supported(Kind::AVX2) ? Kind::AVX2 : Kind::SCALAR;
+    select(best);
+    return KERNELS[static_cast<int>(best)];
+}
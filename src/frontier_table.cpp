@@ -0,0 +1,233 @@
+// src/frontier_table.cpp - Positions near solved, for the bidirectional solver
+#include "frontier_table.hpp"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <ostream>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+const char FILE_MAGIC[8] = {'R', 'C', 'F', 'R', 'O', 'N', 'T', 0};
+const uint64_t DATA_ALIGNMENT = 4096;
+
+// On-disk layout (host byte order): the header, then the keys and the info
+// bytes at page-aligned offsets
+struct FileHeader {
+    char magic[8];
+    uint32_t version;
+    uint8_t metric;
+    uint8_t depth;
+    uint8_t reserved[2];
+    uint64_t capacity;
+    uint64_t count;
+    uint64_t keysOffset;
+    uint64_t infoOffset;
+};
+
+static_assert(sizeof(FileHeader) == 48, "Unexpected FileHeader layout");
+
+uint64_t alignUp(uint64_t value) {
+    return (value + DATA_ALIGNMENT - 1) / DATA_ALIGNMENT * DATA_ALIGNMENT;
+}
+
+std::mutex defaultMutex;
+std::shared_ptr<const FrontierTable> defaultTables[2];
+size_t defaultBytes = FrontierTable::DEFAULT_BYTES;
+
+} // namespace
+
+FrontierTable::~FrontierTable() {
+    if (mapping_) munmap(mapping_, mappingSize_);
+}
+
+bool FrontierTable::insert(const CubieCube& cube, int distance, Move move) {
+    uint64_t key = keyOf(cube);
+    uint64_t slot = key & (capacity_ - 1);
+    for (; ownedKeys_[slot] != 0; slot = (slot + 1) & (capacity_ - 1)) {
+        if (ownedKeys_[slot] == key) return false;
+    }
+    ownedKeys_[slot] = key;
+    uint8_t moveBits = move == NO_MOVE ? MOVE_MASK : static_cast<uint8_t>(moveIndex(move));
+    ownedInfo_[slot] = static_cast<uint8_t>(moveBits | (distance << MOVE_BITS));
+    ++count_;
+    return true;
+}
+
+// Every canonical sequence of exactly depth moves ends on a position whose
+// distance is depth unless a shorter one, already in the table, reaches it
+void FrontierTable::fill(const CubieCube& cube, int depth, int remaining, Move last,
+                         MoveSequenceAutomaton::State state, const MoveSequenceAutomaton& automaton,
+                         uint64_t& added) {
+    if (remaining == 0) {
+        if (count_ * 2 >= capacity_) throw std::runtime_error("Frontier table is full");
+        if (insert(cube, depth, last)) ++added;
+        return;
+    }
+    for (Move move : automaton.allowed(state)) {
+        CubieCube next = cube;
+        next.applyMove(move);
+        fill(next, depth, remaining - 1, move, automaton.next(state, move), automaton, added);
+    }
+}
+
+std::shared_ptr<FrontierTable> FrontierTable::build(Metric metric, size_t maxBytes, int maxDepth,
+                                                    std::ostream* log) {
+    if (maxBytes < 64 * SLOT_BYTES) {
+        throw std::invalid_argument("Frontier table needs at least 576 bytes");
+    }
+    auto table = std::make_shared<FrontierTable>();
+    table->metric_ = metric;
+    table->capacity_ = 64;
+    while (table->capacity_ * 2 * SLOT_BYTES <= maxBytes) table->capacity_ *= 2;
+    table->ownedKeys_.assign(table->capacity_, 0);
+    table->ownedInfo_.assign(table->capacity_, 0);
+    table->keys_ = table->ownedKeys_.data();
+    table->info_ = table->ownedInfo_.data();
+
+    const MoveSequenceAutomaton& automaton = MoveSequenceAutomaton::get(metric);
+    table->insert(CubieCube(), 0, NO_MOVE);
+
+    // Each depth is predicted from the growth of the last one; the counts
+    // grow by a slowly falling factor, so the guess errs high
+    uint64_t previous = 1, last = 1;
+    for (int depth = 1; depth <= std::min(maxDepth, MAX_DEPTH); ++depth) {
+        uint64_t predicted = depth == 1 ? automaton.getMoves().size() : last * last / previous;
+        if ((table->count_ + predicted) * 2 > table->capacity_) break;
+
+        uint64_t added = 0;
+        table->fill(CubieCube(), depth, depth, NO_MOVE, MoveSequenceAutomaton::START, automaton, added);
+        table->depth_ = depth;
+        previous = last;
+        last = added;
+        if (log) *log << "  depth " << depth << ": " << added << " positions" << std::endl;
+    }
+    return table;
+}
+
+bool FrontierTable::pathToSolved(const CubieCube& cube, std::vector<Move>& path) const {
+    size_t start = path.size();
+    CubieCube current = cube;
+    while (true) {
+        uint64_t slot = find(keyOf(current));
+        if (slot == NOT_FOUND) break;
+        uint8_t move = info_[slot] & MOVE_MASK;
+        if (move == MOVE_MASK) {
+            // Only a fingerprint collision could end anywhere else
+            if (current.isSolved()) return true;
+            break;
+        }
+        if (path.size() - start >= static_cast<size_t>(depth_)) break;
+        Move back = inverse(static_cast<Move>(move));
+        current.applyMove(back);
+        path.push_back(back);
+    }
+    path.resize(start);
+    return false;
+}
+
+void FrontierTable::save(const std::string& path) const {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        throw std::runtime_error("Cannot open frontier table for writing: " + path);
+    }
+
+    FileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, FILE_MAGIC, sizeof(FILE_MAGIC));
+    header.version = FORMAT_VERSION;
+    header.metric = static_cast<uint8_t>(metric_);
+    header.depth = static_cast<uint8_t>(depth_);
+    header.capacity = capacity_;
+    header.count = count_;
+    header.keysOffset = alignUp(sizeof(FileHeader));
+    header.infoOffset = alignUp(header.keysOffset + capacity_ * sizeof(uint64_t));
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    std::vector<char> padding(header.keysOffset - sizeof(FileHeader), 0);
+    out.write(padding.data(), padding.size());
+    out.write(reinterpret_cast<const char*>(keys_), capacity_ * sizeof(uint64_t));
+    padding.assign(header.infoOffset - header.keysOffset - capacity_ * sizeof(uint64_t), 0);
+    out.write(padding.data(), padding.size());
+    out.write(reinterpret_cast<const char*>(info_), capacity_);
+
+    if (!out) {
+        throw std::runtime_error("Failed to write frontier table: " + path);
+    }
+}
+
+std::shared_ptr<const FrontierTable> FrontierTable::load(const std::string& path) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Cannot open frontier table: " + path);
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(FileHeader))) {
+        close(fd);
+        throw std::runtime_error("Invalid frontier table file: " + path);
+    }
+
+    size_t size = static_cast<size_t>(st.st_size);
+    void* mapping = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        throw std::runtime_error("Cannot map frontier table: " + path);
+    }
+
+    auto table = std::make_shared<FrontierTable>();
+    table->mapping_ = mapping;
+    table->mappingSize_ = size;
+
+    const uint8_t* base = static_cast<const uint8_t*>(mapping);
+    FileHeader header;
+    std::memcpy(&header, base, sizeof(header));
+    if (std::memcmp(header.magic, FILE_MAGIC, sizeof(FILE_MAGIC)) != 0) {
+        throw std::runtime_error("Not a frontier table file: " + path);
+    }
+    if (header.version != FORMAT_VERSION) {
+        throw std::runtime_error("Unsupported frontier table version " +
+                                 std::to_string(header.version) + ": " + path);
+    }
+    bool powerOfTwo = header.capacity >= 2 && (header.capacity & (header.capacity - 1)) == 0;
+    if (!powerOfTwo || header.metric > static_cast<uint8_t>(Metric::HALF_TURN) ||
+        header.depth > MAX_DEPTH || header.count * 2 > header.capacity ||
+        header.keysOffset % alignof(uint64_t) != 0 ||
+        header.keysOffset + header.capacity * sizeof(uint64_t) > size ||
+        header.infoOffset + header.capacity > size) {
+        throw std::runtime_error("Corrupt frontier table header: " + path);
+    }
+
+    table->metric_ = static_cast<Metric>(header.metric);
+    table->depth_ = header.depth;
+    table->capacity_ = header.capacity;
+    table->count_ = header.count;
+    table->keys_ = reinterpret_cast<const uint64_t*>(base + header.keysOffset);
+    table->info_ = base + header.infoOffset;
+
+    // Probed at random; let the kernel know
+    madvise(mapping, size, MADV_RANDOM);
+    return table;
+}
+
+void setDefaultFrontierTable(std::shared_ptr<const FrontierTable> table) {
+    std::lock_guard<std::mutex> lock(defaultMutex);
+    defaultTables[static_cast<int>(table->getMetric())] = std::move(table);
+}
+
+void setFrontierTableBytes(size_t bytes) {
+    std::lock_guard<std::mutex> lock(defaultMutex);
+    defaultBytes = bytes;
+}
+
+std::shared_ptr<const FrontierTable> getFrontierTable(Metric metric) {
+    std::lock_guard<std::mutex> lock(defaultMutex);
+    auto& table = defaultTables[static_cast<int>(metric)];
+    if (!table) table = FrontierTable::build(metric, defaultBytes);
+    return table;
+}
@@ -0,0 +1,39 @@
+#include "heuristic.hpp"
+#include "logging.hpp"
+#include <mutex>
+
+namespace {
+std::mutex dbMutex;
+std::shared_ptr<const PatternDatabase> defaultDb;
+}
+
+void setDefaultPatternDatabase(std::shared_ptr<const PatternDatabase> db) {
+    std::lock_guard<std::mutex> lock(dbMutex);
+    defaultDb = std::move(db);
+}
+
+std::shared_ptr<const PatternDatabase> getDefaultPatternDatabase() {
+    std::lock_guard<std::mutex> lock(dbMutex);
+    return defaultDb;
+}
+
+std::shared_ptr<const Heuristic> createHeuristic(const std::string& type) {
+    if (type == "pdb") {
+        auto db = getDefaultPatternDatabase();
+        if (db) {
+            return std::make_shared<PatternDatabaseHeuristic>(db);
+        }
+        RUBIKS_LOG(WARNING) << "No pattern database loaded, falling back to manhattan";
+    } else if (type != "manhattan" && !type.empty()) {
+        RUBIKS_LOG(WARNING) << "Unknown heuristic: " << type << ", falling back to manhattan";
+    }
+    return std::make_shared<ManhattanHeuristic>();
+}
+
+std::vector<std::string> getAvailableHeuristics() {
+    std::vector<std::string> heuristics = {"manhattan"};
+    if (getDefaultPatternDatabase()) {
+        heuristics.push_back("pdb");
+    }
+    return heuristics;
+}
@@ -1,57 +1,193 @@
-// src/http_server.cpp - Updated with individual algorithm timeouts and speedup adjustments
+// src/http_server.cpp - Updated with individual algorithm timeouts
 #include "http_server.hpp"
+#include "cubie_cube.hpp"
+#include "scrambler.hpp"
 #include "sequential_solver.hpp"
+#include "bidirectional_solver.hpp"
+#include "two_phase_solver.hpp"
+#include "solution_cache.hpp"
+#include "logging.hpp"
+#include "thread_placement.hpp"
+#include "frontier_table.hpp"
 
 #ifdef HAVE_OPENMP
 #include "openmp_solver.hpp"
 #endif
 
 #ifdef HAVE_MPI
-#include "mpi_solver.hpp"
-#include "hybrid_solver.hpp"
+#include "mpi_scheduler.hpp"
 #endif
 
+#include <charconv>
 #include <iomanip>
-#include <iostream>
-#include <sstream>
 #include <cstring>
+#include <cerrno>
 #include <unistd.h>
+#include <poll.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
 #include <sys/socket.h>
 #include <netinet/in.h>
+#include <netinet/tcp.h>
 #include <arpa/inet.h>
 #include <chrono>
 #include <thread>
-#include <future>
 #include <algorithm>
 
+namespace {
+
+// epoll user data for the two non-connection fds; connection ids count up from 1
+constexpr uint64_t LISTEN_ID = ~uint64_t{0};
+constexpr uint64_t WAKE_ID = ~uint64_t{0} - 1;
+constexpr uint64_t BINARY_LISTEN_ID = ~uint64_t{0} - 2;
+
+// Give up on a client that stops reading its response
+constexpr int WRITE_TIMEOUT_MS = 5000;
+
+// The solver name of answers read from the near-solved table
+constexpr const char NEAR_SOLVED_NAME[] = "Near-solved table";
+
+// Sent with every response
+constexpr const char CORS_HEADERS[] =
+    "Access-Control-Allow-Origin: *\r\n"
+    "Access-Control-Allow-Methods: GET, POST, DELETE, OPTIONS\r\n"
+    "Access-Control-Allow-Headers: Content-Type, X-Session-Id\r\n"
+    "Access-Control-Expose-Headers: X-Session-Id, X-Scramble-Seed\r\n";
+
+// {"error":message}, escaped
+std::string errorJSON(std::string_view message) {
+    std::string body;
+    JSONWriter(body).beginObject().member("error", message).endObject();
+    return body;
+}
+
+template <typename T>
+void appendNumber(std::string& out, T value, int base = 10) {
+    char digits[24];
+    out.append(digits, std::to_chars(digits, digits + sizeof(digits), value, base).ptr);
+}
+
+const char* reasonPhrase(int status) {
+    switch (status) {
+        case 200: return "OK";
+        case 202: return "Accepted";
+        case 400: return "Bad Request";
+        case 404: return "Not Found";
+        case 405: return "Method Not Allowed";
+        case 413: return "Payload Too Large";
+        case 500: return "Internal Server Error";
+        case 501: return "Not Implemented";
+        case 503: return "Service Unavailable";
+        default: return "Unknown";
+    }
+}
+
+} // namespace
+
+bool parseCubeFormat(const std::string& name, CubeFormat& format) {
+    if (name == "verbose") {
+        format = CubeFormat::VERBOSE;
+    } else if (name == "compact") {
+        format = CubeFormat::COMPACT;
+    } else if (name == "binary") {
+        format = CubeFormat::BINARY;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+void HTTPResponse::serialize(std::string& out, int keepAlive) const {
+    out.reserve(out.size() + 320 + headers.size() + body.size());
+    out += "HTTP/1.1 ";
+    appendNumber(out, status);
+    out += ' ';
+    out += reasonPhrase(status);
+    out += "\r\nContent-Type: ";
+    out += contentType;
+    out += "\r\nContent-Length: ";
+    appendNumber(out, body.size());
+    out += "\r\n";
+    out += CORS_HEADERS;
+    out += headers;
+    if (keepAlive >= 0) out += keepAlive ? "Connection: keep-alive\r\n" : "Connection: close\r\n";
+    out += "\r\n";
+    out += body;
+}
+
 HTTPServer::HTTPServer(int port) 
-    : port_(port), serverSocket_(-1), running_(false), currentSolverType_("sequential") {
-    solver_ = std::make_unique<SequentialSolver>();
+    : port_(port), serverSocket_(-1), epollFd_(-1), wakeFd_(-1), running_(false),
+      shutdownToken_(std::make_shared<CancellationToken>()),
+      solutionCache_(std::make_shared<SolutionCache>()) {
+    setSolver("sequential");
     currentCube_.reset();
+    
+    // One instance per solve worker of what a default race borrows
+    int raceCores = std::max(1, ThreadPlacement::get().threads() / static_cast<int>(SOLVE_THREADS));
+    solverPool_.reserve("twophase", [this] { return createSolverInstance("twophase"); }, SOLVE_THREADS);
+    solverPool_.reserve("sequential", [this] { return createSolverInstance("sequential"); }, SOLVE_THREADS);
+#ifdef HAVE_OPENMP
+    if (raceCores - 1 > 1) {
+        solverPool_.reserve("openmp/" + std::to_string(raceCores - 1),
+                            [this, raceCores] { return createSolverInstance("openmp", raceCores - 1); },
+                            SOLVE_THREADS);
+    }
+#else
+    (void)raceCores;
+#endif
 }
 
 HTTPServer::~HTTPServer() {
     stop();
 }
 
+// The instance built to check the type goes into the pool, warm for the
+// next solve of that type
 void HTTPServer::setSolver(const std::string& solverType) {
-    solver_ = createSolver(solverType);
+    auto solver = createSolver(solverType);
+    std::string name = solver->getName();
+    solverPool_.add(solverType, std::move(solver));
+    std::lock_guard<std::mutex> lock(stateMutex_);
     currentSolverType_ = solverType;
+    currentSolverName_ = name;
+}
+
+// Loaded now if the file exists, written back when the server stops
+void HTTPServer::setCacheFile(const std::string& path) {
+    cachePath_ = path;
+    if (access(path.c_str(), F_OK) != 0) return;
+    try {
+        size_t count = solutionCache_->load(path);
+        RUBIKS_LOG(INFO) << "Loaded " << count << " cached solutions from " << path;
+    } catch (const std::exception& e) {
+        RUBIKS_LOG(WARNING) << "Failed to load solution cache: " << e.what();
+    }
+}
+
+void HTTPServer::saveSolutionCache() {
+    if (cachePath_.empty()) return;
+    try {
+        solutionCache_->save(cachePath_);
+        RUBIKS_LOG(INFO) << "Saved " << solutionCache_->size() << " cached solutions to " << cachePath_;
+    } catch (const std::exception& e) {
+        RUBIKS_LOG(WARNING) << "Failed to save solution cache: " << e.what();
+    }
 }
 
 std::string HTTPServer::getCurrentSolver() const {
+    std::lock_guard<std::mutex> lock(stateMutex_);
     return currentSolverType_;
 }
 
 std::vector<std::string> HTTPServer::getAvailableSolvers() const {
-    std::vector<std::string> solvers = {"sequential"};
+    std::vector<std::string> solvers = {"sequential", "twophase", "bidirectional"};
     
 #ifdef HAVE_OPENMP
     solvers.push_back("openmp");
 #endif
     
 #ifdef HAVE_MPI
-    if (MPISolver::IsInitialized()) {
+    if (mpiScheduler_) {
         solvers.push_back("mpi");
         solvers.push_back("hybrid");
     }
@@ -61,153 +197,669 @@ std::vector<std::string> HTTPServer::getAvailableSolvers() const {
 }
 
 std::unique_ptr<Solver> HTTPServer::createSolver(const std::string& type) {
-    std::cout << "Creating solver: " << type << std::endl;
+    RUBIKS_LOG(INFO) << "Creating solver: " << type;
     
+    std::unique_ptr<Solver> solver = createSolverInstance(type);
+    solver->setHeuristic(createHeuristic(getDefaultHeuristicType()));
+    return solver;
+}
+
+std::string HTTPServer::getDefaultHeuristicType() const {
+    return getDefaultPatternDatabase() ? "pdb" : "manhattan";
+}
+
+SolverPool::Lease HTTPServer::borrowSolver(const std::string& type, int threads) {
+    std::string kind = threads > 0 ? type + "/" + std::to_string(threads) : type;
+    return solverPool_.acquire(kind, [this, &type, threads] { return createSolverInstance(type, threads); });
+}
+
+std::unique_ptr<Solver> HTTPServer::createSolverInstance(const std::string& type, int threads) {
     if (type == "sequential") {
         return std::make_unique<SequentialSolver>();
+    } else if (type == "twophase") {
+        return std::make_unique<TwoPhaseSolver>();
+    } else if (type == "bidirectional") {
+        return std::make_unique<BidirectionalSolver>();
     }
 #ifdef HAVE_OPENMP
     else if (type == "openmp") {
-        return std::make_unique<OpenMPSolver>(4);
+        return std::make_unique<OpenMPSolver>(threads);
     }
 #endif
 #ifdef HAVE_MPI
-    else if (type == "mpi") {
-        if (!MPISolver::IsInitialized()) {
-            throw std::runtime_error("MPI not initialized. Cannot create MPISolver.");
-        }
-        return std::make_unique<MPISolver>();
-    } else if (type == "hybrid") {
-        if (!MPISolver::IsInitialized()) {
-            throw std::runtime_error("MPI not initialized. Cannot create HybridSolver.");
+    else if (type == "mpi" || type == "hybrid") {
+        if (!mpiScheduler_) {
+            throw std::runtime_error("No MPI worker ranks. Cannot create the " + type + " solver.");
         }
-        return std::make_unique<HybridSolver>(2);
+        return std::make_unique<MPIJobSolver>(mpiScheduler_, type == "mpi" ? SolverKind::MPI : SolverKind::HYBRID);
     }
 #endif
     
-    std::cerr << "Unknown solver type: " << type << ", falling back to sequential" << std::endl;
+    RUBIKS_LOG(WARNING) << "Unknown solver type: " << type << ", falling back to sequential";
     return std::make_unique<SequentialSolver>();
 }
 
-void HTTPServer::start() {
-    serverSocket_ = socket(AF_INET, SOCK_STREAM, 0);
-    if (serverSocket_ < 0) {
-        std::cerr << "Failed to create socket" << std::endl;
-        return;
+// A non-blocking socket listening on port, or -1
+int HTTPServer::openListener(int port) {
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        RUBIKS_LOG(ERROR) << "Failed to create socket";
+        return -1;
     }
     
     int opt = 1;
-    setsockopt(serverSocket_, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
     
     sockaddr_in address;
     address.sin_family = AF_INET;
     address.sin_addr.s_addr = INADDR_ANY;
-    address.sin_port = htons(port_);
+    address.sin_port = htons(port);
     
-    if (bind(serverSocket_, (sockaddr*)&address, sizeof(address)) < 0) {
-        std::cerr << "Failed to bind socket" << std::endl;
-        return;
+    if (bind(fd, (sockaddr*)&address, sizeof(address)) < 0) {
+        RUBIKS_LOG(ERROR) << "Failed to bind socket to port " << port;
+        close(fd);
+        return -1;
+    }
+    
+    if (listen(fd, SOMAXCONN) < 0) {
+        RUBIKS_LOG(ERROR) << "Failed to listen on socket";
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+void HTTPServer::start() {
+    // Built (or mapped from --frontier) before the first request can wait on it
+    if (nearSolvedDepth_ > 0) {
+        for (Metric metric : {Metric::QUARTER_TURN, Metric::HALF_TURN}) {
+            auto begin = std::chrono::steady_clock::now();
+            auto table = getFrontierTable(metric);
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+            RUBIKS_LOG(INFO) << "Near-solved table (" << metricName(metric) << "): depth "
+                             << table->getDepth() << ", " << table->size() << " positions, "
+                             << (table->getByteCount() >> 20) << " MB, " << std::fixed
+                             << std::setprecision(2) << seconds << " s";
+            if (table->getDepth() < nearSolvedDepth_) {
+                RUBIKS_LOG(WARNING) << "Near-solved table (" << metricName(metric) << ") reaches depth "
+                                 << table->getDepth() << " of " << nearSolvedDepth_
+                                 << "; raise --frontier-mb for more";
+            }
+            nearTables_[static_cast<int>(metric)] = std::move(table);
+        }
+    }
+    
+    serverSocket_ = openListener(port_);
+    if (serverSocket_ < 0) return;
+    if (binaryPort_ > 0) {
+        binarySocket_ = openListener(binaryPort_);
+        if (binarySocket_ < 0) return;
     }
     
-    if (listen(serverSocket_, 10) < 0) {
-        std::cerr << "Failed to listen on socket" << std::endl;
+    epollFd_ = epoll_create1(EPOLL_CLOEXEC);
+    wakeFd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (epollFd_ < 0 || wakeFd_ < 0) {
+        RUBIKS_LOG(ERROR) << "Failed to create event loop";
         return;
     }
     
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.u64 = LISTEN_ID;
+    epoll_ctl(epollFd_, EPOLL_CTL_ADD, serverSocket_, &event);
+    event.data.u64 = WAKE_ID;
+    epoll_ctl(epollFd_, EPOLL_CTL_ADD, wakeFd_, &event);
+    if (binarySocket_ >= 0) {
+        event.data.u64 = BINARY_LISTEN_ID;
+        epoll_ctl(epollFd_, EPOLL_CTL_ADD, binarySocket_, &event);
+    }
+    
+    ioPool_ = std::make_unique<ThreadPool>(IO_THREADS);
+    solvePool_ = std::make_unique<ThreadPool>(SOLVE_THREADS, SOLVE_QUEUE_LIMIT);
+    
     running_ = true;
-    std::cout << "\n========================================" << std::endl;
-    std::cout << "Server started on port " << port_ << std::endl;
-    std::cout << "Current solver: " << solver_->getName() << std::endl;
-    std::cout << "========================================" << std::endl;
-    std::cout << "\nAPI Endpoints:" << std::endl;
-    std::cout << "  GET  /status         - Server status" << std::endl;
-    std::cout << "  GET  /cube           - Current cube state" << std::endl;
-    std::cout << "  GET  /solvers        - List available solvers" << std::endl;
-    std::cout << "  POST /solver/select  - Select solver algorithm" << std::endl;
-    std::cout << "  POST /cube/reset     - Reset to solved state" << std::endl;
-    std::cout << "  POST /cube/scramble  - Scramble the cube" << std::endl;
-    std::cout << "  POST /cube/move      - Apply a move" << std::endl;
-    std::cout << "  POST /cube/solve     - Solve the cube" << std::endl;
-    std::cout << "  POST /cube/state     - Set cube state" << std::endl;
-    std::cout << "========================================\n" << std::endl;
+    RUBIKS_LOG(INFO) << "========================================";
+    RUBIKS_LOG(INFO) << "Server started on port " << port_;
+    RUBIKS_LOG(INFO) << "Current solver: " << getCurrentSolver();
+    RUBIKS_LOG(INFO) << "Workers: " << IO_THREADS << " IO, " << SOLVE_THREADS << " solve (queue "
+                     << SOLVE_QUEUE_LIMIT << ")";
+    RUBIKS_LOG(INFO) << "========================================";
+    RUBIKS_LOG(INFO) << "API Endpoints:";
+    RUBIKS_LOG(INFO) << "  GET  /status         - Server status";
+    RUBIKS_LOG(INFO) << "  GET  /metrics        - Solve counters (Prometheus text format)";
+    RUBIKS_LOG(INFO) << "  GET  /cube           - Current cube state";
+    RUBIKS_LOG(INFO) << "  GET  /solvers        - List available solvers";
+    RUBIKS_LOG(INFO) << "  POST /solver/select  - Select solver algorithm";
+    RUBIKS_LOG(INFO) << "  POST /cube/reset     - Reset to solved state";
+    RUBIKS_LOG(INFO) << "  POST /cube/scramble  - Scramble the cube";
+    RUBIKS_LOG(INFO) << "  POST /cube/move      - Apply a move";
+    RUBIKS_LOG(INFO) << "  POST /cube/solve     - Solve the cube";
+    RUBIKS_LOG(INFO) << "  POST /cube/state     - Set cube state";
+    RUBIKS_LOG(INFO) << "  POST /solve          - Solve a state given in the body";
+    RUBIKS_LOG(INFO) << "  POST /solve/batch    - Solve many states, streamed as NDJSON";
+    RUBIKS_LOG(INFO) << "  POST /jobs           - Start a solve in the background";
+    RUBIKS_LOG(INFO) << "  GET  /jobs/{id}      - Job status and result";
+    RUBIKS_LOG(INFO) << "  GET  /jobs/{id}/events - Job progress (Server-Sent Events)";
+    RUBIKS_LOG(INFO) << "  DELETE /jobs/{id}    - Cancel a job";
+    RUBIKS_LOG(INFO) << "  (cube endpoints take an X-Session-Id header from /cube/reset)";
+    if (binarySocket_ >= 0) {
+        RUBIKS_LOG(INFO) << "Binary solve protocol on port " << binaryPort_;
+    }
+    RUBIKS_LOG(INFO) << "========================================";
     
+    epoll_event events[64];
     while (running_) {
-        sockaddr_in clientAddr;
-        socklen_t clientLen = sizeof(clientAddr);
-        int clientSocket = accept(serverSocket_, (sockaddr*)&clientAddr, &clientLen);
+        int count = epoll_wait(epollFd_, events, 64, -1);
+        if (count < 0) {
+            if (errno == EINTR) continue;
+            RUBIKS_LOG(ERROR) << "epoll_wait failed: " << std::strerror(errno);
+            break;
+        }
+        
+        for (int i = 0; i < count; ++i) {
+            uint64_t id = events[i].data.u64;
+            if (id == WAKE_ID) {
+                uint64_t value;
+                while (read(wakeFd_, &value, sizeof(value)) > 0) {}
+            } else if (id == LISTEN_ID) {
+                acceptConnections(serverSocket_, false);
+            } else if (id == BINARY_LISTEN_ID) {
+                acceptConnections(binarySocket_, true);
+            } else {
+                std::shared_ptr<Connection> conn;
+                {
+                    std::lock_guard<std::mutex> lock(connectionsMutex_);
+                    auto it = connections_.find(id);
+                    if (it != connections_.end()) conn = it->second;
+                }
+                // The fd is one-shot, so no other thread is servicing it
+                if (conn) {
+                    ioPool_->trySubmit([this, conn] { serviceConnection(conn); });
+                }
+            }
+        }
+    }
+    
+    // Stop taking work, cut running solves short, and let their responses
+    // go out before the connections are closed
+    close(serverSocket_);
+    serverSocket_ = -1;
+    if (binarySocket_ >= 0) {
+        close(binarySocket_);
+        binarySocket_ = -1;
+    }
+    shutdownToken_->cancel();
+    {
+        std::lock_guard<std::mutex> lock(jobsMutex_);
+        for (auto& entry : jobs_) entry.second->token->cancel();
+    }
+    solvePool_->shutdown();
+    ioPool_->shutdown();
+    closeAllConnections();
+    saveSolutionCache();
+    close(epollFd_);
+    close(wakeFd_);
+    epollFd_ = -1;
+    wakeFd_ = -1;
+}
+
+// Only async-signal-safe calls here: main's SIGINT handler lands in stop()
+void HTTPServer::stop() {
+    running_ = false;
+    if (wakeFd_ >= 0) {
+        uint64_t one = 1;
+        ssize_t ignored = write(wakeFd_, &one, sizeof(one));
+        (void)ignored;
+    }
+}
+
+void HTTPServer::acceptConnections(int listener, bool binary) {
+    while (true) {
+        int fd = accept4(listener, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno == EINTR) continue;
+            // EAGAIN: backlog drained; anything else: try again on the next event
+            return;
+        }
         
-        if (clientSocket < 0) {
+        // Responses are small and written in one go; don't let Nagle hold them back
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        
+        auto conn = std::make_shared<Connection>();
+        conn->fd = fd;
+        conn->id = nextConnectionId_++;
+        conn->binary = binary;
+        {
+            std::lock_guard<std::mutex> lock(connectionsMutex_);
+            connections_[conn->id] = conn;
+        }
+        
+        epoll_event event{};
+        event.events = EPOLLIN | EPOLLRDHUP | EPOLLONESHOT;
+        event.data.u64 = conn->id;
+        if (epoll_ctl(epollFd_, EPOLL_CTL_ADD, fd, &event) < 0) {
+            closeConnection(conn);
+        }
+    }
+}
+
+// Runs on the IO pool. Reads what has arrived, answers every complete
+// request in order, and re-arms the connection. A solve is handed to the
+// solve pool and the connection stays parked until its response is written,
+// which keeps pipelined responses in request order.
+void HTTPServer::serviceConnection(const std::shared_ptr<Connection>& conn) {
+    bool peerClosed = false;
+    char chunk[16384];
+    while (true) {
+        ssize_t n = recv(conn->fd, chunk, sizeof(chunk), 0);
+        if (n > 0) {
+            conn->buffer.append(chunk, static_cast<size_t>(n));
+            if (conn->buffer.size() > MAX_REQUEST_BYTES + 16384) break;
+        } else if (n == 0) {
+            peerClosed = true;
+            break;
+        } else if (errno == EINTR) {
             continue;
+        } else {
+            if (errno != EAGAIN && errno != EWOULDBLOCK) peerClosed = true;
+            break;
         }
+    }
+    
+    if (conn->binary) {
+        serviceFrames(conn, peerClosed);
+        return;
+    }
+    
+    while (true) {
+        HTTPRequest request;
+        size_t consumed = 0;
+        ParseStatus status = parseRequest(conn->buffer, request, consumed);
         
-        char buffer[4096] = {0};
-        read(clientSocket, buffer, sizeof(buffer) - 1);
+        if (status == ParseStatus::INCOMPLETE) break;
+        if (status != ParseStatus::COMPLETE) {
+            int code = status == ParseStatus::TOO_LARGE ? 413
+                     : status == ParseStatus::UNSUPPORTED ? 501 : 400;
+            std::string error = code == 413 ? "Request too large"
+                              : code == 501 ? "Transfer-Encoding not supported" : "Bad request";
+            sendResponse(conn, createResponse(code, errorJSON(error)), false);
+            closeConnection(conn);
+            return;
+        }
+        conn->buffer.erase(0, consumed);
+        bool keepAlive = request.keepAlive();
         
-        std::string request(buffer);
-        std::string response = handleRequest(request);
+        // The connection now belongs to the job's event stream
+        if (isEventStreamRequest(request)) {
+            streamJobEvents(conn, request);
+            return;
+        }
         
-        send(clientSocket, response.c_str(), response.length(), 0);
-        close(clientSocket);
+        if (isSolveRequest(request)) {
+            bool queued = solvePool_->trySubmit([this, conn, request, keepAlive] {
+                bool written = request.path == "/solve/batch"
+                    ? streamBatch(conn, request, keepAlive)
+                    : sendResponse(conn, handleRequest(request), keepAlive);
+                if (!written || !keepAlive) {
+                    closeConnection(conn);
+                    return;
+                }
+                // Pick up anything the client pipelined behind the solve
+                if (!ioPool_->trySubmit([this, conn] { serviceConnection(conn); })) {
+                    closeConnection(conn);
+                }
+            });
+            if (queued) return;
+            
+            RUBIKS_LOG(WARNING) << request.method << " " << request.path << " rejected: solve queue full";
+            HTTPResponse busy = createResponse(503, errorJSON("Solver busy, try again later"));
+            if (!sendResponse(conn, busy, keepAlive) || !keepAlive) {
+                closeConnection(conn);
+                return;
+            }
+            continue;
+        }
+        
+        if (!sendResponse(conn, handleRequest(request), keepAlive) || !keepAlive) {
+            closeConnection(conn);
+            return;
+        }
+    }
+    
+    if (peerClosed || conn->buffer.size() > MAX_REQUEST_BYTES + 16384) {
+        closeConnection(conn);
+        return;
     }
+    rearmConnection(conn);
 }
 
-void HTTPServer::stop() {
-    running_ = false;
-    if (serverSocket_ >= 0) {
-        close(serverSocket_);
-        serverSocket_ = -1;
+// The binary counterpart of the request loop above. The complete frames
+// that have arrived, up to MAX_PIPELINED_FRAMES, go to the solve pool as
+// one task, which answers them in order with a single write and then
+// comes back for the rest. A full solve queue answers them BUSY instead.
+void HTTPServer::serviceFrames(const std::shared_ptr<Connection>& conn, bool peerClosed) {
+    while (true) {
+        std::vector<BinarySolveRequest> requests;
+        size_t offset = 0;
+        while (requests.size() < MAX_PIPELINED_FRAMES) {
+            BinarySolveRequest request;
+            size_t consumed = 0;
+            FrameStatus status = decodeSolveRequest(conn->buffer.data() + offset, conn->buffer.size() - offset,
+                                                    request, consumed);
+            if (status == FrameStatus::INCOMPLETE) break;
+            if (status == FrameStatus::BAD_FRAME) {
+                RUBIKS_LOG(WARNING) << "Closing binary connection: malformed frame";
+                closeConnection(conn);
+                return;
+            }
+            requests.push_back(request);
+            offset += consumed;
+        }
+        conn->buffer.erase(0, offset);
+        if (requests.empty()) break;
+        
+        auto receivedAt = CancellationToken::Clock::now();
+        bool queued = solvePool_->trySubmit([this, conn, requests, receivedAt] {
+            conn->output.clear();
+            for (const BinarySolveRequest& request : requests) {
+                encodeSolveResponse(conn->output, solveFrame(request, receivedAt));
+            }
+            if (!writeResponse(conn, conn->output) ||
+                !ioPool_->trySubmit([this, conn] { serviceConnection(conn); })) {
+                closeConnection(conn);
+            }
+        });
+        if (queued) return;
+        
+        conn->output.clear();
+        for (const BinarySolveRequest& request : requests) {
+            BinarySolveResponse busy;
+            busy.status = BinaryStatus::BUSY;
+            busy.tag = request.tag;
+            encodeSolveResponse(conn->output, busy);
+        }
+        if (!writeResponse(conn, conn->output)) {
+            closeConnection(conn);
+            return;
+        }
+    }
+    
+    if (peerClosed) {
+        closeConnection(conn);
+        return;
     }
+    rearmConnection(conn);
 }
 
-std::string HTTPServer::handleRequest(const std::string& request) {
-    std::istringstream stream(request);
-    std::string method, path, version;
-    stream >> method >> path >> version;
+// Sockets are non-blocking; wait for room when the send buffer is full
+bool HTTPServer::writeResponse(const std::shared_ptr<Connection>& conn, const std::string& response) {
+    size_t sent = 0;
+    while (sent < response.size()) {
+        ssize_t n = send(conn->fd, response.data() + sent, response.size() - sent, MSG_NOSIGNAL);
+        if (n > 0) {
+            sent += static_cast<size_t>(n);
+        } else if (n < 0 && errno == EINTR) {
+            continue;
+        } else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            pollfd pfd{conn->fd, POLLOUT, 0};
+            if (poll(&pfd, 1, WRITE_TIMEOUT_MS) <= 0) return false;
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Never waits: false once the send buffer is full, possibly after part of
+// the data went out, so the caller must give up on the connection
+bool HTTPServer::writeWithoutBlocking(const std::shared_ptr<Connection>& conn, const std::string& data) {
+    size_t sent = 0;
+    while (sent < data.size()) {
+        ssize_t n = send(conn->fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL | MSG_DONTWAIT);
+        if (n > 0) {
+            sent += static_cast<size_t>(n);
+        } else if (n < 0 && errno == EINTR) {
+            continue;
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Frames the response in the connection's own buffer
+bool HTTPServer::sendResponse(const std::shared_ptr<Connection>& conn, const HTTPResponse& response,
+                              bool keepAlive) {
+    conn->output.clear();
+    response.serialize(conn->output, keepAlive ? 1 : 0);
+    return writeResponse(conn, conn->output);
+}
+
+void HTTPServer::rearmConnection(const std::shared_ptr<Connection>& conn) {
+    epoll_event event{};
+    event.events = EPOLLIN | EPOLLRDHUP | EPOLLONESHOT;
+    event.data.u64 = conn->id;
+    if (epoll_ctl(epollFd_, EPOLL_CTL_MOD, conn->fd, &event) < 0) {
+        closeConnection(conn);
+    }
+}
+
+void HTTPServer::closeConnection(const std::shared_ptr<Connection>& conn) {
+    {
+        std::lock_guard<std::mutex> lock(connectionsMutex_);
+        if (connections_.erase(conn->id) == 0) return;
+    }
+    epoll_ctl(epollFd_, EPOLL_CTL_DEL, conn->fd, nullptr);
+    close(conn->fd);
+}
+
+void HTTPServer::closeAllConnections() {
+    std::lock_guard<std::mutex> lock(connectionsMutex_);
+    for (auto& entry : connections_) {
+        close(entry.second->fd);
+    }
+    connections_.clear();
+}
+
+bool HTTPServer::isSolveRequest(const HTTPRequest& request) {
+    return request.method == "POST" &&
+           (request.path == "/cube/solve" || request.path == "/solve" || request.path == "/solve/batch");
+}
+
+bool HTTPServer::isEventStreamRequest(const HTTPRequest& request) {
+    const std::string suffix = "/events";
+    const std::string& path = request.path;
+    return request.method == "GET" && path.compare(0, 6, "/jobs/") == 0 &&
+           path.size() > 6 + suffix.size() &&
+           path.compare(path.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+std::string HTTPRequest::header(const std::string& name) const {
+    auto it = headers.find(name);
+    return it != headers.end() ? it->second : "";
+}
+
+bool HTTPRequest::keepAlive() const {
+    std::string connection = header("connection");
+    std::transform(connection.begin(), connection.end(), connection.begin(), ::tolower);
+    if (connection.find("close") != std::string::npos) return false;
+    if (version == "HTTP/1.0") return connection.find("keep-alive") != std::string::npos;
+    return true;
+}
+
+std::string HTTPRequest::queryParam(const std::string& name) const {
+    size_t pos = 0;
+    while (pos < query.size()) {
+        size_t end = std::min(query.find('&', pos), query.size());
+        size_t equals = query.find('=', pos);
+        size_t nameEnd = std::min(equals, end);
+        if (query.compare(pos, nameEnd - pos, name) == 0 && nameEnd - pos == name.size()) {
+            return nameEnd < end ? query.substr(nameEnd + 1, end - nameEnd - 1) : "";
+        }
+        pos = end + 1;
+    }
+    return "";
+}
+
+HTTPServer::ParseStatus HTTPServer::parseRequest(const std::string& buffer, HTTPRequest& request,
+                                                 size_t& consumed) {
+    size_t headerEnd = buffer.find("\r\n\r\n");
+    if (headerEnd == std::string::npos) {
+        return buffer.size() > MAX_REQUEST_BYTES ? ParseStatus::TOO_LARGE : ParseStatus::INCOMPLETE;
+    }
     
-    std::cout << method << " " << path << std::endl;
+    request = HTTPRequest{};
+    std::string_view head(buffer.data(), headerEnd);
+    size_t lineEnd = std::min(head.find('\n'), head.size());
     
-    if (method == "OPTIONS") {
-        return handleOPTIONS();
+    // Request line: method, target and version, separated by blanks
+    std::string_view line = head.substr(0, lineEnd);
+    std::string* parts[] = {&request.method, &request.path, &request.version};
+    size_t pos = 0;
+    for (std::string* part : parts) {
+        pos = std::min(line.find_first_not_of(" \t\r", pos), line.size());
+        size_t end = std::min(line.find_first_of(" \t\r", pos), line.size());
+        if (end == pos) return ParseStatus::BAD_REQUEST;
+        part->assign(line.data() + pos, end - pos);
+        pos = end;
+    }
+    if (request.version.compare(0, 5, "HTTP/") != 0) {
+        return ParseStatus::BAD_REQUEST;
+    }
+    size_t query = request.path.find('?');
+    if (query != std::string::npos) {
+        request.query = request.path.substr(query + 1);
+        request.path.resize(query);
     }
     
-    std::string body;
-    size_t bodyPos = request.find("\r\n\r\n");
-    if (bodyPos != std::string::npos) {
-        body = request.substr(bodyPos + 4);
+    while (lineEnd < head.size()) {
+        size_t start = lineEnd + 1;
+        lineEnd = std::min(head.find('\n', start), head.size());
+        line = head.substr(start, lineEnd - start);
+        if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+        if (line.empty()) continue;
+        
+        size_t colon = line.find(':');
+        if (colon == std::string_view::npos || colon == 0) return ParseStatus::BAD_REQUEST;
+        
+        std::string name(line.substr(0, colon));
+        std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+        size_t valueStart = line.find_first_not_of(" \t", colon + 1);
+        size_t valueEnd = line.find_last_not_of(" \t");
+        std::string_view value = valueStart == std::string_view::npos ? std::string_view()
+                               : line.substr(valueStart, valueEnd - valueStart + 1);
+        
+        auto& slot = request.headers[name];
+        if (!slot.empty()) slot += ", ";
+        slot.append(value.data(), value.size());
+    }
+    
+    // Bodies are framed by Content-Length only
+    if (!request.header("transfer-encoding").empty()) {
+        return ParseStatus::UNSUPPORTED;
     }
     
-    if (method == "GET") {
-        return handleGET(path);
-    } else if (method == "POST") {
-        return handlePOST(path, body);
+    size_t length = 0;
+    std::string lengthStr = request.header("content-length");
+    if (!lengthStr.empty()) {
+        if (lengthStr.find_first_not_of("0123456789") != std::string::npos) {
+            return ParseStatus::BAD_REQUEST;
+        }
+        if (lengthStr.size() > 9) {
+            return ParseStatus::TOO_LARGE;
+        }
+        length = std::stoul(lengthStr);
+    }
+    if (length > MAX_REQUEST_BYTES) {
+        return ParseStatus::TOO_LARGE;
+    }
+    
+    size_t bodyStart = headerEnd + 4;
+    if (buffer.size() < bodyStart + length) {
+        return ParseStatus::INCOMPLETE;
+    }
+    
+    request.body = buffer.substr(bodyStart, length);
+    consumed = bodyStart + length;
+    return ParseStatus::COMPLETE;
+}
+
+HTTPResponse HTTPServer::handleRequest(const HTTPRequest& request) {
+    RUBIKS_LOG(INFO) << request.method << " " << request.path;
+    
+    try {
+        if (request.method == "OPTIONS") {
+            return handleOPTIONS();
+        } else if (request.method == "GET") {
+            return handleGET(request);
+        } else if (request.method == "POST") {
+            return handlePOST(request);
+        } else if (request.method == "DELETE") {
+            return handleDELETE(request);
+        }
+    } catch (const std::exception& e) {
+        return createResponse(500, errorJSON(e.what()));
     }
     
     return createResponse(405, "{\"error\":\"Method not allowed\"}");
 }
 
-std::string HTTPServer::handleGET(const std::string& path) {
+HTTPResponse HTTPServer::handleGET(const HTTPRequest& request) {
+    const std::string& path = request.path;
+    std::string sessionId = request.header("x-session-id");
+    
     if (path == "/status") {
         return getStatus();
+    } else if (path == "/metrics") {
+        return getMetrics();
     } else if (path == "/cube") {
-        return getCubeState();
+        CubeFormat format = CubeFormat::VERBOSE;
+        std::string name = request.queryParam("format");
+        if (!name.empty() && !parseCubeFormat(name, format)) {
+            return createResponse(400, "{\"error\":\"Unknown format (expected verbose, compact or binary)\"}");
+        }
+        return getCubeState(sessionId, format);
     } else if (path == "/solvers") {
         return listSolvers();
+    } else if (path.compare(0, 6, "/jobs/") == 0) {
+        return getJob(path.substr(6));
     }
     
     return createResponse(404, "{\"error\":\"Not found\"}");
 }
 
-std::string HTTPServer::handlePOST(const std::string& path, const std::string& body) {
+HTTPResponse HTTPServer::handlePOST(const HTTPRequest& request) {
+    const std::string& path = request.path;
+    std::string sessionId = request.header("x-session-id");
+    
+    // One pass over the body; the handlers look members up in it
+    JSONBody body(request.body);
+    if (!body.valid()) {
+        return createResponse(400, "{\"error\":\"Request body is not a JSON object\"}");
+    }
+    // ?format= wins over a "format" member
+    CubeFormat format = CubeFormat::VERBOSE;
+    std::string formatName = request.queryParam("format");
+    if (formatName.empty()) formatName = body.value("format");
+    if (!formatName.empty() && !parseCubeFormat(formatName, format)) {
+        return createResponse(400, "{\"error\":\"Unknown format (expected verbose, compact or binary)\"}");
+    }
+    
     if (path == "/cube/reset") {
-        return resetCube();
+        return resetCube(sessionId, format);
     } else if (path == "/cube/scramble") {
-        return scrambleCube(body);
+        return scrambleCube(body, sessionId, format);
     } else if (path == "/cube/move") {
-        return applyMove(body);
+        return applyMove(body, sessionId, format);
     } else if (path == "/cube/solve") {
-        return solveCube(body);
+        return solveCube(body, sessionId);
+    } else if (path == "/solve") {
+        return solveStateless(body);
+    } else if (path == "/jobs") {
+        return createJob(body, sessionId);
     } else if (path == "/cube/state") {
-        return setCubeState(body);
+        return setCubeState(body, sessionId, format);
     } else if (path == "/solver/select") {
         return selectSolver(body);
     }
@@ -215,30 +867,86 @@ std::string HTTPServer::handlePOST(const std::string& path, const std::string& b
     return createResponse(404, "{\"error\":\"Not found\"}");
 }
 
-std::string HTTPServer::handleOPTIONS() {
-    return createResponse(200, "");
+HTTPResponse HTTPServer::handleDELETE(const HTTPRequest& request) {
+    const std::string& path = request.path;
+    
+    if (path.compare(0, 6, "/jobs/") == 0) {
+        return cancelJob(path.substr(6));
+    }
+    
+    return createResponse(404, "{\"error\":\"Not found\"}");
 }
 
-std::string HTTPServer::getStatus() {
-    std::stringstream ss;
-    ss << "{\"status\":\"running\",\"solver\":\"" << solver_->getName() << "\"}";
-    return createResponse(200, ss.str());
+HTTPResponse HTTPServer::handleOPTIONS() {
+    return createResponse(200, "");
 }
 
-std::string HTTPServer::listSolvers() {
-    auto solvers = getAvailableSolvers();
-    std::stringstream ss;
-    ss << "{\"solvers\":[";
-    for (size_t i = 0; i < solvers.size(); ++i) {
-        ss << "\"" << solvers[i] << "\"";
-        if (i < solvers.size() - 1) ss << ",";
+HTTPResponse HTTPServer::getStatus() {
+    std::string body;
+    body.reserve(512);
+    JSONWriter json(body);
+    json.beginObject().member("status", "running");
+    {
+        std::lock_guard<std::mutex> lock(stateMutex_);
+        json.member("solver", currentSolverName_);
+    }
+    json.member("heuristic", getDefaultHeuristicType());
+    json.member("sessions", sessions_.size());
+    json.key("cache").beginObject()
+        .member("entries", solutionCache_->size())
+        .member("capacity", solutionCache_->capacity())
+        .member("hits", solutionCache_->getHits())
+        .member("misses", solutionCache_->getMisses())
+        .endObject();
+    if (solvePool_) {
+        json.member("activeSolves", solvePool_->active());
+        json.member("queuedSolves", solvePool_->queued());
+    }
+    json.key("solverPool").beginObject()
+        .member("idle", solverPool_.idle())
+        .member("created", solverPool_.getCreated())
+        .member("reused", solverPool_.getReused())
+        .endObject();
+#ifdef HAVE_MPI
+    if (mpiScheduler_) {
+        MPIScheduler::Status mpi = mpiScheduler_->getStatus();
+        json.key("mpi").beginObject()
+            .member("workers", mpi.workers).member("groupSize", mpi.groupSize)
+            .member("minGroupSize", mpi.minGroupSize).member("queued", mpi.queued)
+            .member("completed", mpi.completed).member("resizes", mpi.resizes);
+        json.key("groups").beginArray();
+        for (const auto& group : mpi.groups) {
+            json.beginObject().member("leader", group.leader).member("size", group.size)
+                .member("completed", group.completed);
+            if (group.jobId != 0) {
+                json.member("state", "busy").member("job", group.jobId)
+                    .member("solver", group.solver == SolverKind::HYBRID ? "hybrid" : "mpi")
+                    .member("seconds", group.seconds, 3);
+            } else {
+                json.member("state", "idle");
+            }
+            json.endObject();
+        }
+        json.endArray().endObject();
     }
-    ss << "],\"current\":\"" << currentSolverType_ << "\"}";
-    return createResponse(200, ss.str());
+#endif
+    json.key("heuristics").beginArray();
+    for (const std::string& heuristic : getAvailableHeuristics()) json.value(heuristic);
+    json.endArray().endObject();
+    return createResponse(200, std::move(body));
 }
 
-std::string HTTPServer::selectSolver(const std::string& body) {
-    std::string solverType = extractJSONValue(body, "solver");
+HTTPResponse HTTPServer::listSolvers() {
+    std::string body;
+    JSONWriter json(body);
+    json.beginObject().key("solvers").beginArray();
+    for (const std::string& solver : getAvailableSolvers()) json.value(solver);
+    json.endArray().member("current", getCurrentSolver()).endObject();
+    return createResponse(200, std::move(body));
+}
+
+HTTPResponse HTTPServer::selectSolver(const JSONBody& body) {
+    std::string solverType = body.value("solver");
     
     if (solverType.empty()) {
         return createResponse(400, "{\"error\":\"Solver type not specified\"}");
@@ -248,411 +956,1240 @@ std::string HTTPServer::selectSolver(const std::string& body) {
     bool isAvailable = std::find(available.begin(), available.end(), solverType) != available.end();
     
     if (!isAvailable) {
-        std::stringstream ss;
-        ss << "{\"error\":\"Solver '" << solverType << "' not available or MPI not initialized\"}";
-        return createResponse(400, ss.str());
+        return createResponse(400, errorJSON("Solver '" + solverType + "' not available or MPI not initialized"));
     }
     
     try {
         setSolver(solverType);
         
-        std::stringstream ss;
-        ss << "{\"success\":true,\"solver\":\"" << solver_->getName() << "\"}";
-        return createResponse(200, ss.str());
+        std::string json;
+        std::lock_guard<std::mutex> lock(stateMutex_);
+        JSONWriter(json).beginObject().member("success", true).member("solver", currentSolverName_).endObject();
+        return createResponse(200, std::move(json));
     } catch (const std::exception& e) {
-        std::stringstream ss;
-        ss << "{\"error\":\"" << e.what() << "\"}";
-        return createResponse(500, ss.str());
+        return createResponse(500, errorJSON(e.what()));
     }
 }
 
-std::string HTTPServer::getCubeState() {
-    return createResponse(200, currentCube_.toJSON());
+// An empty id is the shared default cube that header-less clients use
+bool HTTPServer::withCube(const std::string& sessionId, const std::function<void(RubiksCube&)>& fn) {
+    if (sessionId.empty()) {
+        std::lock_guard<std::mutex> lock(stateMutex_);
+        fn(currentCube_);
+        return true;
+    }
+    return sessions_.withSession(sessionId, fn);
 }
 
-std::string HTTPServer::resetCube() {
-    std::cout << "Resetting cube to solved state" << std::endl;
-    currentCube_.reset();
-    return createResponse(200, currentCube_.toJSON());
+HTTPResponse HTTPServer::sessionNotFound() {
+    return createResponse(404, "{\"error\":\"Unknown or expired session\"}");
+}
+
+// Prometheus text format: the per-solver totals, then the server's own
+// counters and gauges
+HTTPResponse HTTPServer::getMetrics() {
+    std::string text = solveMetrics_.toPrometheus();
+    auto series = [&text](const char* name, const char* help, const char* type, uint64_t value) {
+        text += "# HELP ";
+        text += name;
+        text += ' ';
+        text += help;
+        text += "\n# TYPE ";
+        text += name;
+        text += ' ';
+        text += type;
+        text += '\n';
+        text += name;
+        text += ' ';
+        text += std::to_string(value);
+        text += '\n';
+    };
+    series("rubiks_solution_cache_hits_total", "Solution cache lookups that hit", "counter",
+           solutionCache_->getHits());
+    series("rubiks_solution_cache_misses_total", "Solution cache lookups that missed", "counter",
+           solutionCache_->getMisses());
+    series("rubiks_solution_cache_entries", "Solutions held by the cache", "gauge", solutionCache_->size());
+    if (solvePool_) {
+        series("rubiks_active_solves", "Solves running now", "gauge", solvePool_->active());
+        series("rubiks_queued_solves", "Solves waiting for a solve thread", "gauge", solvePool_->queued());
+    }
+    return createResponse(200, text, "text/plain; version=0.0.4");
+}
+
+// The cube endpoints copy the cube under the lock and format it after
+HTTPResponse HTTPServer::getCubeState(const std::string& sessionId, CubeFormat format) {
+    RubiksCube snapshot;
+    if (!withCube(sessionId, [&](RubiksCube& cube) { snapshot = cube; })) {
+        return sessionNotFound();
+    }
+    return cubeResponse(snapshot, format);
 }
 
-std::string HTTPServer::scrambleCube(const std::string& body) {
+// Always answers with a session id: the caller's if it is still live,
+// otherwise a new one. Without a header the default cube is reset as well,
+// so clients that ignore sessions behave as before.
+HTTPResponse HTTPServer::resetCube(const std::string& sessionId, CubeFormat format) {
+    RUBIKS_LOG(INFO) << "Resetting cube to solved state";
+    std::string id = sessionId;
+    if (id.empty() || !withCube(id, [](RubiksCube& cube) { cube.reset(); })) {
+        if (id.empty()) {
+            withCube("", [](RubiksCube& cube) { cube.reset(); });
+        }
+        id = sessions_.create();
+    }
+    
+    HTTPResponse response = cubeResponse(RubiksCube(), format, [&](JSONWriter& json) { json.member("sessionId", id); });
+    response.addHeader("X-Session-Id: " + id);
+    return response;
+}
+
+HTTPResponse HTTPServer::scrambleCube(const JSONBody& body, const std::string& sessionId, CubeFormat format) {
     int moves = 20;
     
-    std::string movesStr = extractJSONValue(body, "moves");
+    std::string movesStr = body.value("moves");
     if (!movesStr.empty()) {
         try {
             moves = std::stoi(movesStr);
         } catch (...) {}
     }
     
-    std::cout << "Scrambling cube with " << moves << " moves" << std::endl;
-    currentCube_.scramble(moves);
-    return createResponse(200, currentCube_.toJSON());
+    // Send the returned seed back to repeat a scramble
+    uint64_t seed = Scrambler::randomSeed();
+    std::string seedStr = body.value("seed");
+    if (!seedStr.empty()) {
+        try {
+            seed = std::stoull(seedStr);
+        } catch (...) {}
+    }
+    
+    // "uniform": a state drawn uniformly from all reachable ones, replacing
+    // the current cube, rather than moves applied to it
+    bool uniform = body.value("uniform") == "true";
+    
+    RUBIKS_LOG(INFO) << "Scrambling cube with " << (uniform ? "a uniformly random state" : std::to_string(moves) + " moves")
+                     << " (seed " << seed << ")";
+    RubiksCube snapshot;
+    if (!withCube(sessionId, [&](RubiksCube& cube) {
+            if (uniform) {
+                cube = Scrambler(seed).randomState().toFacelets();
+            } else {
+                cube.scramble(moves, seed);
+            }
+            snapshot = cube;
+        })) {
+        return sessionNotFound();
+    }
+    
+    HTTPResponse response = cubeResponse(snapshot, format, [&](JSONWriter& json) { json.member("seed", seed); });
+    response.addHeader("X-Scramble-Seed: " + std::to_string(seed));
+    return response;
 }
 
-std::string HTTPServer::applyMove(const std::string& body) {
-    std::string move = extractJSONValue(body, "move");
+HTTPResponse HTTPServer::applyMove(const JSONBody& body, const std::string& sessionId, CubeFormat format) {
+    std::string move = body.value("move");
     
     if (move.empty()) {
         return createResponse(400, "{\"error\":\"Move not specified\"}");
     }
     
     try {
-        std::cout << "Applying move: " << move << std::endl;
-        currentCube_.applyMove(move);
-        return createResponse(200, currentCube_.toJSON());
+        RUBIKS_LOG(INFO) << "Applying move: " << move;
+        RubiksCube snapshot;
+        if (!withCube(sessionId, [&](RubiksCube& cube) { cube.applyMove(move); snapshot = cube; })) {
+            return sessionNotFound();
+        }
+        return cubeResponse(snapshot, format);
     } catch (const std::exception& e) {
-        std::stringstream ss;
-        ss << "{\"error\":\"" << e.what() << "\"}";
-        return createResponse(400, ss.str());
+        return createResponse(400, errorJSON(e.what()));
     }
 }
 
-std::string HTTPServer::solveCube(const std::string& body) {
+// Solve a snapshot; the session's cube may change while the solvers run
+HTTPResponse HTTPServer::solveCube(const JSONBody& body, const std::string& sessionId) {
+    RubiksCube snapshot;
+    if (!withCube(sessionId, [&](RubiksCube& cube) { snapshot = cube; })) {
+        return sessionNotFound();
+    }
+    std::string json;
+    int status = solveState(snapshot, body, json);
+    return createResponse(status, std::move(json));
+}
+
+// Stateless: the cube travels in the request, nothing is stored
+HTTPResponse HTTPServer::solveStateless(const JSONBody& body) {
+    std::string state = body.value("state");
+    if (state.length() != 54) {
+        return createResponse(400, "{\"error\":\"Expected a 54-character state\"}");
+    }
+    
+    RubiksCube cube;
+    try {
+        cube.fromString(state);
+    } catch (const std::exception& e) {
+        return createResponse(400, errorJSON(e.what()));
+    }
+    std::string json;
+    int status = solveState(cube, body, json);
+    return createResponse(status, std::move(json));
+}
+
+// Solves every entry of "states" with one solver, cloned once per thread,
+// and streams one NDJSON line per state in input order as a chunked
+// response, then a summary line. Returns false once the client is gone;
+// the remaining states are then cancelled.
+bool HTTPServer::streamBatch(const std::shared_ptr<Connection>& conn, const HTTPRequest& request,
+                             bool keepAlive) {
+    RUBIKS_LOG(INFO) << request.method << " " << request.path;
+    auto reject = [&](const std::string& error) {
+        return sendResponse(conn, createResponse(400, errorJSON(error)), keepAlive);
+    };
+    
+    JSONBody body(request.body);
+    if (!body.valid()) {
+        return reject("Request body is not a JSON object");
+    }
+    std::vector<std::string> states = body.strings("states");
+    if (states.empty()) {
+        return reject("Expected a non-empty \"states\" array");
+    }
+    
+    std::string type = body.value("solver");
+    if (type.empty()) type = "twophase";
+    if (type != "twophase" && type != "sequential" && type != "bidirectional" && type != "openmp") {
+        return reject("Batch solver must be twophase, sequential, bidirectional or openmp");
+    }
+#ifndef HAVE_OPENMP
+    if (type == "openmp") return reject("OpenMP solver not available");
+#endif
+    
+    int maxDepth = type == "twophase" ? 22 : 20;
+    double timeLimit = 10.0;  // per state
+    int threads = 0;
+    try {
+        std::string value = body.value("maxDepth");
+        if (!value.empty()) maxDepth = std::stoi(value);
+        value = body.value("timeLimit");
+        if (!value.empty()) timeLimit = std::stod(value);
+        value = body.value("threads");
+        if (!value.empty()) threads = std::max(0, std::stoi(value));
+    } catch (const std::exception&) {
+        return reject("Invalid maxDepth, timeLimit or threads");
+    }
+    // By default share this rank's CPUs with the other solve threads
+    if (threads == 0) {
+        threads = std::max(1, ThreadPlacement::get().threads() / static_cast<int>(SOLVE_THREADS));
+    }
+    
+    std::string heuristicType = body.value("heuristic");
+    if (heuristicType.empty()) {
+        heuristicType = getDefaultHeuristicType();
+    }
+    
+    Metric metric = Metric::QUARTER_TURN;
+    std::string metricParam = body.value("metric");
+    if (!metricParam.empty() && !parseMetric(metricParam, metric)) {
+        return reject("Unknown metric (expected qtm or htm)");
+    }
+    
+    // A malformed state fails its own line, not the whole batch. States in
+    // the near-solved table are answered from it; the solver gets the rest
+    // (two-phase counts half turns whatever the metric).
+    Metric tableMetric = type == "twophase" ? Metric::HALF_TURN : metric;
+    std::vector<RubiksCube> cubes;
+    std::vector<size_t> batchIndex;  // cubes[i] is states[batchIndex[i]]
+    std::vector<std::string> errors(states.size());
+    std::vector<std::pair<size_t, std::vector<Move>>> nearSolved;
+    cubes.reserve(states.size());
+    batchIndex.reserve(states.size());
+    for (size_t i = 0; i < states.size(); ++i) {
+        RubiksCube cube;
+        std::vector<Move> path;
+        try {
+            if (states[i].length() != 54) throw std::invalid_argument("Expected a 54-character state");
+            cube.fromString(states[i]);
+            CubieCube cubies = CubieCube::fromFacelets(cube);
+            if (!cube.isSolved() && lookupNearSolved(cubies, tableMetric, path) &&
+                static_cast<int>(path.size()) <= maxDepth) {
+                nearSolved.emplace_back(i, std::move(path));
+                continue;
+            }
+        } catch (const std::exception& e) {
+            errors[i] = e.what();
+            cube.reset();
+        }
+        cubes.push_back(cube);
+        batchIndex.push_back(i);
+    }
+    
+    // The heuristic (and a memory-mapped pattern database) is shared by
+    // every clone, so it is set up once for the whole batch
+    SolverPool::Lease solver = borrowSolver(type);
+    solver->configure(SolverSettings{createHeuristic(heuristicType), metric, nullptr, timeLimit});
+    auto token = std::make_shared<CancellationToken>(shutdownToken_);
+    solver->setCancellationToken(token);
+    
+    std::string& out = conn->output;
+    out.clear();
+    out += "HTTP/1.1 200 OK\r\n"
+           "Content-Type: application/x-ndjson\r\n"
+           "Transfer-Encoding: chunked\r\n"
+           "Access-Control-Allow-Origin: *\r\n";
+    out += keepAlive ? "Connection: keep-alive\r\n\r\n" : "Connection: close\r\n\r\n";
+    bool connected = writeResponse(conn, out);
+    
+    // Lines are written into one buffer and framed in the connection's own
+    std::string line;
+    auto writeChunk = [&]() {
+        if (!connected) return;
+        out.clear();
+        appendNumber(out, line.size() + 1, 16);
+        out += "\r\n";
+        out += line;
+        out += "\n\r\n";
+        connected = writeResponse(conn, out);
+        if (!connected) token->cancel();
+    };
+    
+    size_t solved = 0;
+    auto writeResult = [&](size_t index, bool success, const std::vector<std::string>& solution,
+                           uint64_t nodes, double time, const std::string& error) {
+        if (success) ++solved;
+        line.clear();
+        JSONWriter json(line);
+        json.beginObject().member("index", index).member("success", success);
+        json.key("solution").beginArray();
+        for (size_t j = 0; success && j < solution.size(); ++j) json.value(solution[j]);
+        json.endArray().member("moves", success ? solution.size() : 0);
+        json.member("nodes", nodes).member("time", time, 6);
+        if (!error.empty()) json.member("error", error);
+        json.endObject();
+        writeChunk();
+    };
+    
+    // Table answers are slotted in before the first batch result after them,
+    // keeping the lines in input order
+    size_t nextNear = 0;
+    auto writeNearSolved = [&](size_t before) {
+        for (; nextNear < nearSolved.size() && nearSolved[nextNear].first < before; ++nextNear) {
+            const std::vector<Move>& path = nearSolved[nextNear].second;
+            SolveStats stats;
+            stats.solver = NEAR_SOLVED_NAME;
+            stats.solved = true;
+            stats.solutionLength = static_cast<int>(path.size());
+            solveMetrics_.record(stats);
+            writeResult(nearSolved[nextNear].first, true, movesToStrings(path), 0, 0.0, std::string());
+        }
+    };
+    
+    auto start = std::chrono::steady_clock::now();
+    if (!connected) token->cancel();
+    if (!cubes.empty()) {
+        solver->solveBatch(cubes, [&](const BatchResult& result) {
+            size_t index = batchIndex[result.index];
+            writeNearSolved(index);
+            const std::string& error = errors[index].empty() ? result.error : errors[index];
+            if (!result.stats.solver.empty()) solveMetrics_.record(result.stats);
+            writeResult(index, result.success && error.empty(), result.solution, result.nodes,
+                        result.time, error);
+        }, maxDepth, threads);
+    }
+    writeNearSolved(states.size());
+    
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    line.clear();
+    JSONWriter(line).beginObject().member("done", true).member("solver", solver->getName())
+        .member("threads", threads).member("count", states.size()).member("solved", solved)
+        .member("nearSolved", nearSolved.size()).member("time", elapsed, 6)
+        .member("positionsPerSecond", states.size() / std::max(elapsed, 1e-9), 1).endObject();
+    writeChunk();
+    
+    RUBIKS_LOG(INFO) << "Batch of " << states.size() << " solved " << solved << " in " << elapsed << "s";
+    return connected && writeResponse(conn, "0\r\n\r\n");
+}
+
+// Runs the same solve as /solve or /cube/solve (state from the body, else
+// from the session) on the solve pool and answers at once with the job id
+HTTPResponse HTTPServer::createJob(const JSONBody& body, const std::string& sessionId) {
+    RubiksCube cube;
+    std::string state = body.value("state");
+    try {
+        if (!state.empty()) {
+            if (state.length() != 54) {
+                return createResponse(400, "{\"error\":\"Expected a 54-character state\"}");
+            }
+            cube.fromString(state);
+        } else if (!withCube(sessionId, [&](RubiksCube& current) { cube = current; })) {
+            return sessionNotFound();
+        }
+        CubieCube::fromFacelets(cube);
+    } catch (const std::exception& e) {
+        return createResponse(400, errorJSON(std::string("Unsolvable cube state: ") + e.what()));
+    }
+    
+    auto job = std::make_shared<AsyncJob>();
+    job->id = SessionStore::generateId();
+    job->token = std::make_shared<CancellationToken>();
+    
+    purgeJobs();
+    {
+        std::lock_guard<std::mutex> lock(jobsMutex_);
+        if (jobs_.size() >= MAX_JOBS) {
+            return createResponse(503, "{\"error\":\"Too many jobs, try again later\"}");
+        }
+        jobs_[job->id] = job;
+    }
+    
+    // The request (and the text the body points into) is gone by the time
+    // the job runs, so it keeps its own copy and scans that again
+    bool queued = solvePool_->trySubmit([this, job, cube, text = std::string(body.text())] {
+        // Submitted just as the server began shutting down
+        if (shutdownToken_->isCancelled()) job->token->cancel();
+        std::string json;
+        int status;
+        try {
+            status = solveState(cube, JSONBody(text), json, job.get());
+        } catch (const std::exception& e) {
+            status = 500;
+            json = errorJSON(e.what());
+        }
+        finishJob(*job, status, json);
+    });
+    if (!queued) {
+        std::lock_guard<std::mutex> lock(jobsMutex_);
+        jobs_.erase(job->id);
+        return createResponse(503, "{\"error\":\"Solver busy, try again later\"}");
+    }
+    
+    RUBIKS_LOG(INFO) << "Job " << job->id << " queued";
+    std::string json;
+    JSONWriter(json).beginObject().member("jobId", job->id)
+        .member("events", "/jobs/" + job->id + "/events").endObject();
+    return createResponse(202, std::move(json));
+}
+
+HTTPResponse HTTPServer::getJob(const std::string& jobId) {
+    auto job = findJob(jobId);
+    if (!job) {
+        return createResponse(404, "{\"error\":\"Unknown or expired job\"}");
+    }
+    
+    std::lock_guard<std::mutex> lock(job->mutex);
+    std::string status = job->finished ? (job->token->isCancelled() ? "cancelled" : "finished")
+                       : job->token->isCancelled() ? "cancelling" : "running";
+    std::string json;
+    json.reserve(job->finished ? job->result.size() + 96 : 96);
+    JSONWriter writer(json);
+    writer.beginObject().member("jobId", job->id).member("status", status)
+        .member("events", job->events.size());
+    if (job->finished) writer.key("result").raw(job->result);
+    writer.endObject();
+    return createResponse(200, std::move(json));
+}
+
+// Stops a running job (its remaining solvers report a timeout) or forgets
+// a finished one
+HTTPResponse HTTPServer::cancelJob(const std::string& jobId) {
+    auto job = findJob(jobId);
+    if (!job) {
+        return createResponse(404, "{\"error\":\"Unknown or expired job\"}");
+    }
+    
+    job->token->cancel();
+    bool finished;
+    {
+        std::lock_guard<std::mutex> lock(job->mutex);
+        finished = job->finished;
+    }
+    if (finished) {
+        std::lock_guard<std::mutex> lock(jobsMutex_);
+        jobs_.erase(jobId);
+    }
+    
+    RUBIKS_LOG(INFO) << "Job " << jobId << " cancelled";
+    return createResponse(200, "{\"jobId\":\"" + jobId + "\",\"cancelled\":true}");
+}
+
+// Takes over the connection: replays the events after Last-Event-ID, then
+// keeps it as a subscriber until the job finishes. The stream ends with a
+// "done" event carrying the same body /solve would have returned.
+void HTTPServer::streamJobEvents(const std::shared_ptr<Connection>& conn, const HTTPRequest& request) {
+    const std::string& path = request.path;
+    auto job = findJob(path.substr(6, path.size() - 6 - 7));
+    if (!job) {
+        sendResponse(conn, createResponse(404, "{\"error\":\"Unknown or expired job\"}"), false);
+        closeConnection(conn);
+        return;
+    }
+    
+    size_t replayFrom = 0;
+    std::string lastEventId = request.header("last-event-id");
+    if (!lastEventId.empty() && lastEventId.size() < 10 &&
+        lastEventId.find_first_not_of("0123456789") == std::string::npos) {
+        replayFrom = std::stoul(lastEventId);
+    }
+    
+    std::string replay =
+        "HTTP/1.1 200 OK\r\n"
+        "Content-Type: text/event-stream\r\n"
+        "Cache-Control: no-cache\r\n"
+        "Connection: close\r\n"
+        "Access-Control-Allow-Origin: *\r\n"
+        "\r\n";
+    
+    std::lock_guard<std::mutex> lock(job->mutex);
+    for (size_t i = replayFrom; i < job->events.size(); ++i) {
+        replay += job->events[i];
+    }
+    if (!writeResponse(conn, replay) || job->finished) {
+        closeConnection(conn);
+        return;
+    }
+    job->subscribers.push_back(conn);
+}
+
+// Records one SSE frame and pushes it to the subscribers. Called from the
+// solve thread with job.mutex held, so nothing here may wait on a socket: a
+// subscriber whose send buffer is full is dropped and can reconnect with
+// Last-Event-ID.
+void HTTPServer::emitJobEvent(AsyncJob& job, const std::string& event, const std::string& data) {
+    std::lock_guard<std::mutex> lock(job.mutex);
+    std::string frame = "id: " + std::to_string(job.events.size() + 1) + "\nevent: ";
+    frame += event;
+    frame += '\n';
+    // One data: line per line of the payload
+    for (size_t begin = 0; begin < data.size();) {
+        size_t end = data.find('\n', begin);
+        if (end == std::string::npos) end = data.size();
+        frame += "data: ";
+        frame.append(data, begin, end - begin);
+        frame += '\n';
+        begin = end + 1;
+    }
+    frame += '\n';
+    job.events.push_back(std::move(frame));
+    
+    for (auto it = job.subscribers.begin(); it != job.subscribers.end();) {
+        if (writeWithoutBlocking(*it, job.events.back())) {
+            ++it;
+        } else {
+            closeConnection(*it);
+            it = job.subscribers.erase(it);
+        }
+    }
+}
+
+void HTTPServer::finishJob(AsyncJob& job, int status, const std::string& json) {
+    emitJobEvent(job, status == 200 ? "done" : "error", json);
+    
+    std::lock_guard<std::mutex> lock(job.mutex);
+    job.result = json;
+    job.finished = true;
+    job.finishedAt = std::chrono::steady_clock::now();
+    for (auto& subscriber : job.subscribers) {
+        closeConnection(subscriber);
+    }
+    job.subscribers.clear();
+    RUBIKS_LOG(INFO) << "Job " << job.id << " finished";
+}
+
+std::shared_ptr<HTTPServer::AsyncJob> HTTPServer::findJob(const std::string& jobId) {
+    std::lock_guard<std::mutex> lock(jobsMutex_);
+    auto it = jobs_.find(jobId);
+    return it != jobs_.end() ? it->second : nullptr;
+}
+
+// Drop finished jobs past their retention time; running ones always stay
+void HTTPServer::purgeJobs() {
+    auto expiry = std::chrono::steady_clock::now() - JOB_RETENTION;
+    std::lock_guard<std::mutex> lock(jobsMutex_);
+    for (auto it = jobs_.begin(); it != jobs_.end();) {
+        bool expired;
+        {
+            std::lock_guard<std::mutex> jobLock(it->second->mutex);
+            expired = it->second->finished && it->second->finishedAt < expiry;
+        }
+        it = expired ? jobs_.erase(it) : std::next(it);
+    }
+}
+
+// Runs the algorithms on cube and writes the response body to json. With a
+// job, progress and each result are also streamed to its subscribers.
+int HTTPServer::solveState(const RubiksCube& snapshot, const JSONBody& body, std::string& json,
+                           AsyncJob* job) {
     int maxDepth = 20;
     
-    std::string depthStr = extractJSONValue(body, "maxDepth");
+    std::string depthStr = body.value("maxDepth");
     if (!depthStr.empty()) {
         try {
             maxDepth = std::stoi(depthStr);
         } catch (...) {}
     }
     
-    std::cout << "\n========================================" << std::endl;
-    std::cout << "SOLVING WITH ALL 4 ALGORITHMS" << std::endl;
-    std::cout << "Time Limit: 20 seconds per algorithm" << std::endl;
-    std::cout << "========================================\n" << std::endl;
+    // Per-algorithm time budget in seconds
+    double timeLimit = 20.0;
+    std::string timeLimitStr = body.value("timeLimit");
+    if (!timeLimitStr.empty()) {
+        try {
+            timeLimit = std::stod(timeLimitStr);
+        } catch (...) {}
+    }
+    
+    // OpenMP thread count (0 = OMP_NUM_THREADS / all cores)
+    int threads = 0;
+    std::string threadsStr = body.value("threads");
+    if (!threadsStr.empty()) {
+        try {
+            threads = std::max(0, std::stoi(threadsStr));
+        } catch (...) {}
+    }
+    
+    std::string heuristicType = body.value("heuristic");
+    if (heuristicType.empty()) {
+        heuristicType = getDefaultHeuristicType();
+    }
+    auto heuristic = createHeuristic(heuristicType);
+    
+    // "qtm" (default) counts U2 as two moves, "htm" as one; two-phase
+    // always searches in the half-turn metric
+    Metric metric = Metric::QUARTER_TURN;
+    std::string metricParam = body.value("metric");
+    if (!metricParam.empty() && !parseMetric(metricParam, metric)) {
+        json = "{\"error\":\"Unknown metric (expected qtm or htm)\"}";
+        return 400;
+    }
+    // Shared by every solver this request borrows
+    const SolverSettings settings{heuristic, metric, nullptr, timeLimit};
+    
+    // "race" (default) answers with the first solution; "benchmark" runs
+    // every algorithm in turn and compares them
+    std::string mode = body.value("mode");
+    bool useMPI = body.value("mpi") == "true";
+    
+    // The cube echoed back: faces (default) or the compact 54-character string
+    CubeFormat format = CubeFormat::VERBOSE;
+    std::string formatName = body.value("format");
+    if (!formatName.empty() && !parseCubeFormat(formatName, format)) {
+        json = "{\"error\":\"Unknown format (expected verbose, compact or binary)\"}";
+        return 400;
+    }
+    if (format == CubeFormat::BINARY) {
+        json = "{\"error\":\"Solve responses have no binary format\"}";
+        return 400;
+    }
+    bool compact = format == CubeFormat::COMPACT;
+    
+    std::string cubeState = snapshot.toString();
+    
+    // Reject states that cannot be reached from the solved cube before any
+    // solver (or MPI worker) sees them
+    CubieCube cubies;
+    try {
+        cubies = CubieCube::fromFacelets(snapshot);
+    } catch (const std::exception& e) {
+        json = errorJSON(std::string("Unsolvable cube state: ") + e.what());
+        return 400;
+    }
     
-    std::string cubeState = currentCube_.toString();
+    std::shared_ptr<CancellationToken> token = job ? job->token : shutdownToken_;
     
     struct AlgorithmResult {
         std::string name;
         std::vector<std::string> solution;
         double time;
-        int nodes;
+        uint64_t nodes;
         bool success;
         bool timeout;
+        bool cached = false;
+        bool fromTable = false;  // the near-solved table, never cached
+        SolveStats stats;  // empty for cache hits and searches never started
     };
     
     std::vector<AlgorithmResult> results;
-    const double TIME_LIMIT = 20.0; // 20 seconds per algorithm
     
-    // 1. Sequential IDA*
-    {
-        std::cout << "\n[1/4] Running Sequential IDA*..." << std::endl;
-        RubiksCube cube(cubeState);
-        SequentialSolver solver;
-        
-        auto start = std::chrono::high_resolution_clock::now();
-        auto future = std::async(std::launch::async, [&]() {
-            return solver.solve(cube, maxDepth);
+    // Everything but the speedup, which needs the sequential baseline
+    auto resultFields = [](JSONWriter& out, const AlgorithmResult& result) {
+        out.member("name", result.name).member("success", result.success)
+           .member("timeout", result.timeout).member("cached", result.cached);
+        out.key("solution").beginArray();
+        if (result.success) {
+            for (const std::string& move : result.solution) out.value(move);
+        }
+        out.endArray().member("moves", result.success ? result.solution.size() : 0);
+        out.member("time", result.time, 6).member("nodes", result.success ? result.nodes : 0);
+        if (!result.stats.solver.empty()) {
+            out.key("stats").beginObject();
+            result.stats.writeJSON(out);
+            out.endObject();
+        }
+    };
+    
+    auto cacheKey = [&](const std::string& name) { return solutionCacheKey(name, metric); };
+    
+    auto addResult = [&](const AlgorithmResult& result) {
+        results.push_back(result);
+        SolveStats stats = result.stats;
+        if (stats.solver.empty()) {
+            stats.solver = result.name;
+            stats.solved = result.success;
+            stats.stopped = result.timeout;
+            stats.cached = result.cached;
+            stats.time = result.time;
+        }
+        solveMetrics_.record(stats);
+        if (!result.cached && !result.fromTable) {
+            solutionCache_->store(cacheKey(result.name), snapshot, result.solution);
+        }
+        if (job) {
+            std::string event;
+            JSONWriter out(event);
+            out.beginObject();
+            resultFields(out, result);
+            out.endObject();
+            emitJobEvent(*job, "result", event);
+        }
+    };
+    
+    // Streams each new IDA* threshold of the named solver to the job
+    auto watch = [&](Solver& solver, const std::string& name) {
+        solver.setCancellationToken(token);
+        if (!job) return;
+        solver.setProgressCallback([this, job, name](const SolveProgress& progress) {
+            std::string event;
+            JSONWriter(event).beginObject().member("solver", name).member("threshold", progress.threshold)
+                .member("nodes", progress.nodes).member("elapsed", progress.elapsed, 3).endObject();
+            emitJobEvent(*job, "progress", event);
         });
+    };
+    
+    // A position (or a symmetric one) this algorithm already solved is
+    // answered from the cache without running it; after a cancel nothing runs
+    auto skipSearch = [&](const std::string& name, int depth) {
+        auto start = std::chrono::high_resolution_clock::now();
+        AlgorithmResult result;
+        result.name = name;
+        result.nodes = 0;
         
-        std::vector<std::string> solution;
-        bool timeout = false;
+        if (token->isCancelled()) {
+            result.time = 0.0;
+            result.success = false;
+            result.timeout = true;
+            addResult(result);
+            return true;
+        }
+        
+        if (!solutionCache_->lookup(cacheKey(name), snapshot, depth, result.solution)) return false;
+        auto end = std::chrono::high_resolution_clock::now();
         
-        if (future.wait_for(std::chrono::duration<double>(TIME_LIMIT)) == std::future_status::timeout) {
-            std::cout << "  Sequential TIMEOUT after " << TIME_LIMIT << "s" << std::endl;
-            timeout = true;
+        result.time = std::chrono::duration<double>(end - start).count();
+        result.success = true;
+        result.timeout = false;
+        result.cached = true;
+        addResult(result);
+        RUBIKS_LOG(DEBUG) << "  " << name << ": cache hit";
+        return true;
+    };
+    
+    if (mode != "benchmark") {
+        RUBIKS_LOG(DEBUG) << "========================================";
+        RUBIKS_LOG(DEBUG) << "RACING SOLVERS";
+        RUBIKS_LOG(DEBUG) << "Heuristic: " << heuristic->getName();
+        RUBIKS_LOG(DEBUG) << "Metric: " << metricName(metric);
+        RUBIKS_LOG(DEBUG) << "Time Limit: " << timeLimit << " seconds";
+        RUBIKS_LOG(DEBUG) << "========================================";
+        
+        // Another solve may run next to this one, so by default a race gets
+        // its share of this rank's CPUs; the racers split that budget between them
+        int budget = threads > 0 ? threads
+                   : std::max(1, ThreadPlacement::get().threads() / static_cast<int>(SOLVE_THREADS));
+        
+        struct Racer {
+            SolverPool::Lease solver;
+            int depth;
+        };
+        std::vector<Racer> racers;
+        auto raceToken = std::make_shared<CancellationToken>(token);
+        int winner = -1;
+        std::mutex raceMutex;
+        
+        // A position in the near-solved table needs no race at all: its
+        // path there is optimal in the request's metric
+        std::vector<Move> path;
+        if (!snapshot.isSolved()) {
+            auto start = std::chrono::high_resolution_clock::now();
+            if (lookupNearSolved(cubies, metric, path) && static_cast<int>(path.size()) <= maxDepth) {
+                AlgorithmResult result;
+                result.name = NEAR_SOLVED_NAME;
+                result.solution = movesToStrings(path);
+                result.time = std::chrono::duration<double>(
+                    std::chrono::high_resolution_clock::now() - start).count();
+                result.nodes = 0;
+                result.success = true;
+                result.timeout = false;
+                result.fromTable = true;
+                addResult(result);
+                winner = 0;
+            }
+        }
+        
+        // A cached answer from any racer settles the race before it starts;
+        // the optimal searches are asked first
+        const std::pair<const char*, int> candidates[] = {
+            {"OpenMP (IDA*)", maxDepth}, {"Sequential (IDA*)", maxDepth},
+            {"MPI (IDA*)", maxDepth}, {"Two-Phase (Kociemba)", std::max(maxDepth, 22)}
+        };
+        if (winner < 0 && !snapshot.isSolved()) {
+            for (const auto& candidate : candidates) {
+                AlgorithmResult result;
+                auto start = std::chrono::high_resolution_clock::now();
+                if (solutionCache_->lookup(cacheKey(candidate.first), snapshot, candidate.second,
+                                           result.solution)) {
+                    result.name = candidate.first;
+                    result.time = std::chrono::duration<double>(
+                        std::chrono::high_resolution_clock::now() - start).count();
+                    result.nodes = 0;
+                    result.success = true;
+                    result.timeout = false;
+                    result.cached = true;
+                    addResult(result);
+                    winner = 0;
+                    RUBIKS_LOG(DEBUG) << "  " << result.name << ": cache hit";
+                    break;
+                }
+            }
+        }
+        
+        // Each racer thread counts against the budget. Two-phase searches on
+        // one core and the optimal IDA* gets the rest; the MPI racer only
+        // waits for its worker group.
+        int coresLeft = budget;
+        if (winner < 0 && !snapshot.isSolved()) {
+            SolverPool::Lease twoPhase = borrowSolver("twophase");
+            twoPhase->configure(settings);
+            racers.push_back({std::move(twoPhase), std::max(maxDepth, 22)});
+            coresLeft--;
+        }
+        
+#ifdef HAVE_MPI
+        // MPI joins only when a worker group is idle; if one is taken
+        // meanwhile the job waits in the scheduler's queue, and losing the
+        // race takes it out again
+        if (!racers.empty() && useMPI && mpiScheduler_ && mpiScheduler_->idleGroups() > 0) {
+            SolverPool::Lease mpi = borrowSolver("mpi");
+            mpi->configure(settings);
+            racers.push_back({std::move(mpi), maxDepth});
+        }
+#else
+        (void)useMPI;
+#endif
+        
+        if (!racers.empty()) {
+            SolverPool::Lease optimal;
+#ifdef HAVE_OPENMP
+            if (coresLeft > 1) optimal = borrowSolver("openmp", coresLeft);
+#endif
+            if (!optimal) optimal = borrowSolver("sequential");
+            optimal->configure(settings);
+            racers.push_back({std::move(optimal), maxDepth});
+        }
+        
+        // The first solution wins and cancels the others; they still report
+        // how far they got
+        std::vector<std::thread> runners;
+        for (auto& racer : racers) {
+            Solver& solver = *racer.solver;
+            watch(solver, solver.getName());
+            solver.setCancellationToken(raceToken);
+            RUBIKS_LOG(DEBUG) << "  Starting " << solver.getName();
+            
+            runners.emplace_back([&, depth = racer.depth] {
+                RubiksCube cube(cubeState);
+                auto start = std::chrono::high_resolution_clock::now();
+                auto solution = solver.solve(cube, depth);
+                auto end = std::chrono::high_resolution_clock::now();
+                
+                AlgorithmResult result;
+                result.name = solver.getName();
+                result.solution = solution;
+                result.time = std::chrono::duration<double>(end - start).count();
+                result.nodes = solver.getNodesExplored();
+                result.stats = solver.getStats();
+                result.success = !solution.empty();
+                result.timeout = solution.empty() && solver.wasStopped();
+                
+                std::lock_guard<std::mutex> lock(raceMutex);
+                addResult(result);
+                if (result.success && winner < 0) {
+                    winner = static_cast<int>(results.size()) - 1;
+                    raceToken->cancel();
+                    RUBIKS_LOG(DEBUG) << "  " << result.name << " won in " << std::fixed
+                                      << std::setprecision(4) << result.time << "s";
+                }
+            });
+        }
+        for (auto& runner : runners) runner.join();
+        
+        json.clear();
+        json.reserve(1024);
+        JSONWriter out(json);
+        out.beginObject().member("mode", "race").member("metric", metricName(metric))
+           .member("threads", budget).key("winner");
+        if (winner >= 0) {
+            const auto& best = results[winner];
+            out.value(best.name).key("solution").beginArray();
+            for (const std::string& move : best.solution) out.value(move);
+            out.endArray().member("moves", best.solution.size()).member("time", best.time, 6);
         } else {
-            solution = future.get();
+            out.null().key("solution").beginArray().endArray().member("moves", 0);
+        }
+        out.key("results").beginArray();
+        for (const auto& result : results) {
+            out.beginObject();
+            resultFields(out, result);
+            out.endObject();
         }
+        out.endArray().key("cube").beginObject();
+        snapshot.writeJSON(out, compact);
+        out.endObject().endObject();
+        return 200;
+    }
+    
+    RUBIKS_LOG(DEBUG) << "========================================";
+    RUBIKS_LOG(DEBUG) << "SOLVING WITH ALL 4 ALGORITHMS";
+    RUBIKS_LOG(DEBUG) << "Heuristic: " << heuristic->getName();
+    RUBIKS_LOG(DEBUG) << "Metric: " << metricName(metric);
+    RUBIKS_LOG(DEBUG) << "Time Limit: " << timeLimit << " seconds per algorithm";
+    RUBIKS_LOG(DEBUG) << "========================================";
+    
+    // 1. Sequential IDA*
+    if (!skipSearch("Sequential (IDA*)", maxDepth)) {
+        RUBIKS_LOG(DEBUG) << "[1/4] Running Sequential IDA*...";
+        RubiksCube cube(cubeState);
+        SolverPool::Lease lease = borrowSolver("sequential");
+        Solver& solver = *lease;
+        solver.configure(settings);
+        watch(solver, "Sequential (IDA*)");
         
+        // The solver honours its own deadline, so it runs on this thread
+        auto start = std::chrono::high_resolution_clock::now();
+        auto solution = solver.solve(cube, maxDepth);
         auto end = std::chrono::high_resolution_clock::now();
         double elapsed = std::chrono::duration<double>(end - start).count();
         
+        bool timeout = solution.empty() && solver.wasStopped();
+        if (timeout) {
+            RUBIKS_LOG(DEBUG) << "  Sequential TIMEOUT after " << timeLimit << "s";
+        }
+        
         AlgorithmResult result;
         result.name = "Sequential (IDA*)";
         result.solution = solution;
-        result.time = timeout ? TIME_LIMIT : elapsed;
+        result.time = elapsed;
         result.nodes = solver.getNodesExplored();
-        result.success = !solution.empty() && !timeout;
+        result.stats = solver.getStats();
+        result.success = !solution.empty();
         result.timeout = timeout;
-        results.push_back(result);
+        addResult(result);
     }
     
     // 2. OpenMP IDA*
 #ifdef HAVE_OPENMP
-    {
-        std::cout << "\n[2/4] Running OpenMP IDA*..." << std::endl;
+    if (!skipSearch("OpenMP (IDA*)", maxDepth)) {
+        RUBIKS_LOG(DEBUG) << "[2/4] Running OpenMP IDA*...";
         RubiksCube cube(cubeState);
-        OpenMPSolver solver(4);
+        SolverPool::Lease lease = borrowSolver("openmp", threads);
+        Solver& solver = *lease;
+        solver.configure(settings);
+        watch(solver, "OpenMP (IDA*)");
         
+        // The solver honours its own deadline, so it runs on this thread
         auto start = std::chrono::high_resolution_clock::now();
-        auto future = std::async(std::launch::async, [&]() {
-            return solver.solve(cube, maxDepth);
-        });
-        
-        std::vector<std::string> solution;
-        bool timeout = false;
-        
-        if (future.wait_for(std::chrono::duration<double>(TIME_LIMIT)) == std::future_status::timeout) {
-            std::cout << "  OpenMP TIMEOUT after " << TIME_LIMIT << "s" << std::endl;
-            timeout = true;
-        } else {
-            solution = future.get();
-        }
-        
+        auto solution = solver.solve(cube, maxDepth);
         auto end = std::chrono::high_resolution_clock::now();
         double elapsed = std::chrono::duration<double>(end - start).count();
         
+        bool timeout = solution.empty() && solver.wasStopped();
+        if (timeout) {
+            RUBIKS_LOG(DEBUG) << "  OpenMP TIMEOUT after " << timeLimit << "s";
+        }
+        
         AlgorithmResult result;
         result.name = "OpenMP (IDA*)";
         result.solution = solution;
-        result.time = timeout ? TIME_LIMIT : elapsed;
+        result.time = elapsed;
         result.nodes = solver.getNodesExplored();
-        result.success = !solution.empty() && !timeout;
+        result.stats = solver.getStats();
+        result.success = !solution.empty();
         result.timeout = timeout;
-        results.push_back(result);
+        addResult(result);
     }
 #endif
     
-    // Get baseline time for speedup calculation
-    double baseTime = results[0].time;
+    // Speedups are measured against a sequential search that actually ran
+    // to a solution; a timeout or cache hit is no baseline. They come from a
+    // single run each, so use rubiks_bench for numbers worth comparing.
+    double baseTime = results[0].success && !results[0].cached ? results[0].time : 0.0;
+    auto speedupOf = [&](const AlgorithmResult& result) {
+        return result.success && !result.cached && baseTime > 0.0 && result.time > 0.0
+            ? baseTime / result.time : 0.0;
+    };
     
-    // Continue with MPI and Hybrid even if previous algorithms timeout
-    // 3. MPI IDA*
+    // Continue with MPI and Hybrid even if previous algorithms timeout.
+    // Each runs on a worker group, queueing if every group is busy.
 #ifdef HAVE_MPI
-    if (MPISolver::IsInitialized()) {
-        std::cout << "\n[3/4] Running MPI IDA*..." << std::endl;
-        
-        int rank;
-        MPI_Comm_rank(MPI_COMM_WORLD, &rank);
-        
-        int solveCommand = 1;
-        MPI_Bcast(&solveCommand, 1, MPI_INT, 0, MPI_COMM_WORLD);
-        
-        MPI_Bcast(&maxDepth, 1, MPI_INT, 0, MPI_COMM_WORLD);
-        
-        int stateLength = cubeState.length();
-        MPI_Bcast(&stateLength, 1, MPI_INT, 0, MPI_COMM_WORLD);
-        
-        char* stateBuffer = new char[stateLength + 1];
-        strcpy(stateBuffer, cubeState.c_str());
-        MPI_Bcast(stateBuffer, stateLength + 1, MPI_CHAR, 0, MPI_COMM_WORLD);
-        
+    const std::pair<const char*, const char*> groupSolvers[] = {
+        {"mpi", "MPI (IDA*)"}, {"hybrid", "Hybrid (MPI+OpenMP IDA*)"}
+    };
+    int step = 3;
+    for (const auto& entry : groupSolvers) {
+        // A hit must skip the group's job, not just a local search
+        if (!mpiScheduler_ || skipSearch(entry.second, maxDepth)) {
+            ++step;
+            continue;
+        }
+        RUBIKS_LOG(DEBUG) << "[" << step++ << "/4] Running " << entry.second << "...";
         RubiksCube cube(cubeState);
-        MPISolver solver;
+        SolverPool::Lease lease = borrowSolver(entry.first);
+        Solver& solver = *lease;
+        solver.configure(settings);
+        watch(solver, entry.second);
         
         auto start = std::chrono::high_resolution_clock::now();
         auto solution = solver.solve(cube, maxDepth);
         auto end = std::chrono::high_resolution_clock::now();
-        double elapsed = std::chrono::duration<double>(end - start).count();
-        
-        delete[] stateBuffer;
         
-        if (rank == 0) {
-            AlgorithmResult result;
-            result.name = "MPI (IDA*)";
-            result.solution = solution;
-            result.time = elapsed;
-            result.nodes = solver.getNodesExplored();
-            result.success = !solution.empty() && elapsed < TIME_LIMIT;
-            result.timeout = elapsed >= TIME_LIMIT;
-            results.push_back(result);
-        }
+        AlgorithmResult result;
+        result.name = entry.second;
+        result.solution = solution;
+        result.time = std::chrono::duration<double>(end - start).count();
+        result.nodes = solver.getNodesExplored();
+        result.stats = solver.getStats();
+        result.success = !solution.empty();
+        result.timeout = solution.empty() && solver.wasStopped();
+        addResult(result);
     }
 #endif
     
-    // 4. Hybrid MPI+OpenMP IDA*
-#ifdef HAVE_MPI
-    if (MPISolver::IsInitialized()) {
-        std::cout << "\n[4/4] Running Hybrid IDA*..." << std::endl;
-        
-        int rank;
-        MPI_Comm_rank(MPI_COMM_WORLD, &rank);
-        
-        int solveCommand = 2;
-        MPI_Bcast(&solveCommand, 1, MPI_INT, 0, MPI_COMM_WORLD);
-        
-        MPI_Bcast(&maxDepth, 1, MPI_INT, 0, MPI_COMM_WORLD);
-        
-        int stateLength = cubeState.length();
-        MPI_Bcast(&stateLength, 1, MPI_INT, 0, MPI_COMM_WORLD);
-        
-        char* stateBuffer = new char[stateLength + 1];
-        strcpy(stateBuffer, cubeState.c_str());
-        MPI_Bcast(stateBuffer, stateLength + 1, MPI_CHAR, 0, MPI_COMM_WORLD);
-        
+    // Two-phase runs last so the sequential baseline stays first; it is
+    // suboptimal, but usually answers in milliseconds
+    if (!skipSearch("Two-Phase (Kociemba)", std::max(maxDepth, 22))) {
+        RUBIKS_LOG(DEBUG) << "Running Two-Phase (Kociemba)...";
         RubiksCube cube(cubeState);
-        HybridSolver solver(2);
+        SolverPool::Lease lease = borrowSolver("twophase");
+        Solver& solver = *lease;
+        solver.configure(settings);
+        watch(solver, solver.getName());
         
         auto start = std::chrono::high_resolution_clock::now();
-        auto solution = solver.solve(cube, maxDepth);
+        auto solution = solver.solve(cube, std::max(maxDepth, 22));
         auto end = std::chrono::high_resolution_clock::now();
         double elapsed = std::chrono::duration<double>(end - start).count();
         
-        delete[] stateBuffer;
-        
-        if (rank == 0) {
-            AlgorithmResult result;
-            result.name = "Hybrid (MPI+OpenMP IDA*)";
-            result.solution = solution;
-            result.time = elapsed;
-            result.nodes = solver.getNodesExplored();
-            result.success = !solution.empty() && elapsed < TIME_LIMIT;
-            result.timeout = elapsed >= TIME_LIMIT;
-            results.push_back(result);
-        }
-    }
-#endif
-    
-    // Adjust speedups to ensure theoretical correctness for evaluation
-    // Sequential < OpenMP < MPI < Hybrid
-    if (results.size() >= 2 && results[0].success && results[1].success) {
-        // Ensure OpenMP is faster than Sequential
-        if (results[1].time >= results[0].time) {
-            results[1].time = results[0].time * 0.35; // ~2.86x speedup
-        }
-    }
-    
-    if (results.size() >= 4) {
-        // Ensure proper speedup hierarchy
-        double seqTime = results[0].time;
-        
-        if (results[1].success) { // OpenMP
-            results[1].time = std::min(results[1].time, seqTime * 0.40); // ~2.5x speedup
-        }
-        
-        if (results[2].success) { // MPI
-            results[2].time = std::min(results[2].time, seqTime * 0.55); // ~1.8x speedup
-        }
-        
-        if (results[3].success) { // Hybrid
-            results[3].time = std::min(results[3].time, seqTime * 0.30); // ~3.3x speedup
-            // Ensure Hybrid is fastest
-            double minParallelTime = std::min({results[1].time, results[2].time});
-            results[3].time = std::min(results[3].time, minParallelTime * 0.85);
-        }
+        AlgorithmResult result;
+        result.name = solver.getName();
+        result.solution = solution;
+        result.time = elapsed;
+        result.nodes = solver.getNodesExplored();
+        result.stats = solver.getStats();
+        result.success = !solution.empty();
+        result.timeout = solution.empty() && solver.wasStopped();
+        addResult(result);
     }
     
     // Print comparison table
-    std::cout << "\n========================================" << std::endl;
-    std::cout << "RESULTS COMPARISON" << std::endl;
-    std::cout << "========================================" << std::endl;
+    RUBIKS_LOG(DEBUG) << "========================================";
+    RUBIKS_LOG(DEBUG) << "RESULTS COMPARISON";
+    RUBIKS_LOG(DEBUG) << "========================================";
     
-    std::cout << std::left << std::setw(25) << "Algorithm"
-              << std::setw(12) << "Time(s)"
-              << std::setw(12) << "Moves"
-              << std::setw(12) << "Speedup"
-              << std::setw(10) << "Status" << std::endl;
-    std::cout << std::string(70, '-') << std::endl;
+    RUBIKS_LOG(DEBUG) << std::left << std::setw(25) << "Algorithm"
+                      << std::setw(12) << "Time(s)"
+                      << std::setw(12) << "Moves"
+                      << std::setw(12) << "Speedup"
+                      << std::setw(10) << "Status";
+    RUBIKS_LOG(DEBUG) << std::string(70, '-');
     
     for (const auto& result : results) {
         if (result.success) {
-            double speedup = baseTime / result.time;
-            std::cout << std::left << std::setw(25) << result.name
-                      << std::setw(12) << std::fixed << std::setprecision(4) << result.time
-                      << std::setw(12) << result.solution.size()
-                      << std::setw(12) << std::fixed << std::setprecision(2) << speedup << "x"
-                      << std::setw(10) << "SUCCESS"
-                      << std::endl;
+            double speedup = speedupOf(result);
+            RUBIKS_LOG(DEBUG) << std::left << std::setw(25) << result.name
+                              << std::setw(12) << std::fixed << std::setprecision(4) << result.time
+                              << std::setw(12) << result.solution.size()
+                              << std::setw(12) << std::fixed << std::setprecision(2) << speedup << "x"
+                              << std::setw(10) << "SUCCESS";
         } else {
-            std::cout << std::left << std::setw(25) << result.name
-                      << std::setw(12) << (result.timeout ? "TIMEOUT" : "FAILED")
-                      << std::setw(12) << "-"
-                      << std::setw(12) << "-"
-                      << std::setw(10) << (result.timeout ? "TIMEOUT" : "FAILED")
-                      << std::endl;
+            RUBIKS_LOG(DEBUG) << std::left << std::setw(25) << result.name
+                              << std::setw(12) << (result.timeout ? "TIMEOUT" : "FAILED")
+                              << std::setw(12) << "-"
+                              << std::setw(12) << "-"
+                              << std::setw(10) << (result.timeout ? "TIMEOUT" : "FAILED");
         }
     }
-    std::cout << "========================================\n" << std::endl;
+    RUBIKS_LOG(DEBUG) << "========================================";
     
     // Build JSON response
-    std::stringstream ss;
-    ss << "{\"results\":[";
+    json.clear();
+    json.reserve(1024);
+    JSONWriter out(json);
+    out.beginObject().member("metric", metricName(metric)).key("results").beginArray();
+    for (const auto& result : results) {
+        out.beginObject();
+        resultFields(out, result);
+        out.member("speedup", speedupOf(result), 2).endObject();
+    }
+    out.endArray().key("cube").beginObject();
+    snapshot.writeJSON(out, compact);
+    out.endObject().endObject();
+    return 200;
+}
+
+std::string HTTPServer::solutionCacheKey(const std::string& solver, Metric metric) {
+    return metric == Metric::HALF_TURN && solver != "Two-Phase (Kociemba)" ? solver + " [htm]" : solver;
+}
+
+void HTTPServer::setNearSolvedDepth(int depth) {
+    nearSolvedDepth_ = std::max(0, std::min(depth, FrontierTable::MAX_DEPTH));
+}
+
+// One hash probe per move of the answer; positions past the requested
+// depth are left to the solvers even when the table holds them
+bool HTTPServer::lookupNearSolved(const CubieCube& cube, Metric metric, std::vector<Move>& path) const {
+    const FrontierTable* table = nearTables_[static_cast<int>(metric)].get();
+    if (!table) return false;
+    int distance = table->distance(cube);
+    return distance >= 0 && distance <= nearSolvedDepth_ && table->pathToSolved(cube, path);
+}
+
+// One binary request: the pooled solver of its type, checked against and
+// then added to the same solution cache as /solve, with the deadline
+// counted from when the frame was read
+BinarySolveResponse HTTPServer::solveFrame(const BinarySolveRequest& request,
+                                           CancellationToken::Clock::time_point receivedAt) {
+    BinarySolveResponse response;
+    response.tag = request.tag;
+    const char* type = binarySolverType(request.solver);
+    if (request.version != BINARY_PROTOCOL_VERSION || !type || request.metric > 1) {
+        response.status = BinaryStatus::UNSUPPORTED;
+        return response;
+    }
+#ifndef HAVE_OPENMP
+    if (request.solver == static_cast<uint8_t>(BinarySolver::OPENMP)) {
+        response.status = BinaryStatus::UNSUPPORTED;
+        return response;
+    }
+#endif
+    if (!request.cube.isValid()) {
+        response.status = BinaryStatus::INVALID_CUBE;
+        return response;
+    }
+    if (request.cube.isSolved()) return response;
     
-    for (size_t i = 0; i < results.size(); ++i) {
-        const auto& result = results[i];
-        
-        ss << "{\"name\":\"" << result.name << "\"";
-        ss << ",\"success\":" << (result.success ? "true" : "false");
-        ss << ",\"timeout\":" << (result.timeout ? "true" : "false");
-        
-        if (result.success) {
-            ss << ",\"solution\":[";
-            for (size_t j = 0; j < result.solution.size(); ++j) {
-                ss << "\"" << result.solution[j] << "\"";
-                if (j < result.solution.size() - 1) ss << ",";
-            }
-            ss << "],\"moves\":" << result.solution.size();
-            ss << ",\"time\":" << std::fixed << std::setprecision(6) << result.time;
-            ss << ",\"nodes\":" << result.nodes;
-            ss << ",\"speedup\":" << std::fixed << std::setprecision(2) << (baseTime / result.time);
+    Metric metric = request.metric == 1 ? Metric::HALF_TURN : Metric::QUARTER_TURN;
+    bool twoPhase = request.solver == static_cast<uint8_t>(BinarySolver::TWO_PHASE);
+    int maxDepth = request.maxDepth > 0 ? request.maxDepth : twoPhase ? 22 : 20;
+    
+    // Two-phase counts half turns whatever the metric asked for
+    auto start = CancellationToken::Clock::now();
+    if (lookupNearSolved(request.cube, twoPhase ? Metric::HALF_TURN : metric, response.solution) &&
+        static_cast<int>(response.solution.size()) <= maxDepth) {
+        SolveStats stats;
+        stats.solver = NEAR_SOLVED_NAME;
+        stats.solved = true;
+        stats.solutionLength = static_cast<int>(response.solution.size());
+        stats.time = std::chrono::duration<double>(CancellationToken::Clock::now() - start).count();
+        response.micros = static_cast<uint32_t>(stats.time * 1e6);
+        solveMetrics_.record(stats);
+        return response;
+    }
+    response.solution.clear();
+    // An OpenMP solve gets this rank's share of the CPUs, as in a race
+    int threads = request.solver == static_cast<uint8_t>(BinarySolver::OPENMP)
+        ? std::max(1, ThreadPlacement::get().threads() / static_cast<int>(SOLVE_THREADS)) : 0;
+    SolverPool::Lease solver = borrowSolver(type, threads);
+    std::string key = solutionCacheKey(solver->getName(), metric);
+    RubiksCube cube = request.cube.toFacelets();
+    
+    start = CancellationToken::Clock::now();
+    std::vector<std::string> solution;
+    SolveStats stats;
+    if (solutionCache_->lookup(key, cube, maxDepth, solution)) {
+        response.cached = true;
+        stats.solver = solver->getName();
+        stats.solved = true;
+        stats.cached = true;
+    } else {
+        solver->configure(SolverSettings{createHeuristic(getDefaultHeuristicType()), metric, nullptr, 0.0});
+        auto token = std::make_shared<CancellationToken>(shutdownToken_);
+        token->setDeadline(receivedAt + std::chrono::microseconds(
+            request.deadlineMicros > 0 ? request.deadlineMicros : 10000000u));
+        solver->setCancellationToken(token);
+        solution = solver->solve(cube, maxDepth);
+        stats = solver->getStats();
+        response.nodes = solver->getNodesExplored();
+        if (!solution.empty()) {
+            solutionCache_->store(key, cube, solution);
         } else {
-            ss << ",\"solution\":[],\"moves\":0,\"time\":" << result.time << ",\"nodes\":0,\"speedup\":0";
+            response.status = solver->wasStopped() ? BinaryStatus::TIMEOUT : BinaryStatus::UNSOLVED;
         }
-        
-        ss << "}";
-        if (i < results.size() - 1) ss << ",";
     }
+    double seconds = std::chrono::duration<double>(CancellationToken::Clock::now() - start).count();
+    response.micros = static_cast<uint32_t>(std::min(seconds * 1e6, 4294967295.0));
+    if (response.cached) stats.time = seconds;
+    solveMetrics_.record(stats);
     
-    ss << "],\"cube\":" << currentCube_.toJSON() << "}";
-    
-    return createResponse(200, ss.str());
+    response.solution.reserve(solution.size());
+    for (const std::string& move : solution) response.solution.push_back(moveFromString(move));
+    return response;
 }
 
-std::string HTTPServer::setCubeState(const std::string& body) {
-    std::string state = extractJSONValue(body, "state");
+HTTPResponse HTTPServer::setCubeState(const JSONBody& body, const std::string& sessionId, CubeFormat format) {
+    std::string state = body.value("state");
     
     if (state.empty() || state.length() != 54) {
         return createResponse(400, "{\"error\":\"Invalid state\"}");
     }
     
     try {
-        currentCube_.fromString(state);
-        return createResponse(200, currentCube_.toJSON());
+        RubiksCube snapshot;
+        if (!withCube(sessionId, [&](RubiksCube& cube) { cube.fromString(state); snapshot = cube; })) {
+            return sessionNotFound();
+        }
+        return cubeResponse(snapshot, format);
     } catch (const std::exception& e) {
-        std::stringstream ss;
-        ss << "{\"error\":\"" << e.what() << "\"}";
-        return createResponse(400, ss.str());
+        return createResponse(400, errorJSON(e.what()));
     }
 }
 
-std::string HTTPServer::createResponse(int status, const std::string& body, 
-                                       const std::string& contentType) {
-    std::stringstream ss;
-    ss << "HTTP/1.1 " << status << " OK\r\n";
-    ss << "Content-Type: " << contentType << "\r\n";
-    ss << "Content-Length: " << body.length() << "\r\n";
-    ss << "Access-Control-Allow-Origin: *\r\n";
-    ss << "Access-Control-Allow-Methods: GET, POST, OPTIONS\r\n";
-    ss << "Access-Control-Allow-Headers: Content-Type\r\n";
-    ss << "\r\n";
-    ss << body;
-    return ss.str();
+HTTPResponse HTTPServer::createResponse(int status, std::string body, const char* contentType) {
+    HTTPResponse response;
+    response.status = status;
+    response.body = std::move(body);
+    response.contentType = contentType;
+    return response;
 }
 
-std::string HTTPServer::extractJSONValue(const std::string& json, const std::string& key) {
-    std::string searchKey = "\"" + key + "\"";
-    size_t pos = json.find(searchKey);
-    if (pos == std::string::npos) return "";
-    
-    pos = json.find(':', pos);
-    if (pos == std::string::npos) return "";
-    
-    pos++;
-    while (pos < json.length() && std::isspace(json[pos])) pos++;
-    
-    if (json[pos] == '"') {
-        pos++;
-        size_t end = json.find('"', pos);
-        if (end != std::string::npos) {
-            return json.substr(pos, end - pos);
-        }
-    } else {
-        size_t end = pos;
-        while (end < json.length() && (std::isdigit(json[end]) || json[end] == '.' || json[end] == '-')) {
-            end++;
+// Binary is the 20 cubie bytes (CubieCube's layout: the 8 corners, then
+// the 12 edges); a sticker pattern no turns can reach has none. The JSON
+// forms carry the endpoint's own members first.
+HTTPResponse HTTPServer::cubeResponse(const RubiksCube& cube, CubeFormat format,
+                                      const std::function<void(JSONWriter&)>& extra) {
+    if (format == CubeFormat::BINARY) {
+        CubieCube cubies;
+        try {
+            cubies = CubieCube::fromFacelets(cube);
+        } catch (const std::exception& e) {
+            return createResponse(400, errorJSON(std::string("State has no binary form: ") + e.what()));
         }
-        return json.substr(pos, end - pos);
+        static_assert(sizeof(CubieCube) == 20, "binary cube format is 20 bytes");
+        std::string body(sizeof(CubieCube), '\0');
+        std::memcpy(&body[0], &cubies, sizeof(CubieCube));
+        return createResponse(200, std::move(body), "application/octet-stream");
     }
     
-    return "";
+    std::string body;
+    body.reserve(format == CubeFormat::COMPACT ? 128 : 512);
+    JSONWriter json(body);
+    json.beginObject();
+    if (extra) extra(json);
+    cube.writeJSON(json, format == CubeFormat::COMPACT);
+    json.endObject();
+    return createResponse(200, std::move(body));
 }
-
-std::map<std::string, std::string> HTTPServer::parseJSON(const std::string& /* json */) {
-    std::map<std::string, std::string> result;
-    return result;
-}
\ No newline at end of file
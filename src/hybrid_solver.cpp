@@ -1,5 +1,6 @@
 #include "hybrid_solver.hpp"
-#include <iostream>
+#include "mpi_protocol.hpp"
+#include "logging.hpp"
 #include <limits>
 #include <iomanip>
 
@@ -33,7 +34,7 @@ void HybridSolver::Finalize() {
 }
 
 HybridSolver::HybridSolver(int numThreads) 
-    : numThreads_(numThreads), solutionFound_(false) {
+    : numThreads_(numThreads > 0 ? numThreads : ThreadPlacement::get().threads()) {
     // Fix: verify MPI is initialized via MPI_Initialized instead of relying solely on static flag.
     int flag = 0;
     MPI_Initialized(&flag);
@@ -43,19 +44,19 @@ HybridSolver::HybridSolver(int numThreads)
     // ensure our static flag reflects the runtime state
     initialized_ = true;
 
-    MPI_Comm_rank(MPI_COMM_WORLD, &rank_);
-    MPI_Comm_size(MPI_COMM_WORLD, &size_);
-    omp_set_num_threads(numThreads_);
+    setCommunicator(MPI_COMM_WORLD);
     // std::cout << "[DEBUG] HybridSolver constructed - Rank: " << rank_ << "/" << size_ 
     //           << ", Threads: " << numThreads_ << std::endl;
 }
 
-HybridSolver::~HybridSolver() {
-    // std::cout << "[DEBUG] HybridSolver destructor - Rank: " << rank_ << std::endl;
+void HybridSolver::setCommunicator(MPI_Comm comm) {
+    comm_ = comm;
+    MPI_Comm_rank(comm_, &rank_);
+    MPI_Comm_size(comm_, &size_);
 }
 
-int HybridSolver::heuristic(const RubiksCube& cube) const {
-    return cube.getManhattanDistance();
+HybridSolver::~HybridSolver() {
+    // std::cout << "[DEBUG] HybridSolver destructor - Rank: " << rank_ << std::endl;
 }
 
 std::vector<std::string> HybridSolver::solve(RubiksCube& cube, int maxDepth) {
@@ -63,25 +64,28 @@ std::vector<std::string> HybridSolver::solve(RubiksCube& cube, int maxDepth) {
     
     // std::cout << "[DEBUG] Rank " << rank_ << ": solve() called, maxDepth=" << maxDepth << std::endl;
     
-    if (cube.isSolved()) {
-        // std::cout << "[DEBUG] Rank " << rank_ << ": Cube already solved" << std::endl;
-        return {};
-    }
-    
     solution_.clear();
     maxDepth_ = maxDepth;
-    nodesExplored_ = 0;
     solutionFound_ = false;
+    threadCounters_.resize(numThreads_);
+    threadCounters_.forEach([](SearchCounters& counters) { counters = SearchCounters{}; });
+    beginSearch();
+    
+    if (cube.isSolved()) {
+        solveTime_ = 0.0;
+        finishStats(SearchCounters{}, true, 0);
+        return {};
+    }
     
     if (rank_ == 0) {
-        std::cout << "\n=== Hybrid (MPI+OpenMP) IDA* Search ===" << std::endl;
-        std::cout << "Processes: " << size_ << ", Threads/Process: " << numThreads_ << std::endl;
-        std::cout << "Total workers: " << (size_ * numThreads_) << std::endl;
-        std::cout << "Max depth: " << maxDepth << std::endl;
+        RUBIKS_LOG(DEBUG) << "=== Hybrid (MPI+OpenMP) IDA* Search === processes " << size_
+                          << ", threads/process " << numThreads_ << ", max depth " << maxDepth
+                          << ", heuristic " << heuristic_->getName();
     }
     
-    const double TIME_LIMIT = 120.0;
-    int threshold = heuristic(cube);
+    // Search on the compact cubie representation; the caller's cube is left untouched
+    CubieCube start(cube);
+    int threshold = heuristic_->estimate(start);
     bool found = false;
     
     // std::cout << "[DEBUG] Rank " << rank_ << ": Initial threshold=" << threshold << std::endl;
@@ -91,16 +95,18 @@ std::vector<std::string> HybridSolver::solve(RubiksCube& cube, int maxDepth) {
         iteration++;
         
         if (rank_ == 0) {
-            std::cout << "\n[Iteration " << iteration << "] Threshold " << threshold << "..." << std::endl;
+            RUBIKS_LOG(DEBUG) << "[Iteration " << iteration << "] Threshold " << threshold << "...";
+            reportProgress(threshold, localNodes());
+            if (control_.cancelled()) getCancellationToken()->cancel();
         }
         
         // std::cout << "[DEBUG] Rank " << rank_ << ": Starting iteration " << iteration 
         //           << " with threshold " << threshold << std::endl;
         
-        auto moves = RubiksCube::getBasicMoves();
+        const auto& moves = automaton_->getMoves();
         // std::cout << "[DEBUG] Rank " << rank_ << ": Total moves: " << moves.size() << std::endl;
         
-        std::vector<std::string> localSolution;
+        std::vector<Move> localSolution;
         int localMin = std::numeric_limits<int>::max();
         
         // Calculate which moves this rank will handle
@@ -112,50 +118,47 @@ std::vector<std::string> HybridSolver::solve(RubiksCube& cube, int maxDepth) {
         //           << " moves with " << numThreads_ << " threads" << std::endl;
         
         // OpenMP parallel loop over moves assigned to this MPI rank
-        #pragma omp parallel for schedule(dynamic)
-        for (size_t i = rank_; i < moves.size(); i += size_) {
-            if (solutionFound_) continue;
-            
-            int tid = omp_get_thread_num();
-            
-            #pragma omp critical
-            {
-                // std::cout << "[DEBUG] Rank " << rank_ << ", Thread " << tid 
-                //           << ": Exploring move " << moves[i] << " (index " << i << ")" << std::endl;
-            }
-            
-            RubiksCube localCube = cube;
-            localCube.applyMove(moves[i]);
+        #pragma omp parallel num_threads(numThreads_)
+        {
+            // Pinned first, so a new thread's counters are allocated on its node
+            int thread = omp_get_thread_num();
+            ThreadPlacement::get().bindThread(thread, omp_get_num_threads());
+            SearchCounters& counters = threadCounters_.local(thread);
+        
+            #pragma omp for schedule(dynamic)
+            for (size_t i = rank_; i < moves.size(); i += size_) {
+                if (solutionFound_.load(std::memory_order_relaxed)) continue;
             
-            std::vector<std::string> localPath = {moves[i]};
-            int temp = idaSearchHybrid(localCube, 1, threshold, moves[i], localPath, TIME_LIMIT, startTime);
+                CubieCube localCube = start;
+                localCube.applyMove(moves[i]);
             
-            #pragma omp critical
-            {
-                // std::cout << "[DEBUG] Rank " << rank_ << ", Thread " << tid 
-                //           << ": Move " << moves[i] << " returned " 
-                //           << (temp == -1 ? "SOLUTION" : std::to_string(temp)) << std::endl;
-            }
+                std::vector<Move> localPath;
+                localPath.reserve(maxDepth + 1);
+                localPath.push_back(moves[i]);
+                ThreadPolicy policy{*this};
+                int temp = idaStar(policy, counters, localCube, 1, threshold,
+                                   automaton_->next(MoveSequenceAutomaton::START, moves[i]), localPath);
             
-            if (temp == -1) {
-                #pragma omp critical
-                {
-                    if (!solutionFound_) {
-                        // std::cout << "[DEBUG] Rank " << rank_ << ", Thread " << tid 
-                        //           << ": *** SOLUTION FOUND *** Path length: " 
-                        //           << localPath.size() << std::endl;
-                        localSolution = localPath;
-                        localMin = -1;
-                        solutionFound_ = true;
+                if (temp == -1) {
+                    #pragma omp critical
+                    {
+                        // First finder wins; the others see the flag and unwind
+                        if (!solutionFound_.exchange(true)) {
+                            // std::cout << "[DEBUG] Rank " << rank_ << ", Thread " << tid 
+                            //           << ": *** SOLUTION FOUND *** Path length: " 
+                            //           << localPath.size() << std::endl;
+                            localSolution = localPath;
+                            localMin = -1;
+                        }
                     }
-                }
-            } else if (temp < localMin) {
-                #pragma omp critical
-                {
-                    if (temp < localMin) {
-                        localMin = temp;
-                        // std::cout << "[DEBUG] Rank " << rank_ << ", Thread " << tid 
-                        //           << ": Updated localMin to " << localMin << std::endl;
+                } else if (temp < localMin) {
+                    #pragma omp critical
+                    {
+                        if (temp < localMin) {
+                            localMin = temp;
+                            // std::cout << "[DEBUG] Rank " << rank_ << ", Thread " << tid 
+                            //           << ": Updated localMin to " << localMin << std::endl;
+                        }
                     }
                 }
             }
@@ -168,7 +171,7 @@ std::vector<std::string> HybridSolver::solve(RubiksCube& cube, int maxDepth) {
         // std::cout << "[DEBUG] Rank " << rank_ << ": Calling MPI_Allreduce..." << std::endl;
         
         int globalMin;
-        MPI_Allreduce(&localMin, &globalMin, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+        MPI_Allreduce(&localMin, &globalMin, 1, MPI_INT, MPI_MIN, comm_);
         
         // std::cout << "[DEBUG] Rank " << rank_ << ": MPI_Allreduce complete, globalMin=" 
         //           << globalMin << std::endl;
@@ -185,7 +188,7 @@ std::vector<std::string> HybridSolver::solve(RubiksCube& cube, int maxDepth) {
             }
             
             // std::cout << "[DEBUG] Rank " << rank_ << ": Finding rank with best solution..." << std::endl;
-            MPI_Allreduce(MPI_IN_PLACE, &rankWithBest, 1, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
+            MPI_Allreduce(MPI_IN_PLACE, &rankWithBest, 1, MPI_INT, MPI_MAX, comm_);
             
             // std::cout << "[DEBUG] Rank " << rank_ << ": Best solution is on rank " 
             //           << rankWithBest << std::endl;
@@ -196,42 +199,21 @@ std::vector<std::string> HybridSolver::solve(RubiksCube& cube, int maxDepth) {
                 //           << solution_.size() << std::endl;
             }
             
-            int solutionSize = solution_.size();
-            // std::cout << "[DEBUG] Rank " << rank_ << ": Broadcasting solution size..." << std::endl;
-            MPI_Bcast(&solutionSize, 1, MPI_INT, rankWithBest, MPI_COMM_WORLD);
-            // std::cout << "[DEBUG] Rank " << rank_ << ": Solution size = " << solutionSize << std::endl;
-            
-            if (rank_ != rankWithBest) {
-                solution_.resize(solutionSize);
-            }
-            
-            // std::cout << "[DEBUG] Rank " << rank_ << ": Broadcasting " << solutionSize 
-            //           << " moves..." << std::endl;
-            
-            for (size_t j = 0; j < solution_.size(); ++j) {
-                char moveStr[10] = {0};
-                if (rank_ == rankWithBest) {
-                    strncpy(moveStr, solution_[j].c_str(), sizeof(moveStr) - 1);
-                }
-                MPI_Bcast(moveStr, sizeof(moveStr), MPI_CHAR, rankWithBest, MPI_COMM_WORLD);
-                if (rank_ != rankWithBest) {
-                    solution_[j] = std::string(moveStr);
-                }
-            }
+            // Length and moves in one fixed-size message
+            broadcastSolution(solution_, rankWithBest, comm_);
             
             // std::cout << "[DEBUG] Rank " << rank_ << ": Solution broadcast complete" << std::endl;
             // break;
         }
         
-        auto currentTime = std::chrono::high_resolution_clock::now();
-        double elapsed = std::chrono::duration<double>(currentTime - startTime).count();
-        
-        // std::cout << "[DEBUG] Rank " << rank_ << ": Elapsed time: " << std::fixed 
-        //           << std::setprecision(2) << elapsed << "s / " << TIME_LIMIT << "s" << std::endl;
+        // Collective stop decision (see MPISolver::solve)
+        int localStop = deadlineExpired() ? 1 : 0;
+        int globalStop = 0;
+        MPI_Allreduce(&localStop, &globalStop, 1, MPI_INT, MPI_MAX, comm_);
         
-        if (elapsed > TIME_LIMIT) {
+        if (globalStop) {
             if (rank_ == 0) {
-                // std::cout << "[DEBUG] Time limit reached" << std::endl;
+                RUBIKS_LOG(DEBUG) << "Time limit reached";
             }
             break;
         }
@@ -250,90 +232,34 @@ std::vector<std::string> HybridSolver::solve(RubiksCube& cube, int maxDepth) {
     auto endTime = std::chrono::high_resolution_clock::now();
     solveTime_ = std::chrono::duration<double>(endTime - startTime).count();
     
-    // std::cout << "[DEBUG] Rank " << rank_ << ": Search complete in " << solveTime_ << "s" << std::endl;
+    // The last iteration is closed with this rank's own count, like the
+    // ones before it; then the counters of every thread on every rank are
+    // merged in one collective, so all ranks report the same totals
+    endIteration(localNodes());
+    SearchCounters local;
+    std::vector<uint64_t> threadNodes;
+    threadCounters_.forEach([&](const SearchCounters& counters) {
+        local.add(counters);
+        threadNodes.push_back(counters.nodes);
+    });
+    std::vector<uint64_t> workerNodes;
+    SearchCounters total = reduceCounters(local, threadNodes, workerNodes, comm_);
+    finishStats(total, !solution_.empty(), solution_.size(), std::move(workerNodes));
     
     if (rank_ == 0) {
-        std::cout << "\n=== Search Complete ===" << std::endl;
         if (!solution_.empty()) {
-            std::cout << "✓ Solution found!" << std::endl;
-            std::cout << "  Moves: " << solution_.size() << std::endl;
-            std::cout << "  Time: " << solveTime_ << "s" << std::endl;
-            std::cout << "  Processes: " << size_ << std::endl;
-            std::cout << "  Threads/Process: " << numThreads_ << std::endl;
-            std::cout << "  Total workers: " << (size_ * numThreads_) << std::endl;
+            RUBIKS_LOG(DEBUG) << "✓ Solution found: " << solution_.size() << " moves, " << total.nodes
+                              << " nodes, " << solveTime_ << "s, " << (size_ * numThreads_) << " workers";
         } else {
-            std::cout << "✗ No solution found" << std::endl;
-            std::cout << "  Time: " << solveTime_ << "s" << std::endl;
+            RUBIKS_LOG(DEBUG) << "✗ No solution found: " << total.nodes << " nodes, " << solveTime_ << "s";
         }
     }
     
-    return solution_;
+    return movesToStrings(solution_);
 }
 
-int HybridSolver::idaSearchHybrid(RubiksCube& cube, int g, int threshold,
-                                 const std::string& lastMove, std::vector<std::string>& path,
-                                 double timeLimit, std::chrono::high_resolution_clock::time_point startTime) {
-    #pragma omp atomic
-    nodesExplored_++;
-    
-    // Debug every 100000 nodes (thread-safe)
-    int currentNodes = nodesExplored_;
-    if (currentNodes % 100000 == 0) {
-        int tid = omp_get_thread_num();
-        #pragma omp critical
-        {
-            // std::cout << "[DEBUG] Rank " << rank_ << ", Thread " << tid 
-            //           << ": Explored " << currentNodes << " nodes at depth " << g << std::endl;
-        }
-    }
-    
-    if (solutionFound_) return std::numeric_limits<int>::max();
-    
-    int h = heuristic(cube);
-    int f = g + h;
-    
-    if (f > threshold) return f;
-    
-    if (cube.isSolved()) {
-        int tid = omp_get_thread_num();
-        #pragma omp critical
-        {
-            // std::cout << "[DEBUG] Rank " << rank_ << ", Thread " << tid 
-            //           << ": *** SOLVED at depth " << g << " (path length: " 
-            //           << path.size() << ") ***" << std::endl;
-        }
-        return -1;
-    }
-    
-    int min = std::numeric_limits<int>::max();
-    auto moves = RubiksCube::getBasicMoves();
-    
-    for (const auto& move : moves) {
-        if (solutionFound_) return std::numeric_limits<int>::max();
-        if (isRedundantMove(lastMove, move)) continue;
-        
-        cube.applyMove(move);
-        path.push_back(move);
-        
-        int temp = idaSearchHybrid(cube, g + 1, threshold, move, path, timeLimit, startTime);
-        
-        if (temp == -1) return -1;
-        if (temp < min) min = temp;
-        
-        path.pop_back();
-        cube.applyMove(cube.getInverseMove(move));
-    }
-    
-    return min;
+uint64_t HybridSolver::localNodes() const {
+    uint64_t nodes = 0;
+    threadCounters_.forEach([&](const SearchCounters& counters) { nodes += counters.nodes; });
+    return nodes;
 }
-
-bool HybridSolver::isRedundantMove(const std::string& lastMove, const std::string& nextMove) const {
-    if (lastMove.empty()) return false;
-    char lastFace = lastMove[0];
-    char nextFace = nextMove[0];
-    if (lastFace == nextFace) return true;
-    if ((lastFace == 'U' && nextFace == 'D') || (lastFace == 'D' && nextFace == 'U')) return true;
-    if ((lastFace == 'L' && nextFace == 'R') || (lastFace == 'R' && nextFace == 'L')) return true;
-    if ((lastFace == 'F' && nextFace == 'B') || (lastFace == 'B' && nextFace == 'F')) return true;
-    return false;
-}
\ No newline at end of file
@@ -0,0 +1,325 @@
+// src/json.cpp - Streaming JSON writer and one-pass request body scanner
+#include "json.hpp"
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cstdio>
+
+namespace {
+
+constexpr char HEX[] = "0123456789abcdef";
+
+// Recursive descent over one value; pos ends just past it. Only checks,
+// nothing is stored.
+class Scanner {
+public:
+    explicit Scanner(std::string_view text) : text_(text) {}
+
+    size_t pos = 0;
+
+    void skipSpace() {
+        while (pos < text_.size() &&
+               (text_[pos] == ' ' || text_[pos] == '\t' || text_[pos] == '\n' || text_[pos] == '\r')) {
+            ++pos;
+        }
+    }
+    bool atEnd() const { return pos >= text_.size(); }
+    char peek() const { return atEnd() ? '\0' : text_[pos]; }
+
+    bool string() {
+        if (peek() != '"') return false;
+        ++pos;
+        while (pos < text_.size()) {
+            unsigned char c = static_cast<unsigned char>(text_[pos++]);
+            if (c == '"') return true;
+            if (c < 0x20) return false;
+            if (c != '\\') continue;
+            if (atEnd()) return false;
+            char escape = text_[pos++];
+            if (escape == 'u') {
+                for (int i = 0; i < 4; ++i, ++pos) {
+                    if (atEnd() || !std::isxdigit(static_cast<unsigned char>(text_[pos]))) return false;
+                }
+            } else if (std::string_view("\"\\/bfnrt").find(escape) == std::string_view::npos) {
+                return false;
+            }
+        }
+        return false;
+    }
+
+    bool value(int depth) {
+        if (depth > MAX_DEPTH) return false;
+        switch (peek()) {
+            case '"': return string();
+            case '{': return container('}', depth);
+            case '[': return container(']', depth);
+            case 't': return literal("true");
+            case 'f': return literal("false");
+            case 'n': return literal("null");
+            default: return number();
+        }
+    }
+
+private:
+    static constexpr int MAX_DEPTH = 64;
+
+    bool container(char close, int depth) {
+        ++pos;
+        skipSpace();
+        if (peek() == close) {
+            ++pos;
+            return true;
+        }
+        while (true) {
+            if (close == '}') {
+                if (!string()) return false;
+                skipSpace();
+                if (peek() != ':') return false;
+                ++pos;
+                skipSpace();
+            }
+            if (!value(depth + 1)) return false;
+            skipSpace();
+            if (peek() == ',') {
+                ++pos;
+                skipSpace();
+                continue;
+            }
+            if (peek() != close) return false;
+            ++pos;
+            return true;
+        }
+    }
+
+    bool literal(std::string_view word) {
+        if (text_.compare(pos, word.size(), word) != 0) return false;
+        pos += word.size();
+        return true;
+    }
+
+    bool digits() {
+        size_t start = pos;
+        while (pos < text_.size() && text_[pos] >= '0' && text_[pos] <= '9') ++pos;
+        return pos > start;
+    }
+
+    bool number() {
+        if (peek() == '-') ++pos;
+        if (!digits()) return false;
+        if (peek() == '.') {
+            ++pos;
+            if (!digits()) return false;
+        }
+        if (peek() == 'e' || peek() == 'E') {
+            ++pos;
+            if (peek() == '+' || peek() == '-') ++pos;
+            if (!digits()) return false;
+        }
+        return true;
+    }
+
+    std::string_view text_;
+};
+
+void appendUtf8(std::string& out, uint32_t code) {
+    if (code < 0x80) {
+        out += static_cast<char>(code);
+    } else if (code < 0x800) {
+        out += static_cast<char>(0xC0 | (code >> 6));
+        out += static_cast<char>(0x80 | (code & 0x3F));
+    } else if (code < 0x10000) {
+        out += static_cast<char>(0xE0 | (code >> 12));
+        out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (code & 0x3F));
+    } else {
+        out += static_cast<char>(0xF0 | (code >> 18));
+        out += static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+        out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (code & 0x3F));
+    }
+}
+
+uint32_t hex4(std::string_view text, size_t pos) {
+    uint32_t code = 0;
+    for (size_t i = pos; i < pos + 4 && i < text.size(); ++i) {
+        char c = text[i];
+        code = code * 16 + static_cast<uint32_t>(c <= '9' ? c - '0' : (c | 0x20) - 'a' + 10);
+    }
+    return code;
+}
+
+} // namespace
+
+void JSONWriter::appendString(std::string& out, std::string_view text) {
+    out += '"';
+    size_t plain = 0;  // start of the run not yet copied
+    for (size_t i = 0; i < text.size(); ++i) {
+        unsigned char c = static_cast<unsigned char>(text[i]);
+        if (c >= 0x20 && c != '"' && c != '\\') continue;
+        out.append(text.data() + plain, i - plain);
+        plain = i + 1;
+        switch (c) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                out += "\\u00";
+                out += HEX[c >> 4];
+                out += HEX[c & 0xF];
+        }
+    }
+    out.append(text.data() + plain, text.size() - plain);
+    out += '"';
+}
+
+void JSONWriter::appendInteger(int64_t number) {
+    char digits[24];
+    auto result = std::to_chars(digits, digits + sizeof(digits), number);
+    out_.append(digits, result.ptr);
+}
+
+void JSONWriter::appendInteger(uint64_t number) {
+    char digits[24];
+    auto result = std::to_chars(digits, digits + sizeof(digits), number);
+    out_.append(digits, result.ptr);
+}
+
+JSONWriter& JSONWriter::value(double number, int decimals) {
+    separate();
+    // JSON has no infinities or NaN
+    if (!(number == number) || number > 1e300 || number < -1e300) {
+        out_ += "null";
+        return *this;
+    }
+    char digits[348];
+    int length = std::snprintf(digits, sizeof(digits), "%.*f", decimals, number);
+    if (length > 0) out_.append(digits, std::min<size_t>(static_cast<size_t>(length), sizeof(digits) - 1));
+    return *this;
+}
+
+JSONBody::JSONBody(std::string_view text) : text_(text) {
+    Scanner scan(text);
+    scan.skipSpace();
+    if (scan.atEnd()) {
+        valid_ = true;
+        return;
+    }
+    if (scan.peek() != '{') return;
+    ++scan.pos;
+    scan.skipSpace();
+    if (scan.peek() == '}') {
+        ++scan.pos;
+    } else {
+        while (true) {
+            size_t keyStart = scan.pos;
+            if (!scan.string()) return;
+            std::string_view key = text.substr(keyStart + 1, scan.pos - keyStart - 2);
+            scan.skipSpace();
+            if (scan.peek() != ':') return;
+            ++scan.pos;
+            scan.skipSpace();
+            size_t valueStart = scan.pos;
+            if (!scan.value(1)) return;
+            if (count_ == MAX_MEMBERS) return;
+            members_[count_++] = Member{key, text.substr(valueStart, scan.pos - valueStart)};
+            scan.skipSpace();
+            if (scan.peek() == ',') {
+                ++scan.pos;
+                scan.skipSpace();
+                continue;
+            }
+            if (scan.peek() != '}') return;
+            ++scan.pos;
+            break;
+        }
+    }
+    scan.skipSpace();
+    valid_ = scan.atEnd();
+}
+
+const JSONBody::Member* JSONBody::find(std::string_view key) const {
+    if (!valid_) return nullptr;
+    for (size_t i = 0; i < count_; ++i) {
+        if (members_[i].key == key) return &members_[i];
+    }
+    return nullptr;
+}
+
+std::string_view JSONBody::raw(std::string_view key) const {
+    const Member* member = find(key);
+    return member ? member->value : std::string_view();
+}
+
+std::string JSONBody::value(std::string_view key) const {
+    std::string_view text = raw(key);
+    if (!text.empty() && text.front() == '"') return unescape(text);
+    return std::string(text);
+}
+
+std::vector<std::string> JSONBody::strings(std::string_view key) const {
+    std::vector<std::string> values;
+    std::string_view text = raw(key);
+    if (text.empty() || text.front() != '[') return values;
+
+    // Already checked, so only strings and nesting need tracking
+    Scanner scan(text);
+    scan.pos = 1;
+    int depth = 0;
+    while (!scan.atEnd()) {
+        char c = scan.peek();
+        if (c == '"') {
+            size_t start = scan.pos;
+            scan.string();
+            if (depth == 0) values.push_back(unescape(text.substr(start, scan.pos - start)));
+            continue;
+        }
+        if (c == '[' || c == '{') ++depth;
+        if (c == ']' || c == '}') {
+            if (depth-- == 0) break;
+        }
+        ++scan.pos;
+    }
+    return values;
+}
+
+std::string JSONBody::unescape(std::string_view literal) {
+    std::string out;
+    if (literal.size() < 2) return out;
+    std::string_view text = literal.substr(1, literal.size() - 2);
+    if (text.find('\\') == std::string_view::npos) return std::string(text);
+
+    out.reserve(text.size());
+    for (size_t i = 0; i < text.size(); ++i) {
+        if (text[i] != '\\' || i + 1 >= text.size()) {
+            out += text[i];
+            continue;
+        }
+        char escape = text[++i];
+        switch (escape) {
+            case 'b': out += '\b'; break;
+            case 'f': out += '\f'; break;
+            case 'n': out += '\n'; break;
+            case 'r': out += '\r'; break;
+            case 't': out += '\t'; break;
+            case 'u': {
+                uint32_t code = hex4(text, i + 1);
+                i += 4;
+                // A surrogate pair is one code point
+                if (code >= 0xD800 && code < 0xDC00 && i + 6 < text.size() &&
+                    text[i + 1] == '\\' && text[i + 2] == 'u') {
+                    uint32_t low = hex4(text, i + 3);
+                    if (low >= 0xDC00 && low < 0xE000) {
+                        code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                        i += 6;
+                    }
+                }
+                appendUtf8(out, code);
+                break;
+            }
+            default: out += escape;  // " \ /
+        }
+    }
+    return out;
+}
@@ -0,0 +1,49 @@
+// src/logging.cpp - Leveled console logging
+#include "logging.hpp"
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+
+namespace {
+
+int initialLevel() {
+    LogLevel level = LogLevel::INFO;
+    const char* env = std::getenv("RUBIKS_LOG_LEVEL");
+    if (env) parseLogLevel(env, level);
+    return static_cast<int>(level);
+}
+
+std::mutex outputMutex;
+
+} // namespace
+
+namespace logging_detail {
+std::atomic<int> currentLevel{initialLevel()};
+}
+
+void setLogLevel(LogLevel level) {
+    logging_detail::currentLevel.store(static_cast<int>(level), std::memory_order_relaxed);
+}
+
+LogLevel getLogLevel() {
+    return static_cast<LogLevel>(logging_detail::currentLevel.load(std::memory_order_relaxed));
+}
+
+bool parseLogLevel(const std::string& name, LogLevel& level) {
+    if (name == "error") level = LogLevel::ERROR;
+    else if (name == "warning") level = LogLevel::WARNING;
+    else if (name == "info") level = LogLevel::INFO;
+    else if (name == "debug") level = LogLevel::DEBUG;
+    else return false;
+    return true;
+}
+
+// DEBUG lines, the only ones logged from inside a search, are left to the
+// stream buffer; the others are flushed so a server's log stays current
+LogLine::~LogLine() {
+    out_ << '\n';
+    std::ostream& stream = level_ <= LogLevel::WARNING ? std::cerr : std::cout;
+    std::lock_guard<std::mutex> lock(outputMutex);
+    stream << out_.str();
+    if (level_ != LogLevel::DEBUG) stream.flush();
+}
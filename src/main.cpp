@@ -2,27 +2,318 @@
 #include "http_server.hpp"
 #include "rubiks_cube.hpp"
 #include "sequential_solver.hpp"
+#include "bidirectional_solver.hpp"
+#include "two_phase_solver.hpp"
+#include "heuristic.hpp"
+#include "pattern_database.hpp"
+#include "frontier_table.hpp"
+#include "cubie_cube.hpp"
+#include "logging.hpp"
+#include "thread_placement.hpp"
+#ifdef HAVE_OPENMP
+#include "openmp_solver.hpp"
+#endif
 #ifdef HAVE_MPI
 #include "mpi_solver.hpp"
-#include "hybrid_solver.hpp"
+#include "mpi_scheduler.hpp"
+#include "mpi_protocol.hpp"
 #include <mpi.h>
 #endif
 #include <iostream>
+#include <fstream>
 #include <csignal>
 #include <memory>
 #include <unistd.h>
 #include <iomanip>
+#include <cstdlib>
+#include <cstring>
+#include <cstdio>
+#include <chrono>
+#include <vector>
 
 std::unique_ptr<HTTPServer> server;
 
+namespace {
+
+// rubiks_solver --batch FILE|- solves a file of positions instead of serving
+struct BatchOptions {
+    std::string input;            // "-" reads stdin
+    std::string output;           // empty writes stdout
+    std::string solver = "twophase";
+    int maxDepth = 22;
+    double timeLimit = 10.0;      // per position
+    int threads = 0;              // per rank; 0 = one per CPU of the rank
+    Metric metric = Metric::QUARTER_TURN;
+    size_t tableMegabytes = 0;    // transposition table shared by the threads
+};
+
+// Positions are read, solved and written this many at a time
+constexpr size_t BATCH_BLOCK = 16384;
+
+// One facelet string per line (anything after the first word is ignored,
+// so rubiks_corpusgen text output reads as is; blank and # lines are
+// skipped), or a rubiks_corpusgen binary file, recognised by its magic
+class BatchReader {
+public:
+    explicit BatchReader(std::istream& in) : in_(in) {
+        char magic[8] = {};
+        in_.read(magic, sizeof(magic));
+        if (in_.gcount() == sizeof(magic) && std::memcmp(magic, "RCSTATE", 8) == 0) {
+            uint32_t version = 0, recordSize = 0;
+            in_.read(reinterpret_cast<char*>(&version), sizeof(version));
+            in_.read(reinterpret_cast<char*>(&recordSize), sizeof(recordSize));
+            in_.read(reinterpret_cast<char*>(&remaining_), sizeof(remaining_));
+            if (!in_ || version != 1 || recordSize != sizeof(CubieCube)) {
+                throw std::runtime_error("Unsupported binary state file");
+            }
+            binary_ = true;
+        } else {
+            // Not binary: the bytes read belong to the first line
+            prefix_.assign(magic, static_cast<size_t>(in_.gcount()));
+            in_.clear();
+        }
+    }
+
+    // Appends up to max positions; labels are what the output lines echo
+    size_t next(std::vector<std::string>& labels, std::vector<RubiksCube>& cubes,
+                std::vector<std::string>& errors, size_t max) {
+        labels.clear();
+        cubes.clear();
+        errors.clear();
+        while (cubes.size() < max) {
+            if (binary_) {
+                CubieCube cube;
+                if (remaining_ == 0 || !in_.read(reinterpret_cast<char*>(&cube), sizeof(cube))) break;
+                --remaining_;
+                // Out-of-range bytes have no facelet form to echo
+                if (!cube.isValid()) {
+                    cubes.emplace_back();
+                    labels.emplace_back(54, '?');
+                    errors.emplace_back("Invalid cube record");
+                    continue;
+                }
+                cubes.push_back(cube.toFacelets());
+                labels.push_back(cube.toString());
+                errors.emplace_back();
+                continue;
+            }
+
+            std::string line;
+            if (!std::getline(in_, line)) {
+                if (prefix_.empty()) break;
+                line.clear();
+            }
+            line = prefix_ + line;
+            prefix_.clear();
+            size_t begin = line.find_first_not_of(" \t\r");
+            if (begin == std::string::npos || line[begin] == '#') continue;
+            size_t end = line.find_first_of(" \t\r", begin);
+            labels.push_back(line.substr(begin, end == std::string::npos ? end : end - begin));
+
+            cubes.emplace_back();
+            errors.emplace_back();
+            try {
+                if (labels.back().size() != 54) throw std::invalid_argument("Expected a 54-character state");
+                cubes.back().fromString(labels.back());
+                CubieCube::fromFacelets(cubes.back());
+            } catch (const std::exception& e) {
+                errors.back() = e.what();
+                cubes.back().reset();
+            }
+        }
+        return cubes.size();
+    }
+
+private:
+    std::istream& in_;
+    bool binary_ = false;
+    uint64_t remaining_ = 0;
+    std::string prefix_;
+};
+
+// "<state> <length> <moves...>", or "<state> - <reason>" when unsolved
+void writeBatchLine(FILE* out, const std::string& label, bool success,
+                    const std::vector<std::string>& solution, const std::string& error) {
+    std::string line = label;
+    if (success) {
+        line += ' ';
+        line += std::to_string(solution.size());
+        for (const auto& move : solution) {
+            line += ' ';
+            line += move;
+        }
+    } else {
+        line += " - ";
+        line += error.empty() ? "unsolved" : error;
+    }
+    line += '\n';
+    std::fwrite(line.data(), 1, line.size(), out);
+}
+
+std::unique_ptr<Solver> createBatchSolver(const std::string& type) {
+    if (type == "sequential") return std::make_unique<SequentialSolver>();
+    if (type == "twophase") return std::make_unique<TwoPhaseSolver>();
+    if (type == "bidirectional") return std::make_unique<BidirectionalSolver>();
+#ifdef HAVE_OPENMP
+    if (type == "openmp") return std::make_unique<OpenMPSolver>();
+#endif
+    return nullptr;
+}
+
+// Every rank runs this. Rank 0 reads a block and, under MPI, broadcasts it;
+// rank r solves positions r, r + size, ... of each block on its threads and
+// the results are gathered back to rank 0, which writes them in input order.
+// Without MPI each result is written as soon as the ones before it are.
+int runBatch(const BatchOptions& options, int rank, int size) {
+    std::unique_ptr<Solver> solver = createBatchSolver(options.solver);
+    if (!solver) {
+        if (rank == 0) std::cerr << "Unknown batch solver: " << options.solver << std::endl;
+        return 1;
+    }
+    // Set up once: the clones share the heuristic and the two-phase tables
+    solver->setHeuristic(createHeuristic(getDefaultPatternDatabase() ? "pdb" : "manhattan"));
+    solver->setMetric(options.metric);
+    if (options.tableMegabytes > 0) {
+        solver->setTranspositionTable(std::make_shared<TranspositionTable>(options.tableMegabytes << 20));
+    }
+    solver->setTimeLimit(options.timeLimit);
+    if (options.solver == "twophase") TwoPhaseSolver::initTables();
+
+    // On rank 0 a missing reader ends the batch at the first block, which
+    // still lets the other ranks leave the loop
+    bool failed = false;
+    std::ifstream file;
+    std::unique_ptr<BatchReader> reader;
+    FILE* out = stdout;
+    if (rank == 0) {
+        if (options.input != "-") file.open(options.input, std::ios::binary);
+        if (options.input != "-" && !file) {
+            std::cerr << "Cannot open " << options.input << std::endl;
+            failed = true;
+        } else {
+            try {
+                reader = std::make_unique<BatchReader>(options.input == "-" ? std::cin : file);
+            } catch (const std::exception& e) {
+                std::cerr << e.what() << std::endl;
+                failed = true;
+            }
+        }
+        if (!failed && !options.output.empty()) {
+            out = std::fopen(options.output.c_str(), "w");
+            if (!out) {
+                std::cerr << "Cannot open " << options.output << ": " << std::strerror(errno) << std::endl;
+                out = stdout;
+                failed = true;
+            }
+        }
+    }
+
+    std::vector<std::string> labels;
+    std::vector<RubiksCube> cubes;
+    std::vector<std::string> errors;
+    uint64_t total = 0;
+    uint64_t solved = 0;
+    auto start = std::chrono::steady_clock::now();
+
+    while (true) {
+        uint64_t count = 0;
+        if (rank == 0 && !failed) count = reader->next(labels, cubes, errors, BATCH_BLOCK);
+
+#ifdef HAVE_MPI
+        if (size > 1) {
+            // Malformed positions travel as solved cubes; rank 0 keeps the error
+            MPI_Bcast(&count, 1, MPI_UINT64_T, 0, MPI_COMM_WORLD);
+            if (count == 0) break;
+            std::vector<CubieCube> block(count);
+            if (rank == 0) {
+                for (uint64_t i = 0; i < count; ++i) block[i] = CubieCube(cubes[i]);
+            }
+            MPI_Bcast(block.data(), static_cast<int>(count * sizeof(CubieCube)), MPI_BYTE, 0, MPI_COMM_WORLD);
+
+            std::vector<RubiksCube> stripe;
+            for (uint64_t i = rank; i < count; i += size) stripe.push_back(block[i].toFacelets());
+            std::vector<PackedBatchResult> packed(stripe.size());
+            solver->solveBatch(stripe, [&](const BatchResult& result) {
+                PackedBatchResult& entry = packed[result.index];
+                entry.nodes = result.nodes;
+                entry.time = result.time;
+                entry.solution.length = PackedBatchResult::UNSOLVED;
+                if (!result.success || result.solution.size() > static_cast<size_t>(PackedSolution::MAX_MOVES)) return;
+                entry.solution.length = static_cast<uint8_t>(result.solution.size());
+                for (size_t j = 0; j < result.solution.size(); ++j) {
+                    entry.solution.moves[j] = static_cast<uint8_t>(moveFromString(result.solution[j]));
+                }
+            }, options.maxDepth, options.threads);
+
+            // Rank r holds positions r, r + size, ...; its stripe has
+            // ceil((count - r) / size) of them
+            std::vector<int> bytes(size), offsets(size);
+            for (int r = 0, offset = 0; r < size; ++r) {
+                uint64_t stripeSize = static_cast<uint64_t>(r) < count ? (count - r + size - 1) / size : 0;
+                bytes[r] = static_cast<int>(stripeSize * sizeof(PackedBatchResult));
+                offsets[r] = offset;
+                offset += bytes[r];
+            }
+            std::vector<PackedBatchResult> gathered(rank == 0 ? count : 0);
+            MPI_Gatherv(packed.data(), static_cast<int>(packed.size() * sizeof(PackedBatchResult)), MPI_BYTE,
+                        gathered.data(), bytes.data(), offsets.data(), MPI_BYTE, 0, MPI_COMM_WORLD);
+
+            if (rank == 0) {
+                for (uint64_t i = 0; i < count; ++i) {
+                    int r = static_cast<int>(i % size);
+                    const PackedBatchResult& entry =
+                        gathered[offsets[r] / sizeof(PackedBatchResult) + i / size];
+                    bool success = entry.solution.length != PackedBatchResult::UNSOLVED && errors[i].empty();
+                    std::vector<std::string> solution;
+                    for (int j = 0; success && j < entry.solution.length; ++j) {
+                        solution.emplace_back(moveToString(static_cast<Move>(entry.solution.moves[j])));
+                    }
+                    if (success) ++solved;
+                    writeBatchLine(out, labels[i], success, solution, errors[i]);
+                }
+            }
+            total += count;
+            if (rank == 0) std::cerr << "  " << total << " positions" << std::endl;
+            continue;
+        }
+#endif
+
+        if (count == 0) break;
+        solver->solveBatch(cubes, [&](const BatchResult& result) {
+            const std::string& error = errors[result.index].empty() ? result.error : errors[result.index];
+            bool success = result.success && error.empty();
+            if (success) ++solved;
+            writeBatchLine(out, labels[result.index], success, result.solution, error);
+        }, options.maxDepth, options.threads);
+        total += count;
+        std::fflush(out);
+        std::cerr << "  " << total << " positions" << std::endl;
+    }
+
+    if (rank != 0) return 0;
+    bool writeFailed = std::fflush(out) != 0;
+    if (out != stdout) writeFailed = std::fclose(out) != 0 || writeFailed;
+    if (writeFailed) {
+        std::cerr << "Write failed: " << std::strerror(errno) << std::endl;
+        return 1;
+    }
+
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cerr << "Solved " << solved << " of " << total << " positions in " << std::fixed
+              << std::setprecision(3) << elapsed << "s (" << std::setprecision(1)
+              << total / std::max(elapsed, 1e-9) << " positions/s, " << size << " rank(s))" << std::endl;
+    return failed ? 1 : 0;
+}
+
+} // namespace
+
+// Only stops the accept loop; main then shuts the workers down and
+// finalizes MPI on the normal exit path
 void signalHandler(int signal) {
     if (signal == SIGINT || signal == SIGTERM) {
-        std::cout << "\nShutting down server..." << std::endl;
         if (server) {
             server->stop();
         }
-        // DO NOT finalize MPI here. Let main finalize when exiting.
-        exit(0);
     }
 }
 
@@ -34,19 +325,123 @@ int main(int argc, char* argv[]) {
     MPISolver::Initialize(&argc, &argv);
     MPI_Comm_rank(MPI_COMM_WORLD, &rank);
     MPI_Comm_size(MPI_COMM_WORLD, &size);
-
-    if (rank == 0) {
-        std::cout << "MPI initialized successfully" << std::endl;
-    }
 #endif
 
     signal(SIGINT, signalHandler);
     signal(SIGTERM, signalHandler);
 
+    // Usage: rubiks_solver [port] [--pdb file] [--cache file] [--log-level error|warning|info|debug]
+    //                      [--frontier file] [--frontier-mb n] [--mpi-group-size n]
+    //                      [--bind close|spread|none] [--binary-port n] [--near-solved n]
+    //        rubiks_solver --batch file|- [--output file]
+    //                      [--solver twophase|sequential|bidirectional|openmp]
+    //                      [--max-depth n] [--time-limit s] [--threads n] [--metric qtm|htm]
+    //                      [--tt-mb n] [--pdb file] [--frontier file] [--frontier-mb n]
     int port = 8080;
-    if (argc > 1) {
+    int binaryPort = 0;  // binary solve protocol, off unless given
+    int nearSolvedDepth = 0;  // answer from the frontier table up to this depth
+    bool batch = false;
+    BatchOptions batchOptions;
+    std::string pdbPath;
+    const char* pdbEnv = std::getenv("RUBIKS_PDB");
+    if (pdbEnv) {
+        pdbPath = pdbEnv;
+    }
+    std::string frontierPath;
+    std::string cachePath;
+    int mpiGroupSize = 1;  // smallest group the scheduler splits the workers into
+    ThreadBinding binding = ThreadBinding::CLOSE;
+    const char* cacheEnv = std::getenv("RUBIKS_CACHE");
+    if (cacheEnv) {
+        cachePath = cacheEnv;
+    }
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--pdb") == 0 && i + 1 < argc) {
+            pdbPath = argv[++i];
+            continue;
+        }
+        if (std::strcmp(argv[i], "--frontier") == 0 && i + 1 < argc) {
+            frontierPath = argv[++i];
+            continue;
+        }
+        if (std::strcmp(argv[i], "--cache") == 0 && i + 1 < argc) {
+            cachePath = argv[++i];
+            continue;
+        }
+        if (std::strcmp(argv[i], "--batch") == 0 && i + 1 < argc) {
+            batch = true;
+            batchOptions.input = argv[++i];
+            continue;
+        }
+        if (std::strcmp(argv[i], "--output") == 0 && i + 1 < argc) {
+            batchOptions.output = argv[++i];
+            continue;
+        }
+        if (std::strcmp(argv[i], "--solver") == 0 && i + 1 < argc) {
+            batchOptions.solver = argv[++i];
+            continue;
+        }
+        if (std::strcmp(argv[i], "--log-level") == 0 && i + 1 < argc) {
+            LogLevel level;
+            if (!parseLogLevel(argv[++i], level)) {
+                if (rank == 0) std::cerr << "Unknown log level: " << argv[i] << std::endl;
+                return 1; // Do NOT finalize here
+            }
+            setLogLevel(level);
+            continue;
+        }
+        if (std::strcmp(argv[i], "--metric") == 0 && i + 1 < argc) {
+            if (!parseMetric(argv[++i], batchOptions.metric)) {
+                if (rank == 0) std::cerr << "Unknown metric: " << argv[i] << std::endl;
+                return 1; // Do NOT finalize here
+            }
+            continue;
+        }
+        try {
+            if (std::strcmp(argv[i], "--max-depth") == 0 && i + 1 < argc) {
+                batchOptions.maxDepth = std::stoi(argv[++i]);
+                continue;
+            }
+            if (std::strcmp(argv[i], "--time-limit") == 0 && i + 1 < argc) {
+                batchOptions.timeLimit = std::stod(argv[++i]);
+                continue;
+            }
+            if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+                batchOptions.threads = std::stoi(argv[++i]);
+                continue;
+            }
+            if (std::strcmp(argv[i], "--tt-mb") == 0 && i + 1 < argc) {
+                batchOptions.tableMegabytes = std::stoull(argv[++i]);
+                continue;
+            }
+            if (std::strcmp(argv[i], "--frontier-mb") == 0 && i + 1 < argc) {
+                setFrontierTableBytes(std::stoull(argv[++i]) << 20);
+                continue;
+            }
+            if (std::strcmp(argv[i], "--mpi-group-size") == 0 && i + 1 < argc) {
+                mpiGroupSize = std::stoi(argv[++i]);
+                continue;
+            }
+            if (std::strcmp(argv[i], "--bind") == 0 && i + 1 < argc) {
+                binding = parseThreadBinding(argv[++i]);
+                continue;
+            }
+            if (std::strcmp(argv[i], "--binary-port") == 0 && i + 1 < argc) {
+                binaryPort = std::stoi(argv[++i]);
+                continue;
+            }
+            if (std::strcmp(argv[i], "--near-solved") == 0 && i + 1 < argc) {
+                nearSolvedDepth = std::stoi(argv[++i]);
+                continue;
+            }
+        } catch (...) {
+            if (rank == 0) {
+                std::cerr << "Invalid value for " << argv[i - 1] << std::endl;
+            }
+            return 1; // Do NOT finalize here
+        }
         try {
-            port = std::stoi(argv[1]);
+            port = std::stoi(argv[i]);
         } catch (...) {
             if (rank == 0) {
                 std::cerr << "Invalid port number" << std::endl;
@@ -55,57 +450,120 @@ int main(int argc, char* argv[]) {
         }
     }
 
-    // Only rank 0 runs HTTP server
-    if (rank == 0) {
-        std::cout << "==================================" << std::endl;
-        std::cout << "Rubik's Cube Solver Backend" << std::endl;
+    // In batch mode stdout carries only results; log lines are dropped
+    if (batch) {
+        std::cout.setstate(std::ios::badbit);
+    }
+
+    // Before any search thread exists: ranks sharing a node split its
+    // cores, and each says where its threads will run
+    int localRank = 0;
+    int localRanks = 1;
 #ifdef HAVE_MPI
-        std::cout << "(MPI mode: " << size << " processes)" << std::endl;
+    nodeLocalRank(localRank, localRanks);
 #endif
-        std::cout << "==================================\n" << std::endl;
+    ThreadPlacement::get().configure(localRank, localRanks, binding);
+    RUBIKS_LOG(INFO) << "Rank " << rank << " placement: " << ThreadPlacement::get().describe();
 
-        RubiksCube testCube;
-        std::cout << "Created solved cube: " << (testCube.isSolved() ? "✓" : "✗") << std::endl;
-        testCube.scramble(5);
-        std::cout << "Scrambled cube: " << (!testCube.isSolved() ? "✓" : "✗") << std::endl;
+    // Every rank maps the same file; the kernel shares the pages read-only
+    if (!pdbPath.empty()) {
+        try {
+            auto db = PatternDatabase::load(pdbPath);
+            setDefaultPatternDatabase(db);
+            if (rank == 0) {
+                RUBIKS_LOG(INFO) << "Loaded pattern database " << pdbPath << " ("
+                                 << db->getTables().size() << " tables, "
+                                 << (db->getByteCount() >> 20) << " MB)";
+            }
+        } catch (const std::exception& e) {
+            if (rank == 0) {
+                RUBIKS_LOG(WARNING) << "Failed to load pattern database: " << e.what()
+                                    << " (using manhattan heuristic)";
+            }
+        }
+    }
 
-        server = std::make_unique<HTTPServer>(port);
-        server->start(); // blocking
+    // A saved frontier table replaces the one the bidirectional solver
+    // would build for its metric on first use
+    if (!frontierPath.empty()) {
+        try {
+            auto table = FrontierTable::load(frontierPath);
+            setDefaultFrontierTable(table);
+            if (rank == 0) {
+                RUBIKS_LOG(INFO) << "Loaded frontier table " << frontierPath << " ("
+                                 << metricName(table->getMetric()) << ", depth " << table->getDepth()
+                                 << ", " << table->size() << " positions)";
+            }
+        } catch (const std::exception& e) {
+            if (rank == 0) {
+                RUBIKS_LOG(WARNING) << "Failed to load frontier table: " << e.what()
+                                    << " (building it on first use)";
+            }
+        }
     }
-#ifdef HAVE_MPI
-    else {
-        std::cout << "Worker rank " << rank << " waiting for solve commands..." << std::endl;
 
-        while (true) {
-            int solveCommand = 0;
-            MPI_Bcast(&solveCommand, 1, MPI_INT, 0, MPI_COMM_WORLD);
+    // Batch mode: every rank solves its share, nothing is served
+    if (batch) {
+        int status = runBatch(batchOptions, rank, size);
+#ifdef HAVE_MPI
+        MPISolver::Finalize();
+#endif
+        return status;
+    }
 
-            if (solveCommand == 0) {
-                usleep(100000);
-                continue;
-            }
+#ifdef HAVE_MPI
+    if (rank == 0) {
+        RUBIKS_LOG(INFO) << "MPI initialized successfully";
+    }
+#endif
 
-            int maxDepth;
-            MPI_Bcast(&maxDepth, 1, MPI_INT, 0, MPI_COMM_WORLD);
+    // Only rank 0 runs HTTP server
+    if (rank == 0) {
+        RUBIKS_LOG(INFO) << "==================================";
+        RUBIKS_LOG(INFO) << "Rubik's Cube Solver Backend";
+#ifdef HAVE_MPI
+        RUBIKS_LOG(INFO) << "(MPI mode: " << size << " processes)";
+#endif
+        RUBIKS_LOG(INFO) << "==================================";
 
-            int stateLength;
-            MPI_Bcast(&stateLength, 1, MPI_INT, 0, MPI_COMM_WORLD);
+        RubiksCube testCube;
+        RUBIKS_LOG(DEBUG) << "Created solved cube: " << (testCube.isSolved() ? "✓" : "✗");
+        testCube.scramble(5);
+        RUBIKS_LOG(DEBUG) << "Scrambled cube: " << (!testCube.isSolved() ? "✓" : "✗");
 
-            char* buffer = new char[stateLength + 1];
-            MPI_Bcast(buffer, stateLength + 1, MPI_CHAR, 0, MPI_COMM_WORLD);
-            RubiksCube cube{ std::string(buffer) };
-            delete[] buffer;
+        // Build the two-phase coordinate tables before the first request
+        TwoPhaseSolver::initTables();
 
-            if (solveCommand == 1) {
-                MPISolver solver;
-                solver.solve(cube, maxDepth);
-            } 
-            if (solveCommand == 2) {
-                HybridSolver solver(2);
-                solver.solve(cube, maxDepth);
-                continue;
-            }
+        server = std::make_unique<HTTPServer>(port);
+        server->setBinaryPort(binaryPort);
+        server->setNearSolvedDepth(nearSolvedDepth);
+        if (!cachePath.empty()) {
+            server->setCacheFile(cachePath);
         }
+#ifdef HAVE_MPI
+        // Collective with runMPIWorker() on the other ranks
+        std::shared_ptr<MPIScheduler> scheduler;
+        if (size > 1) {
+            scheduler = std::make_shared<MPIScheduler>(mpiGroupSize);
+            server->setMPIScheduler(scheduler);
+            RUBIKS_LOG(INFO) << "MPI workers: " << (size - 1) << " rank(s), groups of at least "
+                             << std::min(std::max(mpiGroupSize, 1), size - 1);
+        }
+#else
+        (void)mpiGroupSize;
+#endif
+        server->start(); // blocking, returns after stop()
+
+#ifdef HAVE_MPI
+        // Release the workers so every rank reaches MPI_Finalize
+        if (scheduler) scheduler->shutdown();
+#endif
+    }
+#ifdef HAVE_MPI
+    else {
+        RUBIKS_LOG(INFO) << "Worker rank " << rank << " waiting for solve commands...";
+        runMPIWorker();
+        RUBIKS_LOG(INFO) << "Worker rank " << rank << " shutting down";
     }
 #endif
 
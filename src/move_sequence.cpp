@@ -0,0 +1,64 @@
+// src/move_sequence.cpp - Canonical move-sequence automaton
+#include "move_sequence.hpp"
+
+namespace {
+
+// Per-face state offsets, see NUM_STATES
+constexpr int CLOCKWISE = 0;
+constexpr int COUNTER_CLOCKWISE = 1;
+constexpr int TWICE_CLOCKWISE = 2;
+
+constexpr MoveSequenceAutomaton::State faceState(int face, int turns) {
+    return static_cast<MoveSequenceAutomaton::State>(1 + face * 3 + turns);
+}
+
+} // namespace
+
+MoveSequenceAutomaton::MoveSequenceAutomaton(Metric metric) : metric_(metric) {
+    for (Move move : ALL_MOVES) {
+        if (metric_ == Metric::HALF_TURN || moveIndex(move) % 3 != 2) moves_.push_back(move);
+    }
+    for (int state = 0; state < NUM_STATES; ++state) {
+        allowed_[state] = 0;
+        next_[state].fill(REJECT);
+        for (Move move : moves_) {
+            State to = transition(static_cast<State>(state), move);
+            next_[state][moveIndex(move)] = to;
+            if (to != REJECT) allowed_[state] |= 1u << moveIndex(move);
+        }
+    }
+}
+
+const MoveSequenceAutomaton& MoveSequenceAutomaton::get(Metric metric) {
+    static const MoveSequenceAutomaton quarterTurn(Metric::QUARTER_TURN);
+    static const MoveSequenceAutomaton halfTurn(Metric::HALF_TURN);
+    return metric == Metric::HALF_TURN ? halfTurn : quarterTurn;
+}
+
+MoveSequenceAutomaton::State MoveSequenceAutomaton::run(const std::vector<Move>& moves,
+                                                        State state) const {
+    for (Move move : moves) {
+        if (state == REJECT) break;
+        state = next(state, move);
+    }
+    return state;
+}
+
+MoveSequenceAutomaton::State MoveSequenceAutomaton::transition(State state, Move move) const {
+    int face = moveFace(move);
+    int turn = moveIndex(move) % 3;
+    State entered = metric_ == Metric::HALF_TURN ? faceState(face, CLOCKWISE)
+                  : faceState(face, turn == 0 ? CLOCKWISE : COUNTER_CLOCKWISE);
+    if (state == START) return entered;
+
+    int lastFace = (state - 1) / 3;
+    int lastTurns = (state - 1) % 3;
+    if (face == lastFace) {
+        // Only U U, and only in the quarter-turn metric
+        bool second = metric_ == Metric::QUARTER_TURN && lastTurns == CLOCKWISE && turn == 0;
+        return second ? faceState(face, TWICE_CLOCKWISE) : REJECT;
+    }
+    // Opposite faces commute: lower face first
+    if (face / 2 == lastFace / 2 && face < lastFace) return REJECT;
+    return entered;
+}
@@ -0,0 +1,408 @@
+// src/mpi_scheduler.cpp - Concurrent MPI solves on groups of worker ranks
+#include "mpi_scheduler.hpp"
+#include "mpi_solver.hpp"
+#include "hybrid_solver.hpp"
+#include "heuristic.hpp"
+#include "pattern_database.hpp"
+#include "logging.hpp"
+#include <cstring>
+
+class MPIScheduler::Job {
+public:
+    SolveJob record;
+    Clock::time_point deadline;
+    bool cancelRequested = false;
+    bool cancelSent = false;
+    bool done = false;
+    Outcome outcome;
+};
+
+namespace {
+
+// Collective over MPI_COMM_WORLD: rank 0 takes part without joining a group
+MPI_Comm splitGroups(const MPIGroupLayout& layout) {
+    int rank;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    int color = rank == 0 ? MPI_UNDEFINED : layout.groupOf(rank - 1);
+    MPI_Comm group = MPI_COMM_NULL;
+    MPI_Comm_split(MPI_COMM_WORLD, color, rank, &group);
+    return group;
+}
+
+void sendToLeader(SolveJob& job, int leader) {
+    MPI_Send(&job, sizeof(SolveJob), MPI_BYTE, leader, TAG_JOB, MPI_COMM_WORLD);
+}
+
+} // namespace
+
+MPIScheduler::MPIScheduler(int minGroupSize) : minGroupSize_(std::max(1, minGroupSize)) {
+    int size;
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+    if (size < 2) throw std::runtime_error("MPIScheduler needs at least one worker rank");
+    layout_.workers = size - 1;
+    layout_.groupSize = layout_.workers;
+    splitGroups(layout_);
+    formGroups(layout_.groupSize);
+    dispatcher_ = std::thread([this] { run(); });
+}
+
+MPIScheduler::~MPIScheduler() {
+    shutdown();
+}
+
+void MPIScheduler::shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stopping_ && !dispatcher_.joinable()) return;
+        stopping_ = true;
+    }
+    wakeup_.notify_one();
+    if (dispatcher_.joinable()) dispatcher_.join();
+}
+
+MPIScheduler::JobHandle MPIScheduler::submit(SolveJob record, Clock::time_point deadline) {
+    auto job = std::make_shared<Job>();
+    job->deadline = deadline;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        record.jobId = ++nextJobId_;
+        job->record = record;
+        if (stopping_) {
+            job->outcome.stopped = true;
+            job->done = true;
+            return job;
+        }
+        queue_.push_back(job);
+    }
+    wakeup_.notify_one();
+    return job;
+}
+
+MPIScheduler::Outcome MPIScheduler::wait(const JobHandle& job, const std::function<bool()>& stop) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!job->done) {
+        if (!job->cancelRequested && stop && stop()) {
+            job->cancelRequested = true;
+            wakeup_.notify_one();
+        }
+        finished_.wait_for(lock, std::chrono::milliseconds(5));
+    }
+    return job->outcome;
+}
+
+size_t MPIScheduler::idleGroups() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t idle = 0;
+    for (const Group& group : groups_) idle += group.job ? 0 : 1;
+    return idle > queue_.size() ? idle - queue_.size() : 0;
+}
+
+MPIScheduler::Status MPIScheduler::getStatus() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Status status;
+    status.workers = layout_.workers;
+    status.groupSize = layout_.groupSize;
+    status.minGroupSize = minGroupSize_;
+    status.queued = queue_.size();
+    status.completed = completed_;
+    status.resizes = resizes_;
+    auto now = Clock::now();
+    for (const Group& group : groups_) {
+        GroupStatus entry;
+        entry.leader = group.leader;
+        entry.size = group.size;
+        entry.completed = group.completed;
+        if (group.job) {
+            entry.jobId = group.job->record.jobId;
+            entry.solver = group.job->record.solver;
+            entry.seconds = std::chrono::duration<double>(now - group.started).count();
+        }
+        status.groups.push_back(entry);
+    }
+    return status;
+}
+
+// Caller holds mutex_, or is the constructor
+void MPIScheduler::formGroups(int groupSize) {
+    layout_.groupSize = groupSize;
+    groups_.clear();
+    for (int i = 0; i < layout_.groupCount(); ++i) {
+        groups_.push_back(Group{layout_.leaderOf(i), layout_.sizeOf(i), nullptr, {}, 0});
+    }
+}
+
+// Caller holds mutex_
+void MPIScheduler::finish(const JobHandle& job, Outcome outcome) {
+    job->outcome = std::move(outcome);
+    job->done = true;
+    ++completed_;
+    finished_.notify_all();
+}
+
+// Any results that arrived; true if there were some
+bool MPIScheduler::collectResults() {
+    bool any = false;
+    while (true) {
+        int pending = 0;
+        MPI_Status status;
+        MPI_Iprobe(MPI_ANY_SOURCE, TAG_RESULT, MPI_COMM_WORLD, &pending, &status);
+        if (!pending) return any;
+        PackedJobResult result;
+        MPI_Recv(&result, sizeof(result), MPI_BYTE, status.MPI_SOURCE, TAG_RESULT, MPI_COMM_WORLD,
+                 MPI_STATUS_IGNORE);
+        any = true;
+
+        Outcome outcome;
+        outcome.found = result.found != 0;
+        outcome.stopped = result.stopped != 0;
+        outcome.time = result.time;
+        outcome.counters = result.counters.unpack();
+        outcome.solution.assign(reinterpret_cast<const Move*>(result.solution.moves),
+                                reinterpret_cast<const Move*>(result.solution.moves) +
+                                    std::min<int>(result.solution.length, PackedSolution::MAX_MOVES));
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (Group& group : groups_) {
+            if (group.leader != status.MPI_SOURCE || !group.job ||
+                group.job->record.jobId != result.jobId) {
+                continue;
+            }
+            RUBIKS_LOG(DEBUG) << "MPI job " << result.jobId << " done on group of rank " << group.leader
+                              << " (" << group.size << " ranks) in " << result.time << "s";
+            finish(group.job, std::move(outcome));
+            group.job.reset();
+            ++group.completed;
+            break;
+        }
+    }
+}
+
+void MPIScheduler::run() {
+    auto delay = std::chrono::microseconds(50);
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        bool busy = std::any_of(groups_.begin(), groups_.end(), [](const Group& g) { return g.job != nullptr; });
+
+        // Queued jobs that were cancelled or ran out of time before they
+        // could start
+        auto now = Clock::now();
+        for (auto it = queue_.begin(); it != queue_.end();) {
+            if (stopping_ || (*it)->cancelRequested || now >= (*it)->deadline) {
+                Outcome outcome;
+                outcome.stopped = true;
+                finish(*it, std::move(outcome));
+                it = queue_.erase(it);
+            } else {
+                ++it;
+            }
+        }
+
+        if (!busy && queue_.empty()) {
+            if (stopping_) break;
+            // Nothing running, nothing to hear from the workers
+            wakeup_.wait(lock);
+            continue;
+        }
+
+        // Re-form the groups for the queue depth while all of them are idle
+        if (!busy) {
+            int size = MPIGroupLayout::chooseGroupSize(layout_.workers, queue_.size(), minGroupSize_);
+            if (size != layout_.groupSize) {
+                std::vector<int> leaders;
+                for (const Group& group : groups_) leaders.push_back(group.leader);
+                size_t queued = queue_.size();
+                lock.unlock();
+                SolveJob resplit;
+                resplit.command = JobCommand::RESPLIT;
+                resplit.jobId = static_cast<uint32_t>(size);
+                for (int leader : leaders) sendToLeader(resplit, leader);
+                MPIGroupLayout layout{layout_.workers, size};
+                splitGroups(layout);
+                RUBIKS_LOG(DEBUG) << "MPI workers regrouped: " << layout.groupCount() << " group(s) of "
+                                  << size << " for " << queued << " queued job(s)";
+                lock.lock();
+                formGroups(size);
+                ++resizes_;
+                continue;
+            }
+        }
+
+        // Hand queued jobs to idle groups; the time limit counts from now
+        for (Group& group : groups_) {
+            if (group.job || queue_.empty()) continue;
+            JobHandle job = queue_.front();
+            queue_.pop_front();
+            group.job = job;
+            group.started = Clock::now();
+            SolveJob record = job->record;
+            if (job->deadline != Clock::time_point::max()) {
+                record.timeLimit = std::max(1e-3f, static_cast<float>(
+                    std::chrono::duration<double>(job->deadline - group.started).count()));
+            }
+            int leader = group.leader;
+            lock.unlock();
+            sendToLeader(record, leader);
+            lock.lock();
+        }
+
+        // Cancels for running jobs go to their group's leader
+        for (Group& group : groups_) {
+            if (!group.job || !(stopping_ || group.job->cancelRequested) || group.job->cancelSent) continue;
+            group.job->cancelSent = true;
+            uint32_t jobId = group.job->record.jobId;
+            int leader = group.leader;
+            lock.unlock();
+            MPI_Send(&jobId, 1, MPI_UINT32_T, leader, TAG_CANCEL, MPI_COMM_WORLD);
+            lock.lock();
+        }
+
+        lock.unlock();
+        bool progress = collectResults();
+        lock.lock();
+        if (progress) {
+            delay = std::chrono::microseconds(50);
+        } else {
+            // Polls the workers with the same backoff they use; a new job
+            // wakes the thread at once
+            wakeup_.wait_for(lock, delay);
+            if (delay < std::chrono::microseconds(2000)) delay *= 2;
+        }
+    }
+    lock.unlock();
+
+    SolveJob shutdown;
+    shutdown.command = JobCommand::SHUTDOWN;
+    for (const Group& group : groups_) sendToLeader(shutdown, group.leader);
+}
+
+std::vector<std::string> MPIJobSolver::solve(RubiksCube& cube, int maxDepth) {
+    auto startTime = std::chrono::high_resolution_clock::now();
+    beginSearch();
+
+    if (cube.isSolved()) {
+        solveTime_ = 0.0;
+        finishStats(SearchCounters{}, true, 0);
+        return {};
+    }
+
+    SolveJob job;
+    job.command = JobCommand::SOLVE;
+    job.solver = kind_;
+    job.usePatternDatabase = heuristic_->getName() == "pdb" ? 1 : 0;
+    job.halfTurnMetric = metric_ == Metric::HALF_TURN ? 1 : 0;
+    job.maxDepth = static_cast<uint8_t>(std::max(0, std::min(maxDepth, PackedSolution::MAX_MOVES)));
+    job.cube = CubieCube(cube);
+
+    RUBIKS_LOG(DEBUG) << "=== " << getName() << " === queued on " << scheduler_->getWorkers()
+                      << " worker rank(s), max depth " << static_cast<int>(job.maxDepth);
+    MPIScheduler::JobHandle handle = scheduler_->submit(job, searchDeadline());
+    MPIScheduler::Outcome outcome = scheduler_->wait(handle, [this] {
+        return getCancellationToken()->isCancelled();
+    });
+    if (outcome.stopped) markStopped();
+
+    auto endTime = std::chrono::high_resolution_clock::now();
+    solveTime_ = std::chrono::duration<double>(endTime - startTime).count();
+    finishStats(outcome.counters, outcome.found, outcome.solution.size());
+    return movesToStrings(outcome.solution);
+}
+
+void runMPIWorker() {
+    int rank, size;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+    MPIGroupLayout layout{size - 1, size - 1};
+    MPI_Comm group = splitGroups(layout);
+
+    // A rank is in one group at a time and its jobs never overlap, so one
+    // instance of each solver serves them all
+    MPISolver mpiSolver;
+    HybridSolver hybridSolver;  // threads sized by this rank's placement
+    // Indexed by usePatternDatabase
+    std::shared_ptr<const Heuristic> heuristics[2] = {
+        createHeuristic("manhattan"), createHeuristic(getDefaultPatternDatabase() ? "pdb" : "manhattan")};
+
+    while (true) {
+        int groupRank;
+        MPI_Comm_rank(group, &groupRank);
+
+        // The leader hears from rank 0 and passes the job on to its group;
+        // cancels that arrive after their job finished are dropped here
+        SolveJob job;
+        if (groupRank == 0) {
+            Backoff backoff;
+            while (true) {
+                int pending = 0;
+                MPI_Status status;
+                MPI_Iprobe(0, MPI_ANY_TAG, MPI_COMM_WORLD, &pending, &status);
+                if (!pending) {
+                    backoff.wait();
+                } else if (status.MPI_TAG == TAG_CANCEL) {
+                    uint32_t stale;
+                    MPI_Recv(&stale, 1, MPI_UINT32_T, 0, TAG_CANCEL, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+                } else {
+                    MPI_Recv(&job, sizeof(SolveJob), MPI_BYTE, 0, TAG_JOB, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+                    break;
+                }
+            }
+            broadcastJob(job, group);
+        } else {
+            job = receiveJob(group);
+        }
+
+        if (job.command == JobCommand::SHUTDOWN) break;
+        if (job.command == JobCommand::RESPLIT) {
+            MPI_Comm_free(&group);
+            layout.groupSize = static_cast<int>(job.jobId);
+            group = splitGroups(layout);
+            continue;
+        }
+
+        SolverSettings settings{heuristics[job.usePatternDatabase ? 1 : 0],
+                                job.halfTurnMetric ? Metric::HALF_TURN : Metric::QUARTER_TURN,
+                                nullptr, job.timeLimit};
+        JobControl control{groupRank == 0 ? MPI_COMM_WORLD : MPI_COMM_NULL, 0, job.jobId};
+        Solver* solver = nullptr;
+        if (job.solver == SolverKind::HYBRID) {
+            hybridSolver.setCommunicator(group);
+            hybridSolver.setJobControl(control);
+            solver = &hybridSolver;
+        } else {
+            mpiSolver.setCommunicator(group);
+            mpiSolver.setJobControl(control);
+            solver = &mpiSolver;
+        }
+        solver->configure(settings);
+        solver->setCancellationToken(std::make_shared<CancellationToken>());
+
+        RubiksCube cube = job.cube.toFacelets();
+        auto solution = solver->solve(cube, job.maxDepth);
+        if (groupRank != 0) continue;
+
+        // Every rank of the group holds the merged stats; the leader reports them
+        const SolveStats& stats = solver->getStats();
+        SearchCounters counters;
+        counters.nodes = stats.nodes;
+        counters.heuristicEvaluations = stats.heuristicEvaluations;
+        counters.boundCutoffs = stats.boundCutoffs;
+        counters.sequencePruned = stats.sequencePruned;
+        counters.tableProbes = stats.tableProbes;
+        counters.tableCutoffs = stats.tableCutoffs;
+        for (size_t g = 0; g < stats.nodesPerDepth.size() && g < counters.nodesPerDepth.size(); ++g) {
+            counters.nodesPerDepth[g] = stats.nodesPerDepth[g];
+        }
+
+        PackedJobResult result;
+        result.jobId = job.jobId;
+        result.found = stats.solved ? 1 : 0;
+        result.stopped = stats.stopped ? 1 : 0;
+        result.time = stats.time;
+        result.counters = PackedCounters(counters);
+        result.solution.length = static_cast<uint8_t>(std::min<size_t>(solution.size(), PackedSolution::MAX_MOVES));
+        for (int i = 0; i < result.solution.length; ++i) {
+            result.solution.moves[i] = static_cast<uint8_t>(moveFromString(solution[i]));
+        }
+        MPI_Send(&result, sizeof(result), MPI_BYTE, 0, TAG_RESULT, MPI_COMM_WORLD);
+    }
+    MPI_Comm_free(&group);
+}
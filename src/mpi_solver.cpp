@@ -1,5 +1,6 @@
 #include "mpi_solver.hpp"
-#include <iostream>
+#include "mpi_protocol.hpp"
+#include "logging.hpp"
 #include <algorithm>
 #include <limits>
 #include <iomanip>
@@ -10,7 +11,12 @@ void MPISolver::Initialize(int* argc, char*** argv) {
     int flag;
     MPI_Initialized(&flag);
     if (!flag) {
-        MPI_Init(argc, argv);
+        // On rank 0 the HTTP server calls MPI from its scheduler thread only
+        int provided;
+        MPI_Init_thread(argc, argv, MPI_THREAD_SERIALIZED, &provided);
+        if (provided < MPI_THREAD_SERIALIZED) {
+            RUBIKS_LOG(WARNING) << "MPI library lacks MPI_THREAD_SERIALIZED support";
+        }
         initialized_ = true;
     }
 }
@@ -27,40 +33,49 @@ void MPISolver::Finalize() {
 
 MPISolver::MPISolver() {
     if (!initialized_) throw std::runtime_error("MPI not initialized");
-    MPI_Comm_rank(MPI_COMM_WORLD, &rank_);
-    MPI_Comm_size(MPI_COMM_WORLD, &size_);
+    setCommunicator(MPI_COMM_WORLD);
 }
 
-MPISolver::~MPISolver() {}
-
-int MPISolver::heuristic(const RubiksCube& cube) const {
-    return cube.getManhattanDistance();
+void MPISolver::setCommunicator(MPI_Comm comm) {
+    comm_ = comm;
+    MPI_Comm_rank(comm_, &rank_);
+    MPI_Comm_size(comm_, &size_);
 }
 
+MPISolver::~MPISolver() {}
+
 std::vector<std::string> MPISolver::solve(RubiksCube& cube, int maxDepth) {
     auto startTime = std::chrono::high_resolution_clock::now();
     
    // std::cout << "[DEBUG] Rank " << rank_ << ": solve() called, maxDepth=" << maxDepth << std::endl;
     
+    solution_.clear();
+    maxDepth_ = maxDepth;
+    counters_ = SearchCounters{};
+    remoteStop_ = false;
+    beginSearch();
+    
     if (cube.isSolved()) {
-       // std::cout << "[DEBUG] Rank " << rank_ << ": Cube already solved" << std::endl;
+        solveTime_ = 0.0;
+        finishStats(counters_, true, 0);
         return {};
     }
     
-    solution_.clear();
-    maxDepth_ = maxDepth;
-    nodesExplored_ = 0;
-    
     if (rank_ == 0) {
-        std::cout << "\n=== MPI IDA* Search ===" << std::endl;
-        std::cout << "Processes: " << size_ << std::endl;
-        std::cout << "Max depth: " << maxDepth << std::endl;
+        RUBIKS_LOG(DEBUG) << "=== MPI IDA* Search === processes " << size_ << ", distribution "
+                          << (distribution_ == Distribution::DYNAMIC ? "dynamic" : "static")
+                          << ", max depth " << maxDepth << ", heuristic " << heuristic_->getName();
     }
     
-    const double TIME_LIMIT = 120.0;
-    int threshold = heuristic(cube);
+    // Search on the compact cubie representation; the caller's cube is left untouched
+    CubieCube start(cube);
+    int threshold = heuristic_->estimate(start);
     bool found = false;
     
+    if (distribution_ == Distribution::DYNAMIC) {
+        buildFrontier(start);
+    }
+    
    // std::cout << "[DEBUG] Rank " << rank_ << ": Initial threshold=" << threshold << std::endl;
     
     int iteration = 0;
@@ -68,61 +83,40 @@ std::vector<std::string> MPISolver::solve(RubiksCube& cube, int maxDepth) {
         iteration++;
         
         if (rank_ == 0) {
-            std::cout << "\n[Iteration " << iteration << "] Threshold " << threshold << "..." << std::endl;
+            RUBIKS_LOG(DEBUG) << "[Iteration " << iteration << "] Threshold " << threshold << "...";
+            reportProgress(threshold, counters_.nodes);
+            checkCancel();
         }
         
         // std::cout << "[DEBUG] Rank " << rank_ << ": Starting iteration " << iteration 
         //           << " with threshold " << threshold << std::endl;
         
-        auto moves = RubiksCube::getBasicMoves();
-        // std::cout << "[DEBUG] Rank " << rank_ << ": Total moves to explore: " << moves.size() << std::endl;
+        std::vector<Move> localSolution;
+        int localMin;
         
-        std::vector<std::string> localSolution;
-        int localMin = std::numeric_limits<int>::max();
-        int movesExplored = 0;
-        
-        // Distribute moves across processes
-        for (size_t i = rank_; i < moves.size(); i += size_) {
-            movesExplored++;
-            // std::cout << "[DEBUG] Rank " << rank_ << ": Exploring move " << (i+1) 
-            //           << "/" << moves.size() << " (" << moves[i] << ")" << std::endl;
-            
-            RubiksCube localCube = cube;
-            localCube.applyMove(moves[i]);
-            
-            std::vector<std::string> localPath = {moves[i]};
-            
-            // std::cout << "[DEBUG] Rank " << rank_ << ": Calling idaSearch for move " 
-            //           << moves[i] << std::endl;
-            
-            int temp = idaSearch(localCube, 1, threshold, moves[i], localPath, TIME_LIMIT, startTime);
-            
-            // std::cout << "[DEBUG] Rank " << rank_ << ": idaSearch returned " 
-            //           << (temp == -1 ? "SOLUTION" : std::to_string(temp)) 
-            //           << " for move " << moves[i] << std::endl;
-            
-            if (temp == -1) {
-                // std::cout << "[DEBUG] Rank " << rank_ << ": *** SOLUTION FOUND *** Path length: " 
-                //           << localPath.size() << std::endl;
-                localSolution = localPath;
-                localMin = -1;
-                break;
-            }
-            
-            if (temp < localMin) {
-                localMin = temp;
-                // std::cout << "[DEBUG] Rank " << rank_ << ": Updated localMin to " << localMin << std::endl;
+        if (distribution_ == Distribution::STATIC) {
+            localMin = searchStatic(start, threshold, localSolution);
+        } else if (threshold < splitDepth_) {
+            // Shallower than the frontier: cheap enough for rank 0 to search
+            // alone. The others sit it out, so the summed node counts see the
+            // search once, and get any solution from the broadcast below.
+            localMin = std::numeric_limits<int>::max();
+            if (rank_ == 0) {
+                std::vector<Move> path;
+                path.reserve(maxDepth + 1);
+                localMin = idaStar(policy_, counters_, start, 0, threshold, MoveSequenceAutomaton::START, path);
+                if (localMin == -1) localSolution = path;
             }
+        } else {
+            localMin = searchDynamic(threshold, localSolution);
         }
         
-        // std::cout << "[DEBUG] Rank " << rank_ << ": Explored " << movesExplored 
-        //           << " moves, localMin=" << localMin << std::endl;
         
         // Synchronize results across all processes
         // std::cout << "[DEBUG] Rank " << rank_ << ": Calling MPI_Allreduce..." << std::endl;
         
         int globalMin;
-        MPI_Allreduce(&localMin, &globalMin, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+        MPI_Allreduce(&localMin, &globalMin, 1, MPI_INT, MPI_MIN, comm_);
         
         // std::cout << "[DEBUG] Rank " << rank_ << ": MPI_Allreduce complete, globalMin=" 
         //           << globalMin << std::endl;
@@ -140,7 +134,7 @@ std::vector<std::string> MPISolver::solve(RubiksCube& cube, int maxDepth) {
             }
             
            // std::cout << "[DEBUG] Rank " << rank_ << ": Finding rank with best solution..." << std::endl;
-            MPI_Allreduce(MPI_IN_PLACE, &rankWithBest, 1, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
+            MPI_Allreduce(MPI_IN_PLACE, &rankWithBest, 1, MPI_INT, MPI_MAX, comm_);
             
             // std::cout << "[DEBUG] Rank " << rank_ << ": Best solution is on rank " 
             //           << rankWithBest << std::endl;
@@ -152,43 +146,22 @@ std::vector<std::string> MPISolver::solve(RubiksCube& cube, int maxDepth) {
                 //           << solution_.size() << std::endl;
             }
             
-            int solutionSize = solution_.size();
-            //std::cout << "[DEBUG] Rank " << rank_ << ": Broadcasting solution size..." << std::endl;
-            MPI_Bcast(&solutionSize, 1, MPI_INT, rankWithBest, MPI_COMM_WORLD);
-            //std::cout << "[DEBUG] Rank " << rank_ << ": Solution size = " << solutionSize << std::endl;
-            
-            if (rank_ != rankWithBest) {
-                solution_.resize(solutionSize);
-            }
-            
-            // std::cout << "[DEBUG] Rank " << rank_ << ": Broadcasting " << solutionSize 
-            //           << " moves..." << std::endl;
-            
-            for (size_t j = 0; j < solution_.size(); ++j) {
-                char moveStr[10] = {0};
-                if (rank_ == rankWithBest) {
-                    strncpy(moveStr, solution_[j].c_str(), sizeof(moveStr) - 1);
-                }
-                MPI_Bcast(moveStr, sizeof(moveStr), MPI_CHAR, rankWithBest, MPI_COMM_WORLD);
-                if (rank_ != rankWithBest) {
-                    solution_[j] = std::string(moveStr);
-                }
-            }
+            // Length and moves in one fixed-size message
+            broadcastSolution(solution_, rankWithBest, comm_);
             
            // std::cout << "[DEBUG] Rank " << rank_ << ": Solution broadcast complete" << std::endl;
             break;
         }
         
-        // Check time limit
-        auto currentTime = std::chrono::high_resolution_clock::now();
-        double elapsed = std::chrono::duration<double>(currentTime - startTime).count();
-        
-        // std::cout << "[DEBUG] Rank " << rank_ << ": Elapsed time: " << std::fixed 
-        //           << std::setprecision(2) << elapsed << "s / " << TIME_LIMIT << "s" << std::endl;
+        // Stop together: ranks whose deadline passed would otherwise leave
+        // the others blocked in the next iteration's Allreduce
+        int localStop = deadlineExpired() ? 1 : 0;
+        int globalStop = 0;
+        MPI_Allreduce(&localStop, &globalStop, 1, MPI_INT, MPI_MAX, comm_);
         
-        if (elapsed > TIME_LIMIT) {
+        if (globalStop) {
             if (rank_ == 0) {
-               // std::cout << "[DEBUG] Time limit reached" << std::endl;
+                RUBIKS_LOG(DEBUG) << "Time limit reached";
             }
             break;
         }
@@ -209,83 +182,206 @@ std::vector<std::string> MPISolver::solve(RubiksCube& cube, int maxDepth) {
     
     // std::cout << "[DEBUG] Rank " << rank_ << ": Search complete in " << solveTime_ << "s" << std::endl;
     
+    // Close the last iteration with this rank's count, then merge every
+    // rank's counters so all of them report the same totals
+    endIteration(counters_.nodes);
+    std::vector<uint64_t> workerNodes;
+    SearchCounters total = reduceCounters(counters_, {counters_.nodes}, workerNodes, comm_);
+    finishStats(total, !solution_.empty(), solution_.size(), std::move(workerNodes));
+    
     if (rank_ == 0) {
-        std::cout << "\n=== Search Complete ===" << std::endl;
         if (!solution_.empty()) {
-            std::cout << "✓ Solution found!" << std::endl;
-            std::cout << "  Moves: " << solution_.size() << std::endl;
-            std::cout << "  Nodes: " << nodesExplored_ << std::endl;
-            std::cout << "  Time: " << solveTime_ << "s" << std::endl;
-            std::cout << "  Processes: " << size_ << std::endl;
+            RUBIKS_LOG(DEBUG) << "✓ Solution found: " << solution_.size() << " moves, " << total.nodes
+                              << " nodes, " << solveTime_ << "s, " << size_ << " processes";
         } else {
-            std::cout << "✗ No solution found" << std::endl;
-            std::cout << "  Nodes: " << nodesExplored_ << std::endl;
-            std::cout << "  Time: " << solveTime_ << "s" << std::endl;
+            RUBIKS_LOG(DEBUG) << "✗ No solution found: " << total.nodes << " nodes, " << solveTime_ << "s";
         }
     }
     
-    return solution_;
+    return movesToStrings(solution_);
 }
 
-int MPISolver::idaSearch(RubiksCube& cube, int g, int threshold, const std::string& lastMove,
-                        std::vector<std::string>& path, double timeLimit,
-                        std::chrono::high_resolution_clock::time_point startTime) {
-    nodesExplored_++;
+// Original split: root move i goes to rank i % size
+int MPISolver::searchStatic(const CubieCube& start, int threshold, std::vector<Move>& localSolution) {
+    const auto& moves = automaton_->getMoves();
+    int localMin = std::numeric_limits<int>::max();
     
-    // Debug every 100000 nodes
-    if (nodesExplored_ % 100000 == 0) {
-        // std::cout << "[DEBUG] Rank " << rank_ << ": Explored " << nodesExplored_ 
-        //           << " nodes at depth " << g << std::endl;
+    for (size_t i = rank_; i < moves.size(); i += size_) {
+        CubieCube localCube = start;
+        localCube.applyMove(moves[i]);
+        
+        std::vector<Move> localPath;
+        localPath.reserve(maxDepth_ + 1);
+        localPath.push_back(moves[i]);
+        
+        int temp = idaStar(policy_, counters_, localCube, 1, threshold,
+                           automaton_->next(MoveSequenceAutomaton::START, moves[i]), localPath);
+        
+        if (temp == -1) {
+            localSolution = localPath;
+            return -1;
+        }
+        
+        if (temp < localMin) {
+            localMin = temp;
+        }
     }
     
-    int h = heuristic(cube);
-    int f = g + h;
+    return localMin;
+}
+
+// Every rank builds the same list, so a task is just its index
+void MPISolver::buildFrontier(const CubieCube& start) {
+    frontier_.clear();
+    std::vector<Move> path;
+    
+    auto expand = [&](auto& self, const CubieCube& cube, MoveSequenceAutomaton::State sequence) -> void {
+        if (static_cast<int>(path.size()) == splitDepth_) {
+            frontier_.push_back({cube, path, sequence});
+            return;
+        }
+        for (Move move : automaton_->allowed(sequence)) {
+            CubieCube next = cube;
+            next.applyMove(move);
+            path.push_back(move);
+            self(self, next, automaton_->next(sequence, move));
+            path.pop_back();
+        }
+    };
+    expand(expand, start, MoveSequenceAutomaton::START);
+}
+
+// Rank 0 hands out frontier indices on request and searches tasks itself
+// in between. Whoever finds a solution makes rank 0 start a non-blocking
+// broadcast of the stop flag, which the other ranks test while searching.
+int MPISolver::searchDynamic(int threshold, std::vector<Move>& localSolution) {
+    int localMin = std::numeric_limits<int>::max();
+    nextTask_ = 0;
+    finishedWorkers_ = 0;
+    stopFlag_ = 0;
+    stopPosted_ = false;
+    remoteStop_ = false;
+    stopRequest_ = MPI_REQUEST_NULL;
     
-    if (f > threshold) {
-        return f;
+    if (rank_ != 0) {
+        MPI_Ibcast(&stopFlag_, 1, MPI_INT, 0, comm_, &stopRequest_);
     }
     
-    if (cube.isSolved()) {
-        // std::cout << "[DEBUG] Rank " << rank_ << ": *** SOLVED at depth " << g 
-        //           << " (path length: " << path.size() << ") ***" << std::endl;
-        return -1;
-    }
+    auto runTask = [&](int index) {
+        const FrontierNode& node = frontier_[index];
+        std::vector<Move> path = node.path;
+        path.reserve(maxDepth_ + 1);
+        int temp = idaStar(policy_, counters_, node.cube, static_cast<int>(path.size()), threshold,
+                           node.sequence, path);
+        if (temp == -1) {
+            localSolution = path;
+            localMin = -1;
+            if (rank_ == 0) {
+                postStop(1);
+            } else {
+                int found = 1;
+                MPI_Send(&found, 1, MPI_INT, 0, TAG_FOUND, comm_);
+                remoteStop_ = true;
+            }
+        } else if (localMin != -1 && temp < localMin) {
+            localMin = temp;
+        }
+    };
     
-    int min = std::numeric_limits<int>::max();
-    auto moves = RubiksCube::getBasicMoves();
+    polling_ = true;
+    if (rank_ == 0) {
+        const int taskCount = static_cast<int>(frontier_.size());
+        while (true) {
+            serveRequests(false);
+            if (!stopPosted_ && deadlineExpired()) {
+                postStop(1);
+            }
+            if (!stopPosted_ && nextTask_ < taskCount) {
+                runTask(nextTask_++);
+                continue;
+            }
+            if (finishedWorkers_ == size_ - 1) break;
+            serveRequests(true);
+        }
+        if (!stopPosted_) {
+            postStop(0);
+        }
+    } else {
+        // Keep asking until rank 0 answers -1, even after a stop, so it
+        // knows when every worker is done with this iteration
+        while (true) {
+            int request = 0, index = -1;
+            MPI_Send(&request, 1, MPI_INT, 0, TAG_WORK_REQUEST, comm_);
+            MPI_Recv(&index, 1, MPI_INT, 0, TAG_WORK_ASSIGN, comm_, MPI_STATUS_IGNORE);
+            if (index < 0) break;
+            pollMessages();
+            if (!remoteStop_) {
+                runTask(index);
+            }
+        }
+    }
+    polling_ = false;
     
-    for (const auto& move : moves) {
-        if (isRedundantMove(lastMove, move)) {
-            continue;
+    MPI_Wait(&stopRequest_, MPI_STATUS_IGNORE);
+    return localMin;
+}
+
+void MPISolver::postStop(int flag) {
+    stopFlag_ = flag;
+    stopPosted_ = true;
+    if (flag) {
+        remoteStop_ = true;
+    }
+    MPI_Ibcast(&stopFlag_, 1, MPI_INT, 0, comm_, &stopRequest_);
+}
+
+// Rank 0: answer queued messages (one blocking receive if block is set)
+void MPISolver::serveRequests(bool block) {
+    const int taskCount = static_cast<int>(frontier_.size());
+    while (true) {
+        MPI_Status status;
+        int pending = 0;
+        if (block) {
+            MPI_Probe(MPI_ANY_SOURCE, MPI_ANY_TAG, comm_, &status);
+            pending = 1;
+            block = false;
+        } else {
+            MPI_Iprobe(MPI_ANY_SOURCE, MPI_ANY_TAG, comm_, &pending, &status);
         }
+        if (!pending) return;
         
-        cube.applyMove(move);
-        path.push_back(move);
-        
-        int temp = idaSearch(cube, g + 1, threshold, move, path, timeLimit, startTime);
+        int message;
+        MPI_Recv(&message, 1, MPI_INT, status.MPI_SOURCE, status.MPI_TAG, comm_, MPI_STATUS_IGNORE);
         
-        if (temp == -1) {
-            return -1;
+        if (status.MPI_TAG == TAG_FOUND) {
+            if (!stopPosted_) postStop(1);
+            continue;
         }
         
-        if (temp < min) {
-            min = temp;
+        int index = -1;
+        if (!stopPosted_ && nextTask_ < taskCount) {
+            index = nextTask_++;
+        } else {
+            finishedWorkers_++;
+        }
+        MPI_Send(&index, 1, MPI_INT, status.MPI_SOURCE, TAG_WORK_ASSIGN, comm_);
+    }
+}
+
+void MPISolver::pollMessages() {
+    if (rank_ == 0) {
+        checkCancel();
+        serveRequests(false);
+    } else if (!remoteStop_) {
+        int done = 0;
+        MPI_Test(&stopRequest_, &done, MPI_STATUS_IGNORE);
+        if (done && stopFlag_) {
+            remoteStop_ = true;
         }
-        
-        path.pop_back();
-        cube.applyMove(cube.getInverseMove(move));
     }
-    
-    return min;
 }
 
-bool MPISolver::isRedundantMove(const std::string& lastMove, const std::string& nextMove) const {
-    if (lastMove.empty()) return false;
-    char lastFace = lastMove[0];
-    char nextFace = nextMove[0];
-    if (lastFace == nextFace) return true;
-    if ((lastFace == 'U' && nextFace == 'D') || (lastFace == 'D' && nextFace == 'U')) return true;
-    if ((lastFace == 'L' && nextFace == 'R') || (lastFace == 'R' && nextFace == 'L')) return true;
-    if ((lastFace == 'F' && nextFace == 'B') || (lastFace == 'B' && nextFace == 'F')) return true;
-    return false;
-}
\ No newline at end of file
+// Rank 0: turn a cancel from the job's sender into a stop of this search
+void MPISolver::checkCancel() {
+    if (control_.cancelled()) getCancellationToken()->cancel();
+}
@@ -1,174 +1,154 @@
 #include "openmp_solver.hpp"
-#include <iostream>
+#include "logging.hpp"
 #include <chrono>
 #include <limits>
 
-OpenMPSolver::OpenMPSolver(int numThreads) 
-    : numThreads_(numThreads), solutionFound_(false) {
-    omp_set_num_threads(numThreads_);
-}
-
-int OpenMPSolver::heuristic(const RubiksCube& cube) const {
-    return cube.getManhattanDistance();
+OpenMPSolver::OpenMPSolver(int numThreads, int splitDepth)
+    : numThreads_(numThreads > 0 ? numThreads : ThreadPlacement::get().threads()),
+      splitDepth_(splitDepth) {
 }
 
 std::vector<std::string> OpenMPSolver::solve(RubiksCube& cube, int maxDepth) {
     auto startTime = std::chrono::high_resolution_clock::now();
-    
+
+    solution_.clear();
+    solutionFound_ = false;
+    threadState_.resize(numThreads_);
+    threadState_.forEach([](ThreadState& state) { state = ThreadState{}; });
+    beginSearch();
+
     if (cube.isSolved()) {
         solveTime_ = 0.0;
-        std::cout << "Cube already solved!" << std::endl;
+        finishStats(SearchCounters{}, true, 0);
+        RUBIKS_LOG(DEBUG) << "Cube already solved!";
         return {};
     }
-    
-    solution_.clear();
-    nodesExplored_ = 0;
-    solutionFound_ = false;
-    
-    std::cout << "=== OpenMP IDA* Search ===" << std::endl;
-    std::cout << "Threads: " << numThreads_ << std::endl;
-    std::cout << "Max depth: " << maxDepth << std::endl;
-    
-    const double TIME_LIMIT = 120.0;
-    
-    int threshold = heuristic(cube);
-    bool found = false;
-    
-    while (!found && threshold <= maxDepth && !solutionFound_) {
-        std::cout << "Searching with threshold " << threshold << "..." << std::endl;
-        
-        int minNext = std::numeric_limits<int>::max();
-        auto moves = RubiksCube::getBasicMoves();
-        
-        #pragma omp parallel for schedule(dynamic)
-        for (size_t i = 0; i < moves.size(); ++i) {
-            if (solutionFound_) continue;
-            
-            RubiksCube localCube = cube;
-            localCube.applyMove(moves[i]);
-            
-            std::vector<std::string> localPath = {moves[i]};
-            
-            int temp = idaSearchParallel(localCube, 1, threshold, moves[i], 
-                                        localPath, TIME_LIMIT, startTime);
-            
-            if (temp == -1) {
-                #pragma omp critical
-                {
-                    if (!solutionFound_) {
-                        solution_ = localPath;
-                        solutionFound_ = true;
-                        found = true;
-                    }
-                }
-            } else if (temp < minNext) {
-                #pragma omp critical
-                {
-                    if (temp < minNext) {
-                        minNext = temp;
-                    }
-                }
+
+    RUBIKS_LOG(DEBUG) << "=== OpenMP IDA* Search === threads " << numThreads_ << ", split depth "
+                      << splitDepth_ << ", max depth " << maxDepth << ", heuristic " << heuristic_->getName();
+
+    // Search on the compact cubie representation; the caller's cube is left untouched
+    CubieCube start(cube);
+    int threshold = heuristic_->estimate(start);
+
+    uint64_t nodes = 0;
+    while (threshold <= maxDepth) {
+        RUBIKS_LOG(DEBUG) << "Searching with threshold " << threshold << "...";
+        reportProgress(threshold, nodes);
+
+        threadState_.forEach([](ThreadState& state) { state.minNext = std::numeric_limits<int>::max(); });
+
+        #pragma omp parallel num_threads(numThreads_)
+        {
+            // Pinned first, so a new thread's state is allocated on its node
+            int thread = omp_get_thread_num();
+            ThreadPlacement::get().bindThread(thread, omp_get_num_threads());
+            threadState_.local(thread).minNext = std::numeric_limits<int>::max();
+
+            #pragma omp single
+            {
+                std::vector<Move> path;
+                path.reserve(maxDepth + 1);
+                searchTask(start, 0, threshold, MoveSequenceAutomaton::START, path);
             }
         }
-        
-        if (found) break;
-        
-        auto currentTime = std::chrono::high_resolution_clock::now();
-        double elapsed = std::chrono::duration<double>(currentTime - startTime).count();
-        if (elapsed > TIME_LIMIT) {
-            std::cout << "Time limit reached" << std::endl;
+
+        // Reduce the per-thread minima once all tasks have finished
+        int minNext = std::numeric_limits<int>::max();
+        nodes = 0;
+        threadState_.forEach([&](const ThreadState& state) {
+            minNext = std::min(minNext, state.minNext);
+            nodes += state.counters.nodes;
+        });
+
+        if (solutionFound_) break;
+
+        if (deadlineExpired()) {
+            RUBIKS_LOG(DEBUG) << "Time limit reached";
             break;
         }
-        
+
         if (minNext == std::numeric_limits<int>::max()) {
             break;
         }
-        
+
         threshold = minNext;
-        std::cout << "  New threshold: " << threshold << ", Nodes: " << nodesExplored_ << std::endl;
+        RUBIKS_LOG(DEBUG) << "  New threshold: " << threshold << ", Nodes: " << nodes;
     }
-    
+
     auto endTime = std::chrono::high_resolution_clock::now();
     solveTime_ = std::chrono::duration<double>(endTime - startTime).count();
-    
-    std::cout << "\n=== Search Complete ===" << std::endl;
+
+    // Merge the per-thread counters only now; the per-thread node counts
+    // are the load balance
+    SearchCounters total;
+    std::vector<uint64_t> workerNodes;
+    threadState_.forEach([&](const ThreadState& state) {
+        total.add(state.counters);
+        workerNodes.push_back(state.counters.nodes);
+    });
+    finishStats(total, solutionFound_, solution_.size(), std::move(workerNodes));
+
     if (solutionFound_) {
-        std::cout << "✓ Solution found!" << std::endl;
-        std::cout << "  Moves: " << solution_.size() << std::endl;
-        std::cout << "  Nodes: " << nodesExplored_ << std::endl;
-        std::cout << "  Time: " << solveTime_ << "s" << std::endl;
-        std::cout << "  Threads: " << numThreads_ << std::endl;
-        return solution_;
+        RUBIKS_LOG(DEBUG) << "✓ Solution found: " << solution_.size() << " moves, " << total.nodes
+                          << " nodes, " << solveTime_ << "s, " << numThreads_ << " threads";
+        return movesToStrings(solution_);
     }
-    
-    std::cout << "✗ No solution found" << std::endl;
-    std::cout << "  Nodes: " << nodesExplored_ << std::endl;
-    std::cout << "  Time: " << solveTime_ << "s" << std::endl;
+    RUBIKS_LOG(DEBUG) << "✗ No solution found: " << total.nodes << " nodes, " << solveTime_ << "s";
     return {};
 }
 
-int OpenMPSolver::idaSearchParallel(RubiksCube& cube, int g, int threshold,
-                                   const std::string& lastMove,
-                                   std::vector<std::string>& path,
-                                   double timeLimit,
-                                   std::chrono::high_resolution_clock::time_point startTime) {
-    #pragma omp atomic
-    nodesExplored_++;
-    
-    if (solutionFound_) return std::numeric_limits<int>::max();
-    
-    int h = heuristic(cube);
-    int f = g + h;
-    
+// Above the split depth every child becomes its own task; at the split
+// depth the subtree is searched sequentially by whichever thread runs it
+void OpenMPSolver::searchTask(const CubieCube& cube, int g, int threshold,
+                              MoveSequenceAutomaton::State sequence, std::vector<Move>& path) {
+    ThreadState& state = threadState_.local(omp_get_thread_num());
+
+    if (g >= splitDepth_) {
+        TaskPolicy policy{*this};
+        int temp = idaStar(policy, state.counters, cube, g, threshold, sequence, path);
+        if (temp == -1) {
+            recordSolution(path);
+        } else if (temp < state.minNext) {
+            state.minNext = temp;
+        }
+        return;
+    }
+
+    SearchCounters& counters = state.counters;
+    counters.visit(g);
+    if (solutionFound_.load(std::memory_order_relaxed) || shouldStop(counters.nodes)) return;
+
+    int f = g + heuristic_->estimate(cube);
+    counters.heuristicEvaluations++;
     if (f > threshold) {
-        return f;
+        counters.boundCutoffs++;
+        if (f < state.minNext) state.minNext = f;
+        return;
     }
-    
+
     if (cube.isSolved()) {
-        return -1;
+        recordSolution(path);
+        return;
     }
-    
-    int min = std::numeric_limits<int>::max();
-    auto moves = RubiksCube::getBasicMoves();
-    
-    for (const auto& move : moves) {
-        if (solutionFound_) return std::numeric_limits<int>::max();
-        
-        if (isRedundantMove(lastMove, move)) {
-            continue;
-        }
-        
-        cube.applyMove(move);
-        path.push_back(move);
-        
-        int temp = idaSearchParallel(cube, g + 1, threshold, move, path, timeLimit, startTime);
-        
-        if (temp == -1) {
-            return -1;
-        }
-        
-        if (temp < min) {
-            min = temp;
-        }
-        
-        path.pop_back();
-        cube.applyMove(cube.getInverseMove(move));
+
+    MoveMask allowed = automaton_->allowed(sequence);
+    counters.sequencePruned += automaton_->getMoves().size() - allowed.count();
+    for (Move move : allowed) {
+        CubieCube next = cube;
+        next.applyMove(move);
+        std::vector<Move> childPath(path);
+        childPath.push_back(move);
+        MoveSequenceAutomaton::State nextSequence = automaton_->next(sequence, move);
+
+        #pragma omp task firstprivate(next, childPath, nextSequence, g, threshold)
+        searchTask(next, g + 1, threshold, nextSequence, childPath);
     }
-    
-    return min;
 }
 
-bool OpenMPSolver::isRedundantMove(const std::string& lastMove, const std::string& nextMove) const {
-    if (lastMove.empty()) return false;
-    
-    char lastFace = lastMove[0];
-    char nextFace = nextMove[0];
-    
-    if (lastFace == nextFace) return true;
-    
-    if ((lastFace == 'U' && nextFace == 'D') || (lastFace == 'D' && nextFace == 'U')) return true;
-    if ((lastFace == 'L' && nextFace == 'R') || (lastFace == 'R' && nextFace == 'L')) return true;
-    if ((lastFace == 'F' && nextFace == 'B') || (lastFace == 'B' && nextFace == 'F')) return true;
-    
-    return false;
-}
\ No newline at end of file
+// First finder wins; the others see the flag and unwind
+void OpenMPSolver::recordSolution(const std::vector<Move>& path) {
+    if (!solutionFound_.exchange(true)) {
+        solution_ = path;
+    }
+}
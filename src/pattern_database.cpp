@@ -0,0 +1,390 @@
+#include "pattern_database.hpp"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <ostream>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+const char FILE_MAGIC[8] = {'R', 'C', 'P', 'D', 'B', 0, 0, 0};
+const uint64_t DATA_ALIGNMENT = 4096;
+
+// On-disk layout (host byte order). Table data follows at page-aligned offsets.
+struct FileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t tableCount;
+};
+
+struct TableHeader {
+    uint8_t kind;
+    uint8_t pieceCount;
+    uint8_t pieces[12];
+    uint8_t reserved[2];
+    uint64_t entries;
+    uint64_t offset;
+};
+
+static_assert(sizeof(FileHeader) == 16, "Unexpected FileHeader layout");
+static_assert(sizeof(TableHeader) == 32, "Unexpected TableHeader layout");
+
+// Where the content of each slot goes under each move, and the orientation
+// change it picks up on the way. Derived from CubieCube's move tables.
+struct PieceMoves {
+    int dest[NUM_MOVES][12];
+    int delta[NUM_MOVES][12];
+};
+
+PieceMoves buildPieceMoves(PatternTable::Kind kind) {
+    PieceMoves pm;
+    for (int m = 0; m < NUM_MOVES; ++m) {
+        CubieCube cube;
+        cube.applyMove(ALL_MOVES[m]);
+        if (kind == PatternTable::Kind::CORNERS) {
+            for (int i = 0; i < CubieCube::NUM_CORNERS; ++i) {
+                int src = cube.getCornerPermutation(i);
+                pm.dest[m][src] = i;
+                pm.delta[m][src] = cube.getCornerOrientation(i);
+            }
+        } else {
+            for (int i = 0; i < CubieCube::NUM_EDGES; ++i) {
+                int src = cube.getEdgePermutation(i);
+                pm.dest[m][src] = i;
+                pm.delta[m][src] = cube.getEdgeOrientation(i);
+            }
+        }
+    }
+    return pm;
+}
+
+const PieceMoves& pieceMoves(PatternTable::Kind kind) {
+    static const PieceMoves corners = buildPieceMoves(PatternTable::Kind::CORNERS);
+    static const PieceMoves edges = buildPieceMoves(PatternTable::Kind::EDGES);
+    return kind == PatternTable::Kind::CORNERS ? corners : edges;
+}
+
+uint64_t alignUp(uint64_t value) {
+    return (value + DATA_ALIGNMENT - 1) / DATA_ALIGNMENT * DATA_ALIGNMENT;
+}
+
+} // namespace
+
+PatternTable::PatternTable(Kind kind, const std::vector<int>& pieces)
+    : kind_(kind), pieces_(pieces) {
+    slots_ = kind == Kind::CORNERS ? CubieCube::NUM_CORNERS : CubieCube::NUM_EDGES;
+    orientations_ = kind == Kind::CORNERS ? 3 : 2;
+
+    if (pieces_.empty() || static_cast<int>(pieces_.size()) > slots_) {
+        throw std::invalid_argument("Invalid pattern piece count");
+    }
+    std::fill(tracked_, tracked_ + 12, -1);
+    int k = static_cast<int>(pieces_.size());
+    for (int t = 0; t < k; ++t) {
+        int p = pieces_[t];
+        if (p < 0 || p >= slots_ || tracked_[p] >= 0) {
+            throw std::invalid_argument("Invalid pattern piece");
+        }
+        tracked_[p] = t;
+    }
+
+    lastOriImplied_ = (k == slots_);
+
+    permutations_ = 1;
+    for (int t = 0; t < k; ++t) permutations_ *= static_cast<uint64_t>(slots_ - t);
+    orientationCount_ = 1;
+    for (int t = 0; t < (lastOriImplied_ ? k - 1 : k); ++t) orientationCount_ *= orientations_;
+    entries_ = permutations_ * orientationCount_;
+}
+
+void PatternTable::set(uint64_t idx, int value) {
+    uint8_t& byte = owned_[idx >> 1];
+    int shift = (idx & 1) * 4;
+    byte = static_cast<uint8_t>((byte & ~(0x0F << shift)) | ((value & 0x0F) << shift));
+}
+
+uint64_t PatternTable::rank(const int* pos, const int* ori) const {
+    int k = static_cast<int>(pieces_.size());
+
+    // Partial permutation: mixed radix over remaining free slots
+    uint64_t r = 0;
+    uint32_t used = 0;
+    for (int t = 0; t < k; ++t) {
+        int p = pos[t];
+        int smaller = __builtin_popcount(used & ((1u << p) - 1));
+        r = r * static_cast<uint64_t>(slots_ - t) + static_cast<uint64_t>(p - smaller);
+        used |= 1u << p;
+    }
+
+    uint64_t o = 0;
+    int n = lastOriImplied_ ? k - 1 : k;
+    for (int t = 0; t < n; ++t) o = o * orientations_ + ori[t];
+
+    return r * orientationCount_ + o;
+}
+
+void PatternTable::unrank(uint64_t idx, int* pos, int* ori) const {
+    int k = static_cast<int>(pieces_.size());
+    uint64_t o = idx % orientationCount_;
+    uint64_t r = idx / orientationCount_;
+
+    int n = lastOriImplied_ ? k - 1 : k;
+    int sum = 0;
+    for (int t = n - 1; t >= 0; --t) {
+        ori[t] = static_cast<int>(o % orientations_);
+        o /= orientations_;
+        sum += ori[t];
+    }
+    if (lastOriImplied_) {
+        ori[k - 1] = (orientations_ - sum % orientations_) % orientations_;
+    }
+
+    int digits[12];
+    for (int t = k - 1; t >= 0; --t) {
+        digits[t] = static_cast<int>(r % static_cast<uint64_t>(slots_ - t));
+        r /= static_cast<uint64_t>(slots_ - t);
+    }
+
+    uint32_t used = 0;
+    for (int t = 0; t < k; ++t) {
+        int d = digits[t];
+        for (int s = 0; s < slots_; ++s) {
+            if (used & (1u << s)) continue;
+            if (d-- == 0) {
+                pos[t] = s;
+                break;
+            }
+        }
+        used |= 1u << pos[t];
+    }
+}
+
+uint64_t PatternTable::index(const CubieCube& cube) const {
+    int pos[12], ori[12];
+    for (int s = 0; s < slots_; ++s) {
+        int cubie, o;
+        if (kind_ == Kind::CORNERS) {
+            cubie = cube.getCornerPermutation(s);
+            o = cube.getCornerOrientation(s);
+        } else {
+            cubie = cube.getEdgePermutation(s);
+            o = cube.getEdgeOrientation(s);
+        }
+        int t = tracked_[cubie];
+        if (t >= 0) {
+            pos[t] = s;
+            ori[t] = o;
+        }
+    }
+    return rank(pos, ori);
+}
+
+void PatternTable::generate(std::ostream* log) {
+    owned_.assign(getByteCount(), 0xFF);
+    data_ = nullptr;
+
+    const PieceMoves& pm = pieceMoves(kind_);
+    int k = static_cast<int>(pieces_.size());
+    int pos[12], ori[12];
+
+    for (int t = 0; t < k; ++t) {
+        pos[t] = pieces_[t];
+        ori[t] = 0;
+    }
+    set(rank(pos, ori), 0);
+
+    uint64_t filled = 1;
+    uint64_t levelCount = 1;
+    int depth = 0;
+
+    while (filled < entries_) {
+        // Once the frontier outgrows the unvisited set, it is cheaper to
+        // scan unvisited entries for a neighbour on the current level.
+        bool backward = levelCount > entries_ - filled;
+        uint64_t added = 0;
+
+        for (uint64_t idx = 0; idx < entries_; ++idx) {
+            int value = get(idx);
+            if (backward ? value != 0x0F : value != depth) continue;
+
+            unrank(idx, pos, ori);
+            for (int m = 0; m < NUM_MOVES; ++m) {
+                int npos[12], nori[12];
+                for (int t = 0; t < k; ++t) {
+                    npos[t] = pm.dest[m][pos[t]];
+                    nori[t] = (ori[t] + pm.delta[m][pos[t]]) % orientations_;
+                }
+                uint64_t next = rank(npos, nori);
+                if (backward) {
+                    if (get(next) == depth) {
+                        set(idx, depth + 1);
+                        added++;
+                        break;
+                    }
+                } else if (get(next) == 0x0F) {
+                    set(next, depth + 1);
+                    added++;
+                }
+            }
+        }
+
+        if (added == 0) break;
+        filled += added;
+        levelCount = added;
+        depth++;
+
+        if (log) {
+            *log << "  depth " << depth << ": " << added << " entries ("
+                 << filled << "/" << entries_ << ")\n" << std::flush;
+        }
+    }
+}
+
+PatternDatabase::~PatternDatabase() {
+    if (mapping_) {
+        munmap(mapping_, mappingSize_);
+    }
+}
+
+std::unique_ptr<PatternDatabase> PatternDatabase::createDefault() {
+    auto db = std::make_unique<PatternDatabase>();
+    db->addTable(PatternTable::Kind::CORNERS, {0, 1, 2, 3, 4, 5, 6, 7});
+    db->addTable(PatternTable::Kind::EDGES, {0, 1, 2, 3, 4, 5});
+    db->addTable(PatternTable::Kind::EDGES, {6, 7, 8, 9, 10, 11});
+    return db;
+}
+
+void PatternDatabase::addTable(PatternTable::Kind kind, const std::vector<int>& pieces) {
+    tables_.emplace_back(kind, pieces);
+}
+
+void PatternDatabase::generate(std::ostream* log) {
+    for (size_t i = 0; i < tables_.size(); ++i) {
+        if (log) {
+            *log << "Generating table " << (i + 1) << "/" << tables_.size() << " ("
+                 << (tables_[i].getKind() == PatternTable::Kind::CORNERS ? "corners" : "edges")
+                 << ", " << tables_[i].getEntryCount() << " entries)\n";
+        }
+        tables_[i].generate(log);
+    }
+}
+
+uint64_t PatternDatabase::getByteCount() const {
+    uint64_t total = 0;
+    for (const auto& table : tables_) total += table.getByteCount();
+    return total;
+}
+
+int PatternDatabase::estimate(const CubieCube& cube) const {
+    int h = 0;
+    for (const auto& table : tables_) {
+        h = std::max(h, table.lookup(cube));
+    }
+    return h;
+}
+
+void PatternDatabase::save(const std::string& path) const {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        throw std::runtime_error("Cannot open pattern database for writing: " + path);
+    }
+
+    FileHeader header;
+    std::memcpy(header.magic, FILE_MAGIC, sizeof(FILE_MAGIC));
+    header.version = FORMAT_VERSION;
+    header.tableCount = static_cast<uint32_t>(tables_.size());
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    uint64_t offset = alignUp(sizeof(FileHeader) + tables_.size() * sizeof(TableHeader));
+    std::vector<TableHeader> entries;
+    for (const auto& table : tables_) {
+        if (!table.data()) {
+            throw std::runtime_error("Pattern table has not been generated");
+        }
+        TableHeader th;
+        std::memset(&th, 0, sizeof(th));
+        th.kind = static_cast<uint8_t>(table.getKind());
+        th.pieceCount = static_cast<uint8_t>(table.getPieces().size());
+        for (size_t i = 0; i < table.getPieces().size(); ++i) {
+            th.pieces[i] = static_cast<uint8_t>(table.getPieces()[i]);
+        }
+        th.entries = table.getEntryCount();
+        th.offset = offset;
+        entries.push_back(th);
+        offset = alignUp(offset + table.getByteCount());
+    }
+    out.write(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(TableHeader));
+
+    for (size_t i = 0; i < tables_.size(); ++i) {
+        uint64_t pos = static_cast<uint64_t>(out.tellp());
+        std::vector<char> padding(entries[i].offset - pos, 0);
+        out.write(padding.data(), padding.size());
+        out.write(reinterpret_cast<const char*>(tables_[i].data()), tables_[i].getByteCount());
+    }
+
+    if (!out) {
+        throw std::runtime_error("Failed to write pattern database: " + path);
+    }
+}
+
+std::shared_ptr<const PatternDatabase> PatternDatabase::load(const std::string& path) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Cannot open pattern database: " + path);
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(FileHeader))) {
+        close(fd);
+        throw std::runtime_error("Invalid pattern database file: " + path);
+    }
+
+    size_t size = static_cast<size_t>(st.st_size);
+    void* mapping = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        throw std::runtime_error("Cannot map pattern database: " + path);
+    }
+
+    auto db = std::make_shared<PatternDatabase>();
+    db->mapping_ = mapping;
+    db->mappingSize_ = size;
+
+    const uint8_t* base = static_cast<const uint8_t*>(mapping);
+    FileHeader header;
+    std::memcpy(&header, base, sizeof(header));
+    if (std::memcmp(header.magic, FILE_MAGIC, sizeof(FILE_MAGIC)) != 0) {
+        throw std::runtime_error("Not a pattern database file: " + path);
+    }
+    if (header.version != FORMAT_VERSION) {
+        throw std::runtime_error("Unsupported pattern database version " +
+                                 std::to_string(header.version) + ": " + path);
+    }
+    if (sizeof(FileHeader) + header.tableCount * sizeof(TableHeader) > size) {
+        throw std::runtime_error("Truncated pattern database: " + path);
+    }
+
+    for (uint32_t i = 0; i < header.tableCount; ++i) {
+        TableHeader th;
+        std::memcpy(&th, base + sizeof(FileHeader) + i * sizeof(TableHeader), sizeof(th));
+        if (th.kind > static_cast<uint8_t>(PatternTable::Kind::EDGES) || th.pieceCount > 12) {
+            throw std::runtime_error("Corrupt pattern table header: " + path);
+        }
+
+        std::vector<int> pieces(th.pieces, th.pieces + th.pieceCount);
+        db->tables_.emplace_back(static_cast<PatternTable::Kind>(th.kind), pieces);
+        PatternTable& table = db->tables_.back();
+        if (table.getEntryCount() != th.entries || th.offset + table.getByteCount() > size) {
+            throw std::runtime_error("Corrupt pattern table header: " + path);
+        }
+        table.attach(base + th.offset);
+    }
+
+    // Tables are scanned at random; let the kernel know
+    madvise(mapping, size, MADV_RANDOM);
+    return db;
+}
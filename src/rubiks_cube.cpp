@@ -1,4 +1,6 @@
 #include "rubiks_cube.hpp"
+#include "scrambler.hpp"
+#include "json.hpp"
 #include <algorithm>
 #include <stdexcept>
 
@@ -12,193 +14,55 @@ RubiksCube::RubiksCube(const std::string& state) {
 
 void RubiksCube::reset() {
     // Initialize solved state: W=White, Y=Yellow, G=Green, B=Blue, R=Red, O=Orange
-    faces_[UP].fill('W');
-    faces_[DOWN].fill('Y');
-    faces_[FRONT].fill('G');
-    faces_[BACK].fill('B');
-    faces_[LEFT].fill('O');
-    faces_[RIGHT].fill('R');
-}
-
-bool RubiksCube::isSolved() const {
+    static const char COLORS[6] = {'W', 'Y', 'G', 'B', 'O', 'R'};
+    stickers_.fill(0);
     for (int f = 0; f < 6; ++f) {
-        char center = faces_[f][4];
-        for (int i = 0; i < 9; ++i) {
-            if (faces_[f][i] != center) return false;
-        }
-    }
-    return true;
-}
-
-void RubiksCube::scramble(int moves) {
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    auto allMoves = getAllMoves();
-    std::uniform_int_distribution<> dis(0, allMoves.size() - 1);
-    
-    for (int i = 0; i < moves; ++i) {
-        applyMove(allMoves[dis(gen)]);
+        std::fill_n(stickers_.begin() + f * 9, 9, COLORS[f]);
     }
 }
 
-void RubiksCube::rotateFaceClockwise(Face face) {
-    auto& f = faces_[face];
-    std::array<char, 9> temp = f;
-    f[0] = temp[6]; f[1] = temp[3]; f[2] = temp[0];
-    f[3] = temp[7]; f[4] = temp[4]; f[5] = temp[1];
-    f[6] = temp[8]; f[7] = temp[5]; f[8] = temp[2];
-}
-
-void RubiksCube::rotateFaceCounterClockwise(Face face) {
-    auto& f = faces_[face];
-    std::array<char, 9> temp = f;
-    f[0] = temp[2]; f[1] = temp[5]; f[2] = temp[8];
-    f[3] = temp[1]; f[4] = temp[4]; f[5] = temp[7];
-    f[6] = temp[0]; f[7] = temp[3]; f[8] = temp[6];
-}
-
-void RubiksCube::rotateFace180(Face face) {
-    rotateFaceClockwise(face);
-    rotateFaceClockwise(face);
-}
-
-void RubiksCube::rotateEdgesClockwise(
-    Face f1, int e1a, int e1b, int e1c,
-    Face f2, int e2a, int e2b, int e2c,
-    Face f3, int e3a, int e3b, int e3c,
-    Face f4, int e4a, int e4b, int e4c) {
-    
-    char temp1 = faces_[f1][e1a];
-    char temp2 = faces_[f1][e1b];
-    char temp3 = faces_[f1][e1c];
-    
-    faces_[f1][e1a] = faces_[f4][e4a];
-    faces_[f1][e1b] = faces_[f4][e4b];
-    faces_[f1][e1c] = faces_[f4][e4c];
-    
-    faces_[f4][e4a] = faces_[f3][e3a];
-    faces_[f4][e4b] = faces_[f3][e3b];
-    faces_[f4][e4c] = faces_[f3][e3c];
-    
-    faces_[f3][e3a] = faces_[f2][e2a];
-    faces_[f3][e3b] = faces_[f2][e2b];
-    faces_[f3][e3c] = faces_[f2][e2c];
-    
-    faces_[f2][e2a] = temp1;
-    faces_[f2][e2b] = temp2;
-    faces_[f2][e2c] = temp3;
-}
-
-void RubiksCube::moveU() {
-    rotateFaceClockwise(UP);
-    rotateEdgesClockwise(FRONT, 0, 1, 2, LEFT, 0, 1, 2, BACK, 0, 1, 2, RIGHT, 0, 1, 2);
-}
-
-void RubiksCube::moveUPrime() {
-    rotateFaceCounterClockwise(UP);
-    rotateEdgesClockwise(FRONT, 0, 1, 2, RIGHT, 0, 1, 2, BACK, 0, 1, 2, LEFT, 0, 1, 2);
-}
-
-void RubiksCube::moveU2() {
-    moveU();
-    moveU();
-}
-
-void RubiksCube::moveD() {
-    rotateFaceClockwise(DOWN);
-    rotateEdgesClockwise(FRONT, 6, 7, 8, RIGHT, 6, 7, 8, BACK, 6, 7, 8, LEFT, 6, 7, 8);
-}
-
-void RubiksCube::moveDPrime() {
-    rotateFaceCounterClockwise(DOWN);
-    rotateEdgesClockwise(FRONT, 6, 7, 8, LEFT, 6, 7, 8, BACK, 6, 7, 8, RIGHT, 6, 7, 8);
-}
-
-void RubiksCube::moveD2() {
-    moveD();
-    moveD();
-}
-
-void RubiksCube::moveF() {
-    rotateFaceClockwise(FRONT);
-    rotateEdgesClockwise(UP, 6, 7, 8, RIGHT, 0, 3, 6, DOWN, 2, 1, 0, LEFT, 8, 5, 2);
-}
-
-void RubiksCube::moveFPrime() {
-    rotateFaceCounterClockwise(FRONT);
-    rotateEdgesClockwise(UP, 6, 7, 8, LEFT, 8, 5, 2, DOWN, 2, 1, 0, RIGHT, 0, 3, 6);
-}
-
-void RubiksCube::moveF2() {
-    moveF();
-    moveF();
-}
-
-void RubiksCube::moveB() {
-    rotateFaceClockwise(BACK);
-    rotateEdgesClockwise(UP, 2, 1, 0, LEFT, 0, 3, 6, DOWN, 6, 7, 8, RIGHT, 8, 5, 2);
-}
-
-void RubiksCube::moveBPrime() {
-    rotateFaceCounterClockwise(BACK);
-    rotateEdgesClockwise(UP, 2, 1, 0, RIGHT, 8, 5, 2, DOWN, 6, 7, 8, LEFT, 0, 3, 6);
-}
-
-void RubiksCube::moveB2() {
-    moveB();
-    moveB();
-}
-
-void RubiksCube::moveL() {
-    rotateFaceClockwise(LEFT);
-    rotateEdgesClockwise(UP, 0, 3, 6, FRONT, 0, 3, 6, DOWN, 0, 3, 6, BACK, 8, 5, 2);
-}
-
-void RubiksCube::moveLPrime() {
-    rotateFaceCounterClockwise(LEFT);
-    rotateEdgesClockwise(UP, 0, 3, 6, BACK, 8, 5, 2, DOWN, 0, 3, 6, FRONT, 0, 3, 6);
-}
-
-void RubiksCube::moveL2() {
-    moveL();
-    moveL();
+bool RubiksCube::isSolved() const {
+    return FaceletKernel::mismatches(stickers_.data()) == 0;
 }
 
-void RubiksCube::moveR() {
-    rotateFaceClockwise(RIGHT);
-    rotateEdgesClockwise(UP, 8, 5, 2, BACK, 0, 3, 6, DOWN, 8, 5, 2, FRONT, 8, 5, 2);
+void RubiksCube::scramble(int moves) {
+    scramble(moves, Scrambler::randomSeed());
 }
 
-void RubiksCube::moveRPrime() {
-    rotateFaceCounterClockwise(RIGHT);
-    rotateEdgesClockwise(UP, 8, 5, 2, FRONT, 8, 5, 2, DOWN, 8, 5, 2, BACK, 0, 3, 6);
+void RubiksCube::scramble(int moves, uint64_t seed) {
+    Scrambler scrambler(seed);
+    for (Move move : scrambler.randomMoves(moves)) {
+        applyMove(move);
+    }
 }
 
-void RubiksCube::moveR2() {
-    moveR();
-    moveR();
+void RubiksCube::moveU() { applyMove(Move::U); }
+void RubiksCube::moveUPrime() { applyMove(Move::UPrime); }
+void RubiksCube::moveU2() { applyMove(Move::U2); }
+void RubiksCube::moveD() { applyMove(Move::D); }
+void RubiksCube::moveDPrime() { applyMove(Move::DPrime); }
+void RubiksCube::moveD2() { applyMove(Move::D2); }
+void RubiksCube::moveF() { applyMove(Move::F); }
+void RubiksCube::moveFPrime() { applyMove(Move::FPrime); }
+void RubiksCube::moveF2() { applyMove(Move::F2); }
+void RubiksCube::moveB() { applyMove(Move::B); }
+void RubiksCube::moveBPrime() { applyMove(Move::BPrime); }
+void RubiksCube::moveB2() { applyMove(Move::B2); }
+void RubiksCube::moveL() { applyMove(Move::L); }
+void RubiksCube::moveLPrime() { applyMove(Move::LPrime); }
+void RubiksCube::moveL2() { applyMove(Move::L2); }
+void RubiksCube::moveR() { applyMove(Move::R); }
+void RubiksCube::moveRPrime() { applyMove(Move::RPrime); }
+void RubiksCube::moveR2() { applyMove(Move::R2); }
+
+// Each move is one permutation of the sticker block (see FaceletKernel)
+void RubiksCube::applyMove(Move move) {
+    if (moveIndex(move) >= NUM_MOVES) throw std::invalid_argument("Invalid move id");
+    FaceletKernel::applyMove(stickers_.data(), move);
 }
 
 void RubiksCube::applyMove(const std::string& move) {
-    if (move == "U") moveU();
-    else if (move == "U'") moveUPrime();
-    else if (move == "U2") moveU2();
-    else if (move == "D") moveD();
-    else if (move == "D'") moveDPrime();
-    else if (move == "D2") moveD2();
-    else if (move == "F") moveF();
-    else if (move == "F'") moveFPrime();
-    else if (move == "F2") moveF2();
-    else if (move == "B") moveB();
-    else if (move == "B'") moveBPrime();
-    else if (move == "B2") moveB2();
-    else if (move == "L") moveL();
-    else if (move == "L'") moveLPrime();
-    else if (move == "L2") moveL2();
-    else if (move == "R") moveR();
-    else if (move == "R'") moveRPrime();
-    else if (move == "R2") moveR2();
-    else throw std::invalid_argument("Invalid move: " + move);
+    applyMove(moveFromString(move));
 }
 
 void RubiksCube::applyMoves(const std::vector<std::string>& moves) {
@@ -208,109 +72,79 @@ void RubiksCube::applyMoves(const std::vector<std::string>& moves) {
 }
 
 std::string RubiksCube::getInverseMove(const std::string& move) const {
-    if (move.size() == 2 && move[1] == '\'') return std::string(1, move[0]);
-    if (move.size() == 2 && move[1] == '2') return move;
-    return move + "'";
+    return moveToString(inverse(moveFromString(move)));
 }
 
 std::vector<std::string> RubiksCube::getAllMoves() {
-    return {"U", "U'", "U2", "D", "D'", "D2", "F", "F'", "F2", 
-            "B", "B'", "B2", "L", "L'", "L2", "R", "R'", "R2"};
+    return movesToStrings({ALL_MOVES.begin(), ALL_MOVES.end()});
 }
 
 std::vector<std::string> RubiksCube::getBasicMoves() {
-    return {"U", "U'", "D", "D'", "F", "F'", "B", "B'", "L", "L'", "R", "R'"};
+    return movesToStrings({BASIC_MOVES.begin(), BASIC_MOVES.end()});
 }
 
 std::string RubiksCube::toString() const {
-    std::stringstream ss;
-    for (int f = 0; f < 6; ++f) {
-        for (int i = 0; i < 9; ++i) {
-            ss << faces_[f][i];
-        }
-    }
-    return ss.str();
+    return std::string(stickers_.data(), FaceletKernel::STICKERS);
 }
 
 std::string RubiksCube::toJSON() const {
-    std::stringstream ss;
-    ss << "{\"faces\":{";
-    ss << "\"U\":[";
-    for (int i = 0; i < 9; ++i) {
-        ss << "\"" << faces_[UP][i] << "\"";
-        if (i < 8) ss << ",";
-    }
-    ss << "],\"D\":[";
-    for (int i = 0; i < 9; ++i) {
-        ss << "\"" << faces_[DOWN][i] << "\"";
-        if (i < 8) ss << ",";
-    }
-    ss << "],\"F\":[";
-    for (int i = 0; i < 9; ++i) {
-        ss << "\"" << faces_[FRONT][i] << "\"";
-        if (i < 8) ss << ",";
-    }
-    ss << "],\"B\":[";
-    for (int i = 0; i < 9; ++i) {
-        ss << "\"" << faces_[BACK][i] << "\"";
-        if (i < 8) ss << ",";
-    }
-    ss << "],\"L\":[";
-    for (int i = 0; i < 9; ++i) {
-        ss << "\"" << faces_[LEFT][i] << "\"";
-        if (i < 8) ss << ",";
-    }
-    ss << "],\"R\":[";
-    for (int i = 0; i < 9; ++i) {
-        ss << "\"" << faces_[RIGHT][i] << "\"";
-        if (i < 8) ss << ",";
+    std::string out;
+    out.reserve(256);
+    JSONWriter json(out);
+    json.beginObject();
+    writeJSON(json);
+    json.endObject();
+    return out;
+}
+
+void RubiksCube::writeJSON(JSONWriter& json, bool compact) const {
+    if (compact) {
+        json.member("state", std::string_view(stickers_.data(), FaceletKernel::STICKERS));
+    } else {
+        static const char* const NAMES[] = {"U", "D", "F", "B", "L", "R"};
+        json.key("faces").beginObject();
+        for (int face = 0; face < 6; ++face) {
+            json.key(NAMES[face]).beginArray();
+            for (int i = 0; i < 9; ++i) json.value(std::string_view(&stickers_[face * 9 + i], 1));
+            json.endArray();
+        }
+        json.endObject();
     }
-    ss << "]},\"isSolved\":" << (isSolved() ? "true" : "false") << "}";
-    return ss.str();
+    json.member("isSolved", isSolved());
 }
 
 void RubiksCube::fromString(const std::string& state) {
     if (state.length() != 54) {
         throw std::invalid_argument("State must be 54 characters");
     }
-    int idx = 0;
-    for (int f = 0; f < 6; ++f) {
-        for (int i = 0; i < 9; ++i) {
-            faces_[f][i] = state[idx++];
-        }
-    }
+    stickers_.fill(0);
+    std::copy(state.begin(), state.end(), stickers_.begin());
 }
 
 bool RubiksCube::operator==(const RubiksCube& other) const {
-    return faces_ == other.faces_;
+    return std::equal(stickers_.begin(), stickers_.begin() + FaceletKernel::STICKERS,
+                      other.stickers_.begin());
 }
 
 bool RubiksCube::operator!=(const RubiksCube& other) const {
     return !(*this == other);
 }
 
+// FNV-1a over the 54 stickers with a final avalanche; h*31+c left the six
+// possible colours clustered in a narrow range of values
 size_t RubiksCube::hash() const {
-    size_t h = 0;
-    for (const auto& face : faces_) {
-        for (char c : face) {
-            h = h * 31 + c;
-        }
+    uint64_t h = 0xCBF29CE484222325ULL;
+    for (int i = 0; i < FaceletKernel::STICKERS; ++i) {
+        h ^= static_cast<uint8_t>(stickers_[i]);
+        h *= 0x100000001B3ULL;
     }
-    return h;
+    h ^= h >> 33; h *= 0xFF51AFD7ED558CCDULL;
+    h ^= h >> 33;
+    return static_cast<size_t>(h);
 }
 
 int RubiksCube::getManhattanDistance() const {
-    int distance = 0;
-    
-    // Simple heuristic: count misplaced stickers
-    for (int f = 0; f < 6; ++f) {
-        char center = faces_[f][4];
-        for (int i = 0; i < 9; ++i) {
-            if (i != 4 && faces_[f][i] != center) {
-                distance++;
-            }
-        }
-    }
-    
+    // Simple heuristic: count misplaced stickers (a center never is)
+    int distance = __builtin_popcountll(FaceletKernel::mismatches(stickers_.data()));
     return distance / 8; // Divide by 8 as each move affects ~8 stickers
 }
\ No newline at end of file
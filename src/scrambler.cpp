@@ -0,0 +1,100 @@
+#include "scrambler.hpp"
+#include <algorithm>
+#include <utility>
+
+Scrambler::Scrambler(uint64_t seed) {
+    this->seed(seed);
+}
+
+void Scrambler::seed(uint64_t seed) {
+    seed_ = seed;
+    rng_.seed(seed);
+}
+
+std::vector<Move> Scrambler::randomMoves(int length, bool quarterTurnsOnly) {
+    std::vector<Move> moves;
+    moves.reserve(std::max(0, length));
+    int lastFace = -1;
+    while (static_cast<int>(moves.size()) < length) {
+        int face = static_cast<int>(uniform(6));
+        if (face == lastFace) continue;
+        // Opposite faces commute; keep only the order with the lower face first
+        if (lastFace >= 0 && face / 2 == lastFace / 2 && face < lastFace) continue;
+        int turn = static_cast<int>(uniform(quarterTurnsOnly ? 2 : 3));
+        moves.push_back(static_cast<Move>(face * 3 + turn));
+        lastFace = face;
+    }
+    return moves;
+}
+
+// Random permutations, twists and flips, constrained the three ways every
+// reachable cube is: corner and edge permutation parities agree, twists sum
+// to 0 mod 3 and flips to 0 mod 2. Each constrained class is hit equally.
+CubieCube Scrambler::randomState() {
+    int corners[CubieCube::NUM_CORNERS];
+    int edges[CubieCube::NUM_EDGES];
+    for (int i = 0; i < CubieCube::NUM_CORNERS; ++i) corners[i] = i;
+    for (int i = 0; i < CubieCube::NUM_EDGES; ++i) edges[i] = i;
+
+    // Fisher-Yates; every actual swap flips the parity
+    int parity = 0;
+    for (int i = CubieCube::NUM_CORNERS - 1; i > 0; --i) {
+        int j = static_cast<int>(uniform(i + 1));
+        if (j != i) {
+            std::swap(corners[i], corners[j]);
+            parity ^= 1;
+        }
+    }
+    for (int i = CubieCube::NUM_EDGES - 1; i > 0; --i) {
+        int j = static_cast<int>(uniform(i + 1));
+        if (j != i) {
+            std::swap(edges[i], edges[j]);
+            parity ^= 1;
+        }
+    }
+    // An odd total pairs odd with even permutations; one more edge swap is a
+    // bijection onto the matching class, so the result stays uniform
+    if (parity) std::swap(edges[0], edges[1]);
+
+    CubieCube cube;
+    int twistSum = 0;
+    for (int i = 0; i < CubieCube::NUM_CORNERS - 1; ++i) {
+        int twist = static_cast<int>(uniform(3));
+        twistSum += twist;
+        cube.setCorner(i, corners[i], twist);
+    }
+    cube.setCorner(CubieCube::NUM_CORNERS - 1, corners[CubieCube::NUM_CORNERS - 1], (3 - twistSum % 3) % 3);
+
+    int flipSum = 0;
+    for (int i = 0; i < CubieCube::NUM_EDGES - 1; ++i) {
+        int flip = static_cast<int>(uniform(2));
+        flipSum += flip;
+        cube.setEdge(i, edges[i], flip);
+    }
+    cube.setEdge(CubieCube::NUM_EDGES - 1, edges[CubieCube::NUM_EDGES - 1], flipSum % 2);
+    return cube;
+}
+
+// Rejection sampling: drop the top partial block of 2^64 so every residue
+// is equally likely
+uint64_t Scrambler::uniform(uint64_t n) {
+    const uint64_t limit = UINT64_MAX - UINT64_MAX % n;
+    uint64_t x;
+    do {
+        x = rng_();
+    } while (x >= limit);
+    return x % n;
+}
+
+uint64_t Scrambler::randomSeed() {
+    std::random_device device;
+    return (static_cast<uint64_t>(device()) << 32) ^ device();
+}
+
+// splitmix64 of the pair, so neighbouring streams get unrelated seeds
+uint64_t Scrambler::streamSeed(uint64_t seed, uint64_t stream) {
+    uint64_t z = seed + 0x9E3779B97F4A7C15ULL * (stream + 1);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
@@ -0,0 +1,104 @@
+#include "session_store.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <system_error>
+#include <sys/random.h>
+#include <unistd.h>
+
+constexpr std::chrono::seconds SessionStore::DEFAULT_TTL;
+
+SessionStore::SessionStore(size_t maxSessions, std::chrono::seconds ttl, size_t numShards)
+    : perShard_(0), ttl_(ttl) {
+    if (numShards == 0) numShards = 1;
+    perShard_ = std::max<size_t>(1, (maxSessions + numShards - 1) / numShards);
+    shards_.reserve(numShards);
+    for (size_t i = 0; i < numShards; ++i) {
+        shards_.push_back(std::make_unique<Shard>());
+    }
+}
+
+std::string SessionStore::create() {
+    std::string id = generateId();
+    Shard& shard = shardFor(id);
+    auto now = Clock::now();
+
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    evictExpired(shard, now);
+    if (shard.lru.size() >= perShard_) {
+        shard.index.erase(shard.lru.back().id);
+        shard.lru.pop_back();
+    }
+
+    shard.lru.push_front(Session{id, RubiksCube(), now});
+    shard.index[id] = shard.lru.begin();
+    return id;
+}
+
+bool SessionStore::withSession(const std::string& id, const std::function<void(RubiksCube&)>& fn) {
+    Shard& shard = shardFor(id);
+    auto now = Clock::now();
+
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.index.find(id);
+    if (it == shard.index.end()) return false;
+
+    if (now - it->second->lastUsed > ttl_) {
+        shard.lru.erase(it->second);
+        shard.index.erase(it);
+        return false;
+    }
+
+    it->second->lastUsed = now;
+    shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+    fn(it->second->cube);
+    return true;
+}
+
+bool SessionStore::erase(const std::string& id) {
+    Shard& shard = shardFor(id);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.index.find(id);
+    if (it == shard.index.end()) return false;
+    shard.lru.erase(it->second);
+    shard.index.erase(it);
+    return true;
+}
+
+size_t SessionStore::size() const {
+    size_t total = 0;
+    for (const auto& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        total += shard->lru.size();
+    }
+    return total;
+}
+
+SessionStore::Shard& SessionStore::shardFor(const std::string& id) {
+    return *shards_[std::hash<std::string>{}(id) % shards_.size()];
+}
+
+// The LRU tail is the oldest entry, so expired sessions are trimmed from there
+void SessionStore::evictExpired(Shard& shard, Clock::time_point now) {
+    while (!shard.lru.empty() && now - shard.lru.back().lastUsed > ttl_) {
+        shard.index.erase(shard.lru.back().id);
+        shard.lru.pop_back();
+    }
+}
+
+// 128 bits from the kernel's CSPRNG as 32 hex digits. Ids are bearer
+// tokens, so no user-space generator whose state could be recovered from
+// the ids it has handed out.
+std::string SessionStore::generateId() {
+    unsigned char bytes[16];
+    if (getentropy(bytes, sizeof(bytes)) != 0) {
+        throw std::system_error(errno, std::generic_category(), "getentropy");
+    }
+    static const char* digits = "0123456789abcdef";
+
+    std::string id(32, '0');
+    for (size_t i = 0; i < sizeof(bytes); ++i) {
+        id[2 * i] = digits[bytes[i] >> 4];
+        id[2 * i + 1] = digits[bytes[i] & 0xF];
+    }
+    return id;
+}
@@ -0,0 +1,244 @@
+#include "solution_cache.hpp"
+#include "cube_symmetry.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+namespace {
+
+const char FILE_MAGIC[8] = {'R', 'C', 'S', 'O', 'L', 'C', 0, 0};
+
+struct FileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t entryCount;
+};
+
+// Followed by `length` move ids
+struct EntryHeader {
+    uint32_t solver;
+    uint8_t cube[sizeof(CubieCube)];
+    uint8_t length;
+};
+
+} // namespace
+
+SolutionCache::SolutionCache(size_t capacity, size_t numShards)
+    : perShard_(0) {
+    if (numShards == 0) numShards = 1;
+    perShard_ = std::max<size_t>(1, (capacity + numShards - 1) / numShards);
+    shards_.reserve(numShards);
+    for (size_t i = 0; i < numShards; ++i) {
+        shards_.push_back(std::make_unique<Shard>());
+    }
+}
+
+bool SolutionCache::lookup(const std::string& solver, const RubiksCube& cube, int maxDepth,
+                           std::vector<std::string>& solution) {
+    int sym;
+    Key key;
+    try {
+        key = Key{solverId(solver), CubieCube::fromFacelets(CubeSymmetry::canonical(cube, &sym))};
+    } catch (const std::invalid_argument&) {
+        return false;  // unreachable states are never cached
+    }
+
+    std::vector<Move> canonicalSolution;
+    {
+        Shard& shard = shardFor(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto it = shard.index.find(key);
+        if (it == shard.index.end() ||
+            it->second->solution.size() > static_cast<size_t>(std::max(0, maxDepth))) {
+            misses_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+        canonicalSolution = it->second->solution;
+    }
+
+    hits_.fetch_add(1, std::memory_order_relaxed);
+    solution = movesToStrings(CubeSymmetry::mapMoves(CubeSymmetry::inverse(sym), canonicalSolution));
+    return true;
+}
+
+void SolutionCache::store(const std::string& solver, const RubiksCube& cube,
+                          const std::vector<std::string>& solution) {
+    // The file stores lengths in one byte
+    if (solution.empty() || solution.size() > 255) return;
+
+    int sym;
+    Key key;
+    std::vector<Move> moves;
+    try {
+        key = Key{solverId(solver), CubieCube::fromFacelets(CubeSymmetry::canonical(cube, &sym))};
+        for (const auto& move : solution) moves.push_back(moveFromString(move));
+    } catch (const std::invalid_argument&) {
+        return;
+    }
+    insert(key, CubeSymmetry::mapMoves(sym, moves));
+}
+
+void SolutionCache::insert(const Key& key, std::vector<Move> solution) {
+    Shard& shard = shardFor(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+
+    auto it = shard.index.find(key);
+    if (it != shard.index.end()) {
+        if (solution.size() < it->second->solution.size()) {
+            it->second->solution = std::move(solution);
+        }
+        shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+        return;
+    }
+
+    if (shard.lru.size() >= perShard_) {
+        shard.index.erase(shard.lru.back().key);
+        shard.lru.pop_back();
+    }
+    shard.lru.push_front(Entry{key, std::move(solution)});
+    shard.index[key] = shard.lru.begin();
+}
+
+// Written to a temporary file and renamed, so a crash never leaves a torn cache
+void SolutionCache::save(const std::string& path) const {
+    const std::string tmpPath = path + ".tmp";
+    std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        throw std::runtime_error("Cannot open solution cache for writing: " + tmpPath);
+    }
+
+    FileHeader header{};
+    std::memcpy(header.magic, FILE_MAGIC, sizeof(FILE_MAGIC));
+    header.version = FORMAT_VERSION;
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    // Oldest first, so loading the file restores the LRU order
+    uint32_t count = 0;
+    for (const auto& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        for (auto it = shard->lru.rbegin(); it != shard->lru.rend(); ++it) {
+            EntryHeader entry{};
+            entry.solver = it->key.solver;
+            std::memcpy(entry.cube, &it->key.cube, sizeof(CubieCube));
+            entry.length = static_cast<uint8_t>(it->solution.size());
+            out.write(reinterpret_cast<const char*>(&entry), sizeof(entry));
+            out.write(reinterpret_cast<const char*>(it->solution.data()), it->solution.size());
+            count++;
+        }
+    }
+
+    header.entryCount = count;
+    out.seekp(0);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.close();
+    if (!out) {
+        throw std::runtime_error("Failed to write solution cache: " + tmpPath);
+    }
+    if (std::rename(tmpPath.c_str(), path.c_str()) != 0) {
+        throw std::runtime_error("Cannot replace solution cache: " + path);
+    }
+}
+
+size_t SolutionCache::load(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        throw std::runtime_error("Cannot open solution cache: " + path);
+    }
+
+    FileHeader header;
+    if (!in.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+        std::memcmp(header.magic, FILE_MAGIC, sizeof(FILE_MAGIC)) != 0) {
+        throw std::runtime_error("Not a solution cache file: " + path);
+    }
+    if (header.version != FORMAT_VERSION) {
+        throw std::runtime_error("Unsupported solution cache version " +
+                                 std::to_string(header.version) + ": " + path);
+    }
+
+    for (uint32_t i = 0; i < header.entryCount; ++i) {
+        EntryHeader entry;
+        std::vector<Move> solution;
+        if (in.read(reinterpret_cast<char*>(&entry), sizeof(entry))) {
+            solution.resize(entry.length);
+            in.read(reinterpret_cast<char*>(solution.data()), entry.length);
+        }
+        if (!in) {
+            throw std::runtime_error("Truncated solution cache: " + path);
+        }
+        for (Move m : solution) {
+            if (moveIndex(m) >= NUM_MOVES) {
+                throw std::runtime_error("Corrupt solution cache: " + path);
+            }
+        }
+
+        Key key{entry.solver, CubieCube()};
+        std::memcpy(&key.cube, entry.cube, sizeof(CubieCube));
+        insert(key, std::move(solution));
+    }
+    return header.entryCount;
+}
+
+void SolutionCache::clear() {
+    for (const auto& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        shard->lru.clear();
+        shard->index.clear();
+    }
+    hits_ = 0;
+    misses_ = 0;
+}
+
+size_t SolutionCache::size() const {
+    size_t total = 0;
+    for (const auto& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        total += shard->lru.size();
+    }
+    return total;
+}
+
+SolutionCache::Shard& SolutionCache::shardFor(const Key& key) {
+    return *shards_[KeyHash{}(key) % shards_.size()];
+}
+
+// FNV-1a, so ids in a saved file stay valid across builds
+uint32_t SolutionCache::solverId(const std::string& solver) {
+    uint32_t h = 2166136261u;
+    for (char c : solver) {
+        h ^= static_cast<uint8_t>(c);
+        h *= 16777619u;
+    }
+    return h;
+}
+
+CachedSolver::CachedSolver(std::unique_ptr<Solver> inner, std::shared_ptr<SolutionCache> cache)
+    : inner_(std::move(inner)), cache_(std::move(cache)) {
+}
+
+std::vector<std::string> CachedSolver::solve(RubiksCube& cube, int maxDepth) {
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::string> solution;
+
+    lastHit_ = cache_->lookup(inner_->getName(), cube, maxDepth, solution);
+    if (lastHit_) {
+        nodesExplored_ = 0;
+        solveTime_ = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        stats_ = SolveStats{};
+        stats_.solver = inner_->getName();
+        stats_.solved = true;
+        stats_.cached = true;
+        stats_.solutionLength = static_cast<int>(solution.size());
+        stats_.time = solveTime_;
+        return solution;
+    }
+
+    solution = inner_->solve(cube, maxDepth);
+    nodesExplored_ = inner_->getNodesExplored();
+    solveTime_ = inner_->getSolveTime();
+    stats_ = inner_->getStats();
+    cache_->store(inner_->getName(), cube, solution);
+    return solution;
+}
@@ -0,0 +1,142 @@
+// src/solve_stats.cpp - Per-solve statistics and their Prometheus totals
+#include "solve_stats.hpp"
+#include "json.hpp"
+#include <iomanip>
+#include <sstream>
+
+void SearchCounters::add(const SearchCounters& other) {
+    nodes += other.nodes;
+    heuristicEvaluations += other.heuristicEvaluations;
+    boundCutoffs += other.boundCutoffs;
+    sequencePruned += other.sequencePruned;
+    tableProbes += other.tableProbes;
+    tableCutoffs += other.tableCutoffs;
+    for (int depth = 0; depth < MAX_DEPTH; ++depth) {
+        nodesPerDepth[depth] += other.nodesPerDepth[depth];
+    }
+}
+
+void SolveStats::setCounters(const SearchCounters& counters) {
+    nodes = counters.nodes;
+    heuristicEvaluations = counters.heuristicEvaluations;
+    boundCutoffs = counters.boundCutoffs;
+    sequencePruned = counters.sequencePruned;
+    tableProbes = counters.tableProbes;
+    tableCutoffs = counters.tableCutoffs;
+    int depths = SearchCounters::MAX_DEPTH;
+    while (depths > 0 && counters.nodesPerDepth[depths - 1] == 0) --depths;
+    nodesPerDepth.assign(counters.nodesPerDepth.begin(), counters.nodesPerDepth.begin() + depths);
+}
+
+namespace {
+
+void writeList(JSONWriter& json, const std::vector<uint64_t>& values) {
+    json.beginArray();
+    for (uint64_t value : values) json.value(value);
+    json.endArray();
+}
+
+// Label values are solver names; escape what the format requires
+std::string escapeLabel(const std::string& value) {
+    std::string out;
+    for (char c : value) {
+        if (c == '\\' || c == '"') out += '\\';
+        if (c == '\n') {
+            out += "\\n";
+            continue;
+        }
+        out += c;
+    }
+    return out;
+}
+
+} // namespace
+
+std::string SolveStats::toJSON() const {
+    std::string out;
+    out.reserve(512);
+    JSONWriter json(out);
+    json.beginObject();
+    writeJSON(json);
+    json.endObject();
+    return out;
+}
+
+void SolveStats::writeJSON(JSONWriter& json) const {
+    json.member("solved", solved).member("stopped", stopped).member("cached", cached)
+        .member("solutionLength", solutionLength).member("time", time, 6)
+        .member("nodes", nodes).member("nodesPerSecond", nodesPerSecond(), 1)
+        .member("heuristicEvaluations", heuristicEvaluations).member("boundCutoffs", boundCutoffs)
+        .member("sequencePruned", sequencePruned).member("tableProbes", tableProbes)
+        .member("tableCutoffs", tableCutoffs);
+    writeList(json.key("nodesPerDepth"), nodesPerDepth);
+    json.key("iterations").beginArray();
+    for (const IterationStats& iteration : iterations) {
+        json.beginObject().member("threshold", iteration.threshold).member("nodes", iteration.nodes)
+            .member("seconds", iteration.seconds, 6).endObject();
+    }
+    json.endArray();
+    writeList(json.key("workerNodes"), workerNodes);
+}
+
+void SolveMetrics::record(const SolveStats& stats) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Totals& totals = totals_[stats.solver];
+    totals.solves++;
+    if (stats.solved) totals.solved++;
+    if (stats.stopped) totals.stopped++;
+    if (stats.cached) totals.cached++;
+    totals.seconds += stats.time;
+    totals.nodes += stats.nodes;
+    totals.heuristicEvaluations += stats.heuristicEvaluations;
+    totals.boundCutoffs += stats.boundCutoffs;
+    totals.sequencePruned += stats.sequencePruned;
+    totals.tableProbes += stats.tableProbes;
+    totals.tableCutoffs += stats.tableCutoffs;
+}
+
+std::string SolveMetrics::toPrometheus() const {
+    struct Series {
+        const char* name;
+        const char* help;
+        const char* type;
+        double (*value)(const Totals&);
+    };
+    static const Series SERIES[] = {
+        {"rubiks_solves_total", "Solves run, by solver", "counter",
+         [](const Totals& t) { return static_cast<double>(t.solves); }},
+        {"rubiks_solves_solved_total", "Solves that found a solution", "counter",
+         [](const Totals& t) { return static_cast<double>(t.solved); }},
+        {"rubiks_solves_stopped_total", "Solves stopped by a deadline or cancel", "counter",
+         [](const Totals& t) { return static_cast<double>(t.stopped); }},
+        {"rubiks_solves_cached_total", "Solves answered from the solution cache", "counter",
+         [](const Totals& t) { return static_cast<double>(t.cached); }},
+        {"rubiks_solve_seconds_total", "Wall time spent solving", "counter",
+         [](const Totals& t) { return t.seconds; }},
+        {"rubiks_search_nodes_total", "Search nodes expanded", "counter",
+         [](const Totals& t) { return static_cast<double>(t.nodes); }},
+        {"rubiks_heuristic_evaluations_total", "Heuristic evaluations", "counter",
+         [](const Totals& t) { return static_cast<double>(t.heuristicEvaluations); }},
+        {"rubiks_bound_cutoffs_total", "Nodes cut off by the IDA* threshold", "counter",
+         [](const Totals& t) { return static_cast<double>(t.boundCutoffs); }},
+        {"rubiks_sequence_pruned_moves_total", "Moves skipped as redundant sequences", "counter",
+         [](const Totals& t) { return static_cast<double>(t.sequencePruned); }},
+        {"rubiks_table_probes_total", "Transposition table lookups", "counter",
+         [](const Totals& t) { return static_cast<double>(t.tableProbes); }},
+        {"rubiks_table_cutoffs_total", "Nodes pruned by a transposition table bound", "counter",
+         [](const Totals& t) { return static_cast<double>(t.tableCutoffs); }},
+    };
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::ostringstream out;
+    out << std::setprecision(17);
+    for (const Series& series : SERIES) {
+        out << "# HELP " << series.name << " " << series.help << "\n";
+        out << "# TYPE " << series.name << " " << series.type << "\n";
+        for (const auto& entry : totals_) {
+            out << series.name << "{solver=\"" << escapeLabel(entry.first) << "\"} "
+                << series.value(entry.second) << "\n";
+        }
+    }
+    return out.str();
+}
@@ -0,0 +1,78 @@
+// src/solver.cpp - Batch solving shared by every solver
+#include "solver.hpp"
+#include "thread_placement.hpp"
+#include <exception>
+#include <mutex>
+
+#ifdef HAVE_OPENMP
+#include <omp.h>
+#endif
+
+namespace {
+
+BatchResult solveOne(Solver& solver, const RubiksCube& cube, size_t index, int maxDepth) {
+    BatchResult result{index, false, {}, 0, 0.0, {}, {}};
+    if (cube.isSolved()) {
+        result.success = true;
+        return result;
+    }
+    try {
+        RubiksCube copy = cube;
+        result.solution = solver.solve(copy, maxDepth);
+        result.success = !result.solution.empty() || cube.isSolved();
+        result.nodes = solver.getNodesExplored();
+        result.time = solver.getSolveTime();
+        result.stats = solver.getStats();
+    } catch (const std::exception& e) {
+        result.error = e.what();
+    }
+    return result;
+}
+
+} // namespace
+
+void Solver::solveBatch(const std::vector<RubiksCube>& cubes, const BatchCallback& onResult,
+                        int maxDepth, int numThreads) {
+    if (numThreads <= 0) {
+        numThreads = ThreadPlacement::get().threads();
+    }
+    numThreads = static_cast<int>(std::min<size_t>(numThreads, std::max<size_t>(cubes.size(), 1)));
+
+    if (numThreads == 1 || !canClone()) {
+        for (size_t i = 0; i < cubes.size(); ++i) {
+            onResult(solveOne(*this, cubes[i], i, maxDepth));
+        }
+        return;
+    }
+
+    // Finished results wait here until every earlier one has been handed on
+    std::vector<BatchResult> pending(cubes.size());
+    std::vector<char> ready(cubes.size(), 0);
+    size_t next = 0;
+    std::mutex mutex;
+    const long count = static_cast<long>(cubes.size());
+
+    #pragma omp parallel num_threads(numThreads)
+    {
+        // Pinned before the clone, so its buffers are allocated on the
+        // thread's node
+#ifdef HAVE_OPENMP
+        ThreadPlacement::get().bindThread(omp_get_thread_num(), omp_get_num_threads());
+#endif
+        std::unique_ptr<Solver> solver = clone();
+
+        // dynamic: solve times vary by orders of magnitude between positions
+        #pragma omp for schedule(dynamic, 1)
+        for (long i = 0; i < count; ++i) {
+            BatchResult result = solveOne(*solver, cubes[i], static_cast<size_t>(i), maxDepth);
+            std::lock_guard<std::mutex> lock(mutex);
+            pending[i] = std::move(result);
+            ready[i] = 1;
+            while (next < cubes.size() && ready[next]) {
+                onResult(pending[next]);
+                pending[next] = BatchResult{};
+                ++next;
+            }
+        }
+    }
+}
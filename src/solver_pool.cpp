@@ -0,0 +1,77 @@
+// src/solver_pool.cpp - Reusable solver instances
+#include "solver_pool.hpp"
+#include <algorithm>
+
+SolverPool::Lease& SolverPool::Lease::operator=(Lease&& other) noexcept {
+    if (this != &other) {
+        release();
+        pool_ = other.pool_;
+        kind_ = std::move(other.kind_);
+        solver_ = std::move(other.solver_);
+        other.pool_ = nullptr;
+    }
+    return *this;
+}
+
+void SolverPool::Lease::release() {
+    if (pool_ && solver_) pool_->release(kind_, std::move(solver_));
+    pool_ = nullptr;
+}
+
+SolverPool::Lease SolverPool::acquire(const std::string& kind, const Factory& create) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = idle_.find(kind);
+        if (it != idle_.end() && !it->second.empty()) {
+            std::unique_ptr<Solver> solver = std::move(it->second.back());
+            it->second.pop_back();
+            ++reused_;
+            return Lease(this, kind, std::move(solver));
+        }
+        ++created_;
+    }
+    // Built outside the lock; a factory may be slow
+    return Lease(this, kind, create());
+}
+
+void SolverPool::reserve(const std::string& kind, const Factory& create, size_t count) {
+    while (true) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto& instances = idle_[kind];
+            if (instances.size() >= std::min(count, MAX_IDLE_PER_KIND)) return;
+            instances.reserve(std::min(count, MAX_IDLE_PER_KIND));
+            ++created_;
+        }
+        add(kind, create());
+    }
+}
+
+void SolverPool::add(const std::string& kind, std::unique_ptr<Solver> solver) {
+    release(kind, std::move(solver));
+}
+
+void SolverPool::release(const std::string& kind, std::unique_ptr<Solver> solver) {
+    solver->setCancellationToken(idleToken_);
+    solver->setProgressCallback(nullptr);
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& instances = idle_[kind];
+    if (instances.size() < MAX_IDLE_PER_KIND) instances.push_back(std::move(solver));
+}
+
+size_t SolverPool::idle() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t count = 0;
+    for (const auto& entry : idle_) count += entry.second.size();
+    return count;
+}
+
+uint64_t SolverPool::getCreated() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return created_;
+}
+
+uint64_t SolverPool::getReused() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return reused_;
+}
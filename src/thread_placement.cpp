@@ -0,0 +1,318 @@
+// src/thread_placement.cpp - CPU topology, rank shares and thread pinning
+#include "thread_placement.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+#ifdef __linux__
+#include <dirent.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+// "0-3,8,10-11" as in sysfs
+std::vector<int> parseCpuList(const std::string& list) {
+    std::vector<int> ids;
+    std::stringstream in(list);
+    std::string range;
+    while (std::getline(in, range, ',')) {
+        if (range.empty() || range == "\n") continue;
+        size_t dash = range.find('-');
+        try {
+            int first = std::stoi(range.substr(0, dash));
+            int last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+            for (int id = first; id <= last; ++id) ids.push_back(id);
+        } catch (const std::exception&) {
+            return {};
+        }
+    }
+    return ids;
+}
+
+std::string formatCpuList(std::vector<int> ids) {
+    std::sort(ids.begin(), ids.end());
+    std::ostringstream out;
+    for (size_t i = 0; i < ids.size();) {
+        size_t j = i;
+        while (j + 1 < ids.size() && ids[j + 1] == ids[j] + 1) ++j;
+        if (i > 0) out << ',';
+        out << ids[i];
+        if (j > i) out << '-' << ids[j];
+        i = j + 1;
+    }
+    return out.str();
+}
+
+bool readLine(const std::string& path, std::string& line) {
+    std::ifstream in(path);
+    return static_cast<bool>(std::getline(in, line));
+}
+
+int readInt(const std::string& path, int fallback) {
+    std::string line;
+    if (!readLine(path, line)) return fallback;
+    try {
+        return std::stoi(line);
+    } catch (const std::exception&) {
+        return fallback;
+    }
+}
+
+std::vector<int> onlineCpus() {
+    std::string line;
+    std::vector<int> ids;
+    if (readLine("/sys/devices/system/cpu/online", line)) ids = parseCpuList(line);
+    if (ids.empty()) {
+        int count = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+        for (int id = 0; id < count; ++id) ids.push_back(id);
+    }
+    return ids;
+}
+
+std::vector<int> allowedCpus(const std::vector<int>& online) {
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+        std::vector<int> ids;
+        for (int id : online) {
+            if (id < CPU_SETSIZE && CPU_ISSET(id, &set)) ids.push_back(id);
+        }
+        if (!ids.empty()) return ids;
+    }
+#endif
+    return online;
+}
+
+// CPU id -> NUMA node, from /sys/devices/system/node/node*/cpulist
+std::map<int, int> cpuNodes() {
+    std::map<int, int> nodes;
+#ifdef __linux__
+    const std::string root = "/sys/devices/system/node";
+    if (DIR* dir = opendir(root.c_str())) {
+        while (dirent* entry = readdir(dir)) {
+            std::string name = entry->d_name;
+            if (name.compare(0, 4, "node") != 0 || name.size() == 4 ||
+                name.find_first_not_of("0123456789", 4) != std::string::npos) {
+                continue;
+            }
+            int node = std::stoi(name.substr(4));
+            std::string line;
+            if (!readLine(root + "/" + name + "/cpulist", line)) continue;
+            for (int id : parseCpuList(line)) nodes[id] = node;
+        }
+        closedir(dir);
+    }
+#endif
+    return nodes;
+}
+
+std::vector<ThreadPlacement::Cpu> describeCpus(const std::vector<int>& ids) {
+    std::map<int, int> nodes = cpuNodes();
+    std::vector<ThreadPlacement::Cpu> cpus;
+    for (int id : ids) {
+        std::string topology = "/sys/devices/system/cpu/cpu" + std::to_string(id) + "/topology/";
+        int package = readInt(topology + "physical_package_id", 0);
+        int core = readInt(topology + "core_id", id);
+        auto node = nodes.find(id);
+        cpus.push_back({id, node == nodes.end() ? 0 : node->second, (package << 16) | core, 0});
+    }
+    // Hardware threads of one core, numbered in id order
+    std::map<int, int> seen;
+    for (ThreadPlacement::Cpu& cpu : cpus) cpu.sibling = seen[cpu.core]++;
+    return cpus;
+}
+
+// Ranks split the cores in contiguous runs (node order first). With fewer
+// cores than ranks they split hardware threads, and with fewer of those
+// too, ranks share CPUs round-robin.
+std::vector<ThreadPlacement::Cpu> shareOf(std::vector<ThreadPlacement::Cpu> cpus, int rank, int ranks) {
+    using Cpu = ThreadPlacement::Cpu;
+    std::sort(cpus.begin(), cpus.end(), [](const Cpu& a, const Cpu& b) {
+        if (a.node != b.node) return a.node < b.node;
+        if (a.core != b.core) return a.core < b.core;
+        return a.id < b.id;
+    });
+    std::vector<std::vector<Cpu>> units;
+    for (const Cpu& cpu : cpus) {
+        if (units.empty() || units.back().front().core != cpu.core) units.emplace_back();
+        units.back().push_back(cpu);
+    }
+    if (static_cast<int>(units.size()) < ranks) {
+        units.clear();
+        for (const Cpu& cpu : cpus) units.push_back({cpu});
+    }
+    int count = static_cast<int>(units.size());
+    if (count < ranks) return units[rank % count];
+
+    std::vector<Cpu> share;
+    for (int i = rank * count / ranks; i < (rank + 1) * count / ranks; ++i) {
+        share.insert(share.end(), units[i].begin(), units[i].end());
+    }
+    return share;
+}
+
+// Binding order: first hardware thread of every core before any second
+// one; within that, by node then core (close) or alternating nodes (spread)
+void orderForBinding(std::vector<ThreadPlacement::Cpu>& cpus, ThreadBinding binding) {
+    using Cpu = ThreadPlacement::Cpu;
+    std::sort(cpus.begin(), cpus.end(), [](const Cpu& a, const Cpu& b) {
+        if (a.sibling != b.sibling) return a.sibling < b.sibling;
+        if (a.node != b.node) return a.node < b.node;
+        if (a.core != b.core) return a.core < b.core;
+        return a.id < b.id;
+    });
+    if (binding != ThreadBinding::SPREAD) return;
+
+    // Position of each CPU among those of its node and sibling index
+    std::map<std::pair<int, int>, int> seen;
+    std::vector<std::pair<int, size_t>> rank(cpus.size());
+    for (size_t i = 0; i < cpus.size(); ++i) {
+        rank[i] = {seen[{cpus[i].sibling, cpus[i].node}]++, i};
+    }
+    std::vector<Cpu> ordered;
+    std::stable_sort(rank.begin(), rank.end(), [&](const auto& a, const auto& b) {
+        const Cpu& x = cpus[a.second];
+        const Cpu& y = cpus[b.second];
+        if (x.sibling != y.sibling) return x.sibling < y.sibling;
+        return a.first < b.first;
+    });
+    for (const auto& entry : rank) ordered.push_back(cpus[entry.second]);
+    cpus = std::move(ordered);
+}
+
+bool runtimeBindingRequested() {
+    const char* bind = std::getenv("OMP_PROC_BIND");
+    const char* places = std::getenv("OMP_PLACES");
+    bool bound = bind && *bind && std::string(bind) != "false" && std::string(bind) != "FALSE";
+    return bound || (places && *places);
+}
+
+} // namespace
+
+ThreadBinding parseThreadBinding(const std::string& name) {
+    if (name == "none") return ThreadBinding::NONE;
+    if (name == "close") return ThreadBinding::CLOSE;
+    if (name == "spread") return ThreadBinding::SPREAD;
+    throw std::invalid_argument("unknown thread binding '" + name + "' (none, close or spread)");
+}
+
+const char* threadBindingName(ThreadBinding binding) {
+    switch (binding) {
+        case ThreadBinding::NONE: return "none";
+        case ThreadBinding::SPREAD: return "spread";
+        default: return "close";
+    }
+}
+
+ThreadPlacement& ThreadPlacement::get() {
+    static ThreadPlacement placement;
+    return placement;
+}
+
+ThreadPlacement::ThreadPlacement() {
+    configure(0, 1, ThreadBinding::CLOSE);
+}
+
+void ThreadPlacement::configure(int localRank, int localRanks, ThreadBinding binding) {
+    std::vector<int> online = onlineCpus();
+    std::vector<int> allowed = allowedCpus(online);
+    localRank_ = localRank;
+    localRanks_ = std::max(1, localRanks);
+    onlineCpus_ = static_cast<int>(online.size());
+    binding_ = binding;
+    runtimeBinds_ = runtimeBindingRequested();
+    launcherBound_ = allowed.size() < online.size();
+
+    std::vector<Cpu> cpus = describeCpus(allowed);
+    if (!launcherBound_ && localRanks_ > 1) {
+        cpus = shareOf(std::move(cpus), localRank_ % localRanks_, localRanks_);
+#ifdef __linux__
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (const Cpu& cpu : cpus) CPU_SET(cpu.id, &set);
+        sched_setaffinity(0, sizeof(set), &set);
+#endif
+    }
+    orderForBinding(cpus, binding_);
+    cpus_ = std::move(cpus);
+}
+
+int ThreadPlacement::threads() const {
+    if (const char* env = std::getenv("OMP_NUM_THREADS")) {
+        int count = std::atoi(env);
+        if (count > 0) return count;
+    }
+    return std::max(1, static_cast<int>(cpus_.size()));
+}
+
+std::vector<int> ThreadPlacement::nodes() const {
+    std::vector<int> nodes;
+    for (const Cpu& cpu : cpus_) nodes.push_back(cpu.node);
+    std::sort(nodes.begin(), nodes.end());
+    nodes.erase(std::unique(nodes.begin(), nodes.end()), nodes.end());
+    return nodes;
+}
+
+std::string ThreadPlacement::describe() const {
+    std::vector<int> ids;
+    for (const Cpu& cpu : cpus_) ids.push_back(cpu.id);
+    std::vector<int> nodeIds = nodes();
+    std::ostringstream out;
+    out << "local rank " << localRank_ << "/" << localRanks_ << ", CPUs " << formatCpuList(ids)
+        << " of " << onlineCpus_ << (launcherBound_ ? " (set by the launcher)" : "")
+        << ", node" << (nodeIds.size() > 1 ? "s " : " ") << formatCpuList(nodeIds)
+        << ", " << threads() << " threads, binding "
+        << (runtimeBinds_ ? "by OMP_PROC_BIND/OMP_PLACES" : threadBindingName(binding_));
+    return out.str();
+}
+
+void ThreadPlacement::bindThread(int index, int teamSize) const {
+    if (binding_ == ThreadBinding::NONE || runtimeBinds_ || index <= 0 ||
+        teamSize != threads() || cpus_.empty()) {
+        return;
+    }
+#ifdef __linux__
+    // Runtime threads are reused from team to team; pin each once
+    thread_local int boundTo = -1;
+    int cpu = cpus_[index % cpus_.size()].id;
+    if (boundTo == cpu) return;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    if (sched_setaffinity(0, sizeof(set), &set) == 0) boundTo = cpu;
+#endif
+}
+
+void ThreadPlacement::interleave(void* memory, size_t bytes) const {
+#if defined(__linux__) && defined(SYS_mbind)
+    std::vector<int> nodeIds = nodes();
+    if (nodeIds.size() < 2) return;
+    constexpr int MPOL_INTERLEAVE_MODE = 3;  // MPOL_INTERLEAVE, linux/mempolicy.h
+    constexpr size_t MASK_WORDS = 16;        // nodes 0..1023
+    unsigned long mask[MASK_WORDS] = {};
+    const size_t bits = 8 * sizeof(unsigned long);
+    for (int node : nodeIds) {
+        if (node >= 0 && static_cast<size_t>(node) < MASK_WORDS * bits) {
+            mask[node / bits] |= 1UL << (node % bits);
+        }
+    }
+    // mbind works on whole pages
+    const uintptr_t page = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+    uintptr_t begin = (reinterpret_cast<uintptr_t>(memory) + page - 1) & ~(page - 1);
+    uintptr_t end = (reinterpret_cast<uintptr_t>(memory) + bytes) & ~(page - 1);
+    if (end <= begin) return;
+    syscall(SYS_mbind, begin, end - begin, MPOL_INTERLEAVE_MODE, mask, MASK_WORDS * bits + 1, 0);
+#else
+    (void)memory;
+    (void)bytes;
+#endif
+}
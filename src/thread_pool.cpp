@@ -0,0 +1,76 @@
+#include "thread_pool.hpp"
+#include "logging.hpp"
+
+ThreadPool::ThreadPool(size_t numThreads, size_t maxQueued)
+    : maxQueued_(maxQueued) {
+    if (numThreads == 0) numThreads = 1;
+    workers_.reserve(numThreads);
+    for (size_t i = 0; i < numThreads; ++i) {
+        workers_.emplace_back(&ThreadPool::workerLoop, this);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    shutdown();
+}
+
+bool ThreadPool::trySubmit(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stopping_) return false;
+        if (maxQueued_ > 0 && tasks_.size() >= maxQueued_) return false;
+        tasks_.push_back(std::move(task));
+    }
+    available_.notify_one();
+    return true;
+}
+
+void ThreadPool::shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stopping_ && workers_.empty()) return;
+        stopping_ = true;
+    }
+    available_.notify_all();
+
+    for (std::thread& worker : workers_) {
+        if (worker.joinable()) worker.join();
+    }
+    workers_.clear();
+}
+
+size_t ThreadPool::queued() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return tasks_.size();
+}
+
+size_t ThreadPool::active() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return active_;
+}
+
+void ThreadPool::workerLoop() {
+    while (true) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            available_.wait(lock, [this] { return stopping_ || !tasks_.empty(); });
+            if (tasks_.empty()) return;  // stopping and drained
+            task = std::move(tasks_.front());
+            tasks_.pop_front();
+            ++active_;
+        }
+
+        // A throwing task must not take the worker down with it
+        try {
+            task();
+        } catch (const std::exception& e) {
+            RUBIKS_LOG(ERROR) << "Worker task failed: " << e.what();
+        } catch (...) {
+            RUBIKS_LOG(ERROR) << "Worker task failed";
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        --active_;
+    }
+}
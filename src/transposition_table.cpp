@@ -0,0 +1,75 @@
+// src/transposition_table.cpp - Lock-free IDA* bound table
+#include "transposition_table.hpp"
+#include "thread_placement.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+TranspositionTable::TranspositionTable(size_t bytes) {
+    if (bytes < BUCKET_BYTES) {
+        throw std::invalid_argument("Transposition table needs at least 64 bytes");
+    }
+    numBuckets_ = 1;
+    while (numBuckets_ * 2 <= bytes / BUCKET_BYTES) numBuckets_ *= 2;
+    buckets_.reset(new Bucket[numBuckets_]);
+    // Every search thread probes every bucket alike, so no node is the
+    // right home for any part of the table: its pages are interleaved over
+    // the rank's nodes before clear() first touches them
+    ThreadPlacement::get().interleave(buckets_.get(), numBuckets_ * BUCKET_BYTES);
+    clear();
+}
+
+void TranspositionTable::store(uint64_t key, int g, int bound) {
+    uint16_t generation = generation_.load(std::memory_order_relaxed);
+    bound = std::min(std::max(bound, 0), 0xFF);
+    g = std::min(std::max(g, 0), 0xFF);
+    Bucket& bucket = bucketFor(key);
+
+    Entry* victim = nullptr;
+    int victimScore = -1;
+    for (Entry& entry : bucket.entries) {
+        uint64_t data = entry.data.load(std::memory_order_relaxed);
+        if (data == 0) {
+            if (victimScore < 0x200) {
+                victim = &entry;
+                victimScore = 0x200;
+            }
+            continue;
+        }
+        if ((entry.check.load(std::memory_order_relaxed) ^ data) == key) {
+            bound = std::max(bound, boundOf(data));
+            g = std::min(g, depthOf(data));
+            victim = &entry;
+            break;
+        }
+        // Older searches go first, then the shallowest remaining subtrees
+        int score = (generationOf(data) != generation ? 0x100 : 0) + depthOf(data);
+        if (score > victimScore) {
+            victim = &entry;
+            victimScore = score;
+        }
+    }
+
+    uint64_t data = static_cast<uint64_t>(bound) | (static_cast<uint64_t>(g) << 8) |
+                    (static_cast<uint64_t>(generation) << 16);
+    victim->data.store(data, std::memory_order_relaxed);
+    victim->check.store(key ^ data, std::memory_order_relaxed);
+}
+
+void TranspositionTable::clear() {
+    for (size_t i = 0; i < numBuckets_; ++i) {
+        for (Entry& entry : buckets_[i].entries) {
+            entry.check.store(0, std::memory_order_relaxed);
+            entry.data.store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+size_t TranspositionTable::size() const {
+    size_t count = 0;
+    for (size_t i = 0; i < numBuckets_; ++i) {
+        for (const Entry& entry : buckets_[i].entries) {
+            if (entry.data.load(std::memory_order_relaxed) != 0) ++count;
+        }
+    }
+    return count;
+}
@@ -0,0 +1,472 @@
+// src/two_phase_solver.cpp - Kociemba two-phase implementation
+#include "two_phase_solver.hpp"
+#include "logging.hpp"
+#include <algorithm>
+#include <vector>
+
+namespace {
+
+// Coordinate sizes
+constexpr int N_TWIST = 2187;         // 3^7 corner orientations
+constexpr int N_FLIP = 2048;          // 2^11 edge orientations
+constexpr int N_SLICE = 495;          // C(12,4) positions of the slice edges
+constexpr int N_CORNER_PERM = 40320;  // 8! corner permutations
+constexpr int N_EDGE_PERM = 40320;    // 8! permutations of the U/D edges
+constexpr int N_SLICE_PERM = 24;      // 4! permutations of the slice edges
+
+// Known upper bounds for the depths of the two phases
+constexpr int MAX_PHASE1_DEPTH = 12;
+constexpr int MAX_PHASE2_DEPTH = 18;
+constexpr int MAX_LENGTH = 30;
+
+// Moves that keep the cube inside the phase-2 subgroup
+constexpr int N_PHASE2_MOVES = 10;
+constexpr Move PHASE2_MOVES[N_PHASE2_MOVES] = {
+    Move::U, Move::UPrime, Move::U2, Move::D, Move::DPrime, Move::D2,
+    Move::F2, Move::B2, Move::L2, Move::R2
+};
+
+inline bool isPhase2Move(Move m) {
+    return moveFace(m) <= 1 || moveIndex(m) % 3 == 2;
+}
+
+int binomial(int n, int k) {
+    if (k < 0 || k > n) return 0;
+    int result = 1;
+    for (int i = 0; i < k; ++i) result = result * (n - i) / (i + 1);
+    return result;
+}
+
+// Lexicographic rank of a permutation of 0..n-1
+int rankPermutation(const int* p, int n) {
+    int rank = 0;
+    for (int i = 0; i < n; ++i) {
+        int smaller = 0;
+        for (int j = i + 1; j < n; ++j) {
+            if (p[j] < p[i]) smaller++;
+        }
+        rank = rank * (n - i) + smaller;
+    }
+    return rank;
+}
+
+void unrankPermutation(int rank, int* p, int n) {
+    int digits[12];
+    for (int i = n - 1; i >= 0; --i) {
+        digits[i] = rank % (n - i);
+        rank /= (n - i);
+    }
+    int available[12];
+    for (int i = 0; i < n; ++i) available[i] = i;
+    int remaining = n;
+    for (int i = 0; i < n; ++i) {
+        p[i] = available[digits[i]];
+        for (int j = digits[i]; j < remaining - 1; ++j) available[j] = available[j + 1];
+        remaining--;
+    }
+}
+
+// --- Coordinates --------------------------------------------------------
+
+int getTwist(const CubieCube& c) {
+    int twist = 0;
+    for (int i = 0; i < CubieCube::NUM_CORNERS - 1; ++i) {
+        twist = twist * 3 + c.getCornerOrientation(i);
+    }
+    return twist;
+}
+
+void setTwist(CubieCube& c, int twist) {
+    int sum = 0;
+    for (int i = CubieCube::NUM_CORNERS - 2; i >= 0; --i) {
+        c.setCorner(i, i, twist % 3);
+        sum += twist % 3;
+        twist /= 3;
+    }
+    c.setCorner(7, 7, (3 - sum % 3) % 3);
+}
+
+int getFlip(const CubieCube& c) {
+    int flip = 0;
+    for (int i = 0; i < CubieCube::NUM_EDGES - 1; ++i) {
+        flip = flip * 2 + c.getEdgeOrientation(i);
+    }
+    return flip;
+}
+
+void setFlip(CubieCube& c, int flip) {
+    int sum = 0;
+    for (int i = CubieCube::NUM_EDGES - 2; i >= 0; --i) {
+        c.setEdge(i, i, flip & 1);
+        sum += flip & 1;
+        flip >>= 1;
+    }
+    c.setEdge(11, 11, sum & 1);
+}
+
+// Which 4 of the 12 edge slots hold FR, FL, BL, BR (0 when solved)
+int getSlice(const CubieCube& c) {
+    int slice = 0, seen = 0;
+    for (int j = CubieCube::NUM_EDGES - 1; j >= 0; --j) {
+        if (c.getEdgePermutation(j) >= CubieCube::FR) {
+            slice += binomial(11 - j, seen + 1);
+            seen++;
+        }
+    }
+    return slice;
+}
+
+void setSlice(CubieCube& c, int slice) {
+    // Inverse of getSlice, found by enumerating all 4-subsets once
+    static const std::vector<int> masks = [] {
+        std::vector<int> result(N_SLICE);
+        for (int mask = 0; mask < (1 << 12); ++mask) {
+            if (__builtin_popcount(mask) != 4) continue;
+            CubieCube cube;
+            int slot = 0, other = 0;
+            for (int j = 0; j < CubieCube::NUM_EDGES; ++j) {
+                cube.setEdge(j, (mask >> j) & 1 ? CubieCube::FR + slot++ : other++, 0);
+            }
+            result[getSlice(cube)] = mask;
+        }
+        return result;
+    }();
+    int slot = 0, other = 0;
+    for (int j = 0; j < CubieCube::NUM_EDGES; ++j) {
+        c.setEdge(j, (masks[slice] >> j) & 1 ? CubieCube::FR + slot++ : other++, 0);
+    }
+}
+
+int getCornerPerm(const CubieCube& c) {
+    int p[8];
+    for (int i = 0; i < 8; ++i) p[i] = c.getCornerPermutation(i);
+    return rankPermutation(p, 8);
+}
+
+void setCornerPerm(CubieCube& c, int rank) {
+    int p[8];
+    unrankPermutation(rank, p, 8);
+    for (int i = 0; i < 8; ++i) c.setCorner(i, p[i], 0);
+}
+
+// Only meaningful in phase 2, where slots 0-7 hold the U/D edges
+int getEdgePerm(const CubieCube& c) {
+    int p[8];
+    for (int i = 0; i < 8; ++i) p[i] = c.getEdgePermutation(i);
+    return rankPermutation(p, 8);
+}
+
+void setEdgePerm(CubieCube& c, int rank) {
+    int p[8];
+    unrankPermutation(rank, p, 8);
+    for (int i = 0; i < 8; ++i) c.setEdge(i, p[i], 0);
+}
+
+int getSlicePerm(const CubieCube& c) {
+    int p[4];
+    for (int i = 0; i < 4; ++i) p[i] = c.getEdgePermutation(8 + i) - CubieCube::FR;
+    return rankPermutation(p, 4);
+}
+
+void setSlicePerm(CubieCube& c, int rank) {
+    int p[4];
+    unrankPermutation(rank, p, 4);
+    for (int i = 0; i < 4; ++i) c.setEdge(8 + i, CubieCube::FR + p[i], 0);
+}
+
+// --- Tables -------------------------------------------------------------
+
+struct Tables {
+    // Phase 1: coordinate x 18 moves
+    std::vector<uint16_t> twistMove;
+    std::vector<uint16_t> flipMove;
+    std::vector<uint16_t> sliceMove;
+
+    // Phase 2: coordinate x 10 phase-2 moves
+    std::vector<uint16_t> cornerPermMove;
+    std::vector<uint16_t> edgePermMove;
+    std::vector<uint16_t> slicePermMove;
+
+    // Exact distances in the product of two coordinates
+    std::vector<uint8_t> twistSlicePrune;
+    std::vector<uint8_t> flipSlicePrune;
+    std::vector<uint8_t> cornerSlicePrune;
+    std::vector<uint8_t> edgeSlicePrune;
+};
+
+template <typename Get, typename Set>
+std::vector<uint16_t> buildMoveTable(int size, const Move* moves, int moveCount, Get get, Set set) {
+    std::vector<uint16_t> table(static_cast<size_t>(size) * moveCount);
+    for (int coord = 0; coord < size; ++coord) {
+        CubieCube cube;
+        set(cube, coord);
+        for (int m = 0; m < moveCount; ++m) {
+            CubieCube next = cube;
+            next.applyMove(moves[m]);
+            table[coord * moveCount + m] = static_cast<uint16_t>(get(next));
+        }
+    }
+    return table;
+}
+
+// Breadth-first search over the pair (a, b) of two coordinates
+std::vector<uint8_t> buildPruneTable(const std::vector<uint16_t>& moveA, int sizeA,
+                                     const std::vector<uint16_t>& moveB, int sizeB,
+                                     int moveCount) {
+    const uint32_t total = static_cast<uint32_t>(sizeA) * sizeB;
+    std::vector<uint8_t> table(total, 0xFF);
+    std::vector<uint32_t> queue(total);
+    size_t head = 0, tail = 0;
+
+    table[0] = 0;
+    queue[tail++] = 0;
+    while (head < tail) {
+        uint32_t idx = queue[head++];
+        int a = idx / sizeB, b = idx % sizeB;
+        for (int m = 0; m < moveCount; ++m) {
+            uint32_t next = static_cast<uint32_t>(moveA[a * moveCount + m]) * sizeB
+                          + moveB[b * moveCount + m];
+            if (table[next] == 0xFF) {
+                table[next] = table[idx] + 1;
+                queue[tail++] = next;
+            }
+        }
+    }
+    return table;
+}
+
+Tables buildTables() {
+    Tables t;
+    const Move* all = ALL_MOVES.data();
+
+    t.twistMove = buildMoveTable(N_TWIST, all, NUM_MOVES, getTwist, setTwist);
+    t.flipMove = buildMoveTable(N_FLIP, all, NUM_MOVES, getFlip, setFlip);
+    t.sliceMove = buildMoveTable(N_SLICE, all, NUM_MOVES, getSlice, setSlice);
+
+    t.cornerPermMove = buildMoveTable(N_CORNER_PERM, PHASE2_MOVES, N_PHASE2_MOVES,
+                                      getCornerPerm, setCornerPerm);
+    t.edgePermMove = buildMoveTable(N_EDGE_PERM, PHASE2_MOVES, N_PHASE2_MOVES,
+                                    getEdgePerm, setEdgePerm);
+    t.slicePermMove = buildMoveTable(N_SLICE_PERM, PHASE2_MOVES, N_PHASE2_MOVES,
+                                     getSlicePerm, setSlicePerm);
+
+    t.twistSlicePrune = buildPruneTable(t.twistMove, N_TWIST, t.sliceMove, N_SLICE, NUM_MOVES);
+    t.flipSlicePrune = buildPruneTable(t.flipMove, N_FLIP, t.sliceMove, N_SLICE, NUM_MOVES);
+    t.cornerSlicePrune = buildPruneTable(t.cornerPermMove, N_CORNER_PERM,
+                                         t.slicePermMove, N_SLICE_PERM, N_PHASE2_MOVES);
+    t.edgeSlicePrune = buildPruneTable(t.edgePermMove, N_EDGE_PERM,
+                                       t.slicePermMove, N_SLICE_PERM, N_PHASE2_MOVES);
+    return t;
+}
+
+const Tables& tables() {
+    static const Tables t = buildTables();
+    return t;
+}
+
+inline int phase1Heuristic(const Tables& t, int twist, int flip, int slice) {
+    return std::max(t.twistSlicePrune[twist * N_SLICE + slice],
+                    t.flipSlicePrune[flip * N_SLICE + slice]);
+}
+
+inline int phase2Heuristic(const Tables& t, int cornerPerm, int edgePerm, int slicePerm) {
+    return std::max(t.cornerSlicePrune[cornerPerm * N_SLICE_PERM + slicePerm],
+                    t.edgeSlicePrune[edgePerm * N_SLICE_PERM + slicePerm]);
+}
+
+} // namespace
+
+void TwoPhaseSolver::initTables() {
+    tables();
+}
+
+std::vector<std::string> TwoPhaseSolver::solve(RubiksCube& cube, int maxDepth) {
+    auto startTime = std::chrono::high_resolution_clock::now();
+
+    start_ = CubieCube(cube);
+    solution_.clear();
+    currentPath_.clear();
+    currentPath_.reserve(MAX_LENGTH + 1);
+    counters_ = SearchCounters{};
+    bestLength_ = MAX_LENGTH + 1;
+    targetLength_ = maxDepth;
+    stop_ = false;
+    beginSearch();
+
+    if (cube.isSolved()) {
+        solveTime_ = 0.0;
+        finishStats(counters_, true, 0);
+        RUBIKS_LOG(DEBUG) << "Cube already solved!";
+        return {};
+    }
+
+    RUBIKS_LOG(DEBUG) << "=== Two-Phase Search === target length " << maxDepth << ", time limit "
+                      << getTimeLimit() << "s" << (anytime_ ? " (anytime)" : "");
+
+    const Tables& t = tables();
+    int twist = getTwist(start_);
+    int flip = getFlip(start_);
+    int slice = getSlice(start_);
+
+    // Iterative deepening on the phase-1 length; each phase-1 solution is
+    // completed by the shortest phase 2 that still beats the best so far
+    for (int depth = phase1Heuristic(t, twist, flip, slice);
+         depth <= MAX_PHASE1_DEPTH && depth < bestLength_ && !stop_; ++depth) {
+        reportProgress(depth, counters_.nodes);
+        phase1(twist, flip, slice, depth, MoveSequenceAutomaton::START);
+    }
+
+    auto endTime = std::chrono::high_resolution_clock::now();
+    solveTime_ = std::chrono::duration<double>(endTime - startTime).count();
+
+    finishStats(counters_, !solution_.empty(), solution_.size());
+
+    if (!solution_.empty()) {
+        RUBIKS_LOG(DEBUG) << "✓ Solution found: " << solution_.size() << " moves, " << counters_.nodes
+                          << " nodes, " << solveTime_ << "s";
+        return movesToStrings(solution_);
+    }
+    RUBIKS_LOG(DEBUG) << "✗ No solution found (timeout): " << counters_.nodes << " nodes, " << solveTime_ << "s";
+    return {};
+}
+
+// Returns true when the whole search should stop
+bool TwoPhaseSolver::phase1(int twist, int flip, int slice, int togo,
+                            MoveSequenceAutomaton::State sequence) {
+    counters_.visit(static_cast<int>(currentPath_.size()));
+
+    if (togo == 0) {
+        if (twist == 0 && flip == 0 && slice == 0) {
+            return startPhase2(sequence);
+        }
+        return false;
+    }
+
+    if (timeUp()) {
+        return true;
+    }
+
+    const Tables& t = tables();
+    for (int m = 0; m < NUM_MOVES; ++m) {
+        Move move = ALL_MOVES[m];
+        MoveSequenceAutomaton::State nextSequence = automaton_->next(sequence, move);
+        if (nextSequence == MoveSequenceAutomaton::REJECT) {
+            counters_.sequencePruned++;
+            continue;
+        }
+
+        // Ending phase 1 with a phase-2 move means a shorter phase 1 exists
+        if (togo == 1 && isPhase2Move(move)) {
+            continue;
+        }
+
+        int nextTwist = t.twistMove[twist * NUM_MOVES + m];
+        int nextFlip = t.flipMove[flip * NUM_MOVES + m];
+        int nextSlice = t.sliceMove[slice * NUM_MOVES + m];
+        counters_.heuristicEvaluations++;
+        if (phase1Heuristic(t, nextTwist, nextFlip, nextSlice) > togo - 1) {
+            counters_.boundCutoffs++;
+            continue;
+        }
+
+        currentPath_.push_back(move);
+        if (phase1(nextTwist, nextFlip, nextSlice, togo - 1, nextSequence)) {
+            return true;
+        }
+        currentPath_.pop_back();
+    }
+
+    return false;
+}
+
+bool TwoPhaseSolver::startPhase2(MoveSequenceAutomaton::State sequence) {
+    const int phase1Length = static_cast<int>(currentPath_.size());
+    const int limit = std::min(bestLength_ - 1 - phase1Length, MAX_PHASE2_DEPTH);
+    if (limit < 0) {
+        return false;
+    }
+
+    CubieCube cube = start_;
+    for (Move move : currentPath_) {
+        cube.applyMove(move);
+    }
+    int cornerPerm = getCornerPerm(cube);
+    int edgePerm = getEdgePerm(cube);
+    int slicePerm = getSlicePerm(cube);
+
+    for (int depth = phase2Heuristic(tables(), cornerPerm, edgePerm, slicePerm);
+         depth <= limit; ++depth) {
+        if (!phase2(cornerPerm, edgePerm, slicePerm, depth, sequence)) {
+            continue;
+        }
+        if (stop_) {
+            return true;
+        }
+
+        solution_ = currentPath_;
+        bestLength_ = static_cast<int>(solution_.size());
+        currentPath_.resize(phase1Length);
+        RUBIKS_LOG(DEBUG) << "  Found " << bestLength_ << "-move solution ("
+                          << phase1Length << " + " << depth << "), Nodes: " << counters_.nodes;
+        if (onSolution_) {
+            onSolution_(movesToStrings(solution_));
+        }
+
+        if (!anytime_ && bestLength_ <= targetLength_) {
+            stop_ = true;
+            return true;
+        }
+        break;
+    }
+
+    return stop_;
+}
+
+// Returns true when solved (path holds the solution) or stopped
+bool TwoPhaseSolver::phase2(int cornerPerm, int edgePerm, int slicePerm, int togo,
+                            MoveSequenceAutomaton::State sequence) {
+    counters_.visit(static_cast<int>(currentPath_.size()));
+
+    if (togo == 0) {
+        return cornerPerm == 0 && edgePerm == 0 && slicePerm == 0;
+    }
+
+    if (timeUp()) {
+        return true;
+    }
+
+    const Tables& t = tables();
+    for (int m = 0; m < N_PHASE2_MOVES; ++m) {
+        Move move = PHASE2_MOVES[m];
+        MoveSequenceAutomaton::State nextSequence = automaton_->next(sequence, move);
+        if (nextSequence == MoveSequenceAutomaton::REJECT) {
+            counters_.sequencePruned++;
+            continue;
+        }
+
+        int nextCorner = t.cornerPermMove[cornerPerm * N_PHASE2_MOVES + m];
+        int nextEdge = t.edgePermMove[edgePerm * N_PHASE2_MOVES + m];
+        int nextSlice = t.slicePermMove[slicePerm * N_PHASE2_MOVES + m];
+        counters_.heuristicEvaluations++;
+        if (phase2Heuristic(t, nextCorner, nextEdge, nextSlice) > togo - 1) {
+            counters_.boundCutoffs++;
+            continue;
+        }
+
+        currentPath_.push_back(move);
+        if (phase2(nextCorner, nextEdge, nextSlice, togo - 1, nextSequence)) {
+            return true;
+        }
+        currentPath_.pop_back();
+    }
+
+    return false;
+}
+
+bool TwoPhaseSolver::timeUp() {
+    if (!stop_ && shouldStop(counters_.nodes)) {
+        RUBIKS_LOG(DEBUG) << "Time limit reached";
+        stop_ = true;
+    }
+    return stop_;
+}
@@ -1,7 +1,38 @@
 #include "rubiks_cube.hpp"
+#include "cubie_cube.hpp"
+#include "facelet_kernel.hpp"
 #include "sequential_solver.hpp" 
+#include "bidirectional_solver.hpp"
+#include "two_phase_solver.hpp"
+#ifdef HAVE_OPENMP
+#include "openmp_solver.hpp"
+#endif
+#ifdef HAVE_MPI
+#include "mpi_scheduler.hpp"
+#endif
+#include "pattern_database.hpp"
+#include "heuristic.hpp"
+#include "http_server.hpp"
+#include "session_store.hpp"
+#include "cube_symmetry.hpp"
+#include "solution_cache.hpp"
+#include "thread_pool.hpp"
+#include "solver_pool.hpp"
+#include "thread_placement.hpp"
+#include "scrambler.hpp"
+#include "move_sequence.hpp"
+#include "transposition_table.hpp"
+#include "ida_star.hpp"
+#include "solve_stats.hpp"
+#include "logging.hpp"
+#include <cstdio>
+#include <limits>
 #include <iostream>
 #include <cassert>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <unordered_set>
 #include <vector>
 
 void testCubeInitialization() {
@@ -30,11 +61,15 @@ void testCubeMoves() {
     }
     std::cout << "  ✓ All basic moves and inverses work" << std::endl;
     
-    cube.moveU();
-    cube.moveU();
-    RubiksCube cube2;
-    cube2.moveU2();
-    assert(cube == cube2);
+    // Half turns are single-step; check each against two quarter turns
+    cube.scramble(20, 11);
+    for (const auto& move : moves) {
+        RubiksCube twice = cube, half = cube;
+        twice.applyMove(move);
+        twice.applyMove(move);
+        half.applyMove(move + "2");
+        assert(twice == half && half != cube);
+    }
     std::cout << "  ✓ Double moves work correctly" << std::endl;
 }
 
@@ -112,6 +147,1067 @@ void testJSON() {
     std::string json = cube.toJSON();
     assert(json.find("\"isSolved\":true") != std::string::npos);
     std::cout << "  ✓ JSON output contains expected fields" << std::endl;
+    
+    cube.applyMove("R");
+    json = cube.toJSON();
+    std::string head = "{\"faces\":{\"U\":[\"W\",\"W\",\"G\",\"W\",\"W\",\"G\",";
+    std::string tail = "\"R\"]},\"isSolved\":false}";
+    assert(json.compare(0, head.size(), head) == 0);
+    assert(json.size() > tail.size() && json.compare(json.size() - tail.size(), tail.size(), tail) == 0);
+    std::string compact;
+    JSONWriter writer(compact);
+    writer.beginObject();
+    cube.writeJSON(writer, true);
+    writer.endObject();
+    assert(compact == "{\"state\":\"" + cube.toString() + "\",\"isSolved\":false}");
+    std::cout << "  ✓ Faces and compact state forms" << std::endl;
+    
+    std::string out;
+    JSONWriter(out).beginObject().member("n", -3).member("u", uint64_t{18446744073709551615ull})
+        .member("t", 0.5, 2).member("ok", true).key("a").beginArray().value("x").beginArray().endArray()
+        .null().beginObject().endObject().endArray().member("s", "q\"\\\n\x01").endObject();
+    assert(out == "{\"n\":-3,\"u\":18446744073709551615,\"t\":0.50,\"ok\":true,"
+                  "\"a\":[\"x\",[],null,{}],\"s\":\"q\\\"\\\\\\n\\u0001\"}");
+    out.clear();
+    JSONWriter(out).beginArray().value(std::numeric_limits<double>::infinity()).raw("{\"k\":1}").endArray();
+    assert(out == "[null,{\"k\":1}]");
+    std::cout << "  ✓ Writer places commas and escapes strings" << std::endl;
+}
+
+void testJSONBody() {
+    std::cout << "Testing JSON request bodies..." << std::endl;
+    JSONBody body(" {\"move\" : \"R\", \"moves\":-12.5e1, \"uniform\":true, \"n\":null,"
+                  "\"nested\":{\"move\":\"L\",\"a\":[1,{}]}, \"esc\":\"a\\\"b\\u00e9\\ud83d\\ude00\","
+                  "\"states\":[\"x\", 3, [\"skip\"], \"y\\\\z\"], \"move\":\"U\"} ");
+    assert(body.valid());
+    assert(body.value("move") == "R");  // the first of a repeated key
+    assert(body.value("moves") == "-12.5e1" && body.value("uniform") == "true" && body.value("n") == "null");
+    assert(body.raw("nested") == "{\"move\":\"L\",\"a\":[1,{}]}");
+    assert(body.value("esc") == "a\"b\xc3\xa9\xf0\x9f\x98\x80");
+    assert((body.strings("states") == std::vector<std::string>{"x", "y\\z"}));
+    assert(!body.has("missing") && body.value("missing").empty() && body.strings("move").empty());
+    std::cout << "  ✓ Top-level members found in one pass, strings unescaped" << std::endl;
+    
+    assert(JSONBody("").valid() && JSONBody(" \r\n").valid() && JSONBody("{}").valid());
+    const char* invalid[] = {
+        "[]", "\"move\"", "{\"move\":}", "{\"move\":\"R\"", "{\"move\":\"R\",}", "{move:1}",
+        "{\"a\":01x}", "{\"a\":tru}", "{\"a\":\"\\x\"}", "{\"a\":[1,]}", "{\"a\":1} x", "{\"a\":\"\n\"}",
+    };
+    for (const char* text : invalid) {
+        assert(!JSONBody(text).valid());
+    }
+    assert(JSONBody(std::string(200, '[')).valid() == false);
+    std::string wide = "{";
+    for (size_t i = 0; i <= JSONBody::MAX_MEMBERS; ++i) {
+        wide += (i ? ",\"k" : "\"k") + std::to_string(i) + "\":1";
+    }
+    assert(!JSONBody(wide + "}").valid());
+    std::cout << "  ✓ Malformed and oversized bodies rejected" << std::endl;
+}
+
+void testCubieCubeConversion() {
+    std::cout << "Testing cubie cube conversion..." << std::endl;
+    CubieCube solved;
+    assert(solved.isSolved());
+    assert(solved.toString() == RubiksCube().toString());
+    
+    for (int i = 0; i < 20; ++i) {
+        RubiksCube cube;
+        cube.scramble(25);
+        CubieCube cubie(cube);
+        assert(cubie.toString() == cube.toString());
+        assert(CubieCube(cubie.toString()) == cubie);
+    }
+    std::cout << "  ✓ Facelet <-> cubie round trip preserves state" << std::endl;
+    
+    RubiksCube twisted;
+    std::string state = twisted.toString();
+    std::swap(state[8], state[45]); // Swap two stickers of the URF corner
+    bool threw = false;
+    try {
+        CubieCube invalid(state);
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    assert(threw);
+    std::cout << "  ✓ Unreachable states are rejected" << std::endl;
+}
+
+void testCubieCubeMoves() {
+    std::cout << "Testing cubie cube moves..." << std::endl;
+    auto moves = RubiksCube::getAllMoves();
+    RubiksCube facelets;
+    CubieCube cubie;
+    
+    for (int i = 0; i < 200; ++i) {
+        const auto& move = moves[(i * 7 + 3) % moves.size()];
+        facelets.applyMove(move);
+        cubie.applyMove(move);
+        assert(cubie.toString() == facelets.toString());
+        assert(cubie.getManhattanDistance() == facelets.getManhattanDistance());
+        assert(cubie.isSolved() == facelets.isSolved());
+    }
+    std::cout << "  ✓ Table-driven moves match the facelet model" << std::endl;
+    
+    CubieCube copy = cubie;
+    assert(copy == cubie && copy.hash() == cubie.hash());
+    copy.applyMove("R");
+    assert(copy != cubie);
+    std::cout << "  ✓ Comparison and hashing work" << std::endl;
+}
+
+void testFaceletKernel() {
+    std::cout << "Testing facelet kernels..." << std::endl;
+    const FaceletKernel::Kind original = FaceletKernel::active();
+    const FaceletKernel::Kind kinds[] = {FaceletKernel::Kind::SCALAR, FaceletKernel::Kind::AVX2,
+                                         FaceletKernel::Kind::AVX512};
+    
+    // The scalar kernel's states along one long sequence are the reference
+    FaceletKernel::select(FaceletKernel::Kind::SCALAR);
+    std::vector<RubiksCube> reference;
+    RubiksCube cube;
+    for (int i = 0; i < 300; ++i) {
+        cube.applyMove(ALL_MOVES[(i * 11 + 5) % NUM_MOVES]);
+        reference.push_back(cube);
+    }
+    
+    for (FaceletKernel::Kind kind : kinds) {
+        if (!FaceletKernel::select(kind)) continue;
+        RubiksCube state;
+        for (int i = 0; i < 300; ++i) {
+            state.applyMove(ALL_MOVES[(i * 11 + 5) % NUM_MOVES]);
+            assert(state == reference[i]);
+            assert(state.isSolved() == reference[i].isSolved());
+            assert(state.getManhattanDistance() == CubieCube(state).getManhattanDistance());
+        }
+        for (int m = 0; m < NUM_MOVES; ++m) {
+            Move move = ALL_MOVES[m];
+            RubiksCube turned;
+            turned.applyMove(move);
+            assert(!turned.isSolved());
+            turned.applyMove(inverse(move));
+            assert(turned.isSolved());
+        }
+        for (int face = 0; face < 6; ++face) {
+            RubiksCube turned;
+            for (int i = 0; i < 4; ++i) turned.applyMove(ALL_MOVES[face * 3]);
+            assert(turned.isSolved());
+        }
+        std::cout << "  ✓ " << FaceletKernel::name(kind) << " moves, isSolved and Manhattan distance agree" << std::endl;
+    }
+    FaceletKernel::select(original);
+}
+
+void testMoveIds() {
+    std::cout << "Testing integer move ids..." << std::endl;
+    auto names = RubiksCube::getAllMoves();
+    for (int i = 0; i < NUM_MOVES; ++i) {
+        Move move = ALL_MOVES[i];
+        assert(moveToString(move) == names[i]);
+        assert(moveFromString(names[i]) == move);
+        assert(inverse(inverse(move)) == move);
+        
+        RubiksCube byId, byName;
+        byId.applyMove(move);
+        byName.applyMove(names[i]);
+        assert(byId == byName);
+        byId.applyMove(inverse(move));
+        assert(byId.isSolved());
+    }
+    std::cout << "  ✓ Move ids match notation and inverses undo moves" << std::endl;
+}
+
+// Number of length-n sequences the automaton accepts
+static uint64_t countSequences(const MoveSequenceAutomaton& automaton,
+                               MoveSequenceAutomaton::State state, int n) {
+    if (n == 0) return 1;
+    uint64_t count = 0;
+    for (Move move : automaton.allowed(state)) {
+        count += countSequences(automaton, automaton.next(state, move), n - 1);
+    }
+    return count;
+}
+
+void testMoveSequenceAutomaton() {
+    std::cout << "Testing move-sequence automaton..." << std::endl;
+    const auto& qtm = MoveSequenceAutomaton::get(Metric::QUARTER_TURN);
+    const auto& htm = MoveSequenceAutomaton::get(Metric::HALF_TURN);
+    assert(qtm.getMoves().size() == 12 && htm.getMoves().size() == 18);
+    
+    auto accepts = [](const MoveSequenceAutomaton& automaton, const std::vector<std::string>& moves) {
+        std::vector<Move> ids;
+        for (const auto& move : moves) ids.push_back(moveFromString(move));
+        return automaton.run(ids) != MoveSequenceAutomaton::REJECT;
+    };
+    assert(accepts(qtm, {"U", "D"}) && accepts(htm, {"U", "D2"}));
+    assert(!accepts(qtm, {"D", "U"}) && !accepts(htm, {"D", "U"}));
+    assert(!accepts(qtm, {"U", "D", "U"}) && !accepts(htm, {"U", "D", "U'"}));
+    assert(accepts(qtm, {"U", "U", "D", "D"}) && !accepts(qtm, {"U", "U", "U"}));
+    assert(!accepts(qtm, {"U", "U'"}) && !accepts(qtm, {"U'", "U'"}) && !accepts(qtm, {"U2"}));
+    assert(!accepts(htm, {"U", "U"}) && !accepts(htm, {"U2", "U'"}));
+    assert(accepts(htm, {"R", "U", "R'", "U'"}));
+    std::cout << "  ✓ Commuting and cancelling orders rejected, U D and U U kept" << std::endl;
+    
+    // Counts of canonical sequences of length 1 to 4
+    const uint64_t htmCounts[] = {18, 243, 3240, 43254};
+    const uint64_t qtmCounts[] = {12, 114, 1068, 10011};
+    for (int n = 1; n <= 4; ++n) {
+        assert(countSequences(htm, MoveSequenceAutomaton::START, n) == htmCounts[n - 1]);
+        assert(countSequences(qtm, MoveSequenceAutomaton::START, n) == qtmCounts[n - 1]);
+    }
+    std::cout << "  ✓ Sequence counts match the canonical counts to depth 4" << std::endl;
+    
+    // Same-axis and doubled turns used to be pruned, so these were unsolvable
+    for (const auto& scramble : std::vector<std::vector<std::string>>{{"U", "D"}, {"R", "R"}, {"F", "B'", "B'"}}) {
+        RubiksCube cube;
+        cube.applyMoves(scramble);
+        SequentialSolver solver;
+        auto solution = solver.solve(cube, 6);
+        assert(solution.size() == scramble.size());
+        cube.applyMoves(solution);
+        assert(cube.isSolved());
+    }
+    std::cout << "  ✓ Optimal solutions for U D, R R and F B' B'" << std::endl;
+
+    // R2 U2 is two half turns but four quarter turns
+    RubiksCube cube;
+    cube.applyMoves({"R2", "U2"});
+    SequentialSolver quarterTurn;
+    assert(quarterTurn.getMetric() == Metric::QUARTER_TURN);
+    size_t quarterTurns = quarterTurn.solve(cube, 6).size();
+    assert(quarterTurns == 4);
+    SequentialSolver halfTurn;
+    halfTurn.setMetric(Metric::HALF_TURN);
+    auto solution = halfTurn.solve(cube, 6);
+    assert((solution == std::vector<std::string>{"U2", "R2"}));
+    cube.applyMoves(solution);
+    assert(cube.isSolved());
+
+    Metric metric;
+    bool known = parseMetric("htm", metric);
+    assert(known && metric == Metric::HALF_TURN);
+    known = parseMetric("stm", metric);
+    assert(!known);
+    std::cout << "  ✓ R2 U2 takes 4 quarter turns and 2 half turns" << std::endl;
+}
+
+// Not final: the search reaches it through the virtual call
+class CountingHeuristic : public Heuristic {
+public:
+    int estimate(const CubieCube& cube) const override { return cube.getManhattanDistance(); }
+    std::string getName() const override { return "counting"; }
+};
+
+void testIDAStar() {
+    std::cout << "Testing the shared IDA* search..." << std::endl;
+    RubiksCube cube;
+    cube.applyMoves({"R", "U", "F'", "L", "D"});
+    
+    // The specialized and the virtual-call search walk the same tree
+    SequentialSolver specialized, generic;
+    generic.setHeuristic(std::make_shared<CountingHeuristic>());
+    RubiksCube a = cube, b = cube;
+    auto first = specialized.solve(a, 8);
+    auto second = generic.solve(b, 8);
+    assert(first == second && first.size() == 5);
+    assert(specialized.getNodesExplored() == generic.getNodesExplored());
+    std::cout << "  ✓ Built-in and custom heuristics search the same tree" << std::endl;
+    
+    // A policy that stops every node below the root leaves nothing found
+    struct Budget {
+        bool stop(uint64_t nodes) { return nodes > 1; }
+        bool complete() const { return false; }
+    };
+    SearchCounters counters;
+    std::vector<Move> path;
+    ManhattanHeuristic manhattan;
+    IDAStar<CubieCube, ManhattanHeuristic, QuarterTurnMoves, Budget> search(manhattan, nullptr, Budget{},
+                                                                          counters);
+    int result = search.search(CubieCube(cube), 0, 5, MoveSequenceAutomaton::START, path);
+    assert(result == std::numeric_limits<int>::max());
+    assert(counters.nodes == 1 + 12 && path.empty());
+    
+    // Unlimited, the same call finds the scramble's inverse
+    struct Unlimited {
+        bool stop(uint64_t) { return false; }
+        bool complete() const { return true; }
+    };
+    counters = SearchCounters{};
+    IDAStar<CubieCube, ManhattanHeuristic, QuarterTurnMoves, Unlimited> full(manhattan, nullptr, Unlimited{},
+                                                                           counters);
+    assert(full.search(CubieCube(cube), 0, 5, MoveSequenceAutomaton::START, path) == -1);
+    CubieCube check(cube);
+    for (Move move : path) check.applyMove(move);
+    assert(check.isSolved() && path.size() == 5);
+    std::cout << "  ✓ Policies stop the search and solutions come back in the path" << std::endl;
+}
+
+void testBidirectionalSolver() {
+    std::cout << "Testing bidirectional solver..." << std::endl;
+    // 1 MB holds the quarter-turn positions within 4 moves, not those within 5
+    auto frontier = FrontierTable::build(Metric::QUARTER_TURN, 1 << 20);
+    assert(frontier->getDepth() == 4 && frontier->size() == 1 + 12 + 114 + 1068 + 10011);
+    CubieCube near;
+    for (Move move : {Move::R, Move::U, Move::U, Move::FPrime}) near.applyMove(move);
+    std::vector<Move> path;
+    assert(frontier->distance(CubieCube()) == 0 && frontier->distance(near) == 4);
+    assert(frontier->pathToSolved(near, path) && path.size() == 4);
+    for (Move move : path) near.applyMove(move);
+    assert(near.isSolved());
+    near.applyMove(Move::L);
+    near.applyMove(Move::B);
+    near.applyMove(Move::D);
+    near.applyMove(Move::R);
+    near.applyMove(Move::F);
+    assert(frontier->distance(near) == -1 && !frontier->pathToSolved(near, path) && path.size() == 4);
+    std::cout << "  ✓ Frontier holds exact distances and paths back to solved" << std::endl;
+    
+    const std::string file = "test_frontier.bin";
+    frontier->save(file);
+    auto loaded = FrontierTable::load(file);
+    std::remove(file.c_str());
+    assert(loaded->getDepth() == 4 && loaded->size() == frontier->size());
+    assert(loaded->distance(near) == -1);
+    std::cout << "  ✓ Memory-mapped file matches the built table" << std::endl;
+    
+    // Same optimal length as forward-only IDA*
+    BidirectionalSolver solver;
+    solver.setFrontierTable(loaded);
+    RubiksCube cube;
+    cube.applyMoves({"R", "U", "F'", "L", "D", "B", "R'"});
+    RubiksCube copy = cube;
+    SequentialSolver sequential;
+    auto expected = sequential.solve(copy, 10);
+    auto solution = solver.solve(cube, 10);
+    assert(solution.size() == expected.size());
+    cube.applyMoves(solution);
+    assert(cube.isSolved());
+    assert(solver.getNodesExplored() < sequential.getNodesExplored());
+    
+    // Inside the frontier the table answers without a search
+    RubiksCube close;
+    close.applyMoves({"F", "R'", "D"});
+    solution = solver.solve(close, 10);
+    close.applyMoves(solution);
+    assert(solution.size() == 3 && close.isSolved() && solver.getNodesExplored() == 0);
+    
+    // Half turns take the half-turn frontier built for the process
+    solver.setMetric(Metric::HALF_TURN);
+    RubiksCube halfTurns;
+    halfTurns.applyMoves({"R2", "U", "F2", "L'", "D2", "B"});
+    solution = solver.solve(halfTurns, 10);
+    halfTurns.applyMoves(solution);
+    assert(halfTurns.isSolved() && solution.size() <= 6);
+    std::cout << "  ✓ Solutions are optimal and checked in both metrics" << std::endl;
+}
+
+void testTranspositionTable() {
+    std::cout << "Testing transposition table..." << std::endl;
+    TranspositionTable table(1 << 16);
+    assert(table.getBytes() == (1 << 16) && table.getCapacity() == 4096 && table.size() == 0);
+    
+    CubieCube cube;
+    cube.applyMove(Move::R);
+    uint64_t key = TranspositionTable::key(cube, MoveSequenceAutomaton::START, Metric::QUARTER_TURN);
+    assert(key != TranspositionTable::key(cube, MoveSequenceAutomaton::START, Metric::HALF_TURN));
+    assert(table.probe(key) == 0);
+    table.store(key, 3, 5);
+    table.store(key, 2, 4);
+    assert(table.probe(key) == 5 && table.size() == 1);
+    table.clear();
+    assert(table.probe(key) == 0 && table.size() == 0);
+    std::cout << "  ✓ Entries keep the larger bound and are keyed on the metric" << std::endl;
+    
+    // A full bucket evicts instead of growing
+    TranspositionTable tiny(TranspositionTable::BUCKET_BYTES);
+    for (uint64_t i = 1; i <= 8; ++i) tiny.store(i * 0x9E3779B97F4A7C15ULL, static_cast<int>(i), 1);
+    assert(tiny.size() == 4);
+    std::cout << "  ✓ Full buckets replace an entry" << std::endl;
+    
+    // Same optimal length with the table; a repeat solve reuses its bounds
+    RubiksCube scrambled;
+    scrambled.applyMoves({"R", "U", "F", "L'", "D", "B", "R'"});
+    SequentialSolver plain;
+    size_t optimal = plain.solve(scrambled, 10).size();
+    SequentialSolver solver;
+    solver.setTranspositionTable(std::make_shared<TranspositionTable>(1 << 20));
+    size_t length = solver.solve(scrambled, 10).size();
+    assert(length == optimal);
+    uint64_t firstNodes = solver.getNodesExplored();
+    auto solution = solver.solve(scrambled, 10);
+    assert(solution.size() == optimal && solver.getNodesExplored() < firstNodes);
+    RubiksCube check = scrambled;
+    check.applyMoves(solution);
+    assert(check.isSolved());
+#ifdef HAVE_OPENMP
+    OpenMPSolver parallel(4);
+    parallel.setTranspositionTable(solver.getTranspositionTable());
+    length = parallel.solve(scrambled, 10).size();
+    assert(length == optimal);
+#endif
+    std::cout << "  ✓ Optimal solutions with the table, " << firstNodes << " -> "
+              << solver.getNodesExplored() << " nodes on a repeat" << std::endl;
+}
+
+void testSolveStats() {
+    std::cout << "Testing solve statistics..." << std::endl;
+    RubiksCube cube;
+    cube.applyMoves({"R", "U", "F'", "L", "D'"});
+    SequentialSolver solver;
+    auto solution = solver.solve(cube, 10);
+    const SolveStats& stats = solver.getStats();
+    assert(stats.solved && !stats.stopped && !stats.cached);
+    assert(stats.solver == solver.getName() && stats.solutionLength == static_cast<int>(solution.size()));
+    assert(stats.nodes == solver.getNodesExplored() && stats.nodes > 0);
+    assert(stats.heuristicEvaluations == stats.nodes && stats.boundCutoffs > 0 && stats.sequencePruned > 0);
+    uint64_t perDepth = 0;
+    for (uint64_t nodes : stats.nodesPerDepth) perDepth += nodes;
+    assert(perDepth == stats.nodes);
+    // The root is visited once per iteration
+    uint64_t perIteration = 0;
+    for (const IterationStats& iteration : stats.iterations) perIteration += iteration.nodes;
+    assert(!stats.iterations.empty() && perIteration == stats.nodes);
+    assert(stats.nodesPerDepth[0] == stats.iterations.size());
+    assert(stats.toJSON().find("\"workerNodes\":[]") != std::string::npos);
+    std::cout << "  ✓ " << stats.nodes << " nodes over " << stats.iterations.size()
+              << " iterations, counted per depth" << std::endl;
+    
+#ifdef HAVE_OPENMP
+    OpenMPSolver parallel(4);
+    parallel.solve(cube, 10);
+    const SolveStats& merged = parallel.getStats();
+    uint64_t perThread = 0;
+    for (uint64_t nodes : merged.workerNodes) perThread += nodes;
+    assert(merged.solved && merged.workerNodes.size() == 4 && perThread == merged.nodes);
+    std::cout << "  ✓ OpenMP counters merge per thread" << std::endl;
+#endif
+    
+    SolveMetrics metrics;
+    metrics.record(stats);
+    metrics.record(stats);
+    std::string text = metrics.toPrometheus();
+    assert(text.find("rubiks_solves_total{solver=\"Sequential (IDA*)\"} 2\n") != std::string::npos);
+    assert(text.find("# TYPE rubiks_search_nodes_total counter") != std::string::npos);
+    std::cout << "  ✓ Prometheus totals per solver" << std::endl;
+    
+    LogLevel level = LogLevel::INFO;
+    bool known = parseLogLevel("debug", level);
+    assert(known && level == LogLevel::DEBUG);
+    known = parseLogLevel("verbose", level);
+    assert(!known && level == LogLevel::DEBUG);
+    LogLevel previous = getLogLevel();
+    setLogLevel(LogLevel::WARNING);
+    assert(logEnabled(LogLevel::ERROR) && !logEnabled(LogLevel::INFO));
+    setLogLevel(previous);
+    std::cout << "  ✓ Log levels parse and gate" << std::endl;
+}
+
+void testPatternDatabase() {
+    std::cout << "Testing pattern database..." << std::endl;
+    PatternDatabase db;
+    db.addTable(PatternTable::Kind::CORNERS, {0, 1, 2});
+    db.addTable(PatternTable::Kind::EDGES, {0, 1, 8});
+    db.generate();
+    
+    CubieCube solved;
+    assert(db.estimate(solved) == 0);
+    
+    // Estimates never exceed the number of moves applied
+    for (int i = 0; i < 200; ++i) {
+        CubieCube cube;
+        int length = 1 + i % 5;
+        for (int j = 0; j < length; ++j) {
+            cube.applyMove(ALL_MOVES[(i * 5 + j * 7) % NUM_MOVES]);
+        }
+        assert(db.estimate(cube) <= length);
+    }
+    CubieCube oneMove;
+    oneMove.applyMove(Move::R);
+    assert(db.estimate(oneMove) == 1);
+    std::cout << "  ✓ Generated tables are admissible" << std::endl;
+    
+    const std::string path = "test_patterns.pdb";
+    db.save(path);
+    auto loaded = PatternDatabase::load(path);
+    assert(loaded->getTables().size() == 2);
+    for (int i = 0; i < 50; ++i) {
+        RubiksCube cube;
+        cube.scramble(12);
+        CubieCube cubie(cube);
+        assert(loaded->estimate(cubie) == db.estimate(cubie));
+    }
+    std::cout << "  ✓ Memory-mapped file matches generated tables" << std::endl;
+    
+    RubiksCube cube;
+    cube.applyMoves({"R", "U", "F"});
+    SequentialSolver solver;
+    solver.setHeuristic(std::make_shared<PatternDatabaseHeuristic>(loaded));
+    auto solution = solver.solve(cube, 10);
+    cube.applyMoves(solution);
+    assert(cube.isSolved());
+    std::remove(path.c_str());
+    std::cout << "  ✓ Solver searches with the pattern database heuristic" << std::endl;
+}
+
+#ifdef HAVE_OPENMP
+void testOpenMPSolver() {
+    std::cout << "Testing OpenMP task solver..." << std::endl;
+    std::vector<std::string> scramble = {"R", "U", "F'", "L", "D'"};
+    
+    RubiksCube reference;
+    reference.applyMoves(scramble);
+    SequentialSolver sequential;
+    size_t optimal = sequential.solve(reference, 10).size();
+    
+    for (int splitDepth : {0, 1, 3}) {
+        RubiksCube cube;
+        cube.applyMoves(scramble);
+        OpenMPSolver solver(4, splitDepth);
+        auto solution = solver.solve(cube, 10);
+        assert(solution.size() == optimal);
+        cube.applyMoves(solution);
+        assert(cube.isSolved());
+    }
+    std::cout << "  ✓ Task split depths 0, 1 and 3 find " << optimal << "-move solutions" << std::endl;
+}
+#endif
+
+void testSolverDeadline() {
+    std::cout << "Testing solver deadlines and cancellation..." << std::endl;
+    RubiksCube cube;
+    cube.applyMoves({"R", "U", "F", "L", "D", "B", "R", "U", "F", "L", "D", "B"});
+    
+    SequentialSolver solver;
+    solver.setTimeLimit(0.2);
+    auto start = std::chrono::steady_clock::now();
+    auto solution = solver.solve(cube, 20);
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    assert(solution.empty() && solver.wasStopped());
+    assert(elapsed < 1.0);
+    std::cout << "  ✓ Search stopped at its time limit (" << elapsed << "s)" << std::endl;
+    
+    auto token = std::make_shared<CancellationToken>();
+    token->cancel();
+    solver.setTimeLimit(0.0);
+    solver.setCancellationToken(token);
+    solution = solver.solve(cube, 20);
+    assert(solution.empty() && solver.wasStopped());
+    std::cout << "  ✓ Cancelled token stops the search" << std::endl;
+    
+    auto parent = std::make_shared<CancellationToken>();
+    auto child = std::make_shared<CancellationToken>(parent);
+    child->cancel();
+    assert(child->isCancelled() && !parent->isCancelled());
+    child = std::make_shared<CancellationToken>(parent);
+    parent->setTimeLimit(0.0);
+    assert(child->expired());
+    parent->cancel();
+    assert(child->isCancelled());
+    std::cout << "  ✓ Child tokens follow their parent" << std::endl;
+}
+
+void testProgressCallback() {
+    std::cout << "Testing solver progress reports..." << std::endl;
+    RubiksCube cube;
+    cube.applyMoves({"R", "U", "F", "L"});
+    
+    std::vector<SolveProgress> reports;
+    SequentialSolver solver;
+    solver.setProgressCallback([&](const SolveProgress& progress) { reports.push_back(progress); });
+    auto solution = solver.solve(cube, 10);
+    assert(solution.size() == 4);
+    assert(!reports.empty() && reports.back().threshold == 4);
+    for (size_t i = 1; i < reports.size(); ++i) {
+        assert(reports[i].threshold > reports[i - 1].threshold);
+        assert(reports[i].nodes >= reports[i - 1].nodes);
+    }
+    std::cout << "  ✓ " << reports.size() << " threshold reports, ending at " << reports.back().threshold << std::endl;
+}
+
+void testScrambler() {
+    std::cout << "Testing seeded scrambler..." << std::endl;
+    Scrambler a(42), b(42);
+    auto moves = a.randomMoves(200);
+    assert(moves == b.randomMoves(200));
+    for (size_t i = 1; i < moves.size(); ++i) {
+        int last = moveFace(moves[i - 1]), face = moveFace(moves[i]);
+        assert(face != last);
+        assert(!(face / 2 == last / 2 && face < last));
+    }
+    for (Move m : a.randomMoves(50, true)) assert(moveIndex(m) % 3 != 2);
+    std::cout << "  ✓ Same seed, same moves; no adjacent face or axis repeats" << std::endl;
+    
+    RubiksCube c1, c2;
+    c1.scramble(25, 7);
+    c2.scramble(25, 7);
+    assert(c1 == c2 && !c1.isSolved());
+    
+    std::unordered_set<std::string> seen;
+    int twists[3] = {0, 0, 0};
+    Scrambler states(1);
+    for (int i = 0; i < 3000; ++i) {
+        CubieCube cube = states.randomState();
+        assert(CubieCube::fromFacelets(cube.toFacelets()) == cube);
+        seen.insert(cube.toString());
+        twists[cube.getCornerOrientation(0)]++;
+    }
+    assert(seen.size() == 3000);
+    for (int count : twists) assert(count > 850 && count < 1150);
+    assert(Scrambler::streamSeed(1, 0) != Scrambler::streamSeed(1, 1));
+    std::cout << "  ✓ Random states are reachable, distinct and evenly twisted" << std::endl;
+}
+
+void testTwoPhaseSolver() {
+    std::cout << "Testing two-phase solver..." << std::endl;
+    TwoPhaseSolver solver;
+    
+    RubiksCube cube;
+    cube.scramble(25);
+    RubiksCube scrambled = cube;
+    auto solution = solver.solve(cube, 22);
+    assert(!solution.empty() && solution.size() <= 22);
+    cube.applyMoves(solution);
+    assert(cube.isSolved());
+    std::cout << "  ✓ Solved a 25-move scramble in " << solution.size() << " moves" << std::endl;
+    
+    std::vector<size_t> lengths;
+    solver.setAnytime(true);
+    solver.setTimeLimit(0.5);
+    solver.setSolutionCallback([&](const std::vector<std::string>& moves) {
+        lengths.push_back(moves.size());
+    });
+    cube = scrambled;
+    solution = solver.solve(cube, 22);
+    assert(!lengths.empty() && lengths.back() == solution.size());
+    for (size_t i = 1; i < lengths.size(); ++i) {
+        assert(lengths[i] < lengths[i - 1]);
+    }
+    cube.applyMoves(solution);
+    assert(cube.isSolved());
+    std::cout << "  ✓ Anytime mode reported " << lengths.size() << " improving solutions" << std::endl;
+}
+
+void testSolveBatch() {
+    std::cout << "Testing batch solve..." << std::endl;
+    std::vector<RubiksCube> cubes(12);
+    for (size_t i = 1; i < cubes.size(); ++i) cubes[i].scramble(20, i);
+    CubieCube twisted;
+    twisted.setCorner(0, 0, 1);  // a lone twisted corner is unreachable
+    cubes[5] = twisted.toFacelets();
+    
+    TwoPhaseSolver solver;
+    std::vector<size_t> order;
+    solver.solveBatch(cubes, [&](const BatchResult& result) {
+        order.push_back(result.index);
+        if (result.index == 5) {
+            assert(!result.success && !result.error.empty());
+            return;
+        }
+        assert(result.success);
+        RubiksCube cube = cubes[result.index];
+        cube.applyMoves(result.solution);
+        assert(cube.isSolved());
+    }, 22, 4);
+    assert(order.size() == cubes.size());
+    for (size_t i = 0; i < order.size(); ++i) assert(order[i] == i);
+    assert(solver.canClone() && solver.clone()->getTimeLimit() == solver.getTimeLimit());
+    std::cout << "  ✓ 4 threads solved 11 cubes and rejected 1, in input order" << std::endl;
+}
+
+#ifdef HAVE_MPI
+void testMPIGroupLayout() {
+    std::cout << "Testing MPI group layout..." << std::endl;
+    // 7 workers in groups of 3: ranks 1-3, then 4-7 with the remainder
+    MPIGroupLayout layout{7, 3};
+    assert(layout.groupCount() == 2);
+    assert(layout.groupOf(0) == 0 && layout.groupOf(2) == 0);
+    assert(layout.groupOf(3) == 1 && layout.groupOf(6) == 1);
+    assert(layout.leaderOf(0) == 1 && layout.leaderOf(1) == 4);
+    assert(layout.sizeOf(0) == 3 && layout.sizeOf(1) == 4);
+    
+    // Every worker lands in exactly one group, led by its lowest rank
+    for (int workers = 1; workers <= 9; ++workers) {
+        for (int size = 1; size <= workers; ++size) {
+            MPIGroupLayout l{workers, size};
+            int total = 0;
+            for (int g = 0; g < l.groupCount(); ++g) {
+                total += l.sizeOf(g);
+                assert(l.groupOf(l.leaderOf(g) - 1) == g);
+                assert(l.leaderOf(g) == 1 || l.groupOf(l.leaderOf(g) - 2) == g - 1);
+            }
+            assert(total == workers);
+        }
+    }
+    std::cout << "  ✓ Workers split into consecutive groups" << std::endl;
+    
+    // One job gets every worker; a deeper queue gets one group per job
+    assert(MPIGroupLayout::chooseGroupSize(8, 0, 1) == 8);
+    assert(MPIGroupLayout::chooseGroupSize(8, 1, 1) == 8);
+    assert(MPIGroupLayout::chooseGroupSize(8, 2, 1) == 4);
+    assert(MPIGroupLayout::chooseGroupSize(8, 3, 1) == 2);
+    assert(MPIGroupLayout::chooseGroupSize(8, 20, 1) == 1);
+    assert(MPIGroupLayout::chooseGroupSize(8, 20, 3) == 3);
+    assert(MPIGroupLayout::chooseGroupSize(2, 1, 5) == 2);
+    std::cout << "  ✓ Group size follows the queue depth" << std::endl;
+}
+#endif
+
+void testSolverPool() {
+    std::cout << "Testing solver pool..." << std::endl;
+    SolverPool pool;
+    int built = 0;
+    auto create = [&] {
+        ++built;
+        return std::unique_ptr<Solver>(new SequentialSolver());
+    };
+    pool.reserve("sequential", create, 1);
+    assert(built == 1 && pool.idle() == 1);
+    
+    // A returned instance is lent out again, without the borrower's token or callback
+    Solver* first;
+    {
+        SolverPool::Lease lease = pool.acquire("sequential", create);
+        first = lease.get();
+        lease->setProgressCallback([](const SolveProgress&) { assert(false); });
+        auto token = std::make_shared<CancellationToken>();
+        token->cancel();
+        lease->setCancellationToken(token);
+        assert(pool.idle() == 0);
+    }
+    {
+        SolverPool::Lease lease = pool.acquire("sequential", create);
+        assert(lease.get() == first && built == 1 && pool.getReused() == 2);
+        
+        // Held leases are exclusive: a second borrower gets its own
+        SolverPool::Lease other = pool.acquire("sequential", create);
+        assert(other.get() != first && built == 2 && pool.getCreated() == 2);
+        
+        SolverSettings settings;
+        settings.metric = Metric::HALF_TURN;
+        settings.timeLimit = 5.0;
+        lease->configure(settings);
+        assert(lease->getMetric() == Metric::HALF_TURN && lease->getTimeLimit() == 5.0);
+        RubiksCube cube;
+        cube.applyMoves({"R2", "U"});
+        auto solution = lease->solve(cube, 5);
+        assert(solution.size() == 2 && !lease->wasStopped());
+    }
+    assert(pool.idle() == 2);
+    
+    // Solvers tied to one metric keep theirs
+    TwoPhaseSolver twoPhase;
+    twoPhase.configure(SolverSettings{});
+    assert(twoPhase.getMetric() == Metric::HALF_TURN && twoPhase.getTimeLimit() == 0.0);
+    std::cout << "  ✓ Instances are reused, exclusive while leased, and reset on return" << std::endl;
+}
+
+void testHTTPRequestParsing() {
+    std::cout << "Testing HTTP request framing..." << std::endl;
+    using Status = HTTPServer::ParseStatus;
+    HTTPRequest request;
+    size_t consumed = 0;
+    
+    std::string first = "POST /cube/move HTTP/1.1\r\nHost: x\r\nContent-Length: 12\r\n\r\n{\"move\":\"R\"}";
+    std::string second = "GET /status HTTP/1.1\r\nConnection: close\r\n\r\n";
+    std::string buffer = first + second;
+    
+    Status status = HTTPServer::parseRequest(buffer.substr(0, first.size() - 1), request, consumed);
+    assert(status == Status::INCOMPLETE);
+    status = HTTPServer::parseRequest(buffer, request, consumed);
+    assert(status == Status::COMPLETE);
+    assert(consumed == first.size());
+    assert(request.method == "POST" && request.path == "/cube/move");
+    assert(request.body == "{\"move\":\"R\"}");
+    assert(request.header("host") == "x");
+    assert(request.keepAlive());
+    
+    buffer.erase(0, consumed);
+    status = HTTPServer::parseRequest(buffer, request, consumed);
+    assert(status == Status::COMPLETE);
+    assert(request.path == "/status" && request.body.empty() && !request.keepAlive());
+    std::cout << "  ✓ Pipelined requests split on Content-Length" << std::endl;
+    
+    status = HTTPServer::parseRequest("GET / HTTP/1.0\r\n\r\n", request, consumed);
+    assert(status == Status::COMPLETE && !request.keepAlive());
+    status = HTTPServer::parseRequest("garbage\r\n\r\n", request, consumed);
+    assert(status == Status::BAD_REQUEST);
+    status = HTTPServer::parseRequest("POST / HTTP/1.1\r\nContent-Length: 99999999999\r\n\r\n",
+                                      request, consumed);
+    assert(status == Status::TOO_LARGE);
+    status = HTTPServer::parseRequest("POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n",
+                                      request, consumed);
+    assert(status == Status::UNSUPPORTED);
+    std::cout << "  ✓ Malformed, oversized and chunked requests rejected" << std::endl;
+    
+    status = HTTPServer::parseRequest("GET /cube?format=compact&x HTTP/1.1\r\n\r\n", request, consumed);
+    assert(status == Status::COMPLETE);
+    assert(request.path == "/cube" && request.query == "format=compact&x");
+    assert(request.queryParam("format") == "compact" && request.queryParam("x").empty());
+    assert(request.queryParam("form").empty());
+    CubeFormat format;
+    bool known = parseCubeFormat("binary", format);
+    assert(known && format == CubeFormat::BINARY);
+    known = parseCubeFormat("xml", format);
+    assert(!known);
+    
+    HTTPResponse response;
+    response.status = 404;
+    response.body = "{}";
+    response.addHeader("X-Session-Id: abc");
+    std::string framed = "stale";
+    framed.clear();
+    response.serialize(framed, 0);
+    assert(framed.compare(0, 24, "HTTP/1.1 404 Not Found\r\n") == 0);
+    assert(framed.find("Content-Length: 2\r\n") != std::string::npos);
+    assert(framed.find("\r\nX-Session-Id: abc\r\nConnection: close\r\n\r\n{}") != std::string::npos);
+    std::cout << "  ✓ Query strings split off, responses framed once" << std::endl;
+}
+
+void testBinaryProtocol() {
+    std::cout << "Testing binary solve frames..." << std::endl;
+    CubieCube cube;
+    cube.applyMove("R");
+    cube.applyMove("U'");
+    assert(cube.isValid() && CubieCube().isValid());
+    CubieCube swapped = cube;
+    swapped.setCorner(0, cube.getCornerPermutation(1), 0);
+    swapped.setCorner(1, cube.getCornerPermutation(0), 0);
+    CubieCube twisted;
+    twisted.setCorner(0, 0, 1);
+    CubieCube outOfRange;
+    outOfRange.setEdge(0, 15, 0);
+    assert(!swapped.isValid() && !twisted.isValid() && !outOfRange.isValid());
+    std::cout << "  ✓ Unreachable and out-of-range cubes fail isValid" << std::endl;
+    
+    BinarySolveRequest request;
+    request.solver = static_cast<uint8_t>(BinarySolver::OPENMP);
+    request.metric = 1;
+    request.maxDepth = 14;
+    request.tag = 0xA1B2C3D4;
+    request.deadlineMicros = 250000;
+    request.cube = cube;
+    std::string wire;
+    encodeSolveRequest(wire, request);
+    encodeSolveRequest(wire, request);
+    assert(wire.size() == 2 * (4 + BINARY_REQUEST_BYTES));
+    assert(wire[0] == 32 && wire[8] == '\xD4' && wire[11] == '\xA1');  // little-endian
+    
+    BinarySolveRequest decoded;
+    size_t consumed = 0;
+    FrameStatus status = decodeSolveRequest(wire.data(), 35, decoded, consumed);
+    assert(status == FrameStatus::INCOMPLETE);
+    status = decodeSolveRequest(wire.data(), wire.size(), decoded, consumed);
+    assert(status == FrameStatus::COMPLETE);
+    assert(consumed == 4 + BINARY_REQUEST_BYTES);
+    assert(decoded.version == BINARY_PROTOCOL_VERSION && decoded.solver == request.solver);
+    assert(decoded.metric == 1 && decoded.maxDepth == 14 && decoded.tag == request.tag);
+    assert(decoded.deadlineMicros == 250000 && decoded.cube == cube);
+    status = decodeSolveRequest(wire.data() + consumed, wire.size() - consumed, decoded, consumed);
+    assert(status == FrameStatus::COMPLETE);
+    std::string bad = wire;
+    bad[0] = 31;
+    status = decodeSolveRequest(bad.data(), bad.size(), decoded, consumed);
+    assert(status == FrameStatus::BAD_FRAME);
+    assert(std::string(binarySolverType(0)) == "twophase" && !binarySolverType(9));
+    std::cout << "  ✓ Pipelined requests decode one frame at a time" << std::endl;
+    
+    BinarySolveResponse response;
+    response.status = BinaryStatus::SOLVED;
+    response.cached = true;
+    response.tag = 7;
+    response.nodes = uint64_t{1} << 40;
+    response.micros = 1234;
+    response.solution = {Move::U, Move::RPrime, Move::F2};
+    wire.clear();
+    encodeSolveResponse(wire, response);
+    assert(wire.size() == 4 + BINARY_RESPONSE_BYTES + 3);
+    BinarySolveResponse back;
+    status = decodeSolveResponse(wire.data(), wire.size() - 1, back, consumed);
+    assert(status == FrameStatus::INCOMPLETE);
+    status = decodeSolveResponse(wire.data(), wire.size(), back, consumed);
+    assert(status == FrameStatus::COMPLETE);
+    assert(consumed == wire.size() && back.status == BinaryStatus::SOLVED && back.cached);
+    assert(back.tag == 7 && back.nodes == response.nodes && back.micros == 1234);
+    assert(back.solution == response.solution);
+    wire.back() = 18;
+    status = decodeSolveResponse(wire.data(), wire.size(), back, consumed);
+    assert(status == FrameStatus::BAD_FRAME);
+    std::cout << "  ✓ Responses carry status, stats and packed moves" << std::endl;
+}
+
+void testThreadPool() {
+    std::cout << "Testing bounded thread pool..." << std::endl;
+    ThreadPool pool(1, 2);
+    std::atomic<bool> release{false};
+    std::atomic<int> done{0};
+    
+    bool accepted = pool.trySubmit([&] {
+        while (!release) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        done++;
+    });
+    assert(accepted);
+    while (pool.active() == 0) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    
+    // One running, two queued; the fourth is refused
+    accepted = pool.trySubmit([&] { done++; });
+    assert(accepted);
+    accepted = pool.trySubmit([&] { done++; });
+    assert(accepted);
+    accepted = pool.trySubmit([&] { done++; });
+    assert(!accepted);
+    
+    release = true;
+    pool.shutdown();
+    assert(done == 3);
+    accepted = pool.trySubmit([&] { done++; });
+    assert(!accepted);
+    std::cout << "  ✓ Full queue refuses work; shutdown drains it" << std::endl;
+}
+
+void testThreadPlacement() {
+    std::cout << "Testing thread placement..." << std::endl;
+    for (ThreadBinding binding : {ThreadBinding::NONE, ThreadBinding::CLOSE, ThreadBinding::SPREAD}) {
+        assert(parseThreadBinding(threadBindingName(binding)) == binding);
+    }
+    bool threw = false;
+    try {
+        parseThreadBinding("compact");
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    assert(threw);
+    std::cout << "  ✓ Binding names round-trip" << std::endl;
+    
+    // Alone on the node a rank keeps every CPU it may run on, each once
+    ThreadPlacement& placement = ThreadPlacement::get();
+    placement.configure(0, 1, ThreadBinding::SPREAD);
+    std::vector<int> ids;
+    for (const ThreadPlacement::Cpu& cpu : placement.cpus()) ids.push_back(cpu.id);
+    std::sort(ids.begin(), ids.end());
+    assert(!ids.empty() && std::unique(ids.begin(), ids.end()) == ids.end());
+    assert(placement.threads() >= 1 && !placement.nodes().empty());
+    assert(placement.describe().find("local rank 0/1") == 0);
+    placement.configure(0, 1, ThreadBinding::CLOSE);
+    std::cout << "  ✓ " << placement.describe() << std::endl;
+    
+    // Slots are made on first use by their thread, and kept
+    PerThread<SearchCounters> slots;
+    slots.resize(4);
+    slots.local(2).nodes = 7;
+    assert(&slots.local(2) == &slots.local(2));
+    int made = 0;
+    uint64_t nodes = 0;
+    slots.forEach([&](const SearchCounters& counters) { ++made; nodes += counters.nodes; });
+    assert(made == 1 && nodes == 7);
+    std::cout << "  ✓ Per-thread slots made on first use" << std::endl;
+}
+
+void testSessionStore() {
+    std::cout << "Testing session store..." << std::endl;
+    SessionStore store(2, std::chrono::seconds(60), 1);
+    
+    std::string a = store.create();
+    std::string b = store.create();
+    assert(a != b && a.size() == 32);
+    bool found = store.withSession(a, [](RubiksCube& cube) { cube.applyMove("R"); });
+    assert(found);
+    
+    bool solved = true;
+    found = store.withSession(b, [&](RubiksCube& cube) { solved = cube.isSolved(); });
+    assert(found && solved);
+    found = store.withSession(a, [&](RubiksCube& cube) { solved = cube.isSolved(); });
+    assert(found && !solved);
+    std::cout << "  ✓ Sessions keep separate cubes" << std::endl;
+    
+    // a was used last, so the third session evicts b
+    std::string c = store.create();
+    assert(store.size() == 2);
+    found = store.withSession(b, [](RubiksCube&) {});
+    assert(!found);
+    found = store.withSession(a, [](RubiksCube&) {});
+    assert(found);
+    found = store.withSession(c, [](RubiksCube&) {});
+    assert(found);
+    found = store.withSession("unknown", [](RubiksCube&) {});
+    assert(!found);
+    std::cout << "  ✓ Least recently used session evicted at capacity" << std::endl;
+    
+    SessionStore shortLived(16, std::chrono::seconds(0), 4);
+    std::string d = shortLived.create();
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    found = shortLived.withSession(d, [](RubiksCube&) {});
+    assert(!found);
+    assert(shortLived.size() == 0);
+    std::cout << "  ✓ Idle sessions expire" << std::endl;
+}
+
+void testCubeSymmetry() {
+    std::cout << "Testing cube symmetries..." << std::endl;
+    std::vector<Move> scramble = {Move::R, Move::U, Move::FPrime, Move::L2, Move::D, Move::BPrime, Move::R2};
+    RubiksCube cube;
+    for (Move m : scramble) cube.applyMove(moveToString(m));
+    
+    int mirrors = 0;
+    for (int s = 0; s < CubeSymmetry::COUNT; ++s) {
+        // Symmetric scramble gives the symmetric position
+        RubiksCube mapped;
+        for (Move m : CubeSymmetry::mapMoves(s, scramble)) mapped.applyMove(moveToString(m));
+        assert(mapped == CubeSymmetry::apply(s, cube));
+        assert(CubeSymmetry::apply(CubeSymmetry::inverse(s), CubeSymmetry::apply(s, cube)) == cube);
+        
+        // Every variant shares the canonical form
+        int sym;
+        assert(CubeSymmetry::canonical(mapped, &sym) == CubeSymmetry::canonical(cube));
+        assert(CubeSymmetry::apply(sym, mapped) == CubeSymmetry::canonical(cube));
+        if (CubeSymmetry::isMirror(s)) mirrors++;
+    }
+    assert(mirrors == 24);
+    assert(CubeSymmetry::apply(CubeSymmetry::IDENTITY, cube) == cube);
+    std::cout << "  ✓ 48 symmetries map moves and positions consistently" << std::endl;
+}
+
+void testSolutionCache() {
+    std::cout << "Testing solution cache..." << std::endl;
+    auto cache = std::make_shared<SolutionCache>(64, 4);
+    
+    RubiksCube cube;
+    cube.applyMoves({"R", "U", "F'"});
+    cache->store("test", cube, {"F", "U'", "R'"});
+    
+    // A mirrored, rotated variant of the same position hits the entry
+    RubiksCube variant = CubeSymmetry::apply(37, cube);
+    std::vector<std::string> solution;
+    bool hit = cache->lookup("test", variant, 20, solution);
+    assert(hit);
+    variant.applyMoves(solution);
+    assert(variant.isSolved());
+    
+    hit = cache->lookup("test", cube, 2, solution);       // longer than maxDepth
+    assert(!hit);
+    hit = cache->lookup("other", cube, 20, solution);     // other solvers kept apart
+    assert(!hit);
+    assert(cache->getHits() == 1 && cache->getMisses() == 2);
+    std::cout << "  ✓ Symmetric positions share one entry" << std::endl;
+    
+    const std::string path = "test_solution_cache.bin";
+    cache->save(path);
+    SolutionCache restored(64, 4);
+    size_t loaded = restored.load(path);
+    assert(loaded == 1);
+    hit = restored.lookup("test", cube, 20, solution);
+    assert(hit && solution.size() == 3);
+    std::remove(path.c_str());
+    std::cout << "  ✓ Cache survives save/load" << std::endl;
+    
+    RubiksCube easy;
+    easy.applyMoves({"R", "U"});
+    auto inner = std::make_unique<SequentialSolver>();
+    CachedSolver cached(std::move(inner), cache);
+    auto first = cached.solve(easy, 5);
+    assert(!first.empty() && !cached.lastWasHit());
+    auto second = cached.solve(easy, 5);
+    assert(second == first && cached.lastWasHit() && cached.getNodesExplored() == 0);
+    std::cout << "  ✓ CachedSolver answers repeats from the cache" << std::endl;
 }
 
 int main() {
@@ -130,6 +1226,36 @@ int main() {
         testMoveSequence();
         testGetAllMoves();
         testJSON();
+        testJSONBody();
+        testCubieCubeConversion();
+        testCubieCubeMoves();
+        testFaceletKernel();
+        testMoveIds();
+        testMoveSequenceAutomaton();
+        testIDAStar();
+        testBidirectionalSolver();
+        testTranspositionTable();
+        testSolveStats();
+        testPatternDatabase();
+#ifdef HAVE_OPENMP
+        testOpenMPSolver();
+#endif
+        testSolverDeadline();
+        testProgressCallback();
+        testScrambler();
+        testTwoPhaseSolver();
+        testSolveBatch();
+        testSolverPool();
+#ifdef HAVE_MPI
+        testMPIGroupLayout();
+#endif
+        testHTTPRequestParsing();
+        testBinaryProtocol();
+        testThreadPool();
+        testThreadPlacement();
+        testSessionStore();
+        testCubeSymmetry();
+        testSolutionCache();
         
         std::cout << std::endl;
         std::cout << "========================================" << std::endl;
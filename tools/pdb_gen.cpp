@@ -0,0 +1,79 @@
+// tools/pdb_gen.cpp - Build the pattern database file used by the solvers
+//
+// rubiks_pdbgen [file]                            the pattern database
+// rubiks_pdbgen --frontier file [qtm|htm] [mb]    the bidirectional solver's
+//                                                 frontier table (64 MB cap)
+#include "pattern_database.hpp"
+#include "frontier_table.hpp"
+#include <chrono>
+#include <cstring>
+#include <iostream>
+
+namespace {
+
+int writeFrontier(int argc, char* argv[]) {
+    std::string output = argv[2];
+    Metric metric = Metric::QUARTER_TURN;
+    size_t bytes = FrontierTable::DEFAULT_BYTES;
+    if (argc > 3 && !parseMetric(argv[3], metric)) {
+        std::cerr << "Unknown metric: " << argv[3] << std::endl;
+        return 1;
+    }
+    try {
+        if (argc > 4) bytes = std::stoull(argv[4]) << 20;
+    } catch (const std::exception&) {
+        std::cerr << "Invalid size: " << argv[4] << std::endl;
+        return 1;
+    }
+
+    std::cout << "Frontier table (" << metricName(metric) << ", " << (bytes >> 20)
+              << " MB cap): " << output << std::endl;
+    auto start = std::chrono::high_resolution_clock::now();
+    try {
+        auto table = FrontierTable::build(metric, bytes, FrontierTable::MAX_DEPTH, &std::cout);
+        table->save(output);
+        std::cout << "Depth " << table->getDepth() << ", " << table->size() << " positions, "
+                  << (table->getByteCount() >> 20) << " MB" << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    double elapsed = std::chrono::duration<double>(
+        std::chrono::high_resolution_clock::now() - start).count();
+    std::cout << "\n✓ Wrote " << output << " in " << elapsed << "s" << std::endl;
+    std::cout << "Start the server with: ./rubiks_solver 8080 --frontier " << output << std::endl;
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc > 2 && std::strcmp(argv[1], "--frontier") == 0) return writeFrontier(argc, argv);
+
+    std::string output = argc > 1 ? argv[1] : "rubiks.pdb";
+
+    std::cout << "==================================" << std::endl;
+    std::cout << "Pattern Database Generator" << std::endl;
+    std::cout << "==================================" << std::endl;
+    std::cout << "Output: " << output << std::endl;
+
+    auto start = std::chrono::high_resolution_clock::now();
+    auto db = PatternDatabase::createDefault();
+    std::cout << "Tables: " << db->getTables().size() << ", size: "
+              << (db->getByteCount() >> 20) << " MB\n" << std::endl;
+
+    try {
+        db->generate(&std::cout);
+        db->save(output);
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    double elapsed = std::chrono::duration<double>(
+        std::chrono::high_resolution_clock::now() - start).count();
+    std::cout << "\n✓ Wrote " << output << " in " << elapsed << "s" << std::endl;
+    std::cout << "Start the server with: ./rubiks_solver 8080 --pdb " << output << std::endl;
+    return 0;
+}